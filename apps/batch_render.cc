@@ -0,0 +1,35 @@
+#include <core/batch_renderer.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <dataset.json> <output directory> [workers]" << std::endl;
+    return 1;
+  }
+
+  std::ifstream dataset_file(argv[1]);
+  if (!dataset_file.is_open()) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  scalepiegraph::ScaleDataset dataset;
+  dataset_file >> dataset;
+
+  size_t num_workers = argc > 3 ? std::stoul(argv[3]) : 0;
+  scalepiegraph::BatchRenderer renderer(num_workers);
+  scalepiegraph::BatchReport report = renderer.Render(dataset, argv[2]);
+
+  std::cout << "Rendered " << report.num_scales << " scales with "
+            << report.num_workers << " workers in " << report.seconds
+            << " s" << std::endl;
+  std::cout << "  " << report.GetScalesPerSecond() << " scales per second, "
+            << report.GetRealTimeFactor(scalepiegraph::SynthEngine::
+                                            kDefaultSampleRate)
+            << "x real time" << std::endl;
+
+  return 0;
+}
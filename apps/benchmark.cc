@@ -0,0 +1,355 @@
+#include <core/additive_timbre.h>
+#include <core/biquad_bank.h>
+#include <core/performance_analyzer.h>
+#include <core/tuning_verifier.h>
+#include <core/voice_pool.h>
+#include <core/wav_writer.h>
+#include <cinder/audio/Context.h>
+#include <cinder/audio/GenNode.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const double kSampleRate = 44100;
+const size_t kBlockSize = 512;
+const double kSecondsPerRun = 2.0;
+const size_t kNumBlocks = kSecondsPerRun * kSampleRate / kBlockSize;
+
+/**
+ * A GenOscNode whose render callback can be driven directly, so its cost can
+ * be measured outside of a running audio graph.
+ */
+class ProfiledGenOscNode : public ci::audio::GenOscNode {
+ public:
+  ProfiledGenOscNode(ci::audio::WaveformType waveform, float frequency) :
+      ci::audio::GenOscNode(waveform, frequency) {}
+
+  void Initialize() { initialize(); }
+
+  void Render(ci::audio::Buffer* buffer) { process(buffer); }
+};
+
+/**
+ * Measure the seconds spent rendering kSecondsPerRun of a fully busy voice
+ * pool.
+ */
+double time_voice_pool(size_t num_voices,
+                       scalepiegraph::Waveform waveform,
+                       size_t num_threads = 1) {
+  scalepiegraph::VoicePool pool(num_voices, kSampleRate);
+  std::vector<float> block(kBlockSize);
+
+  pool.SetNumThreads(num_threads);
+  pool.SetWaveform(waveform);
+  pool.SetFilterCutoff(4000);
+  for (size_t voice = 0; voice < pool.GetNumVoices(); ++voice) {
+    pool.NoteOn(voice, 110.0 + 3.0 * voice);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t block_idx = 0; block_idx < kNumBlocks; ++block_idx) {
+    pool.Render(block.data(), block.size());
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  return elapsed.count();
+}
+
+/**
+ * Convert a rendering time to nanoseconds per voice per sample.
+ */
+double nanos_per_voice_sample(double seconds, size_t num_voices) {
+  return 1e9 * seconds / (num_voices * kNumBlocks * kBlockSize);
+}
+
+/**
+ * Find how many voices a number of threads renders in real time, printing the
+ * load at each voice count tried.
+ */
+size_t find_sustained_voices(size_t num_threads) {
+  size_t sustained_voices = 0;
+
+  for (size_t num_voices = 8; num_voices <= 65536; num_voices *= 2) {
+    double load = time_voice_pool(num_voices,
+                                  scalepiegraph::Waveform::kSawtooth,
+                                  num_threads) / kSecondsPerRun;
+    std::cout << "  " << num_voices << " voices: "
+              << 100 * load << "% of the audio thread" << std::endl;
+
+    if (load >= 1) {
+      break;
+    }
+
+    // Extrapolate from the largest voice count that still runs in real time
+    sustained_voices = static_cast<size_t>(num_voices / load);
+  }
+
+  return sustained_voices;
+}
+
+} // namespace
+
+void benchmark_voice_pool() {
+  std::cout << "Voice pool: " << kBlockSize << " frame blocks at "
+            << kSampleRate << " Hz" << std::endl;
+
+  size_t num_cores = std::max(1u, std::thread::hardware_concurrency());
+  size_t one_thread_voices = 0;
+
+  for (size_t num_threads = 1; num_threads <= num_cores; num_threads *= 2) {
+    std::cout << " Rendering on " << num_threads << " threads" << std::endl;
+    size_t sustained_voices = find_sustained_voices(num_threads);
+
+    if (num_threads == 1) {
+      one_thread_voices = sustained_voices;
+    }
+
+    std::cout << "  " << num_threads << " threads sustain about "
+              << sustained_voices << " voices";
+    if (one_thread_voices > 0) {
+      std::cout << " (" << static_cast<double>(sustained_voices) /
+                           one_thread_voices << "x one thread)";
+    }
+    std::cout << std::endl;
+  }
+}
+
+void benchmark_biquad_bank() {
+  const size_t kNumFilters = 256;
+  scalepiegraph::BiquadBank bank(kNumFilters, kSampleRate);
+  std::vector<float> input(kBlockSize * scalepiegraph::simd::kLanes);
+  std::vector<float> samples(input.size());
+  for (size_t sample = 0; sample < input.size(); ++sample) {
+    input[sample] = (sample * 7919 % 1000) / 500.0f - 1; // Broadband noise
+  }
+
+  // Sweep every cutoff each block so the coefficients are always gliding
+  auto start = std::chrono::steady_clock::now();
+  for (size_t block_idx = 0; block_idx < kNumBlocks; ++block_idx) {
+    for (size_t filter = 0; filter < kNumFilters; ++filter) {
+      bank.SetFilter(filter, scalepiegraph::FilterMode::kBandPass,
+                     200.0 + 10.0 * ((block_idx + filter) % 100), 2);
+    }
+
+    bank.Glide(0, kNumFilters, kBlockSize);
+    for (size_t first = 0; first < kNumFilters;
+         first += scalepiegraph::simd::kLanes) {
+      std::copy(input.begin(), input.end(), samples.begin());
+      bank.Process(first, samples.data(), kBlockSize);
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  double nanos = nanos_per_voice_sample(elapsed.count(), kNumFilters);
+  std::cout << "Biquad bank: " << nanos << " ns per filter per sample"
+            << std::endl
+            << "  One core sustains about "
+            << static_cast<size_t>(1e9 / (nanos * kSampleRate))
+            << " gliding filters" << std::endl;
+}
+
+void benchmark_additive_voices() {
+  const size_t kNumVoices = 16;
+  const size_t kNumPartials = scalepiegraph::AdditiveTimbre::kMaxPartials;
+  scalepiegraph::VoicePool pool(kNumVoices, kSampleRate);
+  std::vector<float> block(kBlockSize);
+
+  // Low notes keep all of the partials below Nyquist
+  scalepiegraph::AdditiveTimbre timbre;
+  timbre.Clear();
+  for (size_t partial = 1; partial <= kNumPartials; ++partial) {
+    timbre.AddPartial(partial, 1.0 / partial);
+  }
+
+  pool.SetMaxPartials(kNumPartials);
+  pool.SetTimbre(&timbre);
+  for (size_t voice = 0; voice < kNumVoices; ++voice) {
+    pool.NoteOn(voice, 40.0 + voice);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t block_idx = 0; block_idx < kNumBlocks; ++block_idx) {
+    pool.Render(block.data(), block.size());
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  double nanos =
+      nanos_per_voice_sample(elapsed.count(), kNumVoices * kNumPartials);
+  std::cout << "Additive voices: " << nanos << " ns per partial per sample"
+            << std::endl
+            << "  One core sustains about "
+            << static_cast<size_t>(1e9 / (nanos * kSampleRate))
+            << " partials, or "
+            << static_cast<size_t>(1e9 / (nanos * kSampleRate * kNumPartials))
+            << " voices of " << kNumPartials << " partials" << std::endl;
+}
+
+void benchmark_sample_voices() {
+  const size_t kNumVoices = 16;
+  const std::string kPath = "benchmark_sample.wav";
+  const double kRootFrequency = 220;
+
+  // Long enough that every voice streams from disk past the preloaded head
+  std::vector<float> recording(
+      static_cast<size_t>(4 * kSecondsPerRun * kSampleRate));
+  for (size_t frame = 0; frame < recording.size(); ++frame) {
+    recording[frame] = static_cast<float>(
+        std::sin(6.283185307179586 * kRootFrequency * frame / kSampleRate));
+  }
+  scalepiegraph::WavWriter::WriteFile(kPath, recording, kSampleRate);
+
+  scalepiegraph::VoicePool pool(kNumVoices, kSampleRate);
+  std::vector<float> block(kBlockSize);
+  scalepiegraph::StreamedSample sample(kPath, kRootFrequency, kNumVoices);
+  pool.SetSample(&sample);
+
+  // Spread the voices over an octave either side of the root
+  for (size_t voice = 0; voice < kNumVoices; ++voice) {
+    pool.NoteOn(voice, kRootFrequency *
+                           std::exp2(2.0 * voice / kNumVoices - 1));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t block_idx = 0; block_idx < kNumBlocks; ++block_idx) {
+    pool.Render(block.data(), block.size());
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  double nanos = nanos_per_voice_sample(elapsed.count(), kNumVoices);
+  std::cout << "Sample voices: " << nanos << " ns per voice per sample, "
+            << sample.GetNumUnderruns() << " underruns" << std::endl
+            << "  One core sustains about "
+            << static_cast<size_t>(1e9 / (nanos * kSampleRate))
+            << " streamed voices" << std::endl;
+
+  std::remove(kPath.c_str());
+}
+
+void benchmark_performance_analyzer() {
+  const double kSeconds = 10;
+  scalepiegraph::Scale scale(12);
+  scalepiegraph::PerformanceAnalyzer analyzer(scale, 220, kSampleRate);
+
+  // A voice gliding over two octaves keeps every lag of the detector busy
+  std::vector<float> performance(static_cast<size_t>(kSeconds * kSampleRate));
+  double phase = 0;
+  for (size_t frame = 0; frame < performance.size(); ++frame) {
+    phase += 110 * std::exp2(2.0 * frame / performance.size()) / kSampleRate;
+    performance[frame] =
+        static_cast<float>(std::sin(6.283185307179586 * phase));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t first = 0; first < performance.size(); first += kBlockSize) {
+    analyzer.Process(&performance[first],
+                     std::min(kBlockSize, performance.size() - first));
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << "Performance analysis: " << kSeconds / elapsed.count()
+            << "x real time" << std::endl;
+}
+
+void benchmark_tuning_verifier() {
+  std::istringstream json(
+      "{\"scales\": ["
+      "{\"name\": \"Chromatic\", "
+      "\"intervals\": [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]},"
+      "{\"name\": \"Blues\", \"intervals\": [0, 3, 5, 6, 7, 10]},"
+      "{\"name\": \"Whole Tone\", \"intervals\": [0, 2, 4, 6, 8, 10]},"
+      "{\"name\": \"Major\", \"intervals\": [0, 2, 4, 5, 7, 9, 11]}"
+      "]}");
+  scalepiegraph::ScaleDataset dataset;
+  json >> dataset;
+
+  scalepiegraph::TuningVerifier verifier(0, kSampleRate);
+  scalepiegraph::TuningReport report = verifier.VerifyDataset(dataset);
+
+  std::cout << "Tuning verification: "
+            << report.notes.size() / report.seconds << " notes per second on "
+            << report.num_workers << " workers" << std::endl;
+
+  const char* kNames[] = {"sine", "triangle", "square", "sawtooth"};
+  for (size_t waveform = 0; waveform < 4; ++waveform) {
+    double max_error = 0;
+    for (const scalepiegraph::NoteTuning& note : report.notes) {
+      if (static_cast<size_t>(note.waveform) == waveform) {
+        max_error = std::max(max_error, std::fabs(note.error_cents));
+      }
+    }
+
+    std::cout << "  Max " << kNames[waveform] << " error: " << max_error
+              << " cents" << std::endl;
+  }
+}
+
+void benchmark_wavetable_oscillator() {
+  const size_t kNumVoices = 64;
+  const std::vector<ci::audio::WaveformType> kNodeWaveforms = {
+      ci::audio::WaveformType::SINE,
+      ci::audio::WaveformType::TRIANGLE,
+      ci::audio::WaveformType::SQUARE,
+      ci::audio::WaveformType::SAWTOOTH};
+  const std::vector<scalepiegraph::Waveform> kWaveforms = {
+      scalepiegraph::Waveform::kSine,
+      scalepiegraph::Waveform::kTriangle,
+      scalepiegraph::Waveform::kSquare,
+      scalepiegraph::Waveform::kSawtooth};
+  const std::vector<std::string> kNames = {
+      "sine", "triangle", "square", "sawtooth"};
+
+  std::cout << "Per-voice cost in ns per sample (voice pool includes "
+               "envelope and filter)" << std::endl;
+
+  ci::audio::Context* context = ci::audio::Context::master();
+
+  for (size_t wave_idx = 0; wave_idx < kWaveforms.size(); ++wave_idx) {
+    double pool_seconds = time_voice_pool(kNumVoices, kWaveforms[wave_idx]);
+    std::cout << "  " << kNames[wave_idx] << ": wavetable voice "
+              << nanos_per_voice_sample(pool_seconds, kNumVoices);
+
+    if (context == nullptr) {
+      std::cout << ", GenOscNode skipped (no audio device)" << std::endl;
+      continue;
+    }
+
+    auto node = context->makeNode(
+        new ProfiledGenOscNode(kNodeWaveforms[wave_idx], 440));
+    node->Initialize();
+    ci::audio::Buffer buffer(kBlockSize, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t block_idx = 0; block_idx < kNumBlocks; ++block_idx) {
+      node->Render(&buffer);
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << ", GenOscNode " << nanos_per_voice_sample(elapsed.count(), 1)
+              << std::endl;
+  }
+}
+
+int main() {
+  benchmark_voice_pool();
+  benchmark_biquad_bank();
+  benchmark_additive_voices();
+  benchmark_sample_voices();
+  benchmark_performance_analyzer();
+  benchmark_tuning_verifier();
+  benchmark_wavetable_oscillator();
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+#include <core/scale_inference.h>
+#include <fstream>
+#include <iostream>
+#include <jsoncpp/json.h>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    std::cerr << "Usage: " << argv[0]
+              << " <scale name> <reference frequency> <pitches.csv|.wav>..."
+              << std::endl;
+    return 1;
+  }
+
+  scalepiegraph::ScaleInference inference(std::stod(argv[2]));
+
+  for (int arg = 3; arg < argc; ++arg) {
+    std::string path = argv[arg];
+
+    if (path.size() > 4 && path.substr(path.size() - 4) == ".wav") {
+      inference.AddRecording(path);
+      continue;
+    }
+
+    std::ifstream csv_file(path);
+    if (!csv_file.is_open()) {
+      std::cerr << "Cannot open " << path << std::endl;
+      return 1;
+    }
+    inference.AddCsv(csv_file);
+  }
+
+  // Printed as a dataset entry, ready to paste into a dataset's scales
+  Json::Value scale;
+  scale["name"] = argv[1];
+  scale["description"] = "Inferred from " +
+                         std::to_string(inference.GetNumObservations()) +
+                         " observed pitches";
+  for (double frequency : inference.InferFrequencies()) {
+    scale["frequencies"].append(frequency);
+  }
+
+  std::cout << scale << std::endl;
+
+  return 0;
+}
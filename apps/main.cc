@@ -1,4 +1,6 @@
 #include <core/synthesizer.h>
+#include <core/offline_renderer.h>
+#include <core/pattern.h>
 #include <core/scale.h>
 #include <unistd.h>
 #include <iostream>
@@ -6,25 +8,41 @@
 #include <fstream>
 
 void showcase_synthesizer() {
-  const size_t kSecond = 1000000;
+  const size_t kMicrosInSecond = 1000000;
   const float kBaseFrequency = 440.0;
+  const double kStepDuration = 0.25;
 
   scalepiegraph::Synthesizer synthesizer;
   scalepiegraph::Scale scale(12);
 
-  synthesizer.Start(kBaseFrequency);
   synthesizer.SetFilter(kBaseFrequency);
-
   synthesizer.SetWaveform(ci::audio::WaveformType::SAWTOOTH);
-  usleep(kSecond);
-  synthesizer.SetFrequency(scale.CalculateNoteFrequency(kBaseFrequency, 2));
-  synthesizer.SetWaveform(ci::audio::WaveformType::SQUARE);
-  usleep(kSecond);
-  synthesizer.SetFrequency(scale.CalculateNoteFrequency(kBaseFrequency, 4));
-  synthesizer.SetWaveform(ci::audio::WaveformType::TRIANGLE);
-  usleep(kSecond);
-
-  synthesizer.Stop();
+
+  // The sequencer keeps time on the audio clock; only wait for it to finish
+  scalepiegraph::Pattern run = scalepiegraph::Pattern::ScaleRun(
+      scale, kStepDuration, kBaseFrequency);
+  synthesizer.PlayPattern(run);
+  usleep(static_cast<useconds_t>(run.GetDuration() * kMicrosInSecond));
+
+  synthesizer.StopPattern();
+}
+
+void showcase_offline_render(const std::string& path) {
+  using scalepiegraph::SequenceStep;
+  using scalepiegraph::Waveform;
+
+  const float kBaseFrequency = 440.0;
+
+  scalepiegraph::OfflineRenderer renderer;
+  scalepiegraph::Scale scale(12);
+
+  std::vector<SequenceStep> steps = {
+      {0, 1, Waveform::kSawtooth, kBaseFrequency},
+      {2, 1, Waveform::kSquare, kBaseFrequency},
+      {4, 1, Waveform::kTriangle, kBaseFrequency}};
+
+  size_t num_frames = renderer.RenderToFile(scale, steps, path);
+  std::cout << "Rendered " << num_frames << " frames to " << path << std::endl;
 }
 
 void showcase_json_library(std::ifstream& json_file) {
@@ -51,7 +69,13 @@ int main(int argc, char* argv[]) {
   }
 
   showcase_json_library(test_json_file);
-  showcase_synthesizer();
+
+  try {
+    showcase_synthesizer();
+  } catch (std::runtime_error&) {
+    // No audio device, e.g. on a headless machine
+    showcase_offline_render("showcase.wav");
+  }
 
   return 0;
 }
@@ -0,0 +1,67 @@
+#include <core/keyboard_mapping.h>
+#include <core/midi_file.h>
+#include <core/offline_renderer.h>
+#include <core/scale_dataset.h>
+#include <core/tuning_export.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+void print_usage(const std::string& program) {
+  std::cerr << "Usage:" << std::endl
+            << "  " << program
+            << " export <dataset.json> <output directory> [mapping.kbm]"
+            << std::endl
+            << "  " << program
+            << " render <dataset.json> <scale name> <song.mid> <out.wav>"
+            << " [mapping.kbm]" << std::endl;
+}
+
+scalepiegraph::KeyboardMapping load_mapping(int argc,
+                                            char* argv[],
+                                            int index) {
+  scalepiegraph::KeyboardMapping mapping;
+
+  if (argc > index) {
+    std::ifstream mapping_file(argv[index]);
+    mapping_file >> mapping;
+  }
+
+  return mapping;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 4) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::string command = argv[1];
+  std::ifstream dataset_file(argv[2]);
+  if (!dataset_file.is_open()) {
+    std::cerr << "Cannot open " << argv[2] << std::endl;
+    return 1;
+  }
+
+  scalepiegraph::ScaleDataset dataset;
+  dataset_file >> dataset;
+
+  if (command == "export") {
+    size_t num_scales = scalepiegraph::TuningExporter::ExportDataset(
+        dataset, argv[3], load_mapping(argc, argv, 4));
+    std::cout << "Exported tunings of " << num_scales << " scales to "
+              << argv[3] << std::endl;
+  } else if (command == "render" && argc >= 6) {
+    scalepiegraph::OfflineRenderer renderer;
+    size_t num_frames = renderer.RenderMidiToFile(
+        scalepiegraph::MidiFile::Load(argv[4]), dataset[argv[3]], argv[5],
+        load_mapping(argc, argv, 6));
+    std::cout << "Rendered " << num_frames << " frames to " << argv[5]
+              << std::endl;
+  } else {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+#include <core/performance_analyzer.h>
+#include <core/scale_dataset.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+  if (argc < 5) {
+    std::cerr << "Usage: " << argv[0]
+              << " <dataset.json> <scale name> <base frequency>"
+              << " <recording.wav>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream dataset_file(argv[1]);
+  if (!dataset_file.is_open()) {
+    std::cerr << "Cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  scalepiegraph::ScaleDataset dataset;
+  dataset_file >> dataset;
+
+  std::cout << scalepiegraph::PerformanceAnalyzer::AnalyzeFile(
+      argv[4], dataset[argv[2]], std::stod(argv[3]));
+
+  return 0;
+}
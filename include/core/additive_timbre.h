@@ -0,0 +1,85 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing the spectrum of an additive voice: a set of partials,
+ * each a frequency ratio to the fundamental with an amplitude, in ascending
+ * order of ratio. Partials are stored inline with a fixed capacity, so a
+ * timbre can be copied to the audio thread without allocating.
+ */
+class AdditiveTimbre {
+ public:
+  /**
+   * Create a timbre with a single partial at the fundamental.
+   */
+  AdditiveTimbre();
+
+  /**
+   * Append a partial above every partial of this timbre.
+   *
+   * @param ratio The frequency of the partial relative to the fundamental
+   * @param amplitude The amplitude of the partial
+   */
+  void AddPartial(double ratio, double amplitude);
+
+  /**
+   * Remove every partial of this timbre.
+   */
+  void Clear();
+
+  /**
+   * Get the frequency ratio of a partial.
+   *
+   * @param partial_idx The index of the partial
+   * @return The frequency of the partial relative to the fundamental
+   */
+  float GetRatio(size_t partial_idx) const;
+
+  /**
+   * Get the amplitude of a partial.
+   *
+   * @param partial_idx The index of the partial
+   * @return The amplitude of the partial
+   */
+  float GetAmplitude(size_t partial_idx) const;
+
+  /**
+   * Get the number of partials in this timbre.
+   *
+   * @return The number of partials
+   */
+  size_t GetNumPartials() const;
+
+  /**
+   * Create a timbre matched to a Scale, after Sethares: each harmonic of a
+   * harmonic spectrum is moved to the nearest pitch of the Scale, repeated
+   * every period, so the partials of one note land on the other notes of the
+   * Scale. Harmonics that land on the same pitch are merged, and the
+   * amplitudes are normalized to the power of a unit sine.
+   *
+   * @param scale The Scale whose pitches the partials follow
+   * @param num_harmonics The number of harmonics to map onto the Scale
+   * @param rolloff The exponent of the amplitude falloff 1 / n^rolloff
+   * @return The timbre matched to the Scale
+   */
+  static AdditiveTimbre FromScale(const Scale& scale,
+                                  size_t num_harmonics = kDefaultNumHarmonics,
+                                  double rolloff = kDefaultRolloff);
+
+  static const size_t kMaxPartials = 256;
+  static const size_t kDefaultNumHarmonics;
+  static const double kDefaultRolloff;
+
+ private:
+  std::array<float, kMaxPartials> ratios_;
+  std::array<float, kMaxPartials> amplitudes_;
+  size_t num_partials_ = 0;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,118 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <string>
+#include <vector>
+#include <core/offline_renderer.h>
+#include <core/scale_dataset.h>
+
+namespace scalepiegraph {
+
+/**
+ * The throughput of one batch rendering pass.
+ */
+struct BatchReport {
+  size_t num_scales = 0;
+  size_t num_frames = 0;
+  size_t num_workers = 0;
+  double seconds = 0;
+
+  /**
+   * Get the number of scales rendered per second of wall-clock time.
+   *
+   * @return The throughput in scales per second
+   */
+  double GetScalesPerSecond() const;
+
+  /**
+   * Get how many times faster than real time the audio was rendered.
+   *
+   * @param sample_rate The sample rate of the rendered audio
+   * @return The ratio of rendered audio duration to wall-clock time
+   */
+  double GetRealTimeFactor(double sample_rate) const;
+};
+
+/**
+ * A class that renders an audition preview of every Scale in a ScaleDataset.
+ * Each preview is the Scale's ascending and descending run, streamed to its own
+ * WAV file. Scales are shared out over a pool of worker threads, each with its
+ * own independent synthesis engine.
+ */
+class BatchRenderer {
+ public:
+  /**
+   * Create a batch renderer.
+   *
+   * @param num_workers The number of worker threads; 0 uses one per core
+   * @param note_duration The duration of each note of a run in seconds
+   * @param sample_rate The sample rate in frames per second
+   */
+  explicit BatchRenderer(size_t num_workers = 0,
+                         double note_duration = kDefaultNoteDuration,
+                         double sample_rate = SynthEngine::kDefaultSampleRate);
+
+  /**
+   * Render a preview of every Scale in a dataset into a directory.
+   *
+   * @param dataset The Scales to render
+   * @param output_dir The existing directory into which to write previews
+   * @return The throughput of the pass
+   */
+  BatchReport Render(const ScaleDataset& dataset,
+                     const std::string& output_dir) const;
+
+  /**
+   * Set the waveform and filter cutoff used for previews.
+   *
+   * @param waveform The waveform of the previews
+   * @param cutoff The filter cutoff of the previews in hertz
+   */
+  void SetTimbre(Waveform waveform, float cutoff);
+
+  /**
+   * Get the number of worker threads used by this renderer.
+   *
+   * @return The number of worker threads
+   */
+  size_t GetNumWorkers() const;
+
+  /**
+   * Create the ascending and descending run of a Scale, from its first note
+   * up to the octave and back down.
+   *
+   * @param scale The Scale to run
+   * @param note_duration The duration of each note in seconds
+   * @param waveform The waveform of each note
+   * @param cutoff The filter cutoff of each note in hertz
+   * @return The steps of the run
+   */
+  static std::vector<SequenceStep> MakeRun(const Scale& scale,
+                                           double note_duration,
+                                           Waveform waveform,
+                                           float cutoff);
+
+  /**
+   * Create the file name of a file exported for a Scale. Characters that are
+   * unsafe in file names are replaced, and the index keeps names unique.
+   *
+   * @param index The index of the Scale in its dataset
+   * @param scale_name The name of the Scale
+   * @param extension The extension of the file, including its dot
+   * @return The file name of the preview
+   */
+  static std::string MakeFileName(size_t index,
+                                  const std::string& scale_name,
+                                  const std::string& extension = ".wav");
+
+  static const double kDefaultNoteDuration;
+
+ private:
+  size_t num_workers_;
+  double note_duration_;
+  double sample_rate_;
+  Waveform waveform_ = Waveform::kTriangle;
+  float cutoff_ = 2000;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,160 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <core/simd.h>
+
+namespace scalepiegraph {
+
+/**
+ * The responses that a filter of a BiquadBank can have.
+ */
+enum class FilterMode {
+  kLowPass,
+  kHighPass,
+  kBandPass
+};
+
+/**
+ * A class representing a bank of independent biquad filters, stored as a
+ * structure of arrays so that groups of four filters run in the lanes of one
+ * SIMD loop. Changing a filter only sets its target coefficients; the current
+ * coefficients glide to the target linearly across the next control block so
+ * that modulated cutoffs do not produce zipper noise. All storage is allocated
+ * at construction; nothing allocates while processing.
+ */
+class BiquadBank {
+ public:
+  /**
+   * Create a bank of low-pass filters. The number of filters is rounded up to
+   * a multiple of the SIMD width.
+   *
+   * @param num_filters The number of filters in this bank
+   * @param sample_rate The sample rate in frames per second
+   * @param cutoff The initial cutoff frequency of every filter in hertz
+   */
+  explicit BiquadBank(size_t num_filters = simd::kLanes,
+                      double sample_rate = 44100,
+                      double cutoff = kDefaultCutoff);
+
+  /**
+   * Retarget a filter. The filter glides to its new response across the
+   * control block started by the next call to Glide.
+   *
+   * @param filter The index of the filter
+   * @param mode The response of the filter
+   * @param cutoff The cutoff or center frequency in hertz, kept below Nyquist
+   * @param resonance The quality factor of the filter
+   */
+  void SetFilter(size_t filter,
+                 FilterMode mode,
+                 double cutoff,
+                 double resonance = kDefaultResonance);
+
+  /**
+   * Retarget the cutoff frequency of a filter, keeping its mode and resonance.
+   *
+   * @param filter The index of the filter
+   * @param cutoff The cutoff or center frequency in hertz, kept below Nyquist
+   */
+  void SetCutoff(size_t filter, double cutoff);
+
+  /**
+   * Clear the state of a filter and jump straight to its target response, as
+   * for a voice that starts from silence.
+   *
+   * @param filter The index of the filter
+   */
+  void Reset(size_t filter);
+
+  /**
+   * Start a control block for a range of filters: each filter's coefficients
+   * will reach its target after the specified number of processed frames.
+   *
+   * @param first The index of the first filter, a multiple of the SIMD width
+   * @param end One past the index of the last filter
+   * @param num_frames The number of frames in the control block
+   */
+  void Glide(size_t first, size_t end, size_t num_frames);
+
+  /**
+   * Filter a group of four signals in place. The samples are interleaved so
+   * that frame f of filter first + lane is at samples[f * kLanes + lane].
+   *
+   * @param first The index of the first filter, a multiple of the SIMD width
+   * @param samples The interleaved samples to filter
+   * @param num_frames The number of frames to filter
+   */
+  void Process(size_t first, float* samples, size_t num_frames);
+
+  /**
+   * Set the sample rate of this bank, recalculating every filter and jumping
+   * to the new coefficients.
+   *
+   * @param sample_rate The sample rate in frames per second
+   */
+  void SetSampleRate(double sample_rate);
+
+  /**
+   * Get the number of filters in this bank.
+   *
+   * @return The number of filters in this bank
+   */
+  size_t GetNumFilters() const;
+
+  /**
+   * Get the target response of a filter.
+   *
+   * @param filter The index of the filter
+   * @return The mode of the filter
+   */
+  FilterMode GetMode(size_t filter) const;
+
+  /**
+   * Get the target cutoff frequency of a filter.
+   *
+   * @param filter The index of the filter
+   * @return The cutoff or center frequency in hertz, after clamping
+   */
+  double GetCutoff(size_t filter) const;
+
+  /**
+   * Get the target resonance of a filter.
+   *
+   * @param filter The index of the filter
+   * @return The quality factor of the filter
+   */
+  double GetResonance(size_t filter) const;
+
+  static const double kDefaultCutoff;
+  static const double kDefaultResonance;
+  static const double kMinCutoff;
+
+ private:
+  /**
+   * Calculate the target coefficients of a filter from its settings.
+   *
+   * @param filter The index of the filter
+   */
+  void CalculateTarget(size_t filter);
+
+  size_t num_filters_;
+  double sample_rate_;
+
+  // Per-filter settings
+  std::vector<FilterMode> mode_;
+  std::vector<double> cutoff_;
+  std::vector<double> resonance_;
+
+  // Current coefficients, their per-frame glide and their targets
+  std::vector<float> b0_, b1_, b2_, a1_, a2_;
+  std::vector<float> b0_step_, b1_step_, b2_step_, a1_step_, a2_step_;
+  std::vector<float> b0_target_, b1_target_, b2_target_, a1_target_,
+                     a2_target_;
+
+  // Transposed direct form II state
+  std::vector<float> z1_, z2_;
+};
+
+} // namespace scalepiegraph
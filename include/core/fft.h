@@ -0,0 +1,54 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * A class that computes discrete Fourier transforms of one power-of-two size
+ * with the iterative radix-2 Cooley-Tukey algorithm. The twiddle factors and
+ * the bit-reversal permutation are computed once at construction, so one Fft
+ * can be shared by any number of threads.
+ */
+class Fft {
+ public:
+  /**
+   * Create an Fft of the specified size.
+   *
+   * @param size The number of points of the transform, a power of two
+   */
+  explicit Fft(size_t size);
+
+  /**
+   * Transform a signal into its spectrum in place.
+   *
+   * @param data GetSize complex samples, replaced by their spectrum
+   */
+  void Transform(std::complex<double>* data) const;
+
+  /**
+   * Get the magnitude spectrum of a real signal under a Hann window.
+   *
+   * @param samples GetSize samples of the signal
+   * @return The magnitudes of the GetSize / 2 + 1 non-negative frequency bins
+   */
+  std::vector<double> GetHannMagnitudes(const float* samples) const;
+
+  /**
+   * Get the number of points of this Fft.
+   *
+   * @return The size of the transform
+   */
+  size_t GetSize() const;
+
+ private:
+  size_t size_;
+  std::vector<std::complex<double>> twiddles_; // e^(-2 pi i k / size)
+  std::vector<size_t> bit_reversed_;
+  std::vector<double> hann_window_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,112 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <vector>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class mapping MIDI keys onto the notes of a Scale, following the Scala
+ * keyboard mapping (.kbm) format. A repeating table assigns a scale degree,
+ * or nothing, to each key counted from a middle key; every repetition of the
+ * table moves up by the formal octave degree of the Scale. One reference key
+ * is tuned to a fixed frequency and every other key is tuned relative to it.
+ */
+class KeyboardMapping {
+ public:
+  /**
+   * Create a linear mapping that assigns consecutive scale degrees to
+   * consecutive keys, with middle C on the first note of the Scale and A above
+   * it tuned to 440 Hz.
+   */
+  KeyboardMapping();
+
+  /**
+   * Create a mapping from a table of scale degrees.
+   *
+   * @param mapping The scale degree of each key in one repetition of the
+   *                table, or kUnmapped; empty for a linear mapping
+   * @param middle_key The key mapped to the first entry of the table
+   * @param reference_key The key tuned to the reference frequency
+   * @param reference_frequency The frequency of the reference key in hertz
+   * @param first_key The lowest key to map
+   * @param last_key The highest key to map
+   * @param octave_degree The degree at which the table repeats; 0 for the
+   *                      number of notes in the Scale
+   */
+  KeyboardMapping(const std::vector<int>& mapping,
+                  int middle_key,
+                  int reference_key,
+                  double reference_frequency,
+                  int first_key = 0,
+                  int last_key = kNumKeys - 1,
+                  int octave_degree = 0);
+
+  /**
+   * Whether a key plays a note.
+   *
+   * @param key The MIDI key number
+   * @return True if the key is mapped to a scale degree
+   */
+  bool IsMapped(uint8_t key) const;
+
+  /**
+   * Get the scale degree played by a key, counted from the first note of the
+   * Scale at the middle key.
+   *
+   * @param key The MIDI key number
+   * @param num_notes The number of notes in the Scale
+   * @return The scale degree of the key
+   */
+  int GetDegree(uint8_t key, size_t num_notes) const;
+
+  /**
+   * Calculate the frequency of a key using a Scale.
+   *
+   * @param scale The Scale by which to tune the key
+   * @param key The MIDI key number
+   * @return The frequency of the key in hertz
+   */
+  double CalculateKeyFrequency(const Scale& scale, uint8_t key) const;
+
+  /**
+   * Load a Scala keyboard mapping into this mapping.
+   *
+   * @param input_stream The stream from which to read the .kbm file
+   * @param mapping The mapping in which to load the parsed file
+   * @return The consumed input stream
+   */
+  friend std::istream& operator>>(
+      std::istream& input_stream, KeyboardMapping& mapping);
+
+  static const int kNumKeys = 128;
+  static const int kUnmapped = -1;
+
+ private:
+  /**
+   * Calculate the ratio of a scale degree to the first note of a Scale.
+   *
+   * @param scale The Scale of the degree
+   * @param degree The scale degree, which may be negative
+   * @return The frequency ratio of the degree
+   */
+  static double CalculateDegreeRatio(const Scale& scale, int degree);
+
+  /**
+   * Check that the fields of this mapping are consistent.
+   */
+  void Validate() const;
+
+  std::vector<int> mapping_;
+  int middle_key_;
+  int reference_key_;
+  double reference_frequency_;
+  int first_key_;
+  int last_key_;
+  int octave_degree_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,110 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace scalepiegraph {
+
+/**
+ * A cache mapping keys to values that holds at most a fixed number of
+ * entries, evicting the least recently used entry to make room for a new one.
+ * Entries are kept in a list from most to least recently used, indexed by a
+ * hash map, so lookups and insertions take constant time. Not thread-safe.
+ */
+template <typename Key, typename Value>
+class LruCache {
+ public:
+  /**
+   * Create an empty cache.
+   *
+   * @param capacity The largest number of entries the cache holds
+   */
+  explicit LruCache(size_t capacity) : capacity_(capacity) {
+    if (capacity == 0) {
+      throw std::out_of_range("Cache must hold at least one entry.");
+    }
+  }
+
+  /**
+   * Look up the value of a key, marking the key as most recently used.
+   *
+   * @param key The key to look up
+   * @param value Set to the value of the key if it is cached
+   * @return True if the key is cached; otherwise, false
+   */
+  bool Get(const Key& key, Value* value) {
+    auto entry = index_.find(key);
+    if (entry == index_.end()) {
+      return false;
+    }
+
+    entries_.splice(entries_.begin(), entries_, entry->second);
+    *value = entry->second->second;
+    return true;
+  }
+
+  /**
+   * Cache the value of a key as the most recently used entry, replacing any
+   * value the key had and evicting the least recently used entry when full.
+   *
+   * @param key The key to cache
+   * @param value The value of the key
+   */
+  void Put(const Key& key, const Value& value) {
+    auto entry = index_.find(key);
+    if (entry != index_.end()) {
+      entry->second->second = value;
+      entries_.splice(entries_.begin(), entries_, entry->second);
+      return;
+    }
+
+    if (entries_.size() == capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+
+    entries_.emplace_front(key, value);
+    index_[key] = entries_.begin();
+  }
+
+  /**
+   * Check whether a key is cached without marking it as used.
+   *
+   * @param key The key to check
+   * @return True if the key is cached; otherwise, false
+   */
+  bool Contains(const Key& key) const {
+    return index_.count(key) > 0;
+  }
+
+  /**
+   * Get the number of entries in the cache.
+   *
+   * @return The number of cached entries
+   */
+  size_t GetSize() const {
+    return entries_.size();
+  }
+
+  /**
+   * Get the largest number of entries the cache holds.
+   *
+   * @return The capacity of the cache
+   */
+  size_t GetCapacity() const {
+    return capacity_;
+  }
+
+ private:
+  typedef std::list<std::pair<Key, Value>> EntryList;
+
+  size_t capacity_;
+  EntryList entries_; // Most recently used first
+  std::unordered_map<Key, typename EntryList::iterator> index_;
+};
+
+} // namespace scalepiegraph
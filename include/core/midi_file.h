@@ -0,0 +1,99 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * A note event read from a MIDI file, timed in seconds from its start.
+ */
+struct MidiNote {
+  double time = 0;
+  bool is_note_on = false; // Note ons with zero velocity are note offs
+  uint8_t channel = 0;
+  uint8_t key = 0;
+  uint8_t velocity = 0;
+};
+
+/**
+ * A class representing a Standard MIDI File of format 0 or 1. Tracks are not
+ * decoded up front; reading notes merges every track in tick order with one
+ * cursor per track and applies tempo changes as they are reached, so the
+ * notes stream out in time order without being buffered.
+ */
+class MidiFile {
+ public:
+  /**
+   * Create a MIDI file from its contents.
+   *
+   * @param bytes The contents of a Standard MIDI File
+   */
+  explicit MidiFile(const std::vector<uint8_t>& bytes);
+
+  /**
+   * Load a MIDI file from disk.
+   *
+   * @param path The path of the file to load
+   * @return The loaded MIDI file
+   */
+  static MidiFile Load(const std::string& path);
+
+  /**
+   * Call a function with every note event of this file in time order.
+   *
+   * @param callback Called with each note event
+   */
+  void ForEachNote(const std::function<void(const MidiNote&)>& callback) const;
+
+  /**
+   * Get every note event of this file in time order.
+   *
+   * @return The note events
+   */
+  std::vector<MidiNote> GetNotes() const;
+
+  /**
+   * Get the format of this file.
+   *
+   * @return 0 for a single track or 1 for simultaneous tracks
+   */
+  uint16_t GetFormat() const;
+
+  /**
+   * Get the number of tracks in this file.
+   *
+   * @return The number of tracks
+   */
+  size_t GetNumTracks() const;
+
+  /**
+   * Get the number of ticks per quarter note.
+   *
+   * @return The tick resolution of this file; 0 if it uses SMPTE time
+   */
+  uint16_t GetTicksPerQuarter() const;
+
+  static const uint32_t kDefaultTempo; // Microseconds per quarter note
+
+ private:
+  /**
+   * The location of one track's events inside the file contents.
+   */
+  struct Track {
+    size_t begin;
+    size_t end;
+  };
+
+  std::vector<uint8_t> bytes_;
+  std::vector<Track> tracks_;
+  uint16_t format_;
+  uint16_t ticks_per_quarter_ = 0;
+  double seconds_per_smpte_tick_ = 0; // Fixed tick length of SMPTE time
+};
+
+} // namespace scalepiegraph
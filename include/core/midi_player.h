@@ -0,0 +1,92 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <core/keyboard_mapping.h>
+#include <core/midi_file.h>
+#include <core/parameter_queue.h>
+#include <core/scale.h>
+#include <core/synth_engine.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class that plays a MidiFile retuned through a Scale. Every note is
+ * converted once into a note event stamped with its frame, tuned by mapping
+ * its key through a KeyboardMapping. Notes on different channels are kept
+ * apart, and keys without a scale degree are skipped. Events are fed to a
+ * SynthEngine a little ahead of the audio clock so the parameter queue never
+ * overflows, however long the file is.
+ */
+class MidiPlayer {
+ public:
+  /**
+   * Create a player for a MIDI file.
+   *
+   * @param midi_file The file to play
+   * @param scale The Scale in which to play the file
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @param sample_rate The sample rate of the engine that plays the file
+   */
+  MidiPlayer(const MidiFile& midi_file,
+             const Scale& scale,
+             const KeyboardMapping& mapping,
+             double sample_rate);
+
+  /**
+   * Get the note events of the file, stamped with frames counted from its
+   * start.
+   *
+   * @return The note events in frame order
+   */
+  const std::vector<ParameterEvent>& GetEvents() const;
+
+  /**
+   * Get the number of frames until the last event of the file.
+   *
+   * @return The length of the file in frames
+   */
+  uint64_t GetNumFrames() const;
+
+  /**
+   * Start playback, rewinding to the first event.
+   *
+   * @param start_frame The engine frame on which the file starts
+   */
+  void Start(uint64_t start_frame);
+
+  /**
+   * Post every event due before a frame that has not been posted yet. Stops
+   * early if the parameter queue is full; the rest are posted by a later
+   * call. Only call from the engine's producer thread.
+   *
+   * @param engine The engine to which to post events
+   * @param end_frame The engine frame before which events are posted
+   * @return The number of events posted
+   */
+  size_t Feed(SynthEngine& engine, uint64_t end_frame);
+
+  /**
+   * Whether every event has been posted.
+   *
+   * @return True if playback has been fed to the end
+   */
+  bool IsFinished() const;
+
+  /**
+   * Get the engine note identifier of a key on a channel.
+   *
+   * @param channel The MIDI channel
+   * @param key The MIDI key number
+   * @return The note identifier
+   */
+  static int GetNoteId(uint8_t channel, uint8_t key);
+
+ private:
+  std::vector<ParameterEvent> events_;
+  uint64_t start_frame_ = 0;
+  size_t next_event_ = 0;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,169 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <string>
+#include <vector>
+#include <core/keyboard_mapping.h>
+#include <core/midi_file.h>
+#include <core/pattern.h>
+#include <core/scale.h>
+#include <core/synth_engine.h>
+#include <core/waveform.h>
+
+namespace scalepiegraph {
+
+/**
+ * One note of a sequence to render offline.
+ */
+struct SequenceStep {
+  size_t note_index;
+  double duration; // Seconds
+  Waveform waveform;
+  float cutoff; // Filter cutoff in hertz
+};
+
+/**
+ * A class that renders note sequences against a Scale without an audio
+ * device. Rendering runs as fast as the processor allows and events are placed
+ * on exact sample frames, so the output for a given sequence is always
+ * identical.
+ */
+class OfflineRenderer {
+ public:
+  /**
+   * Create an offline renderer.
+   *
+   * @param sample_rate The sample rate in frames per second
+   * @param block_size The number of frames rendered per engine block
+   */
+  explicit OfflineRenderer(double sample_rate = SynthEngine::kDefaultSampleRate,
+                           size_t block_size = kDefaultBlockSize);
+
+  /**
+   * Render a sequence of notes into a memory buffer. The buffer includes a
+   * tail after the last note so its release is not cut off.
+   *
+   * @param scale The Scale whose notes are played
+   * @param steps The notes to play, one after another
+   * @param base_freq The frequency of the first note of the Scale
+   * @return The rendered mono samples
+   */
+  std::vector<float> Render(const Scale& scale,
+                            const std::vector<SequenceStep>& steps,
+                            float base_freq = 440.0) const;
+
+  /**
+   * Render a sequence of notes into a 16-bit WAV file, streaming each block
+   * to disk as it is rendered.
+   *
+   * @param scale The Scale whose notes are played
+   * @param steps The notes to play, one after another
+   * @param path The path of the WAV file to write
+   * @param base_freq The frequency of the first note of the Scale
+   * @return The number of frames written
+   */
+  size_t RenderToFile(const Scale& scale,
+                      const std::vector<SequenceStep>& steps,
+                      const std::string& path,
+                      float base_freq = 440.0) const;
+
+  /**
+   * Render a pattern played by the engine's Sequencer into a memory buffer.
+   *
+   * @param pattern The pattern to play from the first frame
+   * @param seconds The length of audio to render in seconds
+   * @return The rendered mono samples
+   */
+  std::vector<float> RenderPattern(const Pattern& pattern,
+                                   double seconds) const;
+
+  /**
+   * Render a MIDI file retuned through a Scale into a memory buffer. The
+   * buffer includes a tail after the last event.
+   *
+   * @param midi_file The file to play
+   * @param scale The Scale in which to play the file
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @return The rendered mono samples
+   */
+  std::vector<float> RenderMidi(
+      const MidiFile& midi_file,
+      const Scale& scale,
+      const KeyboardMapping& mapping = KeyboardMapping()) const;
+
+  /**
+   * Render a MIDI file retuned through a Scale into a 16-bit WAV file.
+   *
+   * @param midi_file The file to play
+   * @param scale The Scale in which to play the file
+   * @param path The path of the WAV file to write
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @return The number of frames written
+   */
+  size_t RenderMidiToFile(
+      const MidiFile& midi_file,
+      const Scale& scale,
+      const std::string& path,
+      const KeyboardMapping& mapping = KeyboardMapping()) const;
+
+  /**
+   * Get the number of frames that rendering the sequence produces.
+   *
+   * @param steps The notes to play
+   * @return The number of rendered frames, including the release tail
+   */
+  size_t GetNumFrames(const std::vector<SequenceStep>& steps) const;
+
+  /**
+   * Get the sample rate of this renderer.
+   *
+   * @return The sample rate in frames per second
+   */
+  double GetSampleRate() const;
+
+  static const size_t kDefaultBlockSize;
+  static const double kTailSeconds;
+
+ private:
+  /**
+   * Lay out the events of a sequence on their frames.
+   *
+   * @param scale The Scale whose notes are played
+   * @param steps The notes to play, one after another
+   * @param base_freq The frequency of the first note of the Scale
+   * @param events Filled with the events of the sequence in frame order
+   * @return The frame at which the last note ends
+   */
+  uint64_t LayOutEvents(const Scale& scale,
+                        const std::vector<SequenceStep>& steps,
+                        float base_freq,
+                        std::vector<ParameterEvent>* events) const;
+
+  /**
+   * Render events through an engine block by block, passing each block to a
+   * sink.
+   *
+   * @param engine The engine to render
+   * @param events The events to post, in frame order
+   * @param total_frames The number of frames to render
+   * @param sink Called with each rendered block and its number of frames
+   */
+  template <typename Sink>
+  void RenderBlocks(SynthEngine& engine,
+                    const std::vector<ParameterEvent>& events,
+                    uint64_t total_frames,
+                    Sink sink) const;
+
+  /**
+   * Convert a duration to a whole number of frames.
+   *
+   * @param seconds The duration in seconds
+   * @return The duration in frames
+   */
+  uint64_t ToFrames(double seconds) const;
+
+  double sample_rate_;
+  size_t block_size_;
+};
+
+} // namespace scalepiegraph
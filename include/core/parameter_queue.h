@@ -0,0 +1,133 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace scalepiegraph {
+
+class StreamedSample;
+class Wavetable;
+
+/**
+ * A parameter change for the synthesis engine, stamped with the sample frame
+ * at which it should take effect. Note events carry the identifier of the
+ * note they start, stop or retune, wavetable and sample events carry the
+ * wavetable or recording to play, pattern events start or stop the Sequencer,
+ * and timbre and morph events take the timbre or ScaleMorph last handed to the
+ * engine.
+ */
+struct ParameterEvent {
+  enum class Type {
+    kStart,
+    kStop,
+    kFrequency,
+    kWaveform,
+    kFilterCutoff,
+    kNoteOn,
+    kNoteOff,
+    kStopAll,
+    kWavetable,
+    kPlayPattern,
+    kStopPattern,
+    kFilterMode,
+    kFilterResonance,
+    kNoteFilterCutoff,
+    kFilterEnvelope,
+    kTimbre,
+    kMorphScale,
+    kSample
+  };
+
+  Type type = Type::kStop;
+  uint64_t frame = 0;
+  double value = 0;
+  int note = 0;
+  const Wavetable* wavetable = nullptr;
+  StreamedSample* sample = nullptr;
+};
+
+/**
+ * A single-producer/single-consumer lock-free queue of ParameterEvents. The
+ * UI thread pushes events and the audio thread drains them. All storage is
+ * allocated at construction so neither side ever allocates or blocks.
+ */
+class ParameterQueue {
+ public:
+  /**
+   * Create a queue that holds at least the specified number of events. The
+   * capacity is rounded up to a power of two.
+   *
+   * @param capacity The minimum number of events this queue can hold
+   */
+  explicit ParameterQueue(size_t capacity = kDefaultCapacity);
+
+  /**
+   * Push an event onto the back of this queue. Only call from the producer.
+   *
+   * @param event The event to push
+   * @return True if the event was queued; false if the queue was full
+   */
+  bool Push(const ParameterEvent& event);
+
+  /**
+   * Get the event at the front of this queue without removing it. Only call
+   * from the consumer.
+   *
+   * @return The front event, or nullptr if the queue is empty
+   */
+  const ParameterEvent* Peek() const;
+
+  /**
+   * Remove the event at the front of this queue. Only call from the consumer
+   * after Peek returned an event.
+   */
+  void Pop();
+
+  /**
+   * Get the number of events currently waiting in this queue.
+   *
+   * @return The current depth of this queue
+   */
+  size_t GetDepth() const;
+
+  /**
+   * Get the largest depth this queue has reached since the last reset.
+   *
+   * @return The high-water mark of this queue
+   */
+  size_t GetMaxDepth() const;
+
+  /**
+   * Get the number of events rejected because this queue was full.
+   *
+   * @return The number of dropped events
+   */
+  size_t GetNumDropped() const;
+
+  /**
+   * Get the number of events this queue can hold.
+   *
+   * @return The capacity of this queue
+   */
+  size_t GetCapacity() const;
+
+  /**
+   * Reset the high-water mark and dropped-event count.
+   */
+  void ResetStatistics();
+
+  static const size_t kDefaultCapacity;
+
+ private:
+  std::vector<ParameterEvent> events_;
+  size_t mask_;
+  std::atomic<size_t> head_; // Next index to read; owned by the consumer
+  std::atomic<size_t> tail_; // Next index to write; owned by the producer
+  std::atomic<size_t> max_depth_;
+  std::atomic<size_t> num_dropped_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,134 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * One step of a Pattern.
+ */
+struct PatternStep {
+  double frequency = 0; // Hertz; zero for a rest
+  double duration = 0; // Seconds until the next step starts
+  double gate = 0; // Fraction of the duration for which the note sounds
+};
+
+enum class ArpeggioMode { kUp, kDown, kUpDown };
+
+/**
+ * A class representing a sequence of notes for the Sequencer to play. Steps
+ * are stored inline with a fixed capacity, so a Pattern can be copied to the
+ * audio thread without allocating.
+ */
+class Pattern {
+ public:
+  Pattern();
+
+  /**
+   * Append a note to this pattern.
+   *
+   * @param frequency The frequency of the note in hertz
+   * @param duration The number of seconds until the next step
+   * @param gate The fraction of the duration for which the note sounds
+   */
+  void AddNote(double frequency, double duration, double gate = kDefaultGate);
+
+  /**
+   * Append a silent step to this pattern.
+   *
+   * @param duration The number of seconds until the next step
+   */
+  void AddRest(double duration);
+
+  /**
+   * Get a step of this pattern.
+   *
+   * @param step_idx The index of the step
+   * @return The step at the index
+   */
+  const PatternStep& GetStep(size_t step_idx) const;
+
+  /**
+   * Get the number of steps in this pattern.
+   *
+   * @return The number of steps
+   */
+  size_t GetNumSteps() const;
+
+  /**
+   * Get the time this pattern takes to play once.
+   *
+   * @return The sum of the step durations in seconds
+   */
+  double GetDuration() const;
+
+  /**
+   * Set whether this pattern starts over after its last step.
+   *
+   * @param is_looping True to loop this pattern
+   */
+  void SetLooping(bool is_looping);
+
+  /**
+   * Whether this pattern starts over after its last step.
+   *
+   * @return True if this pattern loops
+   */
+  bool IsLooping() const;
+
+  /**
+   * Create a pattern that runs up every note of a Scale and back down. If
+   * the run would not fit in kMaxSteps, it skips evenly spaced notes but
+   * still starts and turns around on the first and last notes.
+   *
+   * @param scale The Scale to run through
+   * @param step_duration The duration of each note in seconds
+   * @param base_freq The frequency of the first note of the Scale
+   * @return The scale run
+   */
+  static Pattern ScaleRun(const Scale& scale,
+                          double step_duration,
+                          float base_freq = 440.0);
+
+  /**
+   * Create a pattern that arpeggiates a chord built from notes of a Scale.
+   * Each repetition of the chord is transposed by the period of the Scale.
+   * If the arpeggio would not fit in kMaxSteps, it skips evenly spaced notes
+   * but keeps the lowest and highest.
+   *
+   * @param scale The Scale from which the chord is built
+   * @param chord The note indices of the chord, from lowest to highest
+   * @param mode The order in which the chord notes are played
+   * @param num_octaves The number of periods of the Scale to span
+   * @param step_duration The duration of each note in seconds
+   * @param base_freq The frequency of the first note of the Scale
+   * @return The arpeggio, set to loop
+   */
+  static Pattern Arpeggio(const Scale& scale,
+                          const std::vector<size_t>& chord,
+                          ArpeggioMode mode,
+                          size_t num_octaves,
+                          double step_duration,
+                          float base_freq = 440.0);
+
+  static const size_t kMaxSteps = 256;
+  static const double kDefaultGate;
+
+ private:
+  /**
+   * Append a step, checking that it is valid and that there is room for it.
+   *
+   * @param step The step to append
+   */
+  void AddStep(const PatternStep& step);
+
+  std::array<PatternStep, kMaxSteps> steps_;
+  size_t num_steps_ = 0;
+  bool is_looping_ = false;
+};
+
+} // namespace scalepiegraph
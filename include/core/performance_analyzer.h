@@ -0,0 +1,130 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json.h>
+#include <core/pitch_detector.h>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * How far the pitches sung or played nearest to one note of a Scale strayed
+ * from it, in cents.
+ */
+struct NoteDeviation {
+  size_t num_windows = 0; // Analysis windows whose pitch was nearest the note
+  double mean_cents = 0; // Signed; positive is sharp
+  double rms_cents = 0;
+  double max_cents = 0; // Largest distance either way
+};
+
+/**
+ * The result of comparing a performance with a Scale.
+ */
+struct PerformanceReport {
+  std::string scale_name;
+  double base_frequency = 0;
+  double seconds = 0; // Length of the audio analyzed
+  size_t num_windows = 0;
+  size_t num_pitched_windows = 0;
+  double mean_abs_cents = 0; // Over every pitched window
+  std::vector<NoteDeviation> notes; // One per note of the Scale
+
+  /**
+   * Convert this report to JSON.
+   *
+   * @return The JSON representation of this report
+   */
+  Json::Value ToJson() const;
+
+  /**
+   * Write this report as a JSON document.
+   *
+   * @param output_stream The stream to which to write
+   * @param report The report to write
+   * @return The output stream
+   */
+  friend std::ostream& operator<<(std::ostream& output_stream,
+                                  const PerformanceReport& report);
+};
+
+/**
+ * A class that scores a monophonic performance against a Scale. Audio is fed
+ * in blocks of any size; every hop, the pitch of the latest window is
+ * detected, matched to the nearest note of the Scale in any octave, and its
+ * deviation from that note is accumulated.
+ */
+class PerformanceAnalyzer {
+ public:
+  /**
+   * Create an analyzer for performances in a Scale.
+   *
+   * @param scale The Scale the performer was meant to follow
+   * @param base_frequency The frequency of the first note of the Scale
+   * @param sample_rate The sample rate of the audio in frames per second
+   * @param hop_frames The number of frames between analysis windows
+   */
+  PerformanceAnalyzer(const Scale& scale,
+                      double base_frequency,
+                      double sample_rate,
+                      size_t hop_frames = kDefaultHopFrames);
+
+  /**
+   * Analyze the next block of the performance.
+   *
+   * @param samples The mono samples of the block
+   * @param num_frames The number of frames in the block
+   */
+  void Process(const float* samples, size_t num_frames);
+
+  /**
+   * Summarize the performance so far.
+   *
+   * @return The deviations of the performance from the Scale
+   */
+  PerformanceReport GetReport() const;
+
+  /**
+   * Score a recording against a Scale, streaming it from disk in blocks.
+   *
+   * @param path The path of a WAV file
+   * @param scale The Scale the performer was meant to follow
+   * @param base_frequency The frequency of the first note of the Scale
+   * @return The deviations of the recording from the Scale
+   */
+  static PerformanceReport AnalyzeFile(const std::string& path,
+                                       const Scale& scale,
+                                       double base_frequency);
+
+  static const size_t kDefaultHopFrames;
+  static const size_t kFileBlockFrames; // Frames read from disk at a time
+
+ private:
+  /**
+   * Detect the pitch of the buffered window and accumulate its deviation.
+   */
+  void AnalyzeWindow();
+
+  Scale scale_;
+  double base_frequency_;
+  double sample_rate_;
+  size_t hop_frames_;
+  PitchDetector detector_;
+  std::vector<float> window_;
+  size_t num_buffered_ = 0;
+  size_t num_frames_ = 0;
+  size_t num_windows_ = 0;
+  double total_abs_cents_ = 0;
+
+  // Per-note sums of the deviations, their squares and absolute maxima
+  std::vector<size_t> note_windows_;
+  std::vector<double> note_sums_;
+  std::vector<double> note_squares_;
+  std::vector<double> note_maxima_;
+};
+
+} // namespace scalepiegraph
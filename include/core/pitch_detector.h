@@ -0,0 +1,69 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * The pitch found in one window of audio.
+ */
+struct PitchEstimate {
+  double frequency = 0; // In hertz; 0 when the window has no clear pitch
+  double aperiodicity = 1; // Normalized difference at the period, 0 to ~1
+};
+
+/**
+ * A class that detects the fundamental frequency of monophonic audio with the
+ * YIN algorithm of de Cheveigné and Kawahara. The difference function, which
+ * dominates the cost, is computed four frames at a time with SIMD, and all
+ * storage is allocated at construction.
+ */
+class PitchDetector {
+ public:
+  /**
+   * Create a PitchDetector for a range of frequencies.
+   *
+   * @param sample_rate The sample rate in frames per second
+   * @param min_frequency The lowest frequency to detect in hertz
+   * @param max_frequency The highest frequency to detect in hertz
+   * @param window_frames The number of frames compared at each lag, rounded
+   * up to a multiple of the SIMD width
+   */
+  explicit PitchDetector(double sample_rate,
+                         double min_frequency = kDefaultMinFrequency,
+                         double max_frequency = kDefaultMaxFrequency,
+                         size_t window_frames = kDefaultWindowFrames);
+
+  /**
+   * Detect the pitch of a window of audio.
+   *
+   * @param input GetInputFrames frames of audio
+   * @return The pitch of the window
+   */
+  PitchEstimate Detect(const float* input);
+
+  /**
+   * Get the number of frames that Detect reads: the window followed by the
+   * longest period detected.
+   *
+   * @return The number of input frames
+   */
+  size_t GetInputFrames() const;
+
+  static const double kDefaultMinFrequency;
+  static const double kDefaultMaxFrequency;
+  static const size_t kDefaultWindowFrames;
+  static const double kThreshold; // Largest aperiodicity of a pitched window
+  static const double kSilence; // RMS level below which there is no pitch
+
+ private:
+  double sample_rate_;
+  size_t window_frames_;
+  size_t min_lag_;
+  size_t max_lag_;
+  std::vector<float> difference_; // Normalized in place, indexed by lag
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,102 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * Tools for keeping the audio render path real-time-safe. Code that runs on
+ * the audio thread marks itself with an AudioThreadScope. When the project is
+ * built with SCALEPIEGRAPH_RT_CHECK, allocations, frees, mutex locks and
+ * exception throws made inside a scope are intercepted and recorded with a
+ * stack trace, so tests can fail on them. Without the flag only violations
+ * reported explicitly are recorded.
+ */
+namespace realtime {
+
+enum class ViolationType { kAllocation, kDeallocation, kMutexLock, kThrow };
+
+/**
+ * A single operation that is unsafe on the audio thread.
+ */
+struct Violation {
+  static const size_t kMaxStackDepth = 32;
+
+  ViolationType type;
+  size_t stack_depth;
+  void* stack[kMaxStackDepth];
+};
+
+/**
+ * Marks the calling thread as rendering audio for the lifetime of this
+ * object. Scopes may be nested.
+ */
+class AudioThreadScope {
+ public:
+  AudioThreadScope();
+
+  ~AudioThreadScope();
+
+  AudioThreadScope(const AudioThreadScope&) = delete;
+
+  AudioThreadScope& operator=(const AudioThreadScope&) = delete;
+};
+
+/**
+ * Whether allocations, locks and throws are intercepted in this build.
+ *
+ * @return True if the build defines SCALEPIEGRAPH_RT_CHECK
+ */
+bool IsEnabled();
+
+/**
+ * Whether the calling thread is inside an AudioThreadScope.
+ *
+ * @return True if the calling thread is rendering audio
+ */
+bool IsAudioThread();
+
+/**
+ * Record a violation with the current stack trace if the calling thread is
+ * rendering audio. Recording itself neither allocates nor locks.
+ *
+ * @param type The type of the violation
+ */
+void ReportViolation(ViolationType type);
+
+/**
+ * Get the number of violations reported since the last clear, including any
+ * beyond the recorded capacity.
+ *
+ * @return The number of violations
+ */
+size_t GetNumViolations();
+
+/**
+ * Get the recorded violations. Allocates, so call off the audio thread.
+ *
+ * @return Up to the first kMaxViolations violations since the last clear
+ */
+std::vector<Violation> GetViolations();
+
+/**
+ * Describe the recorded violations with symbolized stack traces. Allocates,
+ * so call off the audio thread.
+ *
+ * @return A human readable report of the violations
+ */
+std::string DescribeViolations();
+
+/**
+ * Forget every recorded violation. Do not call while audio is rendering.
+ */
+void ClearViolations();
+
+const size_t kMaxViolations = 64;
+
+} // namespace realtime
+
+} // namespace scalepiegraph
@@ -0,0 +1,126 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/wav_writer.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class that records audio from the audio thread to a WAV file. The audio
+ * thread copies each block into a single-producer/single-consumer lock-free
+ * ring, and a writer thread streams the ring to disk, so recording never
+ * blocks the audio thread on I/O however long it runs. Blocks that do not fit
+ * in the ring are dropped and counted as overruns.
+ */
+class Recorder {
+ public:
+  /**
+   * Create a stopped Recorder. The ring holds at least the specified number
+   * of frames, rounded up to a power of two.
+   *
+   * @param sample_rate The sample rate in frames per second
+   * @param num_channels The number of interleaved channels
+   * @param ring_frames The number of frames buffered between the threads
+   */
+  explicit Recorder(double sample_rate,
+                    size_t num_channels = 1,
+                    size_t ring_frames = kDefaultRingFrames);
+
+  /**
+   * Stop recording, finishing the file.
+   */
+  ~Recorder();
+
+  Recorder(const Recorder&) = delete;
+
+  Recorder& operator=(const Recorder&) = delete;
+
+  /**
+   * Start recording to a new file, finishing any file already recording.
+   *
+   * @param path The path of the WAV file to write
+   */
+  void Start(const std::string& path);
+
+  /**
+   * Stop recording, writing every frame already pushed and closing the file.
+   * Does nothing if this Recorder is not recording.
+   */
+  void Stop();
+
+  /**
+   * Push a block of interleaved samples to be recorded. Call only from the
+   * audio thread; never blocks, allocates or throws. Does nothing if this
+   * Recorder is not recording.
+   *
+   * @param samples The interleaved samples to record
+   * @param num_frames The number of frames in the block
+   */
+  void Push(const float* samples, size_t num_frames);
+
+  /**
+   * Whether this Recorder is recording.
+   *
+   * @return True between Start and Stop
+   */
+  bool IsRecording() const;
+
+  /**
+   * Get the number of frames written to the current or last file.
+   *
+   * @return The number of frames written to disk
+   */
+  size_t GetNumFrames() const;
+
+  /**
+   * Get the number of blocks dropped because the ring was full, since the
+   * recording started.
+   *
+   * @return The number of overruns
+   */
+  size_t GetNumOverruns() const;
+
+  /**
+   * Get the number of frames dropped because the ring was full, since the
+   * recording started.
+   *
+   * @return The number of dropped frames
+   */
+  size_t GetNumDroppedFrames() const;
+
+  static const size_t kDefaultRingFrames = 131072; // About three seconds
+
+ private:
+  /**
+   * Write the ring to disk until recording stops, then write what remains.
+   */
+  void RunWriter();
+
+  /**
+   * Write every frame waiting in the ring to disk.
+   *
+   * @return True if any frames were written
+   */
+  bool Drain();
+
+  double sample_rate_;
+  size_t num_channels_;
+  size_t ring_frames_;
+  std::vector<float> ring_; // ring_frames_ interleaved frames
+  std::atomic<size_t> write_count_; // Frames pushed; owned by the audio thread
+  std::atomic<size_t> read_count_; // Frames written; owned by the writer
+  std::atomic<size_t> num_frames_;
+  std::atomic<size_t> num_overruns_;
+  std::atomic<size_t> num_dropped_frames_;
+  std::atomic<bool> is_recording_;
+  std::unique_ptr<WavWriter> writer_; // Owned by the writer thread
+  std::thread writer_thread_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,34 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <memory>
+#include <cinder/audio/Node.h>
+#include <core/recorder.h>
+
+namespace scalepiegraph {
+
+/**
+ * A Cinder audio node that passes its input through unchanged while pushing
+ * it to a Recorder, so whatever reaches the output can be recorded.
+ */
+class RecorderNode : public ci::audio::Node {
+ public:
+  /**
+   * Create a RecorderNode feeding the specified recorder.
+   *
+   * @param recorder The mono recorder to feed
+   * @param format The Cinder node format
+   */
+  explicit RecorderNode(const std::shared_ptr<Recorder>& recorder,
+                        const Format& format = Format());
+
+ protected:
+  void process(ci::audio::Buffer* buffer) override;
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+};
+
+typedef std::shared_ptr<RecorderNode> RecorderNodeRef;
+
+} // namespace scalepiegraph
@@ -0,0 +1,125 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <jsoncpp/json.h>
+
+namespace scalepiegraph {
+
+/**
+ * A snapshot of the timing of the audio render callback.
+ */
+struct RenderStats {
+  uint64_t num_blocks = 0;
+  uint64_t num_dropouts = 0; // Blocks that took longer than their duration
+  uint64_t num_late_callbacks = 0; // Callbacks over a block later than due
+  double last_render_micros = 0;
+  double mean_render_micros = 0;
+  double max_render_micros = 0;
+  double max_load = 0; // Largest render time as a fraction of block duration
+  size_t min_block_frames = 0;
+  size_t max_block_frames = 0;
+  double mean_jitter_micros = 0; // Deviation of callback intervals
+  double max_jitter_micros = 0;
+  // Bin 0 counts renders under 1 us; bin i counts [2^(i-1), 2^i) us; the last
+  // bin also counts everything slower
+  std::vector<uint64_t> render_histogram;
+
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+  size_t num_dropped_events = 0;
+  size_t num_late_events = 0;
+
+  /**
+   * Convert these stats to JSON for regression tracking.
+   *
+   * @return The JSON representation of these stats
+   */
+  Json::Value ToJson() const;
+
+  /**
+   * Write these stats as a JSON document.
+   *
+   * @param output_stream The stream to which to write
+   * @param stats The stats to write
+   * @return The output stream
+   */
+  friend std::ostream& operator<<(std::ostream& output_stream,
+                                  const RenderStats& stats);
+};
+
+/**
+ * A class that times every call of the audio render callback. The audio
+ * thread is the only writer and every counter is a relaxed atomic, so
+ * recording never allocates, locks or waits; any thread may read a snapshot.
+ */
+class RenderProfiler {
+ public:
+  RenderProfiler();
+
+  /**
+   * Record the start of a render block. Only call from the audio thread.
+   *
+   * @param now_nanos The current steady clock time in nanoseconds
+   * @param num_frames The number of frames in the block
+   * @param sample_rate The sample rate in frames per second
+   */
+  void BeginBlock(int64_t now_nanos, size_t num_frames, double sample_rate);
+
+  /**
+   * Record the end of the block started by the last BeginBlock. Only call
+   * from the audio thread.
+   *
+   * @param now_nanos The current steady clock time in nanoseconds
+   */
+  void EndBlock(int64_t now_nanos);
+
+  /**
+   * Get a snapshot of the recorded timing.
+   *
+   * @return The recorded timing; queue fields are left empty
+   */
+  RenderStats GetStats() const;
+
+  /**
+   * Ask the audio thread to clear every statistic at its next block.
+   */
+  void Reset();
+
+  static const size_t kNumHistogramBins = 16;
+
+ private:
+  /**
+   * Clear every statistic. Only call from the audio thread.
+   */
+  void Clear();
+
+  std::atomic<bool> reset_requested_;
+
+  // Owned by the audio thread
+  int64_t block_start_nanos_ = 0;
+  int64_t block_deadline_nanos_ = 0;
+  int64_t previous_start_nanos_ = 0;
+  int64_t previous_duration_nanos_ = 0;
+
+  std::atomic<uint64_t> num_blocks_;
+  std::atomic<uint64_t> num_dropouts_;
+  std::atomic<uint64_t> num_late_callbacks_;
+  std::atomic<int64_t> last_render_nanos_;
+  std::atomic<int64_t> max_render_nanos_;
+  std::atomic<uint64_t> total_render_nanos_;
+  std::atomic<double> max_load_;
+  std::atomic<size_t> min_block_frames_;
+  std::atomic<size_t> max_block_frames_;
+  std::atomic<uint64_t> num_intervals_;
+  std::atomic<uint64_t> total_jitter_nanos_;
+  std::atomic<int64_t> max_jitter_nanos_;
+  std::array<std::atomic<uint64_t>, kNumHistogramBins> histogram_;
+};
+
+} // namespace scalepiegraph
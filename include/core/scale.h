@@ -7,6 +7,15 @@
 
 namespace scalepiegraph {
 
+/**
+ * The note of a Scale nearest to a pitch, and how far the pitch lies from it.
+ */
+struct NearestNote {
+  size_t note_index = 0; // Within one period of the Scale
+  int period = 0; // Periods above the first note; negative below it
+  double deviation = 0; // Cents from the note to the pitch
+};
+
 /**
  * A class representing a musical one-octave scale. Scales are stored as
  * arrays of cumulative interval sizes in cents. Furthermore, intervals
@@ -81,6 +90,24 @@ class Scale {
    */
   double CalculateNoteFrequency(size_t note_index, float base_freq=440.0) const;
 
+  /**
+   * Get the pitch of the specified note above the first note of this Scale.
+   *
+   * @param note_index The zero-based index of the note in this Scale
+   * @return The cumulative cents of the note; 0 for the first note
+   */
+  float GetNoteCents(size_t note_index) const;
+
+  /**
+   * Find the note of this Scale nearest to a pitch by binary search over the
+   * cumulative cents, repeating this Scale every period of GetNumOctaves
+   * octaves above and below the first note.
+   *
+   * @param cents The pitch in cents above the first note of this Scale
+   * @return The nearest note, its period and the deviation of the pitch
+   */
+  NearestNote FindNearestNote(double cents) const;
+
   /**
    * Get the specified pairwise interval of this scale.
    *
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <cmath>
+#include <functional>
 #include <jsoncpp/json.h>
 #include <core/scale.h>
 
@@ -50,6 +51,25 @@ class ScaleDataset {
    */
   friend std::istream& operator>>(
       std::istream& input_stream, ScaleDataset& dataset);
+
+  /**
+   * Called with the index in GetNames and the Scale of each visited Scale.
+   */
+  typedef std::function<void(size_t, const Scale&)> ScaleVisitor;
+
+  /**
+   * Visit every Scale of this dataset on a pool of worker threads. Scales are
+   * handed out one at a time and the calling thread is one of the workers.
+   * Each worker makes its own visitor, so visitors can keep state without
+   * sharing it. If a visit throws, the other Scales are still visited and the
+   * first exception is rethrown once every worker is done.
+   *
+   * @param num_workers The maximum number of worker threads
+   * @param make_visitor Makes the visitor of one worker
+   * @return The number of worker threads used, at least one
+   */
+  size_t ForEachScale(size_t num_workers,
+                      const std::function<ScaleVisitor()>& make_visitor) const;
  private:
   /**
    * Parse a scale's intervals represented in json to a Scale.
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class that infers a Scale from noisy pitch observations, such as the
+ * pitches tracked in field recordings or measurements in a CSV file. Every
+ * observation is folded into one octave above a reference frequency and
+ * added to a fixed histogram of cents, so any number of observations can be
+ * streamed in without being kept. Inference smooths the histogram with a
+ * Gaussian kernel density estimate around the octave and picks its peaks as
+ * the notes of the Scale.
+ */
+class ScaleInference {
+ public:
+  /**
+   * Create an empty inference around a reference frequency. The note nearest
+   * the reference becomes the first note of the inferred Scale.
+   *
+   * @param reference_frequency The approximate tonic in hertz
+   */
+  explicit ScaleInference(double reference_frequency);
+
+  /**
+   * Add an observed pitch.
+   *
+   * @param frequency The observed frequency in hertz
+   * @param weight How much the observation counts, e.g. its duration
+   */
+  void AddFrequency(double frequency, double weight = 1);
+
+  /**
+   * Add every positive number in a CSV stream as an observed frequency.
+   * Cells that are not numbers, such as headers, are skipped.
+   *
+   * @param input_stream The stream of comma-separated frequencies
+   * @return The number of frequencies added
+   */
+  size_t AddCsv(std::istream& input_stream);
+
+  /**
+   * Add the pitches tracked in a monophonic recording, streaming it from
+   * disk. Unpitched windows are skipped.
+   *
+   * @param path The path of a WAV file
+   * @return The number of pitches added
+   */
+  size_t AddRecording(const std::string& path);
+
+  /**
+   * Get the number of observations added so far.
+   *
+   * @return The number of observations
+   */
+  size_t GetNumObservations() const;
+
+  /**
+   * Infer the frequencies of the notes in one octave.
+   *
+   * @param bandwidth The standard deviation of the kernel in cents
+   * @param min_height The lowest peak kept, relative to the highest
+   * @return The ascending frequencies, starting at the note nearest the
+   * reference frequency
+   */
+  std::vector<double> InferFrequencies(
+      double bandwidth = kDefaultBandwidth,
+      double min_height = kDefaultMinHeight) const;
+
+  /**
+   * Infer a one-octave Scale whose first note is the note nearest the
+   * reference frequency.
+   *
+   * @param name The name of the Scale
+   * @param bandwidth The standard deviation of the kernel in cents
+   * @param min_height The lowest peak kept, relative to the highest
+   * @return The inferred Scale
+   */
+  Scale Infer(const std::string& name,
+              double bandwidth = kDefaultBandwidth,
+              double min_height = kDefaultMinHeight) const;
+
+  static const size_t kNumBins = 1200; // One per cent
+  static const double kDefaultBandwidth;
+  static const double kDefaultMinHeight;
+
+ private:
+  /**
+   * Smooth the histogram with a Gaussian kernel that wraps around the octave.
+   *
+   * @param bandwidth The standard deviation of the kernel in cents
+   * @return The density of each bin
+   */
+  std::vector<double> EstimateDensity(double bandwidth) const;
+
+  double reference_frequency_;
+  std::vector<double> histogram_;
+  size_t num_observations_ = 0;
+};
+
+} // namespace scalepiegraph
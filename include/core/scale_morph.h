@@ -0,0 +1,90 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <core/scale.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing a glide of every note from one Scale to another. The
+ * frequency of each note in both Scales is tabulated up front, outside the
+ * audio thread, so that voices only have to find their note in the outgoing
+ * table and interpolate toward the incoming one. Tables are stored inline with
+ * a fixed capacity, so a morph can be copied to the audio thread without
+ * allocating.
+ */
+class ScaleMorph {
+ public:
+  /**
+   * Create a morph with no notes, which leaves every voice where it is.
+   */
+  ScaleMorph() = default;
+
+  /**
+   * Create a morph between two Scales played from the same base frequency.
+   * Notes are tabulated from the base frequency up to kMaxFrequency or
+   * kMaxNotes, whichever comes first.
+   *
+   * @param from The outgoing Scale
+   * @param to The incoming Scale
+   * @param base_freq The frequency of the first note of both Scales
+   * @param duration The length of the morph in seconds
+   */
+  ScaleMorph(const Scale& from,
+             const Scale& to,
+             double base_freq,
+             double duration);
+
+  /**
+   * Find the note of the outgoing Scale that is playing at a frequency.
+   *
+   * @param frequency The frequency of a sounding note
+   * @return The index of the note within kTolerance cents of the frequency;
+   * -1 if there is none
+   */
+  int FindNote(double frequency) const;
+
+  /**
+   * Get the frequency of a note in the outgoing Scale.
+   *
+   * @param note_idx The index of the note
+   * @return The frequency from which the note morphs
+   */
+  double GetFromFrequency(size_t note_idx) const;
+
+  /**
+   * Get the frequency of a note in the incoming Scale.
+   *
+   * @param note_idx The index of the note
+   * @return The frequency to which the note morphs
+   */
+  double GetToFrequency(size_t note_idx) const;
+
+  /**
+   * Get the number of notes tabulated in this morph.
+   *
+   * @return The number of notes
+   */
+  size_t GetNumNotes() const;
+
+  /**
+   * Get the length of this morph.
+   *
+   * @return The length of the morph in seconds
+   */
+  double GetDuration() const;
+
+  static const size_t kMaxNotes = 512;
+  static const double kMaxFrequency;
+  static const double kTolerance;
+
+ private:
+  std::array<double, kMaxNotes> from_frequencies_;
+  std::array<double, kMaxNotes> to_frequencies_;
+  size_t num_notes_ = 0;
+  double duration_ = 0;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,106 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <core/parameter_queue.h>
+#include <core/pattern.h>
+#include <core/triple_buffer.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class that plays Patterns against the audio sample clock. The producer
+ * thread hands over patterns through a lock-free TripleBuffer, and the audio
+ * thread pulls note events from the sequencer as it renders, so every note
+ * starts and stops on its exact frame regardless of the block size or of UI
+ * timing. Step positions are accumulated in fractional frames, so long
+ * patterns do not drift from the tempo.
+ */
+class Sequencer {
+ public:
+  /**
+   * Create a stopped sequencer with an empty pattern.
+   *
+   * @param sample_rate The sample rate in frames per second
+   */
+  explicit Sequencer(double sample_rate);
+
+  /**
+   * Hand a pattern to the audio thread. A playing sequencer switches to it at
+   * its next step. Only call from the producer thread.
+   *
+   * @param pattern The pattern to play
+   */
+  void SetPattern(const Pattern& pattern);
+
+  /**
+   * Start playing the latest pattern from its first step. Only call from the
+   * audio thread.
+   *
+   * @param frame The frame at which the first step starts
+   */
+  void Start(uint64_t frame);
+
+  /**
+   * Stop playing, releasing any sounding note. Only call from the audio
+   * thread.
+   *
+   * @param frame The frame at which the sounding note is released
+   */
+  void Stop(uint64_t frame);
+
+  /**
+   * Whether this sequencer is playing a pattern. Only call from the audio
+   * thread.
+   *
+   * @return True if the sequencer is playing
+   */
+  bool IsPlaying() const;
+
+  /**
+   * Get the frame of the next event this sequencer will produce. Only call
+   * from the audio thread.
+   *
+   * @return The frame of the next event; kNever if none is scheduled
+   */
+  uint64_t GetNextEventFrame() const;
+
+  /**
+   * Advance past the next scheduled event. Only call from the audio thread.
+   *
+   * @param event Set to the note event to apply, if there is one
+   * @return True if the event was set; false if a silent step was passed
+   */
+  bool PopEvent(ParameterEvent* event);
+
+  /**
+   * Set the sample rate at which steps are converted to frames.
+   *
+   * @param sample_rate The sample rate in frames per second
+   */
+  void SetSampleRate(double sample_rate);
+
+  static const uint64_t kNever;
+  static const int kSequencerNote;
+
+ private:
+  /**
+   * Convert a fractional frame position to the frame on which an event lands.
+   *
+   * @param position The position in frames
+   * @return The nearest whole frame
+   */
+  static uint64_t ToFrame(double position);
+
+  TripleBuffer<Pattern> patterns_;
+  double sample_rate_;
+
+  // Owned by the audio thread
+  bool is_playing_ = false;
+  bool is_note_on_ = false;
+  size_t step_idx_ = 0;
+  double step_position_ = 0; // Fractional frame at which the next step starts
+  uint64_t note_off_frame_ = 0;
+};
+
+} // namespace scalepiegraph
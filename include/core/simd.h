@@ -0,0 +1,171 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCALEPIEGRAPH_SIMD_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SCALEPIEGRAPH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace scalepiegraph {
+
+namespace simd {
+
+/**
+ * Four packed single-precision lanes. Maps onto SSE2 or NEON registers where
+ * available and falls back to plain arrays elsewhere, so DSP loops can be
+ * written once against this type.
+ */
+struct Float4 {
+#if defined(SCALEPIEGRAPH_SIMD_SSE)
+  __m128 value;
+#elif defined(SCALEPIEGRAPH_SIMD_NEON)
+  float32x4_t value;
+#else
+  float value[4];
+#endif
+};
+
+const size_t kLanes = 4;
+
+#if defined(SCALEPIEGRAPH_SIMD_SSE)
+
+inline Float4 Splat(float scalar) { return {_mm_set1_ps(scalar)}; }
+inline Float4 Load(const float* data) { return {_mm_loadu_ps(data)}; }
+inline void Store(float* data, Float4 a) { _mm_storeu_ps(data, a.value); }
+inline Float4 operator+(Float4 a, Float4 b) {
+  return {_mm_add_ps(a.value, b.value)};
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return {_mm_sub_ps(a.value, b.value)};
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return {_mm_mul_ps(a.value, b.value)};
+}
+inline Float4 Min(Float4 a, Float4 b) { return {_mm_min_ps(a.value, b.value)}; }
+inline Float4 Max(Float4 a, Float4 b) { return {_mm_max_ps(a.value, b.value)}; }
+inline Float4 Abs(Float4 a) {
+  return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.value)};
+}
+inline Float4 Truncate(Float4 a) {
+  return {_mm_cvtepi32_ps(_mm_cvttps_epi32(a.value))};
+}
+inline Float4 Step(Float4 edge, Float4 a) {
+  return {_mm_and_ps(_mm_cmpge_ps(a.value, edge.value), _mm_set1_ps(1.0f))};
+}
+inline float HorizontalSum(Float4 a) {
+  __m128 shuffled = _mm_shuffle_ps(a.value, a.value, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(a.value, shuffled);
+  shuffled = _mm_movehl_ps(shuffled, sums);
+  return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+
+#elif defined(SCALEPIEGRAPH_SIMD_NEON)
+
+inline Float4 Splat(float scalar) { return {vdupq_n_f32(scalar)}; }
+inline Float4 Load(const float* data) { return {vld1q_f32(data)}; }
+inline void Store(float* data, Float4 a) { vst1q_f32(data, a.value); }
+inline Float4 operator+(Float4 a, Float4 b) {
+  return {vaddq_f32(a.value, b.value)};
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return {vsubq_f32(a.value, b.value)};
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return {vmulq_f32(a.value, b.value)};
+}
+inline Float4 Min(Float4 a, Float4 b) { return {vminq_f32(a.value, b.value)}; }
+inline Float4 Max(Float4 a, Float4 b) { return {vmaxq_f32(a.value, b.value)}; }
+inline Float4 Abs(Float4 a) { return {vabsq_f32(a.value)}; }
+inline Float4 Truncate(Float4 a) {
+  return {vcvtq_f32_s32(vcvtq_s32_f32(a.value))};
+}
+inline Float4 Step(Float4 edge, Float4 a) {
+  uint32x4_t mask = vcgeq_f32(a.value, edge.value);
+  return {vreinterpretq_f32_u32(
+      vandq_u32(mask, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))};
+}
+inline float HorizontalSum(Float4 a) {
+  float32x2_t sums = vadd_f32(vget_low_f32(a.value), vget_high_f32(a.value));
+  return vget_lane_f32(vpadd_f32(sums, sums), 0);
+}
+
+#else
+
+inline Float4 Splat(float scalar) {
+  Float4 result = {{scalar, scalar, scalar, scalar}};
+  return result;
+}
+inline Float4 Load(const float* data) {
+  Float4 result = {{data[0], data[1], data[2], data[3]}};
+  return result;
+}
+inline void Store(float* data, Float4 a) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    data[lane] = a.value[lane];
+  }
+}
+inline Float4 operator+(Float4 a, Float4 b) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] += b.value[lane];
+  }
+  return a;
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] -= b.value[lane];
+  }
+  return a;
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] *= b.value[lane];
+  }
+  return a;
+}
+inline Float4 Min(Float4 a, Float4 b) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] =
+        a.value[lane] < b.value[lane] ? a.value[lane] : b.value[lane];
+  }
+  return a;
+}
+inline Float4 Max(Float4 a, Float4 b) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] =
+        a.value[lane] > b.value[lane] ? a.value[lane] : b.value[lane];
+  }
+  return a;
+}
+inline Float4 Abs(Float4 a) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] = a.value[lane] < 0 ? -a.value[lane] : a.value[lane];
+  }
+  return a;
+}
+inline Float4 Truncate(Float4 a) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] = static_cast<float>(static_cast<int>(a.value[lane]));
+  }
+  return a;
+}
+inline Float4 Step(Float4 edge, Float4 a) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    a.value[lane] = a.value[lane] >= edge.value[lane] ? 1.0f : 0.0f;
+  }
+  return a;
+}
+inline float HorizontalSum(Float4 a) {
+  return a.value[0] + a.value[1] + a.value[2] + a.value[3];
+}
+
+#endif
+
+} // namespace simd
+
+} // namespace scalepiegraph
@@ -0,0 +1,55 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing a polyphase windowed-sinc interpolator. The filter is
+ * tabulated up front for kNumPhases fractional positions between two source
+ * samples, and coefficients between neighbouring phases are interpolated
+ * linearly. Every band of the table has a lower cutoff for reading the source
+ * faster, so pitching a recording up does not alias; bands are half an octave
+ * apart. Interpolating one sample is a pair of SIMD dot products.
+ */
+class SincResampler {
+ public:
+  /**
+   * Tabulate the filters of every band.
+   */
+  SincResampler();
+
+  /**
+   * Choose the band of the table for a playback rate.
+   *
+   * @param ratio The number of source samples read per output sample
+   * @return The band whose cutoff keeps the output below Nyquist
+   */
+  size_t GetBand(double ratio) const;
+
+  /**
+   * Interpolate a source signal between two of its samples.
+   *
+   * @param window kTaps consecutive source samples; the position lies between
+   * window[kTaps / 2 - 1] and window[kTaps / 2]
+   * @param fraction The position past window[kTaps / 2 - 1], from 0 to 1
+   * @param band The band of the table from GetBand
+   * @return The interpolated sample
+   */
+  float Interpolate(const float* window, float fraction, size_t band) const;
+
+  static const size_t kTaps = 32;
+  static const size_t kNumPhases = 256;
+  static const size_t kNumBands = 9;
+  static const double kMaxRatio;
+  static const double kCutoff;
+
+ private:
+  // kNumPhases + 1 rows of kTaps coefficients per band, so the last phase
+  // can be interpolated toward the next sample
+  std::vector<float> coefficients_;
+};
+
+} // namespace scalepiegraph
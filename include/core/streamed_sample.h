@@ -0,0 +1,152 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/wav_reader.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing a recorded instrument sample streamed from disk. Only
+ * the head of the recording is held in memory. Every stream, one per voice,
+ * reads the head and then a lock-free ring that a loader thread keeps
+ * prefetched from the file, so notes start instantly and long recordings never
+ * have to fit in memory. The audio thread never blocks on the disk: a stream
+ * whose ring runs dry plays silence and counts an underrun.
+ */
+class StreamedSample {
+ public:
+  /**
+   * Open a WAV file and start its loader thread.
+   *
+   * @param path The path of the WAV file
+   * @param root_frequency The pitch at which the sample was recorded in hertz
+   * @param num_streams The number of notes that can read the sample at once
+   * @param head_frames The number of frames at the start held in memory
+   * @param ring_frames The number of frames prefetched for each stream,
+   * rounded up to a power of two
+   */
+  StreamedSample(const std::string& path,
+                 double root_frequency,
+                 size_t num_streams,
+                 size_t head_frames = kDefaultHeadFrames,
+                 size_t ring_frames = kDefaultRingFrames);
+
+  /**
+   * Stop the loader thread.
+   */
+  ~StreamedSample();
+
+  StreamedSample(const StreamedSample&) = delete;
+  StreamedSample& operator=(const StreamedSample&) = delete;
+
+  /**
+   * Rewind a stream to the start of the sample. Only call from the thread
+   * that renders the stream.
+   *
+   * @param stream The index of the stream
+   */
+  void Start(size_t stream);
+
+  /**
+   * Read the next frames of a stream. Frames past the end of the sample, and
+   * frames that have not been prefetched yet, are filled with silence. Only
+   * call from the thread that renders the stream; never blocks or allocates.
+   *
+   * @param stream The index of the stream
+   * @param output The buffer into which to read
+   * @param num_frames The number of frames to read
+   * @return The number of frames read from the sample
+   */
+  size_t Read(size_t stream, float* output, size_t num_frames);
+
+  /**
+   * Get the pitch at which the sample was recorded.
+   *
+   * @return The root frequency in hertz
+   */
+  double GetRootFrequency() const;
+
+  /**
+   * Get the sample rate of the recording.
+   *
+   * @return The sample rate in frames per second
+   */
+  double GetSampleRate() const;
+
+  /**
+   * Get the length of the recording.
+   *
+   * @return The number of frames in the recording
+   */
+  size_t GetNumFrames() const;
+
+  /**
+   * Get the number of notes that can read the sample at once.
+   *
+   * @return The number of streams
+   */
+  size_t GetNumStreams() const;
+
+  /**
+   * Get the number of reads that ran past the prefetched frames.
+   *
+   * @return The number of underruns
+   */
+  size_t GetNumUnderruns() const;
+
+  static const size_t kDefaultHeadFrames = 32768;
+  static const size_t kDefaultRingFrames = 32768;
+  static const size_t kLoadFrames; // Frames read from disk at a time
+
+ private:
+  /**
+   * The position of one note in the sample. The stream's reader owns its
+   * position and requests a rewind by bumping its generation; the loader
+   * refills the ring from the end of the head and publishes the generation
+   * as ready. The reader only touches the ring while both match.
+   */
+  struct Stream {
+    std::atomic<uint32_t> requested{0};
+    std::atomic<uint32_t> ready{0};
+    std::atomic<size_t> write_count{0};
+    std::atomic<size_t> read_count{0};
+    size_t position = 0; // Owned by the reader
+    size_t file_frame = 0; // Owned by the loader
+  };
+
+  /**
+   * Prefetch frames until stopped, sleeping while every ring is full.
+   */
+  void RunLoader();
+
+  /**
+   * Rewind or top up the ring of one stream. Once the file cannot be read,
+   * rings are no longer filled.
+   *
+   * @param stream The index of the stream
+   * @return True if any work was done
+   */
+  bool FillStream(size_t stream);
+
+  WavReader reader_; // Owned by the loader after construction
+  double root_frequency_;
+  size_t num_streams_;
+  size_t ring_frames_;
+  std::vector<float> head_;
+  std::vector<float> rings_; // ring_frames_ per stream
+  std::vector<float> load_buffer_;
+  bool has_read_failed_ = false; // Owned by the loader; stops all filling
+  std::unique_ptr<Stream[]> streams_;
+  std::atomic<size_t> num_underruns_;
+  std::atomic<bool> stop_loader_;
+  std::thread loader_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,246 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <core/additive_timbre.h>
+#include <core/parameter_queue.h>
+#include <core/render_profiler.h>
+#include <core/scale_morph.h>
+#include <core/sequencer.h>
+#include <core/triple_buffer.h>
+#include <core/voice_pool.h>
+#include <core/waveform.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing the real-time half of the Synthesizer. Parameter
+ * changes are posted from the UI thread into a lock-free ParameterQueue with
+ * the sample frame at which they should take effect, and the audio thread
+ * drains the queue while rendering so every change lands on its exact frame.
+ * Notes are played by a preallocated VoicePool; the start, stop and frequency
+ * events drive a single lead note for monophonic callers, and a Sequencer
+ * plays Patterns on its own note against the sample clock. The engine does not
+ * depend on Cinder so it can be rendered headlessly.
+ */
+class SynthEngine {
+ public:
+  /**
+   * Create a SynthEngine rendering at the specified sample rate.
+   *
+   * @param sample_rate The sample rate in frames per second
+   * @param queue_capacity The number of parameter events that can be pending
+   * @param num_voices The minimum number of voices that can sound at once,
+   * rounded up by the VoicePool; samples need a stream for every voice
+   */
+  explicit SynthEngine(
+      double sample_rate = kDefaultSampleRate,
+      size_t queue_capacity = ParameterQueue::kDefaultCapacity,
+      size_t num_voices = VoicePool::kDefaultNumVoices);
+
+  /**
+   * Post a parameter change to take effect as soon as possible. The event is
+   * stamped with a frame one block ahead of the audio clock so that events
+   * keep their relative timing inside the next rendered block. Only call from
+   * the single producer thread.
+   *
+   * @param type The type of the parameter change
+   * @param value The new value of the parameter
+   * @param note The note to which the change applies, if any
+   * @return True if the event was queued; false if the queue was full
+   */
+  bool Post(ParameterEvent::Type type, double value = 0, int note = 0);
+
+  /**
+   * Post a parameter change that is already stamped with a frame. Only call
+   * from the single producer thread. Events are validated here so that the
+   * audio thread never has to throw.
+   *
+   * @param event The event to post
+   * @return True if the event was queued; false if the queue was full
+   */
+  bool Post(const ParameterEvent& event);
+
+  /**
+   * Hand a pattern to the sequencer. Post a kPlayPattern event to start it.
+   * Only call from the single producer thread.
+   *
+   * @param pattern The pattern to play
+   */
+  void SetPattern(const Pattern& pattern);
+
+  /**
+   * Hand an additive timbre to the voices and post a kTimbre event to play it.
+   * Sounding voices follow the new timbre without restarting their partials.
+   * Only call from the single producer thread.
+   *
+   * @param timbre The timbre to play
+   * @return True if the event was queued; false if the queue was full
+   */
+  bool SetTimbre(const AdditiveTimbre& timbre);
+
+  /**
+   * Hand a morph between two Scales to the voices and post a kMorphScale
+   * event to start it. Only call from the single producer thread.
+   *
+   * @param morph The morph to play
+   * @return True if the event was queued; false if the queue was full
+   */
+  bool MorphScale(const ScaleMorph& morph);
+
+  /**
+   * Estimate the frame that the audio clock is currently rendering based on
+   * the wall-clock time elapsed since the last rendered block.
+   *
+   * @return The estimated current frame of the audio clock
+   */
+  uint64_t EstimateFrame() const;
+
+  /**
+   * Render the specified number of frames of mono audio, applying every
+   * queued and sequenced event whose frame falls inside the block. Only call
+   * from the audio thread.
+   *
+   * @param output The buffer into which to render
+   * @param num_frames The number of frames to render
+   */
+  void Render(float* output, size_t num_frames);
+
+  /**
+   * Set the sample rate of this engine. Must not be called while rendering.
+   *
+   * @param sample_rate The sample rate in frames per second
+   */
+  void SetSampleRate(double sample_rate);
+
+  /**
+   * Set the number of threads that render the voices of this engine,
+   * including the audio thread. Worth raising only for dense clusters of
+   * hundreds of voices. Must not be called while rendering.
+   *
+   * @param num_threads The number of rendering threads; 0 uses one per core
+   */
+  void SetNumRenderThreads(size_t num_threads);
+
+  /**
+   * Allocate the partials of every voice for additive timbres. Must not be
+   * called while rendering.
+   *
+   * @param max_partials The number of partials per voice
+   */
+  void SetMaxPartials(size_t max_partials);
+
+  /**
+   * Get the sample rate of this engine.
+   *
+   * @return The sample rate in frames per second
+   */
+  double GetSampleRate() const;
+
+  /**
+   * Get the number of frames rendered by this engine.
+   *
+   * @return The frame at the start of the next rendered block
+   */
+  uint64_t GetFrameClock() const;
+
+  /**
+   * Get the queue through which parameter changes reach this engine.
+   *
+   * @return The parameter queue of this engine
+   */
+  const ParameterQueue& GetParameterQueue() const;
+
+  /**
+   * Get the number of events that arrived after the block containing their
+   * frame had already been rendered. Late events are applied at the start of
+   * the next block.
+   *
+   * @return The number of late events
+   */
+  size_t GetNumLateEvents() const;
+
+  /**
+   * Get the voices rendered by this engine.
+   *
+   * @return The voice pool of this engine
+   */
+  const VoicePool& GetVoicePool() const;
+
+  /**
+   * Get the custom wavetable most recently applied by the audio thread.
+   * Wavetables posted before it are no longer read and can be released.
+   *
+   * @return The applied wavetable; nullptr if none has been applied
+   */
+  const Wavetable* GetAppliedWavetable() const;
+
+  /**
+   * Get the sample most recently applied by the audio thread. Samples posted
+   * before it are no longer read and can be released.
+   *
+   * @return The applied sample; nullptr if none has been applied
+   */
+  const StreamedSample* GetAppliedSample() const;
+
+  /**
+   * Get the timing of the blocks rendered by this engine together with the
+   * state of its parameter queue.
+   *
+   * @return A snapshot of the render statistics
+   */
+  RenderStats GetRenderStats() const;
+
+  /**
+   * Clear the render timing and queue statistics of this engine.
+   */
+  void ResetRenderStats();
+
+  static const double kDefaultSampleRate;
+  static const int kLeadNote;
+
+ private:
+  /**
+   * Apply a single parameter event to the rendering state.
+   *
+   * @param event The event to apply
+   */
+  void ApplyEvent(const ParameterEvent& event);
+
+  /**
+   * Get the frame of the earlier of the next queued and next sequenced events.
+   *
+   * @return The frame of the next event; Sequencer::kNever if there is none
+   */
+  uint64_t GetNextEventFrame() const;
+
+  /**
+   * Apply the earlier of the next queued and next sequenced events. Queued
+   * events go first when both fall on the same frame.
+   *
+   * @param block_start The frame at the start of the block being rendered
+   */
+  void ApplyNextEvent(uint64_t block_start);
+
+  ParameterQueue queue_;
+  VoicePool voices_;
+  Sequencer sequencer_;
+  TripleBuffer<AdditiveTimbre> timbres_;
+  TripleBuffer<ScaleMorph> morphs_;
+  double sample_rate_;
+  uint64_t last_posted_frame_ = 0; // Owned by the producer
+
+  // Audio clock published to the producer for timestamping
+  std::atomic<uint32_t> clock_sequence_;
+  std::atomic<uint64_t> block_start_frame_;
+  std::atomic<int64_t> block_start_nanos_;
+  std::atomic<size_t> block_size_;
+  std::atomic<size_t> num_late_events_;
+  std::atomic<const Wavetable*> applied_wavetable_;
+  std::atomic<const StreamedSample*> applied_sample_;
+  RenderProfiler profiler_;
+  uint64_t frame_clock_ = 0; // Owned by the audio thread
+};
+
+} // namespace scalepiegraph
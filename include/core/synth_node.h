@@ -0,0 +1,36 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <memory>
+#include <cinder/audio/InputNode.h>
+#include <core/synth_engine.h>
+
+namespace scalepiegraph {
+
+/**
+ * A Cinder audio node that renders a SynthEngine. The node is the audio
+ * render callback that drains the engine's parameter queue.
+ */
+class SynthNode : public ci::audio::InputNode {
+ public:
+  /**
+   * Create a SynthNode rendering the specified engine.
+   *
+   * @param engine The engine to render
+   * @param format The Cinder node format
+   */
+  explicit SynthNode(const std::shared_ptr<SynthEngine>& engine,
+                     const Format& format = Format());
+
+ protected:
+  void initialize() override;
+
+  void process(ci::audio::Buffer* buffer) override;
+
+ private:
+  std::shared_ptr<SynthEngine> engine_;
+};
+
+typedef std::shared_ptr<SynthNode> SynthNodeRef;
+
+} // namespace scalepiegraph
@@ -1,18 +1,26 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #pragma once
 
-#include <cinder/audio/Node.h>
-#include <cinder/audio/GenNode.h>
+#include <memory>
+#include <string>
+#include <vector>
 #include <cinder/audio/WaveformType.h>
 #include <cinder/audio/Context.h>
 #include <cinder/audio/GainNode.h>
-#include <cinder/audio/FilterNode.h>
+#include <core/midi_player.h>
+#include <core/recorder_node.h>
+#include <core/scale.h>
+#include <core/synth_engine.h>
+#include <core/synth_node.h>
 
 namespace scalepiegraph {
 
 /**
- * A class representing a sound synthesizer with variable waveform, gain, and
- * filter.
+ * A class representing a polyphonic sound synthesizer with variable waveform,
+ * gain, and filter. Parameter changes are queued to the audio thread and
+ * applied on the exact sample frame they were made, so calls never touch the
+ * audio graph. Start, Stop and SetFrequency control a single lead note, while
+ * NoteOn and NoteOff play any number of notes at once.
  */
 class Synthesizer {
  public:
@@ -34,6 +42,63 @@ class Synthesizer {
    */
   void Stop() const;
 
+  /**
+   * Start a note alongside any other sounding notes. Starting a note that is
+   * already sounding retriggers it.
+   *
+   * @param note The identifier of the note, e.g. its key index
+   * @param frequency The frequency of the note
+   */
+  void NoteOn(int note, double frequency) const;
+
+  /**
+   * Release a note started with NoteOn.
+   *
+   * @param note The identifier of the note to release
+   */
+  void NoteOff(int note) const;
+
+  /**
+   * Release every sounding note, including the lead note.
+   */
+  void StopAll() const;
+
+  /**
+   * Start playing a pattern from its first step, replacing any pattern that
+   * is already playing.
+   *
+   * @param pattern The pattern to play
+   */
+  void PlayPattern(const Pattern& pattern) const;
+
+  /**
+   * Stop playing the current pattern.
+   */
+  void StopPattern() const;
+
+  /**
+   * Start playing a MIDI file retuned through a Scale, replacing any file
+   * that is already playing. Call UpdateMidi regularly to keep it playing.
+   *
+   * @param midi_file The file to play
+   * @param scale The Scale in which to play the file
+   * @param mapping The mapping of MIDI keys onto the Scale
+   */
+  void PlayMidi(const MidiFile& midi_file,
+                const Scale& scale,
+                const KeyboardMapping& mapping = KeyboardMapping());
+
+  /**
+   * Post the events of the playing MIDI file that fall shortly ahead of the
+   * audio clock.
+   */
+  void UpdateMidi();
+
+  /**
+   * Stop playing the MIDI file and release its notes.
+   */
+  void StopMidi();
+
   /**
    * Set the frequency of this Synthesizer.
    *
@@ -48,20 +113,161 @@ class Synthesizer {
    */
   void SetWaveform(ci::audio::WaveformType waveform_type) const;
 
+  /**
+   * Play an arbitrary waveform, given as the samples of one cycle, through a
+   * band-limited wavetable.
+   *
+   * @param cycle The samples of a single cycle of the waveform
+   */
+  void SetCustomWaveform(const std::vector<float>& cycle);
+
+  /**
+   * Play a recorded instrument sample, retuned to each note's frequency. The
+   * recording is streamed from disk rather than loaded into memory.
+   *
+   * @param path The path of a WAV file
+   * @param root_frequency The pitch at which the sample was recorded in hertz
+   */
+  void SetSample(const std::string& path, double root_frequency);
+
   /**
    * Set the cutoff frequency of this Synthesizer's filter.
    *
    * @param cutoff The cutoff at which to set this Synthesizer's filter
    */
   void SetFilter(float cutoff);
+
+  /**
+   * Set the response of every voice's filter.
+   *
+   * @param mode The low-pass, high-pass or band-pass response
+   */
+  void SetFilterMode(FilterMode mode);
+
+  /**
+   * Set the resonance of every voice's filter.
+   *
+   * @param resonance The quality factor of the filters
+   */
+  void SetFilterResonance(float resonance);
+
+  /**
+   * Set the cutoff frequency of the filter of a single playing note.
+   *
+   * @param note The identifier of the note to filter
+   * @param cutoff The cutoff at which to set the note's filter
+   */
+  void SetNoteFilter(int note, float cutoff);
+
+  /**
+   * Set how far each note's envelope sweeps its filter cutoff.
+   *
+   * @param octaves The sweep at full envelope level in octaves
+   */
+  void SetFilterEnvelope(float octaves);
+
+  /**
+   * Play an additive timbre whose partials are matched to a Scale, so that the
+   * partials of each note coincide with the other notes of the Scale. Notes
+   * that are sounding follow the new timbre smoothly.
+   *
+   * @param scale The Scale to which to match the partials
+   */
+  void SetAdditiveTimbre(const Scale& scale);
+
+  /**
+   * Glide every sounding note from one Scale to the same note of another.
+   *
+   * @param from The Scale that is currently playing
+   * @param to The Scale to which to glide
+   * @param base_freq The frequency of the first note of both Scales
+   * @param duration The length of the glide in seconds
+   */
+  void MorphScale(const Scale& from,
+                  const Scale& to,
+                  double base_freq,
+                  double duration);
+
+  /**
+   * Start recording everything this Synthesizer plays to a WAV file,
+   * finishing any recording already in progress. The audio thread hands its
+   * output to a background thread that writes the file.
+   *
+   * @param path The path of the WAV file to write
+   */
+  void StartRecording(const std::string& path);
+
+  /**
+   * Stop recording and finish the file.
+   */
+  void StopRecording();
+
+  /**
+   * Whether this Synthesizer is recording.
+   *
+   * @return True between StartRecording and StopRecording
+   */
+  bool IsRecording() const;
+
+  /**
+   * Get the number of audio blocks left out of the recording because the
+   * writer fell behind.
+   *
+   * @return The number of overruns since the recording started
+   */
+  size_t GetNumRecordingOverruns() const;
+
+  /**
+   * Get the number of parameter changes waiting for the audio thread.
+   *
+   * @return The current depth of the parameter queue
+   */
+  size_t GetQueueDepth() const;
+
+  /**
+   * Get the largest number of parameter changes that have been waiting for
+   * the audio thread at once.
+   *
+   * @return The high-water mark of the parameter queue
+   */
+  size_t GetMaxQueueDepth() const;
+
+  /**
+   * Get the number of parameter changes dropped because the queue was full.
+   *
+   * @return The number of dropped parameter changes
+   */
+  size_t GetNumDroppedChanges() const;
+
+  /**
+   * Get the timing of the audio callback and the state of the parameter
+   * queue.
+   *
+   * @return A snapshot of the render statistics
+   */
+  RenderStats GetRenderStats() const;
+
+  /**
+   * Clear the render timing and queue statistics.
+   */
+  void ResetRenderStats();
+
  private:
   const double kFrequencyMax = 20000;
   const double kFrequencyMin = 20;
+  const double kMidiLookahead = 0.5; // Seconds of MIDI events to post ahead
 
   ci::audio::Context* context_;
-  ci::audio::GenOscNodeRef oscillator_;
-  ci::audio::FilterLowPassNodeRef filter_;
+  std::shared_ptr<SynthEngine> engine_;
+  SynthNodeRef synth_node_;
+  // Custom wavetables and samples in the order posted, from the one the audio
+  // thread last applied; earlier ones are released when the next one is set
+  std::vector<std::shared_ptr<Wavetable>> custom_wavetables_;
+  std::vector<std::shared_ptr<StreamedSample>> samples_;
   ci::audio::GainNodeRef gain_;
+  std::shared_ptr<Recorder> recorder_;
+  RecorderNodeRef recorder_node_; // Taps the output of gain_
+  std::unique_ptr<MidiPlayer> midi_player_;
 };
 
-} // namespace scalepiegraph
\ No newline at end of file
+} // namespace scalepiegraph
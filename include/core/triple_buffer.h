@@ -0,0 +1,66 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+
+namespace scalepiegraph {
+
+/**
+ * A lock-free triple buffer handing the latest value of T from a single
+ * producer to a single consumer. The producer writes into a back slot and
+ * publishes it by swapping it with the middle slot; the consumer takes the
+ * middle slot when a new value is waiting. Neither side ever waits on the
+ * other, and since all three slots are allocated up front, publishing and
+ * taking never allocate as long as copying T does not.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() : middle_(1), back_(0), front_(2) {}
+
+  /**
+   * Publish a new value. Only call from the producer.
+   *
+   * @param value The value to publish
+   */
+  void Write(const T& value) {
+    slots_[back_] = value;
+    back_ = middle_.exchange(back_ | kNewBit, std::memory_order_acq_rel) &
+            kIndexMask;
+  }
+
+  /**
+   * Take the most recently published value if it has not been taken yet.
+   * Only call from the consumer.
+   *
+   * @return True if a new value was taken
+   */
+  bool Update() {
+    if (!(middle_.load(std::memory_order_relaxed) & kNewBit)) {
+      return false;
+    }
+
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+
+  /**
+   * Get the value last taken by Update. Only call from the consumer.
+   *
+   * @return The current value of the consumer
+   */
+  const T& Read() const {
+    return slots_[front_];
+  }
+
+ private:
+  static const int kIndexMask = 3;
+  static const int kNewBit = 4;
+
+  T slots_[3];
+  std::atomic<int> middle_; // Slot index, plus kNewBit while unread
+  int back_; // Owned by the producer
+  int front_; // Owned by the consumer
+};
+
+} // namespace scalepiegraph
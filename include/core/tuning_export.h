@@ -0,0 +1,79 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <core/keyboard_mapping.h>
+#include <core/scale.h>
+#include <core/scale_dataset.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class that exports the tuning of Scales to hardware and software
+ * synthesizers, as MIDI Tuning Standard bulk dumps and AnaMark .tun files.
+ * Both formats give a frequency for each of the 128 MIDI keys; keys that the
+ * KeyboardMapping leaves unmapped keep their standard tuning.
+ */
+class TuningExporter {
+ public:
+  /**
+   * Create a MIDI Tuning Standard bulk tuning dump of a Scale.
+   *
+   * @param scale The Scale to export
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @param program The tuning program number to write, from 0 to 127
+   * @param device_id The device to address; kAllDevices by default
+   * @return The system exclusive message, from F0 to F7
+   */
+  static std::vector<uint8_t> MakeBulkDump(const Scale& scale,
+                                           const KeyboardMapping& mapping,
+                                           uint8_t program,
+                                           uint8_t device_id = kAllDevices);
+
+  /**
+   * Write an AnaMark .tun file of a Scale.
+   *
+   * @param scale The Scale to export
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @param output_stream The stream to which to write
+   */
+  static void WriteTun(const Scale& scale,
+                       const KeyboardMapping& mapping,
+                       std::ostream& output_stream);
+
+  /**
+   * Export a bulk dump (.syx) and a .tun file for every Scale in a dataset in
+   * one pass. Each Scale's bulk dump uses its index as the program number.
+   *
+   * @param dataset The Scales to export
+   * @param output_dir The existing directory in which to write the files
+   * @param mapping The mapping of MIDI keys onto each Scale
+   * @return The number of Scales exported
+   */
+  static size_t ExportDataset(
+      const ScaleDataset& dataset,
+      const std::string& output_dir,
+      const KeyboardMapping& mapping = KeyboardMapping());
+
+  /**
+   * Get the frequency of a key, or its standard tuning if it is unmapped.
+   *
+   * @param scale The Scale by which to tune the key
+   * @param mapping The mapping of MIDI keys onto the Scale
+   * @param key The MIDI key number
+   * @return The frequency of the key in hertz
+   */
+  static double CalculateKeyFrequency(const Scale& scale,
+                                      const KeyboardMapping& mapping,
+                                      uint8_t key);
+
+  static const uint8_t kAllDevices = 0x7F;
+  static const size_t kBulkDumpSize = 408;
+  static const size_t kNameLength = 16;
+  static const double kTunBaseFrequency; // Frequency of MIDI key 0
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,152 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsoncpp/json.h>
+#include <core/fft.h>
+#include <core/offline_renderer.h>
+#include <core/scale_dataset.h>
+
+namespace scalepiegraph {
+
+/**
+ * The measured tuning of one rendered note.
+ */
+struct NoteTuning {
+  std::string scale_name;
+  size_t note_index = 0; // Within one period of the Scale
+  size_t octave = 0; // Periods above the base frequency
+  Waveform waveform = Waveform::kSine;
+  double expected_frequency = 0; // From Scale::CalculateNoteFrequency
+  double measured_frequency = 0;
+  double error_cents = 0; // Positive is sharp
+};
+
+/**
+ * The measured tuning of every note rendered in one verification pass.
+ */
+struct TuningReport {
+  std::vector<NoteTuning> notes;
+  size_t num_workers = 0;
+  double seconds = 0;
+
+  /**
+   * Get the largest tuning error of any note, sharp or flat.
+   *
+   * @return The largest absolute error in cents
+   */
+  double GetMaxAbsErrorCents() const;
+
+  /**
+   * Get the mean tuning error over every note, sharp or flat.
+   *
+   * @return The mean absolute error in cents
+   */
+  double GetMeanAbsErrorCents() const;
+
+  /**
+   * Convert this report to JSON.
+   *
+   * @return The JSON representation of this report
+   */
+  Json::Value ToJson() const;
+
+  /**
+   * Write this report as a JSON document.
+   *
+   * @param output_stream The stream to which to write
+   * @param report The report to write
+   * @return The output stream
+   */
+  friend std::ostream& operator<<(std::ostream& output_stream,
+                                  const TuningReport& report);
+};
+
+/**
+ * A class that verifies that the synthesizer plays every note at
+ * Scale::CalculateNoteFrequency. Each note is rendered offline with each
+ * waveform in each octave, and the fundamental of its sustain is measured
+ * with a Hann-windowed FFT whose peak is interpolated between bins. Scales
+ * of a dataset are shared out over a pool of worker threads, like previews
+ * in a BatchRenderer.
+ */
+class TuningVerifier {
+ public:
+  /**
+   * Create a tuning verifier.
+   *
+   * @param num_workers The number of worker threads; 0 uses one per core
+   * @param sample_rate The sample rate in frames per second
+   * @param fft_size The number of frames measured per note, a power of two
+   */
+  explicit TuningVerifier(size_t num_workers = 0,
+                          double sample_rate = SynthEngine::kDefaultSampleRate,
+                          size_t fft_size = kDefaultFftSize);
+
+  /**
+   * Set the waveforms with which each note is rendered. Only the built-in
+   * oscillators can be rendered offline.
+   *
+   * @param waveforms The waveforms to verify
+   */
+  void SetWaveforms(const std::vector<Waveform>& waveforms);
+
+  /**
+   * Set the number of octaves, from the base frequency up, in which each note
+   * is rendered.
+   *
+   * @param num_octaves The number of periods of each Scale to verify
+   * @param base_freq The frequency of the first note of each Scale
+   */
+  void SetRange(size_t num_octaves, float base_freq);
+
+  /**
+   * Render and measure every note of a Scale on the calling thread.
+   *
+   * @param scale The Scale to verify
+   * @return The tuning of every note, waveform and octave
+   */
+  std::vector<NoteTuning> VerifyScale(const Scale& scale) const;
+
+  /**
+   * Render and measure every note of every Scale in a dataset in parallel.
+   *
+   * @param dataset The Scales to verify
+   * @return The tuning of every note, in dataset order
+   */
+  TuningReport VerifyDataset(const ScaleDataset& dataset) const;
+
+  /**
+   * Measure the frequency of the strongest peak near an expected frequency.
+   *
+   * @param samples The fft_size samples to measure
+   * @param expected_frequency The frequency around which to search in hertz
+   * @return The measured frequency in hertz
+   */
+  double MeasureFrequency(const float* samples,
+                          double expected_frequency) const;
+
+  /**
+   * Get the number of worker threads used by this verifier.
+   *
+   * @return The number of worker threads
+   */
+  size_t GetNumWorkers() const;
+
+  static const size_t kDefaultFftSize;
+  static const double kSettleSeconds; // Skipped while the attack settles
+  static const double kSearchCents; // Distance searched around each note
+
+ private:
+  size_t num_workers_;
+  double sample_rate_;
+  Fft fft_;
+  std::vector<Waveform> waveforms_;
+  size_t num_octaves_ = 2;
+  float base_freq_ = 220;
+};
+
+} // namespace scalepiegraph
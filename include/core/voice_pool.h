@@ -0,0 +1,481 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <core/additive_timbre.h>
+#include <core/biquad_bank.h>
+#include <core/scale_morph.h>
+#include <core/simd.h>
+#include <core/sinc_resampler.h>
+#include <core/streamed_sample.h>
+#include <core/waveform.h>
+#include <core/wavetable.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing a fixed pool of synthesizer voices. Every voice has a
+ * band-limited wavetable oscillator, a bank of additive partials or a
+ * resampled recording, an ADSR envelope and its own filter in a BiquadBank,
+ * stored as a structure of arrays so that all voices are rendered four at a
+ * time in SIMD loops. Filter cutoffs can be set per note and swept by each
+ * voice's envelope. All storage is allocated at construction or by
+ * SetMaxPartials; nothing allocates while rendering.
+ *
+ * Large pools can be rendered by several threads. Voices are split into fixed
+ * chunks dealt out round-robin to partitions; the calling thread and a set of
+ * worker threads claim partitions lock-free at every render and the calling
+ * thread mixes the partitions down once all of them are done. Small numbers of
+ * sounding voices are rendered on the calling thread alone.
+ */
+class VoicePool {
+ public:
+  /**
+   * Create a pool with at least the specified number of voices. The number of
+   * voices is rounded up to a multiple of the SIMD width, and the extra voices
+   * are allocated and played like any other.
+   *
+   * @param num_voices The minimum number of voices in this pool; GetNumVoices
+   * reports the rounded-up count
+   * @param sample_rate The sample rate in frames per second
+   */
+  explicit VoicePool(size_t num_voices = kDefaultNumVoices,
+                     double sample_rate = 44100);
+
+  /**
+   * Stop the worker threads of this pool.
+   */
+  ~VoicePool();
+
+  /**
+   * Start a note. A voice already playing the note is retriggered; otherwise a
+   * free voice is used, or a voice is stolen if all voices are busy.
+   *
+   * @param note The identifier of the note to start
+   * @param frequency The frequency of the note
+   */
+  void NoteOn(int note, double frequency);
+
+  /**
+   * Release every voice playing the specified note.
+   *
+   * @param note The identifier of the note to release
+   */
+  void NoteOff(int note);
+
+  /**
+   * Retune every voice playing the specified note without retriggering it.
+   *
+   * @param note The identifier of the note to retune
+   * @param frequency The new frequency of the note
+   */
+  void SetNoteFrequency(int note, double frequency);
+
+  /**
+   * Release every sounding voice.
+   */
+  void ReleaseAll();
+
+  /**
+   * Glide every sounding note of a morph's outgoing Scale to the same note of
+   * its incoming Scale. Each voice's frequency is interpolated every sample
+   * across the morph; notes that are not in the outgoing Scale keep their
+   * frequency. Retuning or restarting a note ends its morph.
+   *
+   * @param morph The morph to play; only read during this call
+   */
+  void MorphScale(const ScaleMorph& morph);
+
+  /**
+   * Set the waveform of every voice. kCustom is ignored until a custom
+   * wavetable has been set, kAdditive until a timbre has been set and kSample
+   * until a sample has been set.
+   *
+   * @param waveform The waveform to generate
+   */
+  void SetWaveform(Waveform waveform);
+
+  /**
+   * Play a user-supplied wavetable on every voice and select kCustom. The pool
+   * does not take ownership; the wavetable must outlive its use here.
+   *
+   * @param wavetable The wavetable to play, built for this pool's sample rate
+   */
+  void SetWavetable(const Wavetable* wavetable);
+
+  /**
+   * Allocate the partials of every voice for additive synthesis. No voice can
+   * play more partials than this. Must not be called while rendering.
+   *
+   * @param max_partials The number of partials per voice, rounded up to a
+   * multiple of the SIMD width and capped at AdditiveTimbre::kMaxPartials
+   */
+  void SetMaxPartials(size_t max_partials);
+
+  /**
+   * Play an additive timbre on every voice and select kAdditive. Sounding
+   * voices keep the phase of every partial and only retune the partials whose
+   * ratio changed, so a timbre can follow a Scale as it is edited. Ignored
+   * until partials have been allocated. The pool does not take ownership; the
+   * timbre must outlive its use here.
+   *
+   * @param timbre The timbre to play
+   */
+  void SetTimbre(const AdditiveTimbre* timbre);
+
+  /**
+   * Play a recorded sample on every voice and select kSample. Each voice
+   * reads its own stream of the sample, retuned from the sample's root
+   * frequency through a SincResampler, and restarts it with every note. The
+   * pool does not take ownership; the sample must outlive its use here.
+   *
+   * @param sample The sample to play, with a stream for every voice
+   */
+  void SetSample(StreamedSample* sample);
+
+  /**
+   * Set the cutoff frequency of every voice's filter and of subsequently
+   * started notes.
+   *
+   * @param cutoff The cutoff or center frequency in hertz
+   */
+  void SetFilterCutoff(double cutoff);
+
+  /**
+   * Set the response of every voice's filter.
+   *
+   * @param mode The response of the filters
+   */
+  void SetFilterMode(FilterMode mode);
+
+  /**
+   * Set the resonance of every voice's filter.
+   *
+   * @param resonance The quality factor of the filters
+   */
+  void SetFilterResonance(double resonance);
+
+  /**
+   * Set the cutoff frequency of the filter of every voice playing the
+   * specified note, until the note is started again.
+   *
+   * @param note The identifier of the note to filter
+   * @param cutoff The cutoff or center frequency in hertz
+   */
+  void SetNoteFilterCutoff(int note, double cutoff);
+
+  /**
+   * Set how far each voice's envelope sweeps its filter cutoff. At full
+   * envelope level the cutoff is raised by this many octaves.
+   *
+   * @param octaves The sweep in octaves; negative values sweep downward
+   */
+  void SetFilterEnvelope(double octaves);
+
+  /**
+   * Set the envelope applied to every subsequently started note.
+   *
+   * @param attack The attack time in seconds
+   * @param decay The decay time in seconds
+   * @param sustain The sustain level from 0 to 1
+   * @param release The release time in seconds
+   */
+  void SetEnvelope(double attack, double decay, double sustain, double release);
+
+  /**
+   * Set the sample rate of this pool, rebuilding the built-in wavetables.
+   * Must not be called while rendering.
+   *
+   * @param sample_rate The sample rate in frames per second
+   */
+  void SetSampleRate(double sample_rate);
+
+  /**
+   * Set the number of threads that render this pool, including the thread
+   * that calls Render. Worker threads busy-wait between renders so that they
+   * respond within microseconds, backing off to sleeping when left idle. Must
+   * not be called while rendering.
+   *
+   * @param num_threads The number of rendering threads; 0 uses one per core
+   */
+  void SetNumThreads(size_t num_threads);
+
+  /**
+   * Get the number of threads that render this pool, including the thread
+   * that calls Render.
+   *
+   * @return The number of rendering threads
+   */
+  size_t GetNumThreads() const;
+
+  /**
+   * Render the mix of all voices, overwriting the output buffer.
+   *
+   * @param output The buffer into which to render
+   * @param num_frames The number of frames to render
+   */
+  void Render(float* output, size_t num_frames);
+
+  /**
+   * Get the number of voices in this pool.
+   *
+   * @return The number of voices in this pool
+   */
+  size_t GetNumVoices() const;
+
+  /**
+   * Get the number of voices that were sounding after the last render.
+   *
+   * @return The number of sounding voices
+   */
+  size_t GetNumActiveVoices() const;
+
+  /**
+   * Get the number of times a sounding voice was stolen for a new note.
+   *
+   * @return The number of stolen voices
+   */
+  size_t GetNumStolenVoices() const;
+
+  /**
+   * Get the frequency at which a note is currently sounding, partway through
+   * any morph. Must not be called while rendering.
+   *
+   * @param note The identifier of the note
+   * @return The frequency of the note; 0 if the note is not sounding
+   */
+  double GetNoteFrequency(int note) const;
+
+  static const size_t kDefaultNumVoices;
+  static const size_t kControlFrames;
+  static const float kVoiceGain;
+  static const size_t kVoicesPerChunk;
+  static const size_t kMinVoicesPerThread;
+  static const size_t kPartitionFrames;
+
+ private:
+  enum class EnvelopeStage : uint8_t {
+    kIdle,
+    kAttack,
+    kDecay,
+    kSustain,
+    kRelease
+  };
+
+  /**
+   * Choose the voice on which to start a note, stealing one if necessary.
+   *
+   * @param note The identifier of the note to start
+   * @return The index of the chosen voice
+   */
+  size_t AllocateVoice(int note);
+
+  /**
+   * Render the voices of one partition, continuing the current control block.
+   *
+   * @param partition The index of the partition
+   * @param num_partitions The number of partitions the voices are split into
+   * @param output The buffer into which to render the partition's mix
+   * @param num_frames The number of frames to render
+   */
+  void RenderPartition(size_t partition, size_t num_partitions,
+                       float* output, size_t num_frames);
+
+  /**
+   * Claim and render partitions of the current job until none are left.
+   * Called by the calling thread and every worker thread.
+   *
+   * @param generation The generation of the job to help with
+   */
+  void RenderClaimedPartitions(uint32_t generation);
+
+  /**
+   * Wait for and help with jobs until the pool is destroyed.
+   */
+  void RunWorker();
+
+  /**
+   * Stop and join every worker thread.
+   */
+  void StopWorkers();
+
+  /**
+   * Advance the envelopes of one partition across one control block, setting
+   * the per-sample step that the SIMD loop applies and counting the sounding
+   * voices of every group.
+   *
+   * @param partition The index of the partition
+   * @param num_partitions The number of partitions the voices are split into
+   * @param num_frames The number of frames in the control block
+   */
+  void AdvanceEnvelopes(size_t partition, size_t num_partitions,
+                        size_t num_frames);
+
+  /**
+   * Render one control block of the sounding groups of one partition.
+   *
+   * @param partition The index of the partition
+   * @param num_partitions The number of partitions the voices are split into
+   * @param output The buffer into which to render
+   * @param num_frames The number of frames in the control block
+   */
+  void RenderControlBlock(size_t partition, size_t num_partitions,
+                          float* output, size_t num_frames);
+
+  /**
+   * Render the wavetable oscillators of one group of voices.
+   *
+   * @param first The index of the first voice of the group
+   * @param samples The interleaved buffer into which to render the group
+   * @param num_frames The number of frames to render
+   */
+  void RenderWavetables(size_t first, float* samples, size_t num_frames);
+
+  /**
+   * Render the sum of the partials of one voice with recursive oscillators,
+   * four partials at a time.
+   *
+   * @param voice The index of the voice
+   * @param partial_mix Per-lane scratch for one control block
+   * @param samples The buffer into which to render, one sample per group
+   * @param num_frames The number of frames to render
+   */
+  void RenderPartials(size_t voice, float* partial_mix, float* samples,
+                      size_t num_frames);
+
+  /**
+   * Render one voice's stream of the sample, resampled to the voice's pitch.
+   *
+   * @param voice The index of the voice
+   * @param source Per-partition scratch for the source frames of one block
+   * @param samples The buffer into which to render, one sample per group
+   * @param num_frames The number of frames to render
+   */
+  void RenderSample(size_t voice, float* source, float* samples,
+                    size_t num_frames);
+
+  /**
+   * Rewind a voice's stream of the sample and clear its resampler.
+   *
+   * @param voice The index of the voice
+   */
+  void StartSample(size_t voice);
+
+  /**
+   * Set the phase increment of a voice and choose its wavetable level.
+   *
+   * @param voice The index of the voice
+   * @param frequency The frequency of the voice
+   */
+  void TuneVoice(size_t voice, double frequency);
+
+  /**
+   * Start the next control block of a voice's morph, interpolating its phase
+   * increment from the precomputed endpoints.
+   *
+   * @param voice The index of the voice
+   * @param num_frames The number of frames in the control block
+   */
+  void AdvanceMorph(size_t voice, size_t num_frames);
+
+  /**
+   * Tune every partial of a voice to the current timbre and the voice's
+   * frequency.
+   *
+   * @param voice The index of the voice
+   */
+  void TunePartials(size_t voice);
+
+  /**
+   * Set the rotation and amplitude of one partial of a voice, silencing it if
+   * it would alias.
+   *
+   * @param voice The index of the voice
+   * @param partial The index of the partial
+   * @param ratio The frequency of the partial relative to the voice
+   * @param amplitude The amplitude of the partial
+   * @return True if the partial is audible
+   */
+  bool TunePartial(size_t voice, size_t partial, float ratio,
+                   float amplitude);
+
+  size_t num_voices_;
+  double sample_rate_;
+  Waveform waveform_ = Waveform::kSine;
+  std::vector<Wavetable> wavetables_; // Built-in waveforms in enum order
+  const Wavetable* custom_wavetable_ = nullptr;
+  const Wavetable* wavetable_ = nullptr;
+  BiquadBank filters_;
+  FilterMode filter_mode_ = FilterMode::kLowPass;
+  double cutoff_ = BiquadBank::kDefaultCutoff;
+  double resonance_ = BiquadBank::kDefaultResonance;
+  double filter_envelope_ = 0; // Octaves of cutoff sweep at full level
+  double attack_ = 0.005;
+  double decay_ = 0.1;
+  double sustain_ = 0.8;
+  double release_ = 0.05;
+  uint64_t next_serial_ = 0;
+  size_t control_frames_left_ = 0; // Frames left in the current control block
+
+  // Per-voice state, one entry per voice
+  std::vector<float> phase_;
+  std::vector<float> phase_increment_;
+  std::vector<size_t> wavetable_level_;
+  std::vector<float> envelope_level_;
+  std::vector<float> envelope_step_;
+  std::vector<float> release_rate_;
+  std::vector<double> note_cutoff_;
+  std::vector<EnvelopeStage> envelope_stage_;
+  std::vector<int> note_;
+  std::vector<uint64_t> serial_;
+  std::vector<uint8_t> group_active_; // Sounding voices of each SIMD group
+
+  // Additive partials, max_partials_ per voice, rotated as complex phasors
+  const AdditiveTimbre* timbre_ = nullptr;
+  size_t max_partials_ = 0;
+  std::vector<float> partial_ratio_; // Ratios of the timbre, shared by voices
+  std::vector<float> partial_real_;
+  std::vector<float> partial_imag_;
+  std::vector<float> partial_cos_;
+  std::vector<float> partial_sin_;
+  std::vector<float> partial_amplitude_;
+  std::vector<size_t> num_partials_; // Partials to render for each voice
+
+  // Scale morphs, interpolating each voice's phase increment between its ends
+  std::vector<float> morph_from_;
+  std::vector<float> morph_to_;
+  std::vector<float> increment_step_; // Added to the increment every frame
+  std::vector<size_t> morph_blocks_;
+  std::vector<size_t> morph_blocks_left_;
+
+  // Recorded samples, read through each voice's window of source frames. The
+  // windows are written twice over so every window is contiguous.
+  StreamedSample* sample_ = nullptr;
+  SincResampler resampler_;
+  std::vector<float> sample_history_; // 2 * SincResampler::kTaps per voice
+  std::vector<size_t> sample_history_index_;
+  std::vector<double> sample_fraction_; // Past the middle of the window
+
+  // Per-partition scratch, one region per rendering thread
+  std::vector<float> voice_samples_; // One group's samples for the filters
+  std::vector<float> mix_; // Per-lane mix of one control block
+  std::vector<float> partial_mix_; // Per-lane partial sum of one voice
+  std::vector<float> sample_source_; // Source frames of one voice's block
+  std::vector<float> partition_output_;
+
+  // The job shared with the worker threads. The job word packs the job's
+  // generation, its number of partitions and the next unclaimed partition.
+  std::vector<std::thread> workers_;
+  std::atomic<uint64_t> job_;
+  std::atomic<size_t> num_partitions_done_;
+  std::atomic<bool> stop_workers_;
+  size_t job_frames_ = 0;
+
+  std::atomic<size_t> num_active_voices_;
+  std::atomic<size_t> num_stolen_voices_;
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,71 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * A class that reads frames of a PCM WAV file on demand, mixed down to mono.
+ * Only the header is parsed when the file is opened, so arbitrarily long
+ * recordings never have to be held in memory. Reads 8, 16, 24 and 32-bit
+ * integer and 32-bit float samples. A truncated file is read up to its last
+ * whole frame.
+ */
+class WavReader {
+ public:
+  /**
+   * Open a WAV file for reading.
+   *
+   * @param path The path of the file to read
+   */
+  explicit WavReader(const std::string& path);
+
+  /**
+   * Read consecutive frames from the file, averaging the channels of each
+   * frame. Frames past the end of the file are not read.
+   *
+   * @param first_frame The index of the first frame to read
+   * @param output The buffer into which to read the mono samples
+   * @param num_frames The number of frames to read
+   * @return The number of frames read
+   */
+  size_t Read(size_t first_frame, float* output, size_t num_frames);
+
+  /**
+   * Get the sample rate of the file.
+   *
+   * @return The sample rate in frames per second
+   */
+  double GetSampleRate() const;
+
+  /**
+   * Get the number of channels in the file.
+   *
+   * @return The number of interleaved channels
+   */
+  size_t GetNumChannels() const;
+
+  /**
+   * Get the length of the file.
+   *
+   * @return The number of frames in the file
+   */
+  size_t GetNumFrames() const;
+
+ private:
+  std::ifstream file_;
+  uint16_t format_ = 0;
+  uint16_t num_channels_ = 0;
+  uint32_t sample_rate_ = 0;
+  uint16_t bytes_per_sample_ = 0;
+  std::streamoff data_offset_ = 0;
+  size_t num_frames_ = 0;
+  std::vector<unsigned char> encoded_; // Reused decoding buffer
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,83 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace scalepiegraph {
+
+/**
+ * A class that streams mono or interleaved multichannel audio to a 16-bit PCM
+ * WAV file. The header is written up front and its sizes are patched when the
+ * writer is closed, so arbitrarily long audio never has to be held in memory.
+ */
+class WavWriter {
+ public:
+  /**
+   * Open a WAV file for writing.
+   *
+   * @param path The path of the file to write
+   * @param sample_rate The sample rate in frames per second
+   * @param num_channels The number of interleaved channels
+   */
+  WavWriter(const std::string& path, double sample_rate,
+            size_t num_channels = 1);
+
+  /**
+   * Close the file if it is still open.
+   */
+  ~WavWriter();
+
+  /**
+   * Append interleaved samples in the range -1 to 1 to the file. Samples
+   * outside the range are clipped.
+   *
+   * @param samples The samples to append
+   * @param num_samples The number of samples, across all channels
+   */
+  void Write(const float* samples, size_t num_samples);
+
+  /**
+   * Patch the header with the final sizes and close the file.
+   */
+  void Close();
+
+  /**
+   * Get the number of frames written so far.
+   *
+   * @return The number of frames written
+   */
+  size_t GetNumFrames() const;
+
+  /**
+   * Write a whole buffer of samples to a WAV file.
+   *
+   * @param path The path of the file to write
+   * @param samples The interleaved samples to write
+   * @param sample_rate The sample rate in frames per second
+   * @param num_channels The number of interleaved channels
+   */
+  static void WriteFile(const std::string& path,
+                        const std::vector<float>& samples,
+                        double sample_rate,
+                        size_t num_channels = 1);
+
+  static const size_t kHeaderSize;
+
+ private:
+  /**
+   * Write the RIFF header for the current number of samples.
+   */
+  void WriteHeader();
+
+  std::ofstream file_;
+  uint32_t sample_rate_;
+  uint16_t num_channels_;
+  size_t num_samples_ = 0;
+  std::vector<char> encoded_; // Reused encoding buffer
+};
+
+} // namespace scalepiegraph
@@ -0,0 +1,22 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+namespace scalepiegraph {
+
+/**
+ * The waveforms that the synthesis engine can generate. The first four mirror
+ * the waveforms of Cinder's GenOscNode so the engine stays independent of
+ * Cinder; kCustom plays a user-supplied wavetable, kAdditive sums the
+ * partials of an AdditiveTimbre and kSample plays a StreamedSample.
+ */
+enum class Waveform {
+  kSine,
+  kTriangle,
+  kSquare,
+  kSawtooth,
+  kCustom,
+  kAdditive,
+  kSample
+};
+
+} // namespace scalepiegraph
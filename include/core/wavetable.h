@@ -0,0 +1,93 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <core/waveform.h>
+
+namespace scalepiegraph {
+
+/**
+ * A class representing a band-limited wavetable oscillator shape. One table is
+ * precomputed per octave of fundamental frequency, each containing only the
+ * harmonics that stay below the Nyquist frequency for that octave, so any
+ * note can be played without aliasing by reading the table for its octave.
+ * Level 0 serves fundamentals up to kBaseFrequency and each further level
+ * serves the octave above the previous one.
+ */
+class Wavetable {
+ public:
+  /**
+   * Create a wavetable from the amplitudes of its harmonics. Harmonic k + 1 is
+   * the sum of a sine and a cosine at k + 1 times the fundamental.
+   *
+   * @param sine_amplitudes The sine amplitude of each harmonic
+   * @param cosine_amplitudes The cosine amplitude of each harmonic
+   * @param sample_rate The sample rate at which the tables will be played
+   */
+  Wavetable(const std::vector<float>& sine_amplitudes,
+            const std::vector<float>& cosine_amplitudes,
+            double sample_rate);
+
+  /**
+   * Create a band-limited wavetable of one of the built-in waveforms.
+   *
+   * @param waveform The waveform; must be one of the first four
+   * @param sample_rate The sample rate at which the tables will be played
+   * @return The wavetable of the waveform
+   */
+  static Wavetable FromWaveform(Waveform waveform, double sample_rate);
+
+  /**
+   * Create a band-limited wavetable from one cycle of an arbitrary waveform.
+   *
+   * @param cycle The samples of a single cycle of the waveform
+   * @param sample_rate The sample rate at which the tables will be played
+   * @return The wavetable of the waveform
+   */
+  static Wavetable FromCycle(const std::vector<float>& cycle,
+                             double sample_rate);
+
+  /**
+   * Get the level of the table to play for the specified phase increment.
+   *
+   * @param phase_increment The fundamental frequency divided by sample rate
+   * @return The level whose harmonics all stay below the Nyquist frequency
+   */
+  size_t GetLevel(double phase_increment) const;
+
+  /**
+   * Get the samples of the table at the specified level. Each table has
+   * kTableSize samples followed by a copy of its first sample so that
+   * interpolation never needs to wrap.
+   *
+   * @param level The level of the table
+   * @return The samples of the table
+   */
+  const float* GetTable(size_t level) const;
+
+  /**
+   * Evaluate the table at the specified level with linear interpolation.
+   *
+   * @param level The level of the table
+   * @param phase The phase in the range 0, inclusive, to 1, exclusive
+   * @return The interpolated sample
+   */
+  float Evaluate(size_t level, double phase) const;
+
+  /**
+   * Get the number of octave levels in this wavetable.
+   *
+   * @return The number of levels
+   */
+  size_t GetNumLevels() const;
+
+  static const size_t kTableSize;
+  static const double kBaseFrequency;
+
+ private:
+  std::vector<std::vector<float>> tables_;
+  double sample_rate_;
+};
+
+} // namespace scalepiegraph
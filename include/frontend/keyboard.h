@@ -1,6 +1,7 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #pragma once
 
+#include <vector>
 #include <cinder/gl/gl.h>
 
 namespace scalepiegraph {
@@ -9,7 +10,12 @@ namespace frontend {
 
 /**
  * A class representing a keyboard to use as onscreen input to
- * trigger a synthesizer.
+ * trigger a synthesizer. The fills and outlines of all keys are kept in one
+ * interleaved vertex buffer that is rebuilt only when the layout changes, and
+ * drawn with one call for the fills and one for the outlines. The keyboard can
+ * be zoomed around a point, and in level-of-detail mode keys too narrow to
+ * tell apart are merged into bands, so only a bounded number of bands is drawn
+ * however many keys there are.
  */
 class Keyboard {
  public:
@@ -37,17 +43,59 @@ class Keyboard {
    */
   void Draw();
 
+  /**
+   * Check whether this keyboard changed since it was last drawn.
+   *
+   * @return True if drawing would show a change; otherwise, false
+   */
+  bool IsDirty() const;
+
   /**
    * Get the key index corresponding to the current position of the mouse, or -1
-   * if the mouse is not in the bounds of a key.
+   * if the mouse is not in the bounds of a key. Equal keys are found in
+   * constant time from the mouse's distance along the keyboard; keys of
+   * unequal widths by a binary search of their edges.
    *
    * @param mouse_pos The current coordinates of the mouse pointer
    * @return The key index if found; otherwise, -1
    */
    int GetKeyIndex(const glm::vec2& mouse_pos) const;
 
+  /**
+   * Highlight the key being played. Only the colors of the previously and
+   * newly pressed keys are uploaded on the next draw.
+   *
+   * @param key_idx The index of the pressed key, or -1 if none is pressed
+   */
+  void SetPressedKey(int key_idx);
+
+  /**
+   * Set whether keys narrower than kMinKeyWidth are merged into bands.
+   *
+   * @param is_enabled Whether level of detail is enabled
+   */
+  void SetLevelOfDetail(bool is_enabled);
+
+  /**
+   * Magnify the keyboard around a point, which stays where it is. The zoom is
+   * kept between 1 and kMaxZoom, and the keys always fill the keyboard.
+   *
+   * @param factor The factor by which to multiply the zoom
+   * @param anchor_x The x-coordinate of the point to zoom around
+   */
+  void Zoom(float factor, float anchor_x);
+
+  /**
+   * Set the widths of the keys of each octave, which are equal by default.
+   *
+   * @param proportions The right edge of each key of an octave as a proportion
+   * of the octave's width, increasing to 1; empty for equal keys
+   */
+  void SetKeyProportions(const std::vector<float>& proportions);
+
   /**
    * Update the number of divisions of this keyboard to the specified number.
+   * Keys become equal again if the number changes.
    *
    * @param num_divisions The new number of divisions for this keyboard
    */
@@ -67,24 +115,100 @@ class Keyboard {
    */
    size_t GetNumOctaves() const;
 
+  /**
+   * Get the number of keys on this keyboard across all of its octaves.
+   *
+   * @return The number of keys on this keyboard
+   */
+  size_t GetNumKeys() const;
+
+  /**
+   * Get the number of bands drawn, each one visible key or, in level-of-detail
+   * mode, a run of keys too narrow to draw apart.
+   *
+   * @return The number of bands drawn
+   */
+  size_t GetNumBands() const;
+
+  /**
+   * Get the magnification of this keyboard.
+   *
+   * @return The zoom, 1 when the whole keyboard is shown
+   */
+  float GetZoom() const;
+
+  static const float kMinKeyWidth;
+  static const float kMaxZoom;
+
  private:
   static const ci::Color kStrokeColor;
   static const ci::Color kKeyColor;
   static const ci::Color kOctaveShade;
+  static const ci::Color kPressedColor;
+  static const size_t kFillVertices;
+
+  /**
+   * A vertex of the keyboard's mesh, interleaving position and color.
+   */
+  struct KeyVertex {
+    glm::vec2 position;
+    ci::Color color;
+  };
 
   /**
-   * Create the keys for this keyboard.
+   * Create the keys for this keyboard and their fills and outlines.
+   */
+  void CreateKeys();
+
+  /**
+   * Get the color with which a band is filled: pressed if it holds the
+   * pressed key, shaded if it holds the first key of an octave.
+   *
+   * @param band The index of the band
+   * @return The fill color of the band
+   */
+  ci::Color GetBandColor(size_t band) const;
+
+  /**
+   * Recolor the fill of the band holding a key and mark its vertices for
+   * upload.
+   *
+   * @param key_idx The index of the key
+   */
+  void WriteKeyColor(size_t key_idx);
+
+  /**
+   * Create a mesh over a range of the shared vertex buffer.
    *
-   * @param should_draw Whether the keys should be drawn or not
+   * @param first_vertex The first vertex of the mesh in the buffer
+   * @param num_vertices The number of vertices in the mesh
+   * @param primitive The primitive with which the vertices are drawn
+   * @return The mesh
    */
-  void CreateKeys(bool should_draw);
+  ci::gl::VboMeshRef CreateMesh(
+      size_t first_vertex, size_t num_vertices, GLenum primitive) const;
 
   glm::vec2 bottom_left_corner_;
   float width_;
   float height_;
   size_t current_divisions_;
   size_t num_octaves_ = 1;
-  std::vector<ci::Path2d> keys_;
+  int pressed_key_ = -1;
+  std::vector<float> key_proportions_; // Empty when keys are equal
+  std::vector<float> key_edges_; // Sorted x-coordinates of the key edges
+  bool is_level_of_detail_ = false;
+  float zoom_ = 1;
+  float zoom_offset_ = 0; // Shift of the zoomed keys, never positive
+  std::vector<size_t> band_first_keys_; // Then one past the last shown key
+
+  // Key fills as triangles, then outlines as lines
+  std::vector<KeyVertex> vertices_;
+  bool is_mesh_stale_ = true; // The layout changed since the last draw
+  size_t first_dirty_vertex_ = 0; // Recolored vertices not yet uploaded
+  size_t end_dirty_vertex_ = 0;
+  ci::gl::VboRef vertex_vbo_;
+  ci::gl::VboMeshRef fill_mesh_;
+  ci::gl::VboMeshRef outline_mesh_;
 };
 
 } // namespace frontend
@@ -2,18 +2,23 @@
 #pragma once
 
 #include <cstdlib>
+#include <vector>
 #include "cinder/gl/gl.h"
-#include <cinder/Path2d.h>
-#include <cinder/Shape2d.h>
-#include <cinder/gl/draw.h>
-#include <cinder/gl/wrapper.h>
 
 namespace scalepiegraph {
 
 namespace frontend {
 
 /**
- * A class representing a Pie Graph with resizable proportions.
+ * A class representing a Pie Graph with resizable proportions. Its outline and
+ * handles are tessellated into triangles once and kept in a vertex mesh, so
+ * drawing is a single submission; moving a handle only retessellates that
+ * handle and the ones after it. The graph can be zoomed around a point, and in
+ * level-of-detail mode handles too close to tell apart are collapsed into
+ * density bands along the arc, so dense scales stay legible until zoomed in.
+ * Only handles that are drawn are kept in the mesh, and they are found by
+ * skipping dense runs of handles, so the geometry stays bounded by the size of
+ * the graph rather than the number of handles.
  */
 class PieGraph {
  public:
@@ -34,12 +39,37 @@ class PieGraph {
   PieGraph(const glm::vec2& pos, float radius, std::vector<float> proportions);
 
   /**
-   * Draw this Pie Graph.
+   * Copy a Pie Graph. The copy uploads its own mesh when it is first drawn,
+   * so that moving the handles of one graph does not change the other.
+   *
+   * @param other The Pie Graph to copy
+   */
+  PieGraph(const PieGraph& other);
+
+  /**
+   * Copy a Pie Graph into this one.
+   *
+   * @param other The Pie Graph to copy
+   * @return This Pie Graph
+   */
+  PieGraph& operator=(const PieGraph& other);
+
+  /**
+   * Draw this Pie Graph, uploading any geometry changed since the last draw.
    */
   void Draw();
 
   /**
-   * Get the index of the Handle nearest the specified position.
+   * Check whether this Pie Graph changed since it was last drawn.
+   *
+   * @return True if drawing would show a change; otherwise, false
+   */
+  bool IsDirty() const;
+
+  /**
+   * Get the index of the Handle nearest the specified position. The position
+   * is converted to an angle once, and only the handles within the angle a
+   * handle spans are found by binary search and tested.
    *
    * @param pos The position which a handle must encompass
    * @return The index of the encompassing handle; -1 if there is none
@@ -59,14 +89,48 @@ class PieGraph {
   bool UpdateHandle(size_t handle_index, glm::vec2 mouse_pos);
 
   /**
-   * Get the position of this Pie Graph.
+   * Set whether handles closer than kMinHandleSpacing to a neighbour are
+   * collapsed into density bands instead of being drawn and picked.
+   *
+   * @param is_enabled Whether level of detail is enabled
+   */
+  void SetLevelOfDetail(bool is_enabled);
+
+  /**
+   * Magnify this Pie Graph around a point, which stays where it is. The zoom
+   * is kept between 1 and kMaxZoom, and the graph is drawn only within the
+   * square it covers unzoomed.
+   *
+   * @param factor The factor by which to multiply the zoom
+   * @param anchor The point to zoom around
+   */
+  void Zoom(float factor, const glm::vec2& anchor);
+
+  /**
+   * Get the magnification of this Pie Graph.
+   *
+   * @return The zoom, 1 when the whole graph is shown
+   */
+  float GetZoom() const;
+
+  /**
+   * Check whether a handle is drawn and can be picked, rather than collapsed
+   * into a density band or outside the zoomed view.
+   *
+   * @param handle_index The index of the handle
+   * @return True if the handle is drawn; otherwise, false
+   */
+  bool IsHandleDetailed(size_t handle_index) const;
+
+  /**
+   * Get the position of this Pie Graph, unzoomed.
    *
    * @return The position of this Pie Graph
    */
   glm::vec2 GetCenter() const;
 
   /**
-   * Get the radius of this Pie Graph.
+   * Get the radius of this Pie Graph, unzoomed.
    *
    * @return The radius of this Pie Graph
    */
@@ -79,23 +143,165 @@ class PieGraph {
    */
   std::vector<float> GetProportions() const;
 
+  static const float kMaxZoom;
+  static const float kMinHandleSpacing;
+
  private:
   static const float kCircleStartOffset;
   static const float kHandleRadius;
+  static const float kOverlapOffset; // Outward shift of overlapping handles
+  static const float kStrokeWidth;
+  static const size_t kArcSegments;
+  static const size_t kHandleSegments;
+  static const size_t kLineVertices;
+  static const size_t kHandleVertices;
   static const ci::Color kStrokeColorPrimary;
   static const ci::Color kStrokeColorSecondary;
+  static const size_t kNumBands;
+  static const float kBandDepth;
+  static const float kBandSaturation;
+
+  /**
+   * Lay out the mesh for the current view and tessellate all of it.
+   */
+  void CreateGeometry();
 
   /**
-   * Create the handles for this Pie Graph and optionally draw them.
+   * Retessellate the handles from the specified one onward, together with the
+   * outline, whose end follows the last handle, and the density bands.
    *
-   * @param should_draw Whether the handles should be drawn.
+   * @param first_handle The index of the first handle that moved
    */
-  void CreateHandles(bool should_draw=true);
+  void UpdateGeometry(size_t first_handle);
+
+  /**
+   * Append the visible handles from the specified one onward that are spaced
+   * widely enough to be drawn to the detailed handles.
+   *
+   * @param first_handle The index of the first handle to select
+   */
+  void SelectDetailedHandles(size_t first_handle);
+
+  /**
+   * Get the range of angles at which handles may be seen through the clip
+   * square of a zoomed graph.
+   *
+   * @param start_angle Set to the smallest visible angle
+   * @param end_angle Set to the largest visible angle, past 2 Pi if the range
+   * wraps around the apex
+   * @return True if any handle may be visible; otherwise, false
+   */
+  bool GetVisibleAngles(float* start_angle, float* end_angle) const;
+
+  /**
+   * Write the density bands, each as deep as the number of handles in it
+   * that are not detailed, or collapsed itself when it holds none.
+   *
+   * @param vertex The first of the kNumBands * kLineVertices vertices to write
+   */
+  void WriteBands(size_t vertex);
+
+  /**
+   * Calculate the angle between a handle and its nearest neighbour, counting
+   * the apex as the neighbour before the first handle.
+   *
+   * @param handle The index of the handle
+   * @return The angle to the nearest neighbour in radians
+   */
+  float CalculateSpacing(size_t handle) const;
+
+  /**
+   * Find the first detailed handle in a range of angles that encompasses a
+   * position.
+   *
+   * @param pos The position which a handle must encompass
+   * @param start_angle The smallest angle of a handle to test
+   * @param end_angle The largest angle of a handle to test
+   * @return The index of the encompassing handle; -1 if there is none
+   */
+  int FindHandle(
+      const glm::vec2& pos, float start_angle, float end_angle) const;
+
+  /**
+   * Get the point at an angle on a circle around the zoomed center, measured
+   * counterclockwise from the apex.
+   *
+   * @param angle The angle in radians
+   * @param radius The distance from the center
+   * @return The point on the circle
+   */
+  glm::vec2 GetPointAt(float angle, float radius) const;
+
+  /**
+   * Get the center of this Pie Graph as drawn, after zooming.
+   *
+   * @return The zoomed center
+   */
+  glm::vec2 GetViewCenter() const;
+
+  /**
+   * Get the radius of this Pie Graph as drawn, after zooming.
+   *
+   * @return The zoomed radius
+   */
+  float GetViewRadius() const;
+
+  /**
+   * Write the two triangles of a stroked line segment.
+   *
+   * @param start The start of the segment
+   * @param end The end of the segment
+   * @param vertex The first of the kLineVertices vertices to write
+   */
+  void WriteLine(const glm::vec2& start, const glm::vec2& end, size_t vertex);
+
+  /**
+   * Upload a range of the positions to the mesh.
+   *
+   * @param first_vertex The first vertex to upload
+   * @param end_vertex One past the last vertex to upload
+   */
+  void UploadPositions(size_t first_vertex, size_t end_vertex);
+
+  /**
+   * Write the triangles of a stroked arc of kArcSegments segments.
+   *
+   * @param start_angle The angle at which the arc starts
+   * @param end_angle The angle at which the arc ends
+   * @param vertex The first of the vertices to write
+   */
+  void WriteArc(float start_angle, float end_angle, size_t vertex);
+
+  /**
+   * Write the two triangles of a sector of an annulus.
+   *
+   * @param start_angle The angle at which the sector starts
+   * @param end_angle The angle at which the sector ends
+   * @param inner_radius The inner radius of the sector
+   * @param outer_radius The outer radius of the sector
+   * @param vertex The first of the kLineVertices vertices to write
+   */
+  void WriteSector(float start_angle, float end_angle, float inner_radius,
+                   float outer_radius, size_t vertex);
 
-  std::vector<ci::Path2d> current_handles_;
   glm::vec2 center_;
-  float radius_;
+  float radius_ = 0;
   std::vector<float> division_radians_;
+  bool is_level_of_detail_ = false;
+  float zoom_ = 1;
+  glm::vec2 zoom_offset_ = glm::vec2(0, 0); // Shift of the zoomed center
+  std::vector<size_t> detailed_handles_; // Indices of drawn handles, sorted
+  std::vector<glm::vec2> handle_points_; // Centers of the drawn handles
+
+  // Tessellated geometry: the start cap, the outline, the density bands in
+  // level-of-detail mode, then the drawn handles
+  std::vector<glm::vec2> positions_;
+  size_t handle_vertex_ = 0; // The first vertex of the handles
+  size_t first_dirty_vertex_ = 0; // Vertices from here on are not uploaded
+  bool is_outline_dirty_ = false; // The outline and bands are not uploaded
+  size_t vertex_capacity_ = 0;
+  ci::gl::VboRef position_vbo_;
+  ci::gl::VboMeshRef mesh_;
 };
 
 } // namespace frontend
@@ -4,12 +4,12 @@
 #include "cinder/app/App.h"
 #include "cinder/app/RendererGl.h"
 #include "cinder/gl/gl.h"
-#include "cinder/Text.h"
 #include "cinder/params/Params.h"
 #include <core/scale_dataset.h>
 #include <core/synthesizer.h>
 #include <frontend/pie_graph.h>
 #include <frontend/keyboard.h>
+#include <frontend/text_renderer.h>
 
 namespace scalepiegraph {
 
@@ -19,6 +19,8 @@ class ScalePieGraphApp : public ci::app::App {
  public:
   ScalePieGraphApp();
 
+  void update() override;
+
   void draw() override;
 
   void mouseDown(ci::app::MouseEvent event) override;
@@ -27,8 +29,12 @@ class ScalePieGraphApp : public ci::app::App {
 
   void mouseDrag(ci::app::MouseEvent event) override;
 
+  void mouseWheel(ci::app::MouseEvent event) override;
+
   void keyDown(ci::app::KeyEvent event) override;
 
+  void keyUp(ci::app::KeyEvent event) override;
+
   void fileDrop(ci::app::FileDropEvent event) override;
 
   const double kMinWindowSize = 800;
@@ -38,6 +44,36 @@ class ScalePieGraphApp : public ci::app::App {
   const ci::Color kBackgroundColor = ci::Color("black");
   const ci::Color kTextColor = ci::Color("white");
   const size_t kMaxOctaves = 4;
+  const std::string kRenderStatsPath = "render_stats.json";
+  const std::string kRecordingPath = "recording.wav";
+  const double kPatternStepDuration = 0.15;
+  const size_t kArpeggioOctaves = 2;
+  const int kMidiMiddleKey = 60;
+  const double kMorphDuration = 0.75; // Seconds to glide between scales
+  const float kActiveFrameRate = 60;
+  const float kIdleFrameRate = 4; // Still feeds MIDI within its lookahead
+  const size_t kFramesBeforeIdle = 30;
+  const double kStatsRefreshSeconds = 0.25;
+  const size_t kPrefetchRadius = 2; // Neighbouring scales laid out ahead
+  const float kZoomStep = 1.25; // Zoom per notch of the mouse wheel
+
+  /**
+   * Check whether anything onscreen changed since the last drawn frame.
+   *
+   * @return True if the frame must be drawn again; otherwise, false
+   */
+  bool IsFrameDirty() const;
+
+  /**
+   * Draw the graph, keyboard and text into the current framebuffer.
+   */
+  void DrawFrame();
+
+  /**
+   * Mark the window to be drawn again and leave the idle frame rate, after
+   * input that may change what is onscreen.
+   */
+  void RequestRedraw();
 
   /**
    * Start the synthesizer at the specified note index using the current scale.
@@ -46,6 +82,22 @@ class ScalePieGraphApp : public ci::app::App {
    */
   void StartSynthesizer(size_t note_idx);
 
+  /**
+   * Start a note at the specified note index using the current scale,
+   * alongside any other sounding notes.
+   *
+   * @param note_idx The note index to start
+   */
+  void StartNote(size_t note_idx);
+
+  /**
+   * Get the note index that a key on the computer keyboard plays.
+   *
+   * @param event The keyboard event of the key
+   * @return The note index of the key; -1 if the key does not play a note
+   */
+  int GetKeyNoteIndex(ci::app::KeyEvent event) const;
+
   /**
    * Update the waveform of the synthesizer given a specified keyboard input.
    *
@@ -53,6 +105,22 @@ class ScalePieGraphApp : public ci::app::App {
    */
   void UpdateWaveform(ci::app::KeyEvent event);
 
+  /**
+   * Update the filter response of the synthesizer given a specified keyboard
+   * input.
+   *
+   * @param event The keyboard event to trigger the new filter response
+   */
+  void UpdateFilterMode(ci::app::KeyEvent event);
+
+  /**
+   * Match the additive timbre of the synthesizer to a scale, if the
+   * synthesizer is playing additively.
+   *
+   * @param scale The scale to which to match the timbre
+   */
+  void UpdateTimbre(const Scale& scale);
+
   /**
    * Translate keyboard events to note inputs to the synthesizer.
    *
@@ -60,6 +128,14 @@ class ScalePieGraphApp : public ci::app::App {
    */
   void HandleKeyboardNotes(ci::app::KeyEvent event);
 
+  /**
+   * Play a scale run or an arpeggio of the current scale given a specified
+   * keyboard input.
+   *
+   * @param event The keyboard event to trigger the pattern
+   */
+  void HandlePatterns(ci::app::KeyEvent event);
+
   /**
    * Translate keyboard events into transposition commands.
    *
@@ -67,13 +143,63 @@ class ScalePieGraphApp : public ci::app::App {
    */
   void HandleTransposition(ci::app::KeyEvent event);
 
+  /**
+   * Toggle or dump the audio render statistics given a specified keyboard
+   * input.
+   *
+   * @param event The keyboard event to trigger the statistics command
+   */
+  void HandleRenderStats(ci::app::KeyEvent event);
+
+  /**
+   * Draw the audio render statistics over the top left of the window.
+   */
+  void DrawRenderStats();
+
+  /**
+   * Play a dropped MIDI file retuned through the current scale.
+   *
+   * @param path The path of the MIDI file
+   */
+  void PlayMidiFile(const std::string& path);
+
+  /**
+   * Play a dropped WAV file as the instrument of every note.
+   *
+   * @param path The path of the WAV file
+   */
+  void PlaySample(const std::string& path);
+
+  /**
+   * Toggle whether sounding notes glide to each newly loaded scale given a
+   * specified keyboard input.
+   *
+   * @param event The keyboard event to trigger the toggle
+   */
+  void HandleMorphMode(ci::app::KeyEvent event);
+
+  /**
+   * Start or stop recording the synthesizer's output given a specified
+   * keyboard input.
+   *
+   * @param event The keyboard event to trigger the recording
+   */
+  void HandleRecording(ci::app::KeyEvent event);
+
   /**
    * Update the current scale to a scale with the specified name in the dataset.
+   * In morph mode, sounding notes glide from the old scale to the new one.
    *
    * @param new_scale_name The name of the new scale to load
    */
   void UpdateScale(const std::string& new_scale_name);
 
+  /**
+   * Lay out the descriptions of the scales around the current scale in the
+   * background, so stepping to them does not wait on text layout.
+   */
+  void PrefetchText();
+
   /**
    * Update the text displayed onscreen. Optional custom text overrides text
    * from the scale, instead displaying the given text in place of the title,
@@ -84,10 +210,21 @@ class ScalePieGraphApp : public ci::app::App {
   void UpdateText(const std::string& custom_text = "");
 
   bool is_ready_ = false; // App is not ready until the dataset is loaded
+  bool show_render_stats_ = false;
+  bool is_additive_ = false; // Timbre follows the scale as it is edited
+  bool is_morphing_ = false; // Sounding notes glide to each new scale
+  bool needs_redraw_ = true; // Input changed something outside the widgets
+  bool is_text_dirty_ = true;
+  bool is_idle_ = false; // Running at the idle frame rate
+  size_t num_clean_frames_ = 0; // Consecutive frames with nothing to draw
+  size_t num_frames_drawn_ = 0;
+  size_t num_frames_skipped_ = 0;
+  double last_stats_seconds_ = 0; // When render statistics were last drawn
   double current_width_;
   double current_height_;
   std::string title_;
   std::string info_;
+  std::string info_key_; // The scale whose description is shown
   glm::vec2 last_mouse_down_pos_;
   int current_handle_idx_ = -1;
   ScaleDataset scale_dataset_;
@@ -96,7 +233,8 @@ class ScalePieGraphApp : public ci::app::App {
   size_t current_transposition_ = 0;
   Scale current_scale_;
   size_t current_scale_idx_ = 0;
-  ci::gl::TextureRef text_box_texture_;
+  TextRenderer text_renderer_;
+  ci::gl::FboRef frame_fbo_; // The last drawn frame, shown while clean
   PieGraph last_graph_;
   PieGraph graph_;
   Keyboard keyboard_;
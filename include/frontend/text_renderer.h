@@ -0,0 +1,152 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cinder/Font.h>
+#include <cinder/gl/gl.h>
+#include <cinder/gl/TextureFont.h>
+#include <core/lru_cache.h>
+
+namespace scalepiegraph {
+
+namespace frontend {
+
+/**
+ * A class that draws text from a glyph atlas. Every glyph of the font is
+ * rasterized into the atlas once, so drawing text only places quads. Laid-out
+ * text is kept in least recently used caches, keyed by scale for wrapped
+ * descriptions and by the text itself for single lines, and the layouts of
+ * scales likely to be shown next can be prepared on a background thread.
+ */
+class TextRenderer {
+ public:
+  /**
+   * Create a text renderer, building the glyph atlas of a font. Requires a
+   * current OpenGL context.
+   *
+   * @param font The font with which to draw
+   * @param wrap_width The width at which wrapped text breaks into lines
+   * @param cache_capacity The number of layouts kept in each cache
+   */
+  TextRenderer(const ci::Font& font,
+               float wrap_width,
+               size_t cache_capacity = kDefaultCacheCapacity);
+
+  /**
+   * Stop preparing layouts and destroy this text renderer.
+   */
+  ~TextRenderer();
+
+  TextRenderer(const TextRenderer&) = delete;
+  TextRenderer& operator=(const TextRenderer&) = delete;
+
+  /**
+   * Draw text wrapped to the wrap width, laying it out only if the layout
+   * cached under its key is missing or of different text.
+   *
+   * @param key The key of the text, such as the name of its scale
+   * @param text The text to draw
+   * @param upper_left The upper left corner of the text
+   */
+  void DrawWrapped(const std::string& key,
+                   const std::string& text,
+                   const glm::vec2& upper_left);
+
+  /**
+   * Draw a single line of text centered on a position.
+   *
+   * @param text The text to draw
+   * @param center The position of the top center of the text
+   */
+  void DrawCentered(const std::string& text, const glm::vec2& center);
+
+  /**
+   * Draw a single line of text from its upper left corner.
+   *
+   * @param text The text to draw
+   * @param upper_left The upper left corner of the text
+   */
+  void DrawLine(const std::string& text, const glm::vec2& upper_left);
+
+  /**
+   * Lay out wrapped text on the background thread so that it is cached before
+   * it is drawn. Replaces any text still waiting to be laid out.
+   *
+   * @param entries The key and text of each layout to prepare
+   */
+  void Prefetch(
+      const std::vector<std::pair<std::string, std::string>>& entries);
+
+  /**
+   * Get the number of wrapped layouts in the cache.
+   *
+   * @return The number of cached wrapped layouts
+   */
+  size_t GetNumCached() const;
+
+  static const size_t kDefaultCacheCapacity;
+
+ private:
+  /**
+   * Text with the position of every glyph relative to its upper left corner.
+   */
+  struct TextLayout {
+    std::string text;
+    std::vector<std::pair<ci::Font::Glyph, glm::vec2>> glyphs;
+    float width;
+  };
+
+  typedef std::shared_ptr<const TextLayout> LayoutRef;
+  typedef LruCache<std::string, LayoutRef> LayoutCache;
+
+  /**
+   * Get a cached layout, laying out and caching the text if needed.
+   *
+   * @param cache The cache in which to look
+   * @param key The key of the layout
+   * @param text The text of the layout
+   * @param is_wrapped Whether the text wraps at the wrap width
+   * @return The layout of the text
+   */
+  LayoutRef GetLayout(LayoutCache& cache,
+                      const std::string& key,
+                      const std::string& text,
+                      bool is_wrapped);
+
+  /**
+   * Lay out text with the font.
+   *
+   * @param text The text to lay out
+   * @param is_wrapped Whether the text wraps at the wrap width
+   * @return The layout of the text
+   */
+  LayoutRef Layout(const std::string& text, bool is_wrapped) const;
+
+  /**
+   * Lay out prefetched text until this renderer is destroyed.
+   */
+  void RunPrefetch();
+
+  ci::gl::TextureFontRef atlas_;
+  ci::Rectf wrap_rect_;
+
+  mutable std::mutex font_mutex_; // Fonts are not safe to measure in parallel
+  mutable std::mutex cache_mutex_; // Guards both caches and the queue
+  LayoutCache wrapped_layouts_;
+  LayoutCache line_layouts_;
+  std::deque<std::pair<std::string, std::string>> pending_;
+  std::condition_variable pending_condition_;
+  bool is_stopping_ = false;
+  std::thread prefetch_thread_;
+};
+
+} // namespace frontend
+
+} // namespace scalepiegraph
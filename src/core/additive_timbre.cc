@@ -0,0 +1,114 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/additive_timbre.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace scalepiegraph {
+
+const size_t AdditiveTimbre::kMaxPartials;
+const size_t AdditiveTimbre::kDefaultNumHarmonics = 64;
+const double AdditiveTimbre::kDefaultRolloff = 1; // Like a sawtooth
+
+AdditiveTimbre::AdditiveTimbre() {
+  AddPartial(1, 1);
+}
+
+void AdditiveTimbre::AddPartial(double ratio, double amplitude) {
+  if (num_partials_ == kMaxPartials) {
+    throw std::out_of_range("Timbre is full.");
+  }
+
+  if (ratio <= 0 || amplitude < 0) {
+    throw std::out_of_range("Invalid partial.");
+  }
+
+  if (num_partials_ > 0 && ratio < ratios_[num_partials_ - 1]) {
+    throw std::out_of_range("Partials must be added in ascending order.");
+  }
+
+  ratios_[num_partials_] = static_cast<float>(ratio);
+  amplitudes_[num_partials_] = static_cast<float>(amplitude);
+  ++num_partials_;
+}
+
+void AdditiveTimbre::Clear() {
+  num_partials_ = 0;
+}
+
+float AdditiveTimbre::GetRatio(size_t partial_idx) const {
+  if (partial_idx >= num_partials_) {
+    throw std::out_of_range("Partial index exceeds size of timbre.");
+  }
+
+  return ratios_[partial_idx];
+}
+
+float AdditiveTimbre::GetAmplitude(size_t partial_idx) const {
+  if (partial_idx >= num_partials_) {
+    throw std::out_of_range("Partial index exceeds size of timbre.");
+  }
+
+  return amplitudes_[partial_idx];
+}
+
+size_t AdditiveTimbre::GetNumPartials() const {
+  return num_partials_;
+}
+
+AdditiveTimbre AdditiveTimbre::FromScale(const Scale& scale,
+                                         size_t num_harmonics,
+                                         double rolloff) {
+  if (num_harmonics == 0 || num_harmonics > kMaxPartials) {
+    throw std::out_of_range("Invalid number of harmonics.");
+  }
+
+  // Pitches of one period in cents, closed by the start of the next period
+  double period = Scale::kCentsInOctave * scale.GetNumOctaves();
+  std::vector<double> pitches = {0};
+  for (float proportion : scale.GetProportions()) {
+    pitches.push_back(proportion * period);
+  }
+  pitches.push_back(period);
+
+  std::vector<double> ratios;
+  std::vector<double> amplitudes;
+  for (size_t harmonic = 1; harmonic <= num_harmonics; ++harmonic) {
+    double cents = Scale::kCentsInOctave * std::log2(harmonic);
+    double period_start = std::floor(cents / period) * period;
+    double offset = cents - period_start;
+
+    auto above = std::lower_bound(pitches.begin(), pitches.end(), offset);
+    double nearest = *above;
+    if (above != pitches.begin() && offset - *(above - 1) < *above - offset) {
+      nearest = *(above - 1);
+    }
+
+    double ratio = std::exp2((period_start + nearest) / Scale::kCentsInOctave);
+    double amplitude = 1 / std::pow(harmonic, rolloff);
+
+    // Harmonics that land on the same pitch reinforce each other
+    if (!ratios.empty() && ratio <= ratios.back()) {
+      amplitudes.back() += amplitude;
+    } else {
+      ratios.push_back(ratio);
+      amplitudes.push_back(amplitude);
+    }
+  }
+
+  double power = 0;
+  for (double amplitude : amplitudes) {
+    power += amplitude * amplitude;
+  }
+
+  AdditiveTimbre timbre;
+  timbre.Clear();
+  for (size_t partial = 0; partial < ratios.size(); ++partial) {
+    timbre.AddPartial(ratios[partial], amplitudes[partial] / std::sqrt(power));
+  }
+
+  return timbre;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,114 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/batch_renderer.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace scalepiegraph {
+
+const double BatchRenderer::kDefaultNoteDuration = 0.25;
+
+double BatchReport::GetScalesPerSecond() const {
+  return seconds > 0 ? num_scales / seconds : 0;
+}
+
+double BatchReport::GetRealTimeFactor(double sample_rate) const {
+  return seconds > 0 ? num_frames / sample_rate / seconds : 0;
+}
+
+BatchRenderer::BatchRenderer(size_t num_workers,
+                             double note_duration,
+                             double sample_rate) :
+    num_workers_(num_workers),
+    note_duration_(note_duration),
+    sample_rate_(sample_rate) {
+  if (num_workers_ == 0) {
+    num_workers_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  if (note_duration <= 0) {
+    throw std::out_of_range("Note duration must be a positive real number");
+  }
+}
+
+BatchReport BatchRenderer::Render(const ScaleDataset& dataset,
+                                  const std::string& output_dir) const {
+  const std::vector<std::string>& names = dataset.GetNames();
+  std::atomic<size_t> num_frames(0);
+
+  auto start = std::chrono::steady_clock::now();
+
+  size_t num_threads = dataset.ForEachScale(num_workers_, [&]() {
+    // Each worker renders with its own engine, so nothing is shared
+    std::shared_ptr<OfflineRenderer> renderer =
+        std::make_shared<OfflineRenderer>(sample_rate_);
+
+    return [&, renderer](size_t index, const Scale& scale) {
+      std::vector<SequenceStep> run =
+          MakeRun(scale, note_duration_, waveform_, cutoff_);
+
+      num_frames += renderer->RenderToFile(
+          scale, run, output_dir + "/" + MakeFileName(index, names[index]));
+    };
+  });
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  BatchReport report;
+  report.num_scales = names.size();
+  report.num_frames = num_frames;
+  report.num_workers = num_threads;
+  report.seconds = elapsed.count();
+  return report;
+}
+
+void BatchRenderer::SetTimbre(Waveform waveform, float cutoff) {
+  waveform_ = waveform;
+  cutoff_ = cutoff;
+}
+
+size_t BatchRenderer::GetNumWorkers() const {
+  return num_workers_;
+}
+
+std::vector<SequenceStep> BatchRenderer::MakeRun(const Scale& scale,
+                                                 double note_duration,
+                                                 Waveform waveform,
+                                                 float cutoff) {
+  std::vector<SequenceStep> run;
+  size_t octave_index = scale.GetNumNotes(); // First note an octave up
+
+  for (size_t note_idx = 0; note_idx <= octave_index; ++note_idx) {
+    run.push_back({note_idx, note_duration, waveform, cutoff});
+  }
+
+  for (size_t note_idx = octave_index; note_idx-- > 0;) {
+    run.push_back({note_idx, note_duration, waveform, cutoff});
+  }
+
+  return run;
+}
+
+std::string BatchRenderer::MakeFileName(size_t index,
+                                        const std::string& scale_name,
+                                        const std::string& extension) {
+  std::string file_name = std::to_string(index) + "_";
+
+  for (char character : scale_name) {
+    if (std::isalnum(static_cast<unsigned char>(character)) ||
+        character == '-') {
+      file_name += character;
+    } else {
+      file_name += '_';
+    }
+  }
+
+  return file_name + extension;
+}
+
+} // namespace scalepiegraph
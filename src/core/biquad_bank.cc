@@ -0,0 +1,207 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/biquad_bank.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+using simd::Float4;
+
+const double BiquadBank::kDefaultCutoff = 200; // Matches FilterLowPassNode
+const double BiquadBank::kDefaultResonance = 0.7071; // Butterworth
+const double BiquadBank::kMinCutoff = 10;
+
+namespace {
+
+const double kTwoPi = 6.283185307179586;
+const double kMaxCutoffRatio = 0.49; // Of the sample rate, below Nyquist
+
+} // namespace
+
+BiquadBank::BiquadBank(size_t num_filters, double sample_rate, double cutoff) :
+    sample_rate_(sample_rate) {
+  if (num_filters == 0) {
+    throw std::out_of_range("Filter bank must have at least one filter.");
+  }
+
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  // Pad to whole SIMD groups; padding filters are never heard
+  num_filters_ =
+      (num_filters + simd::kLanes - 1) / simd::kLanes * simd::kLanes;
+
+  mode_ = std::vector<FilterMode>(num_filters_, FilterMode::kLowPass);
+  cutoff_ = std::vector<double>(num_filters_, cutoff);
+  resonance_ = std::vector<double>(num_filters_, kDefaultResonance);
+
+  for (std::vector<float>* coefficients :
+       {&b0_, &b1_, &b2_, &a1_, &a2_,
+        &b0_step_, &b1_step_, &b2_step_, &a1_step_, &a2_step_,
+        &b0_target_, &b1_target_, &b2_target_, &a1_target_, &a2_target_,
+        &z1_, &z2_}) {
+    *coefficients = std::vector<float>(num_filters_, 0);
+  }
+
+  SetSampleRate(sample_rate);
+}
+
+void BiquadBank::SetFilter(
+    size_t filter, FilterMode mode, double cutoff, double resonance) {
+  if (resonance <= 0) {
+    throw std::out_of_range("Resonance must be a positive real number");
+  }
+
+  mode_.at(filter) = mode;
+  resonance_[filter] = resonance;
+  SetCutoff(filter, cutoff);
+}
+
+void BiquadBank::SetCutoff(size_t filter, double cutoff) {
+  cutoff_.at(filter) = std::min(std::max(cutoff, kMinCutoff),
+                                kMaxCutoffRatio * sample_rate_);
+  CalculateTarget(filter);
+}
+
+void BiquadBank::Reset(size_t filter) {
+  b0_.at(filter) = b0_target_[filter];
+  b1_[filter] = b1_target_[filter];
+  b2_[filter] = b2_target_[filter];
+  a1_[filter] = a1_target_[filter];
+  a2_[filter] = a2_target_[filter];
+
+  b0_step_[filter] = 0;
+  b1_step_[filter] = 0;
+  b2_step_[filter] = 0;
+  a1_step_[filter] = 0;
+  a2_step_[filter] = 0;
+
+  z1_[filter] = 0;
+  z2_[filter] = 0;
+}
+
+void BiquadBank::Glide(size_t first, size_t end, size_t num_frames) {
+  float frames = static_cast<float>(std::max<size_t>(num_frames, 1));
+
+  for (size_t filter = first; filter < end; ++filter) {
+    b0_step_[filter] = (b0_target_[filter] - b0_[filter]) / frames;
+    b1_step_[filter] = (b1_target_[filter] - b1_[filter]) / frames;
+    b2_step_[filter] = (b2_target_[filter] - b2_[filter]) / frames;
+    a1_step_[filter] = (a1_target_[filter] - a1_[filter]) / frames;
+    a2_step_[filter] = (a2_target_[filter] - a2_[filter]) / frames;
+  }
+}
+
+void BiquadBank::Process(size_t first, float* samples, size_t num_frames) {
+  Float4 b0 = simd::Load(&b0_[first]);
+  Float4 b1 = simd::Load(&b1_[first]);
+  Float4 b2 = simd::Load(&b2_[first]);
+  Float4 a1 = simd::Load(&a1_[first]);
+  Float4 a2 = simd::Load(&a2_[first]);
+  Float4 b0_step = simd::Load(&b0_step_[first]);
+  Float4 b1_step = simd::Load(&b1_step_[first]);
+  Float4 b2_step = simd::Load(&b2_step_[first]);
+  Float4 a1_step = simd::Load(&a1_step_[first]);
+  Float4 a2_step = simd::Load(&a2_step_[first]);
+  Float4 z1 = simd::Load(&z1_[first]);
+  Float4 z2 = simd::Load(&z2_[first]);
+
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    b0 = b0 + b0_step;
+    b1 = b1 + b1_step;
+    b2 = b2 + b2_step;
+    a1 = a1 + a1_step;
+    a2 = a2 + a2_step;
+
+    // Transposed direct form II
+    float* frame_samples = samples + frame * simd::kLanes;
+    Float4 input = simd::Load(frame_samples);
+    Float4 output = b0 * input + z1;
+    z1 = b1 * input - a1 * output + z2;
+    z2 = b2 * input - a2 * output;
+
+    simd::Store(frame_samples, output);
+  }
+
+  simd::Store(&b0_[first], b0);
+  simd::Store(&b1_[first], b1);
+  simd::Store(&b2_[first], b2);
+  simd::Store(&a1_[first], a1);
+  simd::Store(&a2_[first], a2);
+  simd::Store(&z1_[first], z1);
+  simd::Store(&z2_[first], z2);
+}
+
+void BiquadBank::SetSampleRate(double sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  sample_rate_ = sample_rate;
+
+  for (size_t filter = 0; filter < num_filters_; ++filter) {
+    SetCutoff(filter, cutoff_[filter]);
+
+    // Keep the state; only the coefficients jump
+    float z1 = z1_[filter];
+    float z2 = z2_[filter];
+    Reset(filter);
+    z1_[filter] = z1;
+    z2_[filter] = z2;
+  }
+}
+
+size_t BiquadBank::GetNumFilters() const {
+  return num_filters_;
+}
+
+FilterMode BiquadBank::GetMode(size_t filter) const {
+  return mode_.at(filter);
+}
+
+double BiquadBank::GetCutoff(size_t filter) const {
+  return cutoff_.at(filter);
+}
+
+double BiquadBank::GetResonance(size_t filter) const {
+  return resonance_.at(filter);
+}
+
+void BiquadBank::CalculateTarget(size_t filter) {
+  // Coefficients from the Audio EQ Cookbook, normalized by a0
+  double omega = kTwoPi * cutoff_[filter] / sample_rate_;
+  double cos_omega = std::cos(omega);
+  double alpha = std::sin(omega) / (2 * resonance_[filter]);
+  double a0 = 1 + alpha;
+  double b0 = 0;
+  double b1 = 0;
+  double b2 = 0;
+
+  switch (mode_[filter]) {
+    case FilterMode::kLowPass:
+      b0 = (1 - cos_omega) / 2;
+      b1 = 1 - cos_omega;
+      b2 = b0;
+      break;
+    case FilterMode::kHighPass:
+      b0 = (1 + cos_omega) / 2;
+      b1 = -(1 + cos_omega);
+      b2 = b0;
+      break;
+    case FilterMode::kBandPass:
+      b0 = alpha; // Unity gain at the center frequency
+      b1 = 0;
+      b2 = -alpha;
+      break;
+  }
+
+  b0_target_[filter] = static_cast<float>(b0 / a0);
+  b1_target_[filter] = static_cast<float>(b1 / a0);
+  b2_target_[filter] = static_cast<float>(b2 / a0);
+  a1_target_[filter] = static_cast<float>(-2 * cos_omega / a0);
+  a2_target_[filter] = static_cast<float>((1 - alpha) / a0);
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,85 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/fft.h>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace scalepiegraph {
+
+namespace {
+
+const double kTwoPi = 6.283185307179586;
+
+} // namespace
+
+Fft::Fft(size_t size) : size_(size) {
+  if (size < 2 || (size & (size - 1)) != 0) {
+    throw std::out_of_range("FFT size must be a power of two.");
+  }
+
+  for (size_t index = 0; index < size_ / 2; ++index) {
+    twiddles_.push_back(std::polar(1.0, -kTwoPi * index / size_));
+  }
+
+  size_t num_bits = 0;
+  while ((size_t(1) << num_bits) < size_) {
+    ++num_bits;
+  }
+
+  for (size_t index = 0; index < size_; ++index) {
+    size_t reversed = 0;
+    for (size_t bit = 0; bit < num_bits; ++bit) {
+      reversed |= ((index >> bit) & 1) << (num_bits - 1 - bit);
+    }
+    bit_reversed_.push_back(reversed);
+  }
+
+  for (size_t index = 0; index < size_; ++index) {
+    hann_window_.push_back(0.5 - 0.5 * std::cos(kTwoPi * index / size_));
+  }
+}
+
+void Fft::Transform(std::complex<double>* data) const {
+  for (size_t index = 0; index < size_; ++index) {
+    if (index < bit_reversed_[index]) {
+      std::swap(data[index], data[bit_reversed_[index]]);
+    }
+  }
+
+  // Combine pairs of half-length transforms, doubling the length each pass
+  for (size_t length = 2; length <= size_; length *= 2) {
+    size_t half = length / 2;
+    size_t twiddle_stride = size_ / length;
+
+    for (size_t start = 0; start < size_; start += length) {
+      for (size_t offset = 0; offset < half; ++offset) {
+        std::complex<double> odd =
+            twiddles_[offset * twiddle_stride] * data[start + offset + half];
+        data[start + offset + half] = data[start + offset] - odd;
+        data[start + offset] += odd;
+      }
+    }
+  }
+}
+
+std::vector<double> Fft::GetHannMagnitudes(const float* samples) const {
+  std::vector<std::complex<double>> spectrum(size_);
+  for (size_t index = 0; index < size_; ++index) {
+    spectrum[index] = samples[index] * hann_window_[index];
+  }
+
+  Transform(spectrum.data());
+
+  std::vector<double> magnitudes(size_ / 2 + 1);
+  for (size_t bin = 0; bin < magnitudes.size(); ++bin) {
+    magnitudes[bin] = std::abs(spectrum[bin]);
+  }
+
+  return magnitudes;
+}
+
+size_t Fft::GetSize() const {
+  return size_;
+}
+
+} // namespace scalepiegraph
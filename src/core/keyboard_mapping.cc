@@ -0,0 +1,185 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/keyboard_mapping.h>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace scalepiegraph {
+
+const int KeyboardMapping::kNumKeys;
+const int KeyboardMapping::kUnmapped;
+
+namespace {
+
+/**
+ * Divide rounding towards negative infinity, so keys below the middle key
+ * fall into the previous repetition of the table.
+ */
+int FloorDivide(int dividend, int divisor) {
+  int quotient = dividend / divisor;
+  if ((dividend % divisor != 0) && ((dividend < 0) != (divisor < 0))) {
+    --quotient;
+  }
+  return quotient;
+}
+
+/**
+ * Read the next line of a Scala file that is not a comment.
+ */
+std::string ReadScalaLine(std::istream& input_stream) {
+  std::string line;
+
+  while (std::getline(input_stream, line)) {
+    if (!line.empty() && line[0] != '!') {
+      return line;
+    }
+  }
+
+  throw std::runtime_error("Truncated keyboard mapping.");
+}
+
+} // namespace
+
+KeyboardMapping::KeyboardMapping() :
+    KeyboardMapping(std::vector<int>(), 60, 69, 440.0) {}
+
+KeyboardMapping::KeyboardMapping(const std::vector<int>& mapping,
+                                 int middle_key,
+                                 int reference_key,
+                                 double reference_frequency,
+                                 int first_key,
+                                 int last_key,
+                                 int octave_degree) :
+    mapping_(mapping),
+    middle_key_(middle_key),
+    reference_key_(reference_key),
+    reference_frequency_(reference_frequency),
+    first_key_(first_key),
+    last_key_(last_key),
+    octave_degree_(octave_degree) {
+  Validate();
+}
+
+bool KeyboardMapping::IsMapped(uint8_t key) const {
+  if (key < first_key_ || key > last_key_) {
+    return false;
+  }
+
+  if (mapping_.empty()) {
+    return true;
+  }
+
+  int map_size = static_cast<int>(mapping_.size());
+  int offset = key - middle_key_;
+  int entry = offset - FloorDivide(offset, map_size) * map_size;
+
+  return mapping_[entry] != kUnmapped;
+}
+
+int KeyboardMapping::GetDegree(uint8_t key, size_t num_notes) const {
+  int offset = key - middle_key_;
+
+  if (mapping_.empty()) {
+    return offset;
+  }
+
+  if (!IsMapped(key)) {
+    throw std::out_of_range("Key is not mapped to a scale degree.");
+  }
+
+  int map_size = static_cast<int>(mapping_.size());
+  int repetition = FloorDivide(offset, map_size);
+  int octave_degree =
+      octave_degree_ > 0 ? octave_degree_ : static_cast<int>(num_notes);
+
+  return mapping_[offset - repetition * map_size] + repetition * octave_degree;
+}
+
+double KeyboardMapping::CalculateKeyFrequency(const Scale& scale,
+                                              uint8_t key) const {
+  if (!IsMapped(key)) {
+    throw std::out_of_range("Key is not mapped to a scale degree.");
+  }
+
+  size_t num_notes = scale.GetNumNotes();
+  double key_ratio =
+      CalculateDegreeRatio(scale, GetDegree(key, num_notes));
+  double reference_ratio = CalculateDegreeRatio(
+      scale, GetDegree(static_cast<uint8_t>(reference_key_), num_notes));
+
+  return reference_frequency_ * key_ratio / reference_ratio;
+}
+
+std::istream& operator>>(std::istream& input_stream,
+                         KeyboardMapping& mapping) {
+  try {
+    std::vector<int> fields;
+    for (size_t field = 0; field < 5; ++field) {
+      fields.push_back(std::stoi(ReadScalaLine(input_stream)));
+    }
+    double reference_frequency = std::stod(ReadScalaLine(input_stream));
+    int octave_degree = std::stoi(ReadScalaLine(input_stream));
+
+    int map_size = fields[0];
+    std::vector<int> table;
+    for (int entry = 0; entry < map_size; ++entry) {
+      std::istringstream entry_stream(ReadScalaLine(input_stream));
+      std::string value;
+      entry_stream >> value;
+
+      table.push_back(value == "x" || value == "X" ?
+                      KeyboardMapping::kUnmapped : std::stoi(value));
+    }
+
+    mapping = KeyboardMapping(table, fields[3], fields[4],
+                              reference_frequency, fields[1], fields[2],
+                              octave_degree);
+  } catch (std::logic_error&) {
+    // Malformed numbers and inconsistent fields are both invalid files
+    throw std::runtime_error("Invalid keyboard mapping.");
+  }
+
+  return input_stream;
+}
+
+double KeyboardMapping::CalculateDegreeRatio(const Scale& scale, int degree) {
+  int num_notes = static_cast<int>(scale.GetNumNotes());
+  int period = FloorDivide(degree, num_notes);
+  size_t note_index = static_cast<size_t>(degree - period * num_notes);
+
+  // Each period of the scale spans its number of octaves
+  return scale.CalculateNoteFrequency(note_index, 1.0f) *
+         std::pow(2.0, period * static_cast<int>(scale.GetNumOctaves()));
+}
+
+void KeyboardMapping::Validate() const {
+  if (first_key_ < 0 || last_key_ >= kNumKeys || first_key_ > last_key_) {
+    throw std::out_of_range("Mapped keys must be a range of MIDI keys.");
+  }
+
+  if (middle_key_ < 0 || middle_key_ >= kNumKeys ||
+      reference_key_ < 0 || reference_key_ >= kNumKeys) {
+    throw std::out_of_range("Middle and reference keys must be MIDI keys.");
+  }
+
+  if (reference_frequency_ <= 0) {
+    throw std::out_of_range("Reference frequency must be positive.");
+  }
+
+  if (octave_degree_ < 0) {
+    throw std::out_of_range("Octave degree must not be negative.");
+  }
+
+  for (int degree : mapping_) {
+    if (degree < kUnmapped) {
+      throw std::out_of_range("Mapped scale degrees must not be negative.");
+    }
+  }
+
+  if (!IsMapped(static_cast<uint8_t>(reference_key_))) {
+    throw std::out_of_range("The reference key must be mapped.");
+  }
+}
+
+} // namespace scalepiegraph
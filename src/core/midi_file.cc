@@ -0,0 +1,270 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/midi_file.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const uint32_t MidiFile::kDefaultTempo = 500000; // 120 beats per minute
+
+namespace {
+
+const size_t kChunkHeaderSize = 8;
+const size_t kHeaderSize = 6;
+const uint8_t kMetaEvent = 0xFF;
+const uint8_t kSysExEvent = 0xF0;
+const uint8_t kSysExEscape = 0xF7;
+const uint8_t kTempoMeta = 0x51;
+const uint8_t kEndOfTrackMeta = 0x2F;
+const uint8_t kNoteOff = 0x80;
+const uint8_t kNoteOn = 0x90;
+const uint8_t kProgramChange = 0xC0;
+const uint8_t kChannelPressure = 0xD0;
+
+/**
+ * The read position of one track while the tracks are merged.
+ */
+struct TrackCursor {
+  size_t position;
+  size_t end;
+  uint64_t tick = 0; // Absolute tick of the next event
+  uint8_t running_status = 0;
+  bool is_finished = false;
+};
+
+uint32_t ReadBigEndian(const std::vector<uint8_t>& bytes,
+                       size_t position,
+                       size_t num_bytes) {
+  if (position + num_bytes > bytes.size()) {
+    throw std::runtime_error("Truncated MIDI file.");
+  }
+
+  uint32_t value = 0;
+  for (size_t byte = 0; byte < num_bytes; ++byte) {
+    value = (value << 8) | bytes[position + byte];
+  }
+
+  return value;
+}
+
+uint8_t ReadByte(const std::vector<uint8_t>& bytes, TrackCursor& cursor) {
+  if (cursor.position >= cursor.end) {
+    throw std::runtime_error("Truncated MIDI track.");
+  }
+
+  return bytes[cursor.position++];
+}
+
+uint32_t ReadVariableLength(const std::vector<uint8_t>& bytes,
+                            TrackCursor& cursor) {
+  uint32_t value = 0;
+
+  // Quantities are at most four bytes of seven bits each
+  for (size_t byte = 0; byte < 4; ++byte) {
+    uint8_t next = ReadByte(bytes, cursor);
+    value = (value << 7) | (next & 0x7F);
+
+    if (!(next & 0x80)) {
+      return value;
+    }
+  }
+
+  throw std::runtime_error("Invalid MIDI variable-length quantity.");
+}
+
+void Skip(TrackCursor& cursor, size_t num_bytes) {
+  if (num_bytes > cursor.end - cursor.position) {
+    throw std::runtime_error("Truncated MIDI track.");
+  }
+
+  cursor.position += num_bytes;
+}
+
+/**
+ * Read the delta time of a cursor's next event, or finish its track.
+ */
+void AdvanceTick(const std::vector<uint8_t>& bytes, TrackCursor& cursor) {
+  if (cursor.position >= cursor.end) {
+    cursor.is_finished = true;
+    return;
+  }
+
+  cursor.tick += ReadVariableLength(bytes, cursor);
+}
+
+} // namespace
+
+MidiFile::MidiFile(const std::vector<uint8_t>& bytes) : bytes_(bytes) {
+  if (bytes_.size() < kChunkHeaderSize + kHeaderSize ||
+      std::string(bytes_.begin(), bytes_.begin() + 4) != "MThd") {
+    throw std::runtime_error("Not a Standard MIDI File.");
+  }
+
+  size_t header_length = ReadBigEndian(bytes_, 4, 4);
+  format_ = static_cast<uint16_t>(ReadBigEndian(bytes_, 8, 2));
+  size_t num_tracks = ReadBigEndian(bytes_, 10, 2);
+  uint16_t division = static_cast<uint16_t>(ReadBigEndian(bytes_, 12, 2));
+
+  if (format_ > 1) {
+    throw std::runtime_error("Only MIDI file formats 0 and 1 are supported.");
+  }
+
+  if (division & 0x8000) {
+    // SMPTE time: negative frames per second, then ticks per frame
+    int frames_per_second = -static_cast<int8_t>(division >> 8);
+    int ticks_per_frame = division & 0xFF;
+    if (frames_per_second <= 0 || ticks_per_frame == 0) {
+      throw std::runtime_error("Invalid MIDI time division.");
+    }
+
+    double frame_rate = frames_per_second == 29 ? 29.97 : frames_per_second;
+    seconds_per_smpte_tick_ = 1.0 / (frame_rate * ticks_per_frame);
+  } else if (division == 0) {
+    throw std::runtime_error("Invalid MIDI time division.");
+  } else {
+    ticks_per_quarter_ = division;
+  }
+
+  // Index the track chunks, skipping chunks of unknown types
+  size_t position = kChunkHeaderSize + header_length;
+  while (tracks_.size() < num_tracks && position < bytes_.size()) {
+    uint32_t chunk_length = ReadBigEndian(bytes_, position + 4, 4);
+    size_t begin = position + kChunkHeaderSize;
+
+    if (chunk_length > bytes_.size() - begin) {
+      throw std::runtime_error("Truncated MIDI file.");
+    }
+
+    if (std::string(bytes_.begin() + position,
+                    bytes_.begin() + position + 4) == "MTrk") {
+      tracks_.push_back({begin, begin + chunk_length});
+    }
+
+    position = begin + chunk_length;
+  }
+
+  if (tracks_.size() != num_tracks) {
+    throw std::runtime_error("MIDI file is missing tracks.");
+  }
+}
+
+MidiFile MidiFile::Load(const std::string& path) {
+  std::ifstream midi_file(path, std::ios::binary);
+  if (!midi_file.is_open()) {
+    throw std::runtime_error("Cannot open MIDI file " + path);
+  }
+
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(midi_file)),
+                             std::istreambuf_iterator<char>());
+  return MidiFile(bytes);
+}
+
+void MidiFile::ForEachNote(
+    const std::function<void(const MidiNote&)>& callback) const {
+  std::vector<TrackCursor> cursors;
+  for (const Track& track : tracks_) {
+    TrackCursor cursor;
+    cursor.position = track.begin;
+    cursor.end = track.end;
+    AdvanceTick(bytes_, cursor);
+    cursors.push_back(cursor);
+  }
+
+  uint32_t tempo = kDefaultTempo;
+  uint64_t last_tick = 0;
+  double time = 0;
+
+  while (true) {
+    // Take the earliest event; ties go to the lower track like a sequencer
+    TrackCursor* cursor = nullptr;
+    for (TrackCursor& candidate : cursors) {
+      if (!candidate.is_finished &&
+          (cursor == nullptr || candidate.tick < cursor->tick)) {
+        cursor = &candidate;
+      }
+    }
+
+    if (cursor == nullptr) {
+      return;
+    }
+
+    if (ticks_per_quarter_ > 0) {
+      time += (cursor->tick - last_tick) * (tempo / 1e6) / ticks_per_quarter_;
+    } else {
+      time += (cursor->tick - last_tick) * seconds_per_smpte_tick_;
+    }
+    last_tick = cursor->tick;
+
+    uint8_t status = ReadByte(bytes_, *cursor);
+    if (status & 0x80) {
+      if (status < kSysExEvent) {
+        cursor->running_status = status;
+      }
+    } else if (cursor->running_status) {
+      status = cursor->running_status;
+      --cursor->position; // The byte read was the first data byte
+    } else {
+      throw std::runtime_error("MIDI data byte without a status.");
+    }
+
+    if (status == kMetaEvent) {
+      uint8_t type = ReadByte(bytes_, *cursor);
+      uint32_t length = ReadVariableLength(bytes_, *cursor);
+
+      if (type == kEndOfTrackMeta) {
+        cursor->is_finished = true;
+        continue;
+      }
+
+      if (type == kTempoMeta && length == 3) {
+        tempo = ReadBigEndian(bytes_, cursor->position, 3);
+      }
+      Skip(*cursor, length);
+    } else if (status == kSysExEvent || status == kSysExEscape) {
+      Skip(*cursor, ReadVariableLength(bytes_, *cursor));
+    } else {
+      uint8_t type = status & 0xF0;
+
+      if (type == kNoteOn || type == kNoteOff) {
+        MidiNote note;
+        note.time = time;
+        note.channel = status & 0x0F;
+        note.key = ReadByte(bytes_, *cursor) & 0x7F;
+        note.velocity = ReadByte(bytes_, *cursor) & 0x7F;
+        note.is_note_on = type == kNoteOn && note.velocity > 0;
+        callback(note);
+      } else if (type == kProgramChange || type == kChannelPressure) {
+        Skip(*cursor, 1);
+      } else {
+        Skip(*cursor, 2);
+      }
+    }
+
+    AdvanceTick(bytes_, *cursor);
+  }
+}
+
+std::vector<MidiNote> MidiFile::GetNotes() const {
+  std::vector<MidiNote> notes;
+
+  ForEachNote([&notes](const MidiNote& note) {
+    notes.push_back(note);
+  });
+
+  return notes;
+}
+
+uint16_t MidiFile::GetFormat() const {
+  return format_;
+}
+
+size_t MidiFile::GetNumTracks() const {
+  return tracks_.size();
+}
+
+uint16_t MidiFile::GetTicksPerQuarter() const {
+  return ticks_per_quarter_;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,85 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/midi_player.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+MidiPlayer::MidiPlayer(const MidiFile& midi_file,
+                       const Scale& scale,
+                       const KeyboardMapping& mapping,
+                       double sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  // Tune each key once rather than once per note
+  std::vector<double> key_frequencies(KeyboardMapping::kNumKeys, 0);
+  for (int key = 0; key < KeyboardMapping::kNumKeys; ++key) {
+    if (mapping.IsMapped(static_cast<uint8_t>(key))) {
+      key_frequencies[key] =
+          mapping.CalculateKeyFrequency(scale, static_cast<uint8_t>(key));
+    }
+  }
+
+  midi_file.ForEachNote([&](const MidiNote& note) {
+    if (key_frequencies[note.key] <= 0) {
+      return; // Key has no scale degree
+    }
+
+    ParameterEvent event;
+    event.frame = static_cast<uint64_t>(std::llround(note.time * sample_rate));
+    event.note = GetNoteId(note.channel, note.key);
+
+    if (note.is_note_on) {
+      event.type = ParameterEvent::Type::kNoteOn;
+      event.value = key_frequencies[note.key];
+    } else {
+      event.type = ParameterEvent::Type::kNoteOff;
+    }
+
+    events_.push_back(event);
+  });
+}
+
+const std::vector<ParameterEvent>& MidiPlayer::GetEvents() const {
+  return events_;
+}
+
+uint64_t MidiPlayer::GetNumFrames() const {
+  return events_.empty() ? 0 : events_.back().frame;
+}
+
+void MidiPlayer::Start(uint64_t start_frame) {
+  start_frame_ = start_frame;
+  next_event_ = 0;
+}
+
+size_t MidiPlayer::Feed(SynthEngine& engine, uint64_t end_frame) {
+  size_t num_posted = 0;
+
+  while (next_event_ < events_.size() &&
+         start_frame_ + events_[next_event_].frame < end_frame) {
+    ParameterEvent event = events_[next_event_];
+    event.frame += start_frame_;
+
+    if (!engine.Post(event)) {
+      break; // Queue is full; retry on the next feed
+    }
+
+    ++next_event_;
+    ++num_posted;
+  }
+
+  return num_posted;
+}
+
+bool MidiPlayer::IsFinished() const {
+  return next_event_ == events_.size();
+}
+
+int MidiPlayer::GetNoteId(uint8_t channel, uint8_t key) {
+  return channel * KeyboardMapping::kNumKeys + key;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,215 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/offline_renderer.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <core/midi_player.h>
+#include <core/wav_writer.h>
+
+namespace scalepiegraph {
+
+const size_t OfflineRenderer::kDefaultBlockSize = 512;
+const double OfflineRenderer::kTailSeconds = 0.25;
+
+OfflineRenderer::OfflineRenderer(double sample_rate, size_t block_size) :
+    sample_rate_(sample_rate),
+    block_size_(block_size) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  if (block_size == 0) {
+    throw std::out_of_range("Block size must be at least one frame.");
+  }
+}
+
+std::vector<float> OfflineRenderer::Render(
+    const Scale& scale,
+    const std::vector<SequenceStep>& steps,
+    float base_freq) const {
+  std::vector<float> samples;
+  samples.reserve(GetNumFrames(steps));
+
+  std::vector<ParameterEvent> events;
+  uint64_t total_frames =
+      LayOutEvents(scale, steps, base_freq, &events) + ToFrames(kTailSeconds);
+
+  SynthEngine engine(sample_rate_);
+  RenderBlocks(engine, events, total_frames,
+               [&samples](const float* block, size_t num_frames) {
+    samples.insert(samples.end(), block, block + num_frames);
+  });
+
+  return samples;
+}
+
+std::vector<float> OfflineRenderer::RenderPattern(const Pattern& pattern,
+                                                  double seconds) const {
+  if (seconds < 0) {
+    throw std::out_of_range("Render length must not be negative.");
+  }
+
+  std::vector<float> samples;
+  uint64_t total_frames = ToFrames(seconds);
+  samples.reserve(total_frames);
+
+  ParameterEvent play_event;
+  play_event.type = ParameterEvent::Type::kPlayPattern;
+
+  SynthEngine engine(sample_rate_);
+  engine.SetPattern(pattern);
+  RenderBlocks(engine, {play_event}, total_frames,
+               [&samples](const float* block, size_t num_frames) {
+    samples.insert(samples.end(), block, block + num_frames);
+  });
+
+  return samples;
+}
+
+size_t OfflineRenderer::RenderToFile(const Scale& scale,
+                                     const std::vector<SequenceStep>& steps,
+                                     const std::string& path,
+                                     float base_freq) const {
+  WavWriter writer(path, sample_rate_);
+
+  std::vector<ParameterEvent> events;
+  uint64_t total_frames =
+      LayOutEvents(scale, steps, base_freq, &events) + ToFrames(kTailSeconds);
+
+  SynthEngine engine(sample_rate_);
+  RenderBlocks(engine, events, total_frames,
+               [&writer](const float* block, size_t num_frames) {
+    writer.Write(block, num_frames);
+  });
+
+  writer.Close();
+  return writer.GetNumFrames();
+}
+
+std::vector<float> OfflineRenderer::RenderMidi(
+    const MidiFile& midi_file,
+    const Scale& scale,
+    const KeyboardMapping& mapping) const {
+  MidiPlayer player(midi_file, scale, mapping, sample_rate_);
+  uint64_t total_frames = player.GetNumFrames() + ToFrames(kTailSeconds);
+
+  std::vector<float> samples;
+  samples.reserve(total_frames);
+
+  SynthEngine engine(sample_rate_);
+  RenderBlocks(engine, player.GetEvents(), total_frames,
+               [&samples](const float* block, size_t num_frames) {
+    samples.insert(samples.end(), block, block + num_frames);
+  });
+
+  return samples;
+}
+
+size_t OfflineRenderer::RenderMidiToFile(
+    const MidiFile& midi_file,
+    const Scale& scale,
+    const std::string& path,
+    const KeyboardMapping& mapping) const {
+  MidiPlayer player(midi_file, scale, mapping, sample_rate_);
+  uint64_t total_frames = player.GetNumFrames() + ToFrames(kTailSeconds);
+
+  WavWriter writer(path, sample_rate_);
+
+  SynthEngine engine(sample_rate_);
+  RenderBlocks(engine, player.GetEvents(), total_frames,
+               [&writer](const float* block, size_t num_frames) {
+    writer.Write(block, num_frames);
+  });
+
+  writer.Close();
+  return writer.GetNumFrames();
+}
+
+size_t OfflineRenderer::GetNumFrames(
+    const std::vector<SequenceStep>& steps) const {
+  uint64_t num_frames = ToFrames(kTailSeconds);
+
+  for (const SequenceStep& step : steps) {
+    if (step.duration < 0) {
+      throw std::out_of_range("Step durations must not be negative.");
+    }
+
+    num_frames += ToFrames(step.duration);
+  }
+
+  return num_frames;
+}
+
+double OfflineRenderer::GetSampleRate() const {
+  return sample_rate_;
+}
+
+uint64_t OfflineRenderer::LayOutEvents(
+    const Scale& scale,
+    const std::vector<SequenceStep>& steps,
+    float base_freq,
+    std::vector<ParameterEvent>* events) const {
+  uint64_t frame = 0;
+
+  for (size_t step_idx = 0; step_idx < steps.size(); ++step_idx) {
+    const SequenceStep& step = steps[step_idx];
+    if (step.duration < 0) {
+      throw std::out_of_range("Step durations must not be negative.");
+    }
+
+    ParameterEvent event;
+    event.frame = frame;
+    event.note = static_cast<int>(step_idx);
+
+    event.type = ParameterEvent::Type::kWaveform;
+    event.value = static_cast<int>(step.waveform);
+    events->push_back(event);
+
+    event.type = ParameterEvent::Type::kFilterCutoff;
+    event.value = step.cutoff;
+    events->push_back(event);
+
+    event.type = ParameterEvent::Type::kNoteOn;
+    event.value = scale.CalculateNoteFrequency(step.note_index, base_freq);
+    events->push_back(event);
+
+    frame += ToFrames(step.duration);
+
+    event.type = ParameterEvent::Type::kNoteOff;
+    event.frame = frame;
+    events->push_back(event);
+  }
+
+  return frame;
+}
+
+template <typename Sink>
+void OfflineRenderer::RenderBlocks(SynthEngine& engine,
+                                   const std::vector<ParameterEvent>& events,
+                                   uint64_t total_frames,
+                                   Sink sink) const {
+  std::vector<float> block(block_size_);
+  size_t next_event = 0;
+
+  for (uint64_t block_start = 0;
+       block_start < total_frames;
+       block_start += block_size_) {
+    size_t num_frames = static_cast<size_t>(
+        std::min<uint64_t>(block_size_, total_frames - block_start));
+
+    // Feed only this block's events so the queue never overflows
+    while (next_event < events.size() &&
+           events[next_event].frame < block_start + num_frames) {
+      engine.Post(events[next_event++]);
+    }
+
+    engine.Render(block.data(), num_frames);
+    sink(block.data(), num_frames);
+  }
+}
+
+uint64_t OfflineRenderer::ToFrames(double seconds) const {
+  return static_cast<uint64_t>(std::llround(seconds * sample_rate_));
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,86 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/parameter_queue.h>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t ParameterQueue::kDefaultCapacity = 1024;
+
+ParameterQueue::ParameterQueue(size_t capacity) :
+    head_(0),
+    tail_(0),
+    max_depth_(0),
+    num_dropped_(0) {
+  if (capacity == 0) {
+    throw std::out_of_range("Parameter queue must hold at least one event.");
+  }
+
+  size_t rounded_capacity = 1;
+  while (rounded_capacity < capacity) {
+    rounded_capacity <<= 1;
+  }
+
+  events_ = std::vector<ParameterEvent>(rounded_capacity);
+  mask_ = rounded_capacity - 1;
+}
+
+bool ParameterQueue::Push(const ParameterEvent& event) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  size_t head = head_.load(std::memory_order_acquire);
+
+  if (tail - head == events_.size()) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false; // Queue is full
+  }
+
+  events_[tail & mask_] = event;
+  tail_.store(tail + 1, std::memory_order_release);
+
+  // Only the producer raises the high-water mark, so a plain compare suffices
+  size_t depth = tail + 1 - head;
+  if (depth > max_depth_.load(std::memory_order_relaxed)) {
+    max_depth_.store(depth, std::memory_order_relaxed);
+  }
+
+  return true;
+}
+
+const ParameterEvent* ParameterQueue::Peek() const {
+  size_t head = head_.load(std::memory_order_relaxed);
+
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return nullptr; // Queue is empty
+  }
+
+  return &events_[head & mask_];
+}
+
+void ParameterQueue::Pop() {
+  size_t head = head_.load(std::memory_order_relaxed);
+  head_.store(head + 1, std::memory_order_release);
+}
+
+size_t ParameterQueue::GetDepth() const {
+  // Read the head first so a concurrent pop can never make the depth negative
+  size_t head = head_.load(std::memory_order_acquire);
+  return tail_.load(std::memory_order_acquire) - head;
+}
+
+size_t ParameterQueue::GetMaxDepth() const {
+  return max_depth_.load(std::memory_order_relaxed);
+}
+
+size_t ParameterQueue::GetNumDropped() const {
+  return num_dropped_.load(std::memory_order_relaxed);
+}
+
+size_t ParameterQueue::GetCapacity() const {
+  return events_.size();
+}
+
+void ParameterQueue::ResetStatistics() {
+  max_depth_.store(0, std::memory_order_relaxed);
+  num_dropped_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace scalepiegraph
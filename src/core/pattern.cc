@@ -0,0 +1,179 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/pattern.h>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t Pattern::kMaxSteps;
+const double Pattern::kDefaultGate = 0.8;
+
+namespace {
+
+/**
+ * Pick evenly spaced indices into a run of items, keeping the first and last.
+ *
+ * @param num_items The number of items in the run
+ * @param max_items The maximum number of indices to pick; at least 2
+ * @return Every index if the run fits, or max_items spread over the run
+ */
+std::vector<size_t> SpreadIndices(size_t num_items, size_t max_items) {
+  std::vector<size_t> indices;
+
+  if (num_items <= max_items) {
+    for (size_t item_idx = 0; item_idx < num_items; ++item_idx) {
+      indices.push_back(item_idx);
+    }
+    return indices;
+  }
+
+  for (size_t pick = 0; pick < max_items; ++pick) {
+    indices.push_back(pick * (num_items - 1) / (max_items - 1));
+  }
+  return indices;
+}
+
+} // namespace
+
+Pattern::Pattern() = default;
+
+void Pattern::AddNote(double frequency, double duration, double gate) {
+  if (frequency <= 0) {
+    throw std::out_of_range("Note frequency must be a positive real number");
+  }
+
+  PatternStep step;
+  step.frequency = frequency;
+  step.duration = duration;
+  step.gate = gate;
+  AddStep(step);
+}
+
+void Pattern::AddRest(double duration) {
+  PatternStep step;
+  step.duration = duration;
+  AddStep(step);
+}
+
+const PatternStep& Pattern::GetStep(size_t step_idx) const {
+  if (step_idx >= num_steps_) {
+    throw std::out_of_range("Pattern step index out of range.");
+  }
+
+  return steps_[step_idx];
+}
+
+size_t Pattern::GetNumSteps() const {
+  return num_steps_;
+}
+
+double Pattern::GetDuration() const {
+  double duration = 0;
+
+  for (size_t step_idx = 0; step_idx < num_steps_; ++step_idx) {
+    duration += steps_[step_idx].duration;
+  }
+
+  return duration;
+}
+
+void Pattern::SetLooping(bool is_looping) {
+  is_looping_ = is_looping;
+}
+
+bool Pattern::IsLooping() const {
+  return is_looping_;
+}
+
+Pattern Pattern::ScaleRun(const Scale& scale,
+                          double step_duration,
+                          float base_freq) {
+  // The run up and the run down share their top note
+  std::vector<size_t> note_indices =
+      SpreadIndices(scale.GetNumNotes() + 1, (kMaxSteps + 1) / 2);
+
+  Pattern pattern;
+  for (size_t note_idx : note_indices) {
+    pattern.AddNote(scale.CalculateNoteFrequency(note_idx, base_freq),
+                    step_duration);
+  }
+
+  for (size_t run_idx = note_indices.size() - 1; run_idx-- > 0;) {
+    pattern.AddNote(
+        scale.CalculateNoteFrequency(note_indices[run_idx], base_freq),
+        step_duration);
+  }
+
+  return pattern;
+}
+
+Pattern Pattern::Arpeggio(const Scale& scale,
+                          const std::vector<size_t>& chord,
+                          ArpeggioMode mode,
+                          size_t num_octaves,
+                          double step_duration,
+                          float base_freq) {
+  if (chord.empty() || num_octaves == 0) {
+    throw std::out_of_range("An arpeggio needs at least one note.");
+  }
+
+  // Spread the chord over the requested periods of the scale, lowest first
+  std::vector<double> all_frequencies;
+  for (size_t octave = 0; octave < num_octaves; ++octave) {
+    float octave_base = static_cast<float>(
+        base_freq * std::pow(2.0, octave * scale.GetNumOctaves()));
+
+    for (size_t note_idx : chord) {
+      all_frequencies.push_back(
+          scale.CalculateNoteFrequency(note_idx, octave_base));
+    }
+  }
+
+  // The way back down repeats all but the top and bottom notes
+  size_t max_notes =
+      mode == ArpeggioMode::kUpDown ? (kMaxSteps + 2) / 2 : kMaxSteps;
+  std::vector<double> frequencies;
+  for (size_t freq_idx : SpreadIndices(all_frequencies.size(), max_notes)) {
+    frequencies.push_back(all_frequencies[freq_idx]);
+  }
+
+  Pattern pattern;
+  pattern.SetLooping(true);
+
+  if (mode == ArpeggioMode::kUp || mode == ArpeggioMode::kUpDown) {
+    for (double frequency : frequencies) {
+      pattern.AddNote(frequency, step_duration);
+    }
+  }
+
+  if (mode == ArpeggioMode::kDown) {
+    for (size_t freq_idx = frequencies.size(); freq_idx-- > 0;) {
+      pattern.AddNote(frequencies[freq_idx], step_duration);
+    }
+  } else if (mode == ArpeggioMode::kUpDown) {
+    // Skip the top and bottom notes so they are not repeated when looping
+    for (size_t freq_idx = frequencies.size() - 1; freq_idx-- > 1;) {
+      pattern.AddNote(frequencies[freq_idx], step_duration);
+    }
+  }
+
+  return pattern;
+}
+
+void Pattern::AddStep(const PatternStep& step) {
+  if (num_steps_ == kMaxSteps) {
+    throw std::out_of_range("Pattern is full.");
+  }
+
+  if (step.duration <= 0) {
+    throw std::out_of_range("Step duration must be a positive real number");
+  }
+
+  if (step.gate < 0 || step.gate > 1) {
+    throw std::out_of_range("Step gate must be between 0 and 1.");
+  }
+
+  steps_[num_steps_++] = step;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,161 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/performance_analyzer.h>
+#include <core/wav_reader.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t PerformanceAnalyzer::kDefaultHopFrames = 512;
+const size_t PerformanceAnalyzer::kFileBlockFrames = 8192;
+
+Json::Value PerformanceReport::ToJson() const {
+  Json::Value root;
+
+  root["scale_name"] = scale_name;
+  root["base_frequency"] = base_frequency;
+  root["seconds"] = seconds;
+  root["num_windows"] = Json::UInt64(num_windows);
+  root["num_pitched_windows"] = Json::UInt64(num_pitched_windows);
+  root["mean_abs_cents"] = mean_abs_cents;
+
+  Json::Value note_array(Json::arrayValue);
+  for (const NoteDeviation& note : notes) {
+    Json::Value note_value;
+    note_value["num_windows"] = Json::UInt64(note.num_windows);
+    note_value["mean_cents"] = note.mean_cents;
+    note_value["rms_cents"] = note.rms_cents;
+    note_value["max_cents"] = note.max_cents;
+    note_array.append(note_value);
+  }
+  root["notes"] = note_array;
+
+  return root;
+}
+
+std::ostream& operator<<(std::ostream& output_stream,
+                         const PerformanceReport& report) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+  writer->write(report.ToJson(), &output_stream);
+
+  return output_stream << std::endl;
+}
+
+PerformanceAnalyzer::PerformanceAnalyzer(const Scale& scale,
+                                         double base_frequency,
+                                         double sample_rate,
+                                         size_t hop_frames) :
+    scale_(scale),
+    base_frequency_(base_frequency),
+    sample_rate_(sample_rate),
+    hop_frames_(hop_frames),
+    detector_(sample_rate) {
+  if (base_frequency <= 0) {
+    throw std::out_of_range("Base frequency must be a positive real number");
+  }
+
+  window_ = std::vector<float>(detector_.GetInputFrames(), 0);
+
+  if (hop_frames == 0 || hop_frames > window_.size()) {
+    throw std::out_of_range("Invalid hop size.");
+  }
+
+  note_windows_ = std::vector<size_t>(scale_.GetNumNotes(), 0);
+  note_sums_ = std::vector<double>(scale_.GetNumNotes(), 0);
+  note_squares_ = std::vector<double>(scale_.GetNumNotes(), 0);
+  note_maxima_ = std::vector<double>(scale_.GetNumNotes(), 0);
+}
+
+void PerformanceAnalyzer::Process(const float* samples, size_t num_frames) {
+  num_frames_ += num_frames;
+
+  while (num_frames > 0) {
+    size_t num_copied = std::min(num_frames, window_.size() - num_buffered_);
+    std::copy(samples, samples + num_copied,
+              window_.begin() + num_buffered_);
+    num_buffered_ += num_copied;
+    samples += num_copied;
+    num_frames -= num_copied;
+
+    if (num_buffered_ == window_.size()) {
+      AnalyzeWindow();
+
+      // Keep the overlap with the next window
+      std::copy(window_.begin() + hop_frames_, window_.end(), window_.begin());
+      num_buffered_ -= hop_frames_;
+    }
+  }
+}
+
+PerformanceReport PerformanceAnalyzer::GetReport() const {
+  PerformanceReport report;
+  report.scale_name = scale_.GetName();
+  report.base_frequency = base_frequency_;
+  report.seconds = num_frames_ / sample_rate_;
+  report.num_windows = num_windows_;
+
+  for (size_t note = 0; note < note_windows_.size(); ++note) {
+    NoteDeviation deviation;
+    deviation.num_windows = note_windows_[note];
+
+    if (deviation.num_windows > 0) {
+      deviation.mean_cents = note_sums_[note] / deviation.num_windows;
+      deviation.rms_cents =
+          std::sqrt(note_squares_[note] / deviation.num_windows);
+      deviation.max_cents = note_maxima_[note];
+    }
+
+    report.num_pitched_windows += deviation.num_windows;
+    report.notes.push_back(deviation);
+  }
+
+  if (report.num_pitched_windows > 0) {
+    report.mean_abs_cents = total_abs_cents_ / report.num_pitched_windows;
+  }
+
+  return report;
+}
+
+PerformanceReport PerformanceAnalyzer::AnalyzeFile(const std::string& path,
+                                                   const Scale& scale,
+                                                   double base_frequency) {
+  WavReader reader(path);
+  PerformanceAnalyzer analyzer(scale, base_frequency, reader.GetSampleRate());
+  std::vector<float> block(kFileBlockFrames);
+
+  size_t first_frame = 0;
+  size_t num_read;
+  while ((num_read = reader.Read(first_frame, block.data(), block.size())) >
+         0) {
+    analyzer.Process(block.data(), num_read);
+    first_frame += num_read;
+  }
+
+  return analyzer.GetReport();
+}
+
+void PerformanceAnalyzer::AnalyzeWindow() {
+  ++num_windows_;
+
+  PitchEstimate estimate = detector_.Detect(window_.data());
+  if (estimate.frequency == 0) {
+    return; // Rests, breaths and noise are not scored
+  }
+
+  NearestNote nearest = scale_.FindNearestNote(
+      Scale::kCentsInOctave * std::log2(estimate.frequency / base_frequency_));
+
+  total_abs_cents_ += std::fabs(nearest.deviation);
+  note_windows_[nearest.note_index] += 1;
+  note_sums_[nearest.note_index] += nearest.deviation;
+  note_squares_[nearest.note_index] += nearest.deviation * nearest.deviation;
+  note_maxima_[nearest.note_index] = std::max(
+      note_maxima_[nearest.note_index], std::fabs(nearest.deviation));
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,111 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/pitch_detector.h>
+#include <core/simd.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+using simd::Float4;
+
+const double PitchDetector::kDefaultMinFrequency = 60;
+const double PitchDetector::kDefaultMaxFrequency = 2000;
+const size_t PitchDetector::kDefaultWindowFrames = 1024;
+const double PitchDetector::kThreshold = 0.15;
+const double PitchDetector::kSilence = 0.003; // About -50 dBFS
+
+PitchDetector::PitchDetector(double sample_rate,
+                             double min_frequency,
+                             double max_frequency,
+                             size_t window_frames) :
+    sample_rate_(sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  if (min_frequency <= 0 || max_frequency <= min_frequency ||
+      max_frequency > sample_rate / 4) {
+    throw std::out_of_range("Invalid frequency range.");
+  }
+
+  if (window_frames == 0) {
+    throw std::out_of_range("Window must have at least one frame.");
+  }
+
+  window_frames_ =
+      (window_frames + simd::kLanes - 1) / simd::kLanes * simd::kLanes;
+
+  // Parabolic interpolation looks one lag either side of the period
+  min_lag_ = std::max<size_t>(
+      2, static_cast<size_t>(std::floor(sample_rate / max_frequency)));
+  max_lag_ = static_cast<size_t>(std::ceil(sample_rate / min_frequency)) + 1;
+
+  difference_ = std::vector<float>(max_lag_ + 1, 0);
+}
+
+PitchEstimate PitchDetector::Detect(const float* input) {
+  PitchEstimate estimate;
+
+  Float4 energy = simd::Splat(0);
+  for (size_t frame = 0; frame < window_frames_; frame += simd::kLanes) {
+    Float4 samples = simd::Load(input + frame);
+    energy = energy + samples * samples;
+  }
+
+  if (simd::HorizontalSum(energy) < kSilence * kSilence * window_frames_) {
+    return estimate;
+  }
+
+  // Cumulative mean normalized difference, one lag at a time
+  double running_sum = 0;
+  difference_[0] = 1;
+  for (size_t lag = 1; lag <= max_lag_; ++lag) {
+    Float4 sum = simd::Splat(0);
+    for (size_t frame = 0; frame < window_frames_; frame += simd::kLanes) {
+      Float4 delta =
+          simd::Load(input + frame) - simd::Load(input + frame + lag);
+      sum = sum + delta * delta;
+    }
+
+    float difference = simd::HorizontalSum(sum);
+    running_sum += difference;
+    difference_[lag] = running_sum > 0
+        ? static_cast<float>(difference * lag / running_sum)
+        : 1.0f;
+  }
+
+  // The first dip below the threshold, followed down to its minimum, is the
+  // period; later dips are its multiples
+  size_t period = 0;
+  for (size_t lag = min_lag_; lag < max_lag_; ++lag) {
+    if (difference_[lag] < kThreshold) {
+      period = lag;
+      while (period + 1 < max_lag_ &&
+             difference_[period + 1] < difference_[period]) {
+        ++period;
+      }
+      break;
+    }
+  }
+
+  if (period == 0) {
+    return estimate;
+  }
+
+  double before = difference_[period - 1];
+  double at = difference_[period];
+  double after = difference_[period + 1];
+  double curvature = before - 2 * at + after;
+  double offset = curvature > 0 ? (before - after) / (2 * curvature) : 0;
+
+  estimate.frequency = sample_rate_ / (period + offset);
+  estimate.aperiodicity = at;
+  return estimate;
+}
+
+size_t PitchDetector::GetInputFrames() const {
+  return window_frames_ + max_lag_;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,259 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/realtime_checker.h>
+#include <atomic>
+#include <cstdlib>
+#include <sstream>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define SCALEPIEGRAPH_HAS_BACKTRACE
+#include <execinfo.h>
+#endif
+
+#if defined(SCALEPIEGRAPH_RT_CHECK) && defined(__GLIBC__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <typeinfo>
+#elif defined(SCALEPIEGRAPH_RT_CHECK)
+#include <new>
+#endif
+
+namespace scalepiegraph {
+
+namespace realtime {
+
+const size_t Violation::kMaxStackDepth;
+
+namespace {
+
+// Plain thread-local integers need no allocation to access, so they are safe
+// to read from inside the allocation hooks
+thread_local int audio_thread_depth = 0;
+thread_local bool is_reporting = false;
+
+Violation violations[kMaxViolations];
+std::atomic<bool> is_recorded[kMaxViolations];
+std::atomic<size_t> num_violations(0);
+
+const char* GetViolationName(ViolationType type) {
+  switch (type) {
+    case ViolationType::kAllocation:
+      return "allocation";
+    case ViolationType::kDeallocation:
+      return "deallocation";
+    case ViolationType::kMutexLock:
+      return "mutex lock";
+    case ViolationType::kThrow:
+      return "exception throw";
+  }
+  return "unknown";
+}
+
+#if defined(SCALEPIEGRAPH_HAS_BACKTRACE)
+/**
+ * The first backtrace loads the unwinder, which allocates, so it is taken
+ * during static initialization rather than on the audio thread.
+ */
+struct BacktraceWarmup {
+  BacktraceWarmup() {
+    void* frame;
+    backtrace(&frame, 1);
+  }
+} backtrace_warmup;
+#endif
+
+} // namespace
+
+AudioThreadScope::AudioThreadScope() {
+  ++audio_thread_depth;
+}
+
+AudioThreadScope::~AudioThreadScope() {
+  --audio_thread_depth;
+}
+
+bool IsEnabled() {
+#if defined(SCALEPIEGRAPH_RT_CHECK)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool IsAudioThread() {
+  return audio_thread_depth > 0;
+}
+
+void ReportViolation(ViolationType type) {
+  // Operations made while capturing a violation are not violations themselves
+  if (!IsAudioThread() || is_reporting) {
+    return;
+  }
+  is_reporting = true;
+
+  size_t index = num_violations.fetch_add(1, std::memory_order_relaxed);
+  if (index < kMaxViolations) {
+    Violation& violation = violations[index];
+    violation.type = type;
+#if defined(SCALEPIEGRAPH_HAS_BACKTRACE)
+    violation.stack_depth = static_cast<size_t>(
+        backtrace(violation.stack, Violation::kMaxStackDepth));
+#else
+    violation.stack_depth = 0;
+#endif
+    is_recorded[index].store(true, std::memory_order_release);
+  }
+
+  is_reporting = false;
+}
+
+size_t GetNumViolations() {
+  return num_violations.load(std::memory_order_relaxed);
+}
+
+std::vector<Violation> GetViolations() {
+  std::vector<Violation> recorded;
+
+  for (size_t index = 0; index < kMaxViolations; ++index) {
+    if (is_recorded[index].load(std::memory_order_acquire)) {
+      recorded.push_back(violations[index]);
+    }
+  }
+
+  return recorded;
+}
+
+std::string DescribeViolations() {
+  std::ostringstream description;
+
+  for (const Violation& violation : GetViolations()) {
+    description << "Real-time violation: "
+                << GetViolationName(violation.type) << " on the audio thread"
+                << std::endl;
+
+#if defined(SCALEPIEGRAPH_HAS_BACKTRACE)
+    char** symbols = backtrace_symbols(
+        violation.stack, static_cast<int>(violation.stack_depth));
+    for (size_t frame = 0; symbols && frame < violation.stack_depth; ++frame) {
+      description << "  " << symbols[frame] << std::endl;
+    }
+    std::free(symbols);
+#endif
+  }
+
+  return description.str();
+}
+
+void ClearViolations() {
+  for (std::atomic<bool>& recorded : is_recorded) {
+    recorded.store(false, std::memory_order_relaxed);
+  }
+  num_violations.store(0, std::memory_order_release);
+}
+
+} // namespace realtime
+
+} // namespace scalepiegraph
+
+#if defined(SCALEPIEGRAPH_RT_CHECK) && defined(__GLIBC__)
+
+// glibc lets an executable replace malloc and its siblings and exports the
+// real implementations, which also catches every operator new and delete.
+// Mutex locks and throws are forwarded to the next definition in link order.
+
+using scalepiegraph::realtime::ReportViolation;
+using scalepiegraph::realtime::ViolationType;
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size) {
+  ReportViolation(ViolationType::kAllocation);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  ReportViolation(ViolationType::kAllocation);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+  ReportViolation(ViolationType::kAllocation);
+  return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) {
+  if (pointer != nullptr) {
+    ReportViolation(ViolationType::kDeallocation);
+  }
+  __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+  typedef int (*MutexLock)(pthread_mutex_t*);
+  static MutexLock next_mutex_lock = nullptr;
+  if (next_mutex_lock == nullptr) {
+    next_mutex_lock = reinterpret_cast<MutexLock>(
+        dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+  }
+
+  ReportViolation(ViolationType::kMutexLock);
+  return next_mutex_lock(mutex);
+}
+
+} // extern "C"
+
+namespace __cxxabiv1 {
+
+extern "C" void __cxa_throw(void* exception,
+                            std::type_info* type,
+                            void (*destructor)(void*)) {
+  typedef void (*CxaThrow)(void*, std::type_info*, void (*)(void*));
+  static CxaThrow next_throw = nullptr;
+  if (next_throw == nullptr) {
+    next_throw = reinterpret_cast<CxaThrow>(dlsym(RTLD_NEXT, "__cxa_throw"));
+  }
+
+  ReportViolation(ViolationType::kThrow);
+  next_throw(exception, type, destructor);
+  __builtin_unreachable();
+}
+
+} // namespace __cxxabiv1
+
+#elif defined(SCALEPIEGRAPH_RT_CHECK)
+
+// Elsewhere only allocations made through operator new and delete are seen
+
+using scalepiegraph::realtime::ReportViolation;
+using scalepiegraph::realtime::ViolationType;
+
+void* operator new(std::size_t size) {
+  ReportViolation(ViolationType::kAllocation);
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  if (pointer != nullptr) {
+    ReportViolation(ViolationType::kDeallocation);
+  }
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  operator delete(pointer);
+}
+
+#endif
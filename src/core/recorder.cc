@@ -0,0 +1,153 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/recorder.h>
+#include <core/realtime_checker.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t Recorder::kDefaultRingFrames;
+
+namespace {
+
+// The writer sleeps between passes once the ring is empty
+const std::chrono::milliseconds kWriterSleep(5);
+
+} // namespace
+
+Recorder::Recorder(double sample_rate, size_t num_channels,
+                   size_t ring_frames) :
+    sample_rate_(sample_rate),
+    num_channels_(num_channels),
+    ring_frames_(1),
+    write_count_(0),
+    read_count_(0),
+    num_frames_(0),
+    num_overruns_(0),
+    num_dropped_frames_(0),
+    is_recording_(false) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  if (num_channels == 0 || ring_frames == 0) {
+    throw std::out_of_range("Recorder must hold at least one sample.");
+  }
+
+  // Ring positions wrap with a mask
+  while (ring_frames_ < ring_frames) {
+    ring_frames_ *= 2;
+  }
+
+  ring_ = std::vector<float>(ring_frames_ * num_channels_, 0);
+}
+
+Recorder::~Recorder() {
+  Stop();
+}
+
+void Recorder::Start(const std::string& path) {
+  Stop();
+
+  writer_.reset(new WavWriter(path, sample_rate_, num_channels_));
+
+  // Frames left over from the last recording are never written
+  read_count_.store(write_count_.load(std::memory_order_acquire),
+                    std::memory_order_release);
+  num_frames_.store(0, std::memory_order_relaxed);
+  num_overruns_.store(0, std::memory_order_relaxed);
+  num_dropped_frames_.store(0, std::memory_order_relaxed);
+
+  is_recording_.store(true, std::memory_order_release);
+  writer_thread_ = std::thread(&Recorder::RunWriter, this);
+}
+
+void Recorder::Stop() {
+  if (!is_recording_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  is_recording_.store(false, std::memory_order_release);
+  writer_thread_.join();
+  writer_->Close();
+  writer_.reset();
+}
+
+void Recorder::Push(const float* samples, size_t num_frames) {
+  realtime::AudioThreadScope audio_thread;
+
+  if (!is_recording_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  size_t write_count = write_count_.load(std::memory_order_relaxed);
+  size_t read_count = read_count_.load(std::memory_order_acquire);
+
+  // Drop whole blocks, so the file only has gaps between blocks
+  if (ring_frames_ - (write_count - read_count) < num_frames) {
+    num_overruns_.fetch_add(1, std::memory_order_relaxed);
+    num_dropped_frames_.fetch_add(num_frames, std::memory_order_relaxed);
+    return;
+  }
+
+  // Copy up to the end of the ring, then wrap to its start
+  size_t offset = write_count & (ring_frames_ - 1);
+  size_t first_frames = std::min(num_frames, ring_frames_ - offset);
+  std::copy(samples, samples + first_frames * num_channels_,
+            ring_.begin() + offset * num_channels_);
+  std::copy(samples + first_frames * num_channels_,
+            samples + num_frames * num_channels_, ring_.begin());
+
+  write_count_.store(write_count + num_frames, std::memory_order_release);
+}
+
+bool Recorder::IsRecording() const {
+  return is_recording_.load(std::memory_order_acquire);
+}
+
+size_t Recorder::GetNumFrames() const {
+  return num_frames_.load(std::memory_order_relaxed);
+}
+
+size_t Recorder::GetNumOverruns() const {
+  return num_overruns_.load(std::memory_order_relaxed);
+}
+
+size_t Recorder::GetNumDroppedFrames() const {
+  return num_dropped_frames_.load(std::memory_order_relaxed);
+}
+
+void Recorder::RunWriter() {
+  while (is_recording_.load(std::memory_order_acquire)) {
+    if (!Drain()) {
+      std::this_thread::sleep_for(kWriterSleep);
+    }
+  }
+
+  // Blocks pushed before the recording stopped still belong in the file
+  Drain();
+}
+
+bool Recorder::Drain() {
+  size_t read_count = read_count_.load(std::memory_order_relaxed);
+  size_t write_count = write_count_.load(std::memory_order_acquire);
+
+  if (read_count == write_count) {
+    return false;
+  }
+
+  // Write up to the end of the ring, then wrap to its start
+  size_t offset = read_count & (ring_frames_ - 1);
+  size_t num_frames = write_count - read_count;
+  size_t first_frames = std::min(num_frames, ring_frames_ - offset);
+  writer_->Write(&ring_[offset * num_channels_],
+                 first_frames * num_channels_);
+  writer_->Write(ring_.data(), (num_frames - first_frames) * num_channels_);
+
+  read_count_.store(write_count, std::memory_order_release);
+  num_frames_.fetch_add(num_frames, std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace scalepiegraph
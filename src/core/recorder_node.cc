@@ -0,0 +1,19 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/recorder_node.h>
+
+namespace scalepiegraph {
+
+RecorderNode::RecorderNode(const std::shared_ptr<Recorder>& recorder,
+                           const Format& format) :
+    ci::audio::Node(format),
+    recorder_(recorder) {
+  // The engine renders a single channel, so that is all there is to record
+  setChannelMode(ChannelMode::SPECIFIED);
+  setNumChannels(1);
+}
+
+void RecorderNode::process(ci::audio::Buffer* buffer) {
+  recorder_->Push(buffer->getChannel(0), buffer->getNumFrames());
+}
+
+} // namespace scalepiegraph
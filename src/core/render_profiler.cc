@@ -0,0 +1,198 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/render_profiler.h>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+#include <limits>
+
+namespace scalepiegraph {
+
+const size_t RenderProfiler::kNumHistogramBins;
+
+namespace {
+
+const double kNanosPerMicro = 1000;
+
+/**
+ * Raise an atomic that only one thread writes to at least the given value.
+ */
+template <typename T>
+void StoreMax(std::atomic<T>& maximum, T value) {
+  if (value > maximum.load(std::memory_order_relaxed)) {
+    maximum.store(value, std::memory_order_relaxed);
+  }
+}
+
+} // namespace
+
+Json::Value RenderStats::ToJson() const {
+  Json::Value root;
+
+  root["num_blocks"] = Json::UInt64(num_blocks);
+  root["num_dropouts"] = Json::UInt64(num_dropouts);
+  root["num_late_callbacks"] = Json::UInt64(num_late_callbacks);
+  root["last_render_micros"] = last_render_micros;
+  root["mean_render_micros"] = mean_render_micros;
+  root["max_render_micros"] = max_render_micros;
+  root["max_load"] = max_load;
+  root["min_block_frames"] = Json::UInt64(min_block_frames);
+  root["max_block_frames"] = Json::UInt64(max_block_frames);
+  root["mean_jitter_micros"] = mean_jitter_micros;
+  root["max_jitter_micros"] = max_jitter_micros;
+
+  Json::Value histogram(Json::arrayValue);
+  for (uint64_t count : render_histogram) {
+    histogram.append(Json::UInt64(count));
+  }
+  root["render_histogram"] = histogram;
+
+  root["queue_depth"] = Json::UInt64(queue_depth);
+  root["max_queue_depth"] = Json::UInt64(max_queue_depth);
+  root["num_dropped_events"] = Json::UInt64(num_dropped_events);
+  root["num_late_events"] = Json::UInt64(num_late_events);
+
+  return root;
+}
+
+std::ostream& operator<<(std::ostream& output_stream,
+                         const RenderStats& stats) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+  writer->write(stats.ToJson(), &output_stream);
+
+  return output_stream << std::endl;
+}
+
+RenderProfiler::RenderProfiler() : reset_requested_(false) {
+  Clear();
+}
+
+void RenderProfiler::BeginBlock(int64_t now_nanos,
+                                size_t num_frames,
+                                double sample_rate) {
+  if (reset_requested_.exchange(false, std::memory_order_acquire)) {
+    Clear();
+  }
+
+  int64_t duration_nanos =
+      static_cast<int64_t>(1e9 * num_frames / sample_rate);
+
+  // Compare the time since the last callback with the audio it produced
+  if (previous_start_nanos_ > 0) {
+    int64_t interval = now_nanos - previous_start_nanos_;
+    int64_t jitter = std::llabs(interval - previous_duration_nanos_);
+
+    num_intervals_.fetch_add(1, std::memory_order_relaxed);
+    total_jitter_nanos_.fetch_add(jitter, std::memory_order_relaxed);
+    StoreMax(max_jitter_nanos_, jitter);
+
+    if (interval > 2 * previous_duration_nanos_) {
+      num_late_callbacks_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (num_frames < min_block_frames_.load(std::memory_order_relaxed)) {
+    min_block_frames_.store(num_frames, std::memory_order_relaxed);
+  }
+  StoreMax(max_block_frames_, num_frames);
+
+  block_start_nanos_ = now_nanos;
+  block_deadline_nanos_ = duration_nanos;
+  previous_start_nanos_ = now_nanos;
+  previous_duration_nanos_ = duration_nanos;
+}
+
+void RenderProfiler::EndBlock(int64_t now_nanos) {
+  int64_t render_nanos = now_nanos - block_start_nanos_;
+
+  num_blocks_.fetch_add(1, std::memory_order_relaxed);
+  last_render_nanos_.store(render_nanos, std::memory_order_relaxed);
+  total_render_nanos_.fetch_add(render_nanos, std::memory_order_relaxed);
+  StoreMax(max_render_nanos_, render_nanos);
+
+  if (block_deadline_nanos_ > 0) {
+    StoreMax(max_load_,
+             static_cast<double>(render_nanos) / block_deadline_nanos_);
+  }
+
+  if (render_nanos > block_deadline_nanos_) {
+    num_dropouts_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Bin by the bit length of the render time in whole microseconds
+  uint64_t micros = static_cast<uint64_t>(render_nanos / kNanosPerMicro);
+  size_t bin = 0;
+  while (micros > 0 && bin < kNumHistogramBins - 1) {
+    micros >>= 1;
+    ++bin;
+  }
+  histogram_[bin].fetch_add(1, std::memory_order_relaxed);
+}
+
+RenderStats RenderProfiler::GetStats() const {
+  RenderStats stats;
+
+  stats.num_blocks = num_blocks_.load(std::memory_order_relaxed);
+  stats.num_dropouts = num_dropouts_.load(std::memory_order_relaxed);
+  stats.num_late_callbacks =
+      num_late_callbacks_.load(std::memory_order_relaxed);
+  stats.last_render_micros =
+      last_render_nanos_.load(std::memory_order_relaxed) / kNanosPerMicro;
+  stats.max_render_micros =
+      max_render_nanos_.load(std::memory_order_relaxed) / kNanosPerMicro;
+  stats.max_load = max_load_.load(std::memory_order_relaxed);
+  stats.max_block_frames = max_block_frames_.load(std::memory_order_relaxed);
+  stats.max_jitter_micros =
+      max_jitter_nanos_.load(std::memory_order_relaxed) / kNanosPerMicro;
+
+  if (stats.num_blocks > 0) {
+    stats.mean_render_micros =
+        total_render_nanos_.load(std::memory_order_relaxed) /
+        kNanosPerMicro / stats.num_blocks;
+    stats.min_block_frames = min_block_frames_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t num_intervals = num_intervals_.load(std::memory_order_relaxed);
+  if (num_intervals > 0) {
+    stats.mean_jitter_micros =
+        total_jitter_nanos_.load(std::memory_order_relaxed) /
+        kNanosPerMicro / num_intervals;
+  }
+
+  for (const std::atomic<uint64_t>& count : histogram_) {
+    stats.render_histogram.push_back(count.load(std::memory_order_relaxed));
+  }
+
+  return stats;
+}
+
+void RenderProfiler::Reset() {
+  reset_requested_.store(true, std::memory_order_release);
+}
+
+void RenderProfiler::Clear() {
+  previous_start_nanos_ = 0;
+  previous_duration_nanos_ = 0;
+
+  num_blocks_.store(0, std::memory_order_relaxed);
+  num_dropouts_.store(0, std::memory_order_relaxed);
+  num_late_callbacks_.store(0, std::memory_order_relaxed);
+  last_render_nanos_.store(0, std::memory_order_relaxed);
+  max_render_nanos_.store(0, std::memory_order_relaxed);
+  total_render_nanos_.store(0, std::memory_order_relaxed);
+  max_load_.store(0, std::memory_order_relaxed);
+  min_block_frames_.store(std::numeric_limits<size_t>::max(),
+                          std::memory_order_relaxed);
+  max_block_frames_.store(0, std::memory_order_relaxed);
+  num_intervals_.store(0, std::memory_order_relaxed);
+  total_jitter_nanos_.store(0, std::memory_order_relaxed);
+  max_jitter_nanos_.store(0, std::memory_order_relaxed);
+
+  for (std::atomic<uint64_t>& count : histogram_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+} // namespace scalepiegraph
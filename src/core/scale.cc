@@ -1,5 +1,7 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <core/scale.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace scalepiegraph {
 
@@ -138,6 +140,47 @@ double Scale::CalculateNoteFrequency(size_t note_index, float base_freq) const {
   return freq;
 }
 
+float Scale::GetNoteCents(size_t note_index) const {
+  if (note_index > intervals_.size()) {
+    throw std::out_of_range("Invalid note index for this scale!");
+  }
+
+  if (note_index == 0) {
+    return 0;
+  }
+
+  return intervals_[note_index - 1];
+}
+
+NearestNote Scale::FindNearestNote(double cents) const {
+  double period = num_octaves_ * kCentsInOctave;
+  double period_start = std::floor(cents / period);
+  double offset = cents - period_start * period;
+
+  // The notes on either side of the pitch; past the last note of the period
+  // lies the first note of the next
+  size_t upper_index = std::lower_bound(intervals_.begin(), intervals_.end(),
+                                        offset) - intervals_.begin() + 1;
+  double upper_cents =
+      upper_index > intervals_.size() ? period : intervals_[upper_index - 1];
+  double lower_cents = GetNoteCents(upper_index - 1);
+
+  NearestNote nearest;
+  nearest.period = static_cast<int>(period_start);
+  if (offset - lower_cents <= upper_cents - offset) {
+    nearest.note_index = upper_index - 1;
+    nearest.deviation = offset - lower_cents;
+  } else if (upper_index > intervals_.size()) {
+    nearest.period += 1;
+    nearest.deviation = offset - period;
+  } else {
+    nearest.note_index = upper_index;
+    nearest.deviation = offset - upper_cents;
+  }
+
+  return nearest;
+}
+
 float Scale::GetInterval(size_t inter_index) const {
   if (inter_index > intervals_.size()) {
     throw std::out_of_range("Invalid interval index for this scale!");
@@ -1,5 +1,10 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <core/scale_dataset.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace scalepiegraph {
 
@@ -15,6 +20,48 @@ const Scale& ScaleDataset::operator[](const std::string& name) const {
   return scales_by_name_.at(name);
 }
 
+size_t ScaleDataset::ForEachScale(
+    size_t num_workers,
+    const std::function<ScaleVisitor()>& make_visitor) const {
+  std::atomic<size_t> next_scale(0);
+  std::exception_ptr first_error;
+  std::mutex error_mutex;
+
+  auto work = [&]() {
+    ScaleVisitor visit = make_visitor();
+
+    for (size_t index = next_scale++; index < names_.size();
+         index = next_scale++) {
+      try {
+        visit(index, scales_by_name_.at(names_[index]));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+      }
+    }
+  };
+
+  size_t num_threads = std::max<size_t>(
+      std::min(num_workers, names_.size()), 1);
+  std::vector<std::thread> workers;
+  for (size_t worker = 1; worker < num_threads; ++worker) {
+    workers.push_back(std::thread(work));
+  }
+  work(); // The calling thread is one of the workers
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  if (first_error) {
+    std::rethrow_exception(first_error);
+  }
+
+  return num_threads;
+}
+
 std::istream& operator>>(std::istream& input_stream, ScaleDataset& dataset) {
   Json::Value root;
   input_stream >> root;
@@ -0,0 +1,196 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/scale_inference.h>
+#include <core/pitch_detector.h>
+#include <core/wav_reader.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t ScaleInference::kNumBins;
+const double ScaleInference::kDefaultBandwidth = 10;
+const double ScaleInference::kDefaultMinHeight = 0.1;
+
+namespace {
+
+const double kKernelWidth = 4; // Standard deviations on each side
+const size_t kRecordingHopFrames = 1024;
+
+} // namespace
+
+ScaleInference::ScaleInference(double reference_frequency) :
+    reference_frequency_(reference_frequency),
+    histogram_(kNumBins, 0) {
+  if (reference_frequency <= 0) {
+    throw std::out_of_range(
+        "Reference frequency must be a positive real number");
+  }
+}
+
+void ScaleInference::AddFrequency(double frequency, double weight) {
+  if (frequency <= 0 || weight < 0) {
+    throw std::out_of_range("Invalid observation.");
+  }
+
+  double cents = Scale::kCentsInOctave *
+                 std::log2(frequency / reference_frequency_);
+  double folded = cents - Scale::kCentsInOctave *
+                          std::floor(cents / Scale::kCentsInOctave);
+
+  // Split the observation between the two nearest bins
+  double position = folded * kNumBins / Scale::kCentsInOctave;
+  size_t lower = static_cast<size_t>(position) % kNumBins;
+  double fraction = position - std::floor(position);
+  histogram_[lower] += weight * (1 - fraction);
+  histogram_[(lower + 1) % kNumBins] += weight * fraction;
+
+  ++num_observations_;
+}
+
+size_t ScaleInference::AddCsv(std::istream& input_stream) {
+  size_t num_added = 0;
+  std::string line;
+
+  while (std::getline(input_stream, line)) {
+    std::istringstream cells(line);
+    std::string cell;
+
+    while (std::getline(cells, cell, ',')) {
+      char* end;
+      double frequency = std::strtod(cell.c_str(), &end);
+
+      if (end != cell.c_str() && frequency > 0) {
+        AddFrequency(frequency);
+        ++num_added;
+      }
+    }
+  }
+
+  return num_added;
+}
+
+size_t ScaleInference::AddRecording(const std::string& path) {
+  WavReader reader(path);
+  PitchDetector detector(reader.GetSampleRate());
+  std::vector<float> window(detector.GetInputFrames());
+  size_t num_added = 0;
+
+  for (size_t first_frame = 0;
+       reader.Read(first_frame, window.data(), window.size()) ==
+           window.size();
+       first_frame += kRecordingHopFrames) {
+    PitchEstimate estimate = detector.Detect(window.data());
+
+    if (estimate.frequency > 0) {
+      AddFrequency(estimate.frequency);
+      ++num_added;
+    }
+  }
+
+  return num_added;
+}
+
+size_t ScaleInference::GetNumObservations() const {
+  return num_observations_;
+}
+
+std::vector<double> ScaleInference::InferFrequencies(
+    double bandwidth, double min_height) const {
+  if (bandwidth <= 0 || min_height < 0 || min_height > 1) {
+    throw std::out_of_range("Invalid inference parameters.");
+  }
+
+  std::vector<double> density = EstimateDensity(bandwidth);
+  double max_density = *std::max_element(density.begin(), density.end());
+  if (max_density == 0) {
+    throw std::runtime_error("No observations to infer a scale from.");
+  }
+
+  // Local maxima of the density, refined between bins by a parabola
+  std::vector<double> peaks;
+  for (size_t bin = 0; bin < kNumBins; ++bin) {
+    double before = density[(bin + kNumBins - 1) % kNumBins];
+    double at = density[bin];
+    double after = density[(bin + 1) % kNumBins];
+
+    if (at > before && at >= after && at >= min_height * max_density) {
+      double curvature = before - 2 * at + after;
+      double offset = curvature < 0 ? (before - after) / (2 * curvature) : 0;
+      peaks.push_back((bin + offset) * Scale::kCentsInOctave / kNumBins);
+    }
+  }
+
+  if (peaks.size() < 2) {
+    throw std::runtime_error("Observations show fewer than two notes.");
+  }
+
+  // Start at the peak nearest the reference, around the octave
+  size_t tonic = 0;
+  double tonic_distance = Scale::kCentsInOctave;
+  for (size_t peak = 0; peak < peaks.size(); ++peak) {
+    double distance =
+        std::min(peaks[peak], Scale::kCentsInOctave - peaks[peak]);
+    if (distance < tonic_distance) {
+      tonic = peak;
+      tonic_distance = distance;
+    }
+  }
+
+  std::vector<double> frequencies;
+  for (size_t note = 0; note < peaks.size(); ++note) {
+    size_t peak = (tonic + note) % peaks.size();
+    double cents = peaks[peak] + (peak < tonic ? Scale::kCentsInOctave : 0);
+    frequencies.push_back(reference_frequency_ *
+                          std::exp2(cents / Scale::kCentsInOctave));
+  }
+
+  // A tonic just below the reference belongs to the octave below
+  if (peaks[tonic] > Scale::kCentsInOctave / 2) {
+    for (double& frequency : frequencies) {
+      frequency /= 2;
+    }
+  }
+
+  return frequencies;
+}
+
+Scale ScaleInference::Infer(const std::string& name,
+                            double bandwidth,
+                            double min_height) const {
+  std::vector<double> frequencies = InferFrequencies(bandwidth, min_height);
+
+  return Scale(name, Scale::ConvertFrequenciesToCents(
+      std::vector<float>(frequencies.begin(), frequencies.end())));
+}
+
+std::vector<double> ScaleInference::EstimateDensity(double bandwidth) const {
+  double bins_per_cent = kNumBins / Scale::kCentsInOctave;
+  double sigma = bandwidth * bins_per_cent;
+  int radius = static_cast<int>(std::ceil(kKernelWidth * sigma));
+
+  std::vector<double> kernel;
+  for (int offset = -radius; offset <= radius; ++offset) {
+    kernel.push_back(std::exp(-0.5 * offset * offset / (sigma * sigma)));
+  }
+
+  std::vector<double> density(kNumBins, 0);
+  for (size_t bin = 0; bin < kNumBins; ++bin) {
+    if (histogram_[bin] == 0) {
+      continue; // Sparse histograms smooth quickly
+    }
+
+    for (int offset = -radius; offset <= radius; ++offset) {
+      // The octave wraps, so a note near the reference is not split in two
+      long target = static_cast<long>(bin) + offset;
+      target = ((target % static_cast<long>(kNumBins)) + kNumBins) % kNumBins;
+      density[target] += histogram_[bin] * kernel[offset + radius];
+    }
+  }
+
+  return density;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/scale_morph.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t ScaleMorph::kMaxNotes;
+const double ScaleMorph::kMaxFrequency = 20000; // Top of human hearing
+const double ScaleMorph::kTolerance = 1; // Cents; voices store float pitches
+
+ScaleMorph::ScaleMorph(const Scale& from,
+                       const Scale& to,
+                       double base_freq,
+                       double duration) : duration_(duration) {
+  if (base_freq <= 0) {
+    throw std::out_of_range("Base frequency must be a positive real number");
+  }
+
+  if (duration < 0) {
+    throw std::out_of_range("Morph duration must not be negative.");
+  }
+
+  while (num_notes_ < kMaxNotes) {
+    double from_frequency = from.CalculateNoteFrequency(num_notes_, base_freq);
+    if (from_frequency > kMaxFrequency) {
+      break;
+    }
+
+    from_frequencies_[num_notes_] = from_frequency;
+    to_frequencies_[num_notes_] = to.CalculateNoteFrequency(num_notes_,
+                                                            base_freq);
+    ++num_notes_;
+  }
+}
+
+int ScaleMorph::FindNote(double frequency) const {
+  if (num_notes_ == 0 || frequency <= 0) {
+    return -1;
+  }
+
+  // Notes ascend, so the nearest one neighbours the insertion point
+  const double* begin = from_frequencies_.data();
+  const double* end = begin + num_notes_;
+  const double* above = std::lower_bound(begin, end, frequency);
+
+  const double* nearest = above;
+  if (above == end ||
+      (above != begin && frequency / *(above - 1) < *above / frequency)) {
+    nearest = above - 1;
+  }
+
+  double cents = Scale::kCentsInOctave * std::fabs(std::log2(frequency /
+                                                             *nearest));
+  if (cents > kTolerance) {
+    return -1;
+  }
+
+  return static_cast<int>(nearest - begin);
+}
+
+double ScaleMorph::GetFromFrequency(size_t note_idx) const {
+  if (note_idx >= num_notes_) {
+    throw std::out_of_range("Note index exceeds size of morph.");
+  }
+
+  return from_frequencies_[note_idx];
+}
+
+double ScaleMorph::GetToFrequency(size_t note_idx) const {
+  if (note_idx >= num_notes_) {
+    throw std::out_of_range("Note index exceeds size of morph.");
+  }
+
+  return to_frequencies_[note_idx];
+}
+
+size_t ScaleMorph::GetNumNotes() const {
+  return num_notes_;
+}
+
+double ScaleMorph::GetDuration() const {
+  return duration_;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/sequencer.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const uint64_t Sequencer::kNever = std::numeric_limits<uint64_t>::max();
+const int Sequencer::kSequencerNote = -2;
+
+Sequencer::Sequencer(double sample_rate) : sample_rate_(sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+}
+
+void Sequencer::SetPattern(const Pattern& pattern) {
+  patterns_.Write(pattern);
+}
+
+void Sequencer::Start(uint64_t frame) {
+  patterns_.Update();
+
+  is_playing_ = patterns_.Read().GetNumSteps() > 0;
+  step_idx_ = 0;
+  step_position_ = static_cast<double>(frame);
+
+  // A sounding note is cut off by the first step
+  if (is_note_on_) {
+    note_off_frame_ = std::min(note_off_frame_, frame);
+  }
+}
+
+void Sequencer::Stop(uint64_t frame) {
+  is_playing_ = false;
+
+  if (is_note_on_) {
+    note_off_frame_ = std::min(note_off_frame_, frame);
+  }
+}
+
+bool Sequencer::IsPlaying() const {
+  return is_playing_;
+}
+
+uint64_t Sequencer::GetNextEventFrame() const {
+  uint64_t step_frame = is_playing_ ? ToFrame(step_position_) : kNever;
+
+  if (is_note_on_ && note_off_frame_ <= step_frame) {
+    return note_off_frame_;
+  }
+
+  return step_frame;
+}
+
+bool Sequencer::PopEvent(ParameterEvent* event) {
+  uint64_t frame = GetNextEventFrame();
+  if (frame == kNever) {
+    return false;
+  }
+
+  event->frame = frame;
+  event->note = kSequencerNote;
+
+  // Release the previous note before the next one starts on the same frame
+  if (is_note_on_ && note_off_frame_ == frame) {
+    is_note_on_ = false;
+    event->type = ParameterEvent::Type::kNoteOff;
+    event->value = 0;
+    return true;
+  }
+
+  // Switch patterns only between steps so the rhythm is kept
+  if (patterns_.Update()) {
+    step_idx_ %= std::max<size_t>(patterns_.Read().GetNumSteps(), 1);
+  }
+
+  const Pattern& pattern = patterns_.Read();
+  if (pattern.GetNumSteps() == 0) {
+    is_playing_ = false;
+    return false;
+  }
+
+  const PatternStep& step = pattern.GetStep(step_idx_);
+  double duration = step.duration * sample_rate_;
+  double note_position = step_position_;
+
+  step_position_ += duration;
+  if (++step_idx_ == pattern.GetNumSteps()) {
+    step_idx_ = 0;
+    is_playing_ = pattern.IsLooping();
+  }
+
+  if (step.frequency <= 0 || step.gate <= 0) {
+    return false; // Rest
+  }
+
+  is_note_on_ = true;
+  note_off_frame_ = ToFrame(note_position + step.gate * duration);
+  event->type = ParameterEvent::Type::kNoteOn;
+  event->value = step.frequency;
+  return true;
+}
+
+void Sequencer::SetSampleRate(double sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  sample_rate_ = sample_rate;
+}
+
+uint64_t Sequencer::ToFrame(double position) {
+  return static_cast<uint64_t>(std::llround(position));
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,96 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/sinc_resampler.h>
+#include <core/simd.h>
+#include <algorithm>
+#include <cmath>
+
+namespace scalepiegraph {
+
+using simd::Float4;
+
+const size_t SincResampler::kTaps;
+const size_t SincResampler::kNumPhases;
+const size_t SincResampler::kNumBands;
+const double SincResampler::kMaxRatio = 16; // Four octaves up
+const double SincResampler::kCutoff = 0.9; // Of Nyquist, leaving a transition
+
+namespace {
+
+const double kPi = 3.141592653589793;
+
+/**
+ * Evaluate a Blackman window spanning the taps of the filter.
+ */
+double BlackmanWindow(double offset, double half_width) {
+  if (std::fabs(offset) >= half_width) {
+    return 0;
+  }
+
+  double angle = kPi * offset / half_width;
+  return 0.42 + 0.5 * std::cos(angle) + 0.08 * std::cos(2 * angle);
+}
+
+} // namespace
+
+SincResampler::SincResampler() :
+    coefficients_(kNumBands * (kNumPhases + 1) * kTaps, 0) {
+  double half_width = kTaps / 2.0;
+
+  for (size_t band = 0; band < kNumBands; ++band) {
+    double cutoff = kCutoff / std::exp2(band / 2.0);
+
+    for (size_t phase = 0; phase <= kNumPhases; ++phase) {
+      float* row = &coefficients_[(band * (kNumPhases + 1) + phase) * kTaps];
+      double fraction = static_cast<double>(phase) / kNumPhases;
+      double sum = 0;
+
+      for (size_t tap = 0; tap < kTaps; ++tap) {
+        double offset = tap - (half_width - 1) - fraction;
+        double sinc = offset == 0 ? 1 : std::sin(kPi * cutoff * offset) /
+                                        (kPi * cutoff * offset);
+        row[tap] = static_cast<float>(cutoff * sinc *
+                                      BlackmanWindow(offset, half_width));
+        sum += row[tap];
+      }
+
+      // Unity gain at DC for every phase, so the level does not ripple
+      for (size_t tap = 0; tap < kTaps; ++tap) {
+        row[tap] = static_cast<float>(row[tap] / sum);
+      }
+    }
+  }
+}
+
+size_t SincResampler::GetBand(double ratio) const {
+  if (ratio <= 1) {
+    return 0;
+  }
+
+  double band = std::ceil(2 * std::log2(ratio));
+  return std::min(static_cast<size_t>(band), kNumBands - 1);
+}
+
+float SincResampler::Interpolate(const float* window, float fraction,
+                                 size_t band) const {
+  float position = fraction * kNumPhases;
+  size_t phase = std::min(static_cast<size_t>(position), kNumPhases - 1);
+  float weight = position - phase;
+
+  const float* lower = &coefficients_[(band * (kNumPhases + 1) + phase) *
+                                      kTaps];
+  const float* upper = lower + kTaps;
+
+  Float4 lower_sum = simd::Splat(0);
+  Float4 upper_sum = simd::Splat(0);
+  for (size_t tap = 0; tap < kTaps; tap += simd::kLanes) {
+    Float4 samples = simd::Load(window + tap);
+    lower_sum = lower_sum + samples * simd::Load(lower + tap);
+    upper_sum = upper_sum + samples * simd::Load(upper + tap);
+  }
+
+  float lower_sample = simd::HorizontalSum(lower_sum);
+  return lower_sample + (simd::HorizontalSum(upper_sum) - lower_sample) *
+                        weight;
+}
+
+} // namespace scalepiegraph
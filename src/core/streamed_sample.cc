@@ -0,0 +1,195 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/streamed_sample.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t StreamedSample::kDefaultHeadFrames;
+const size_t StreamedSample::kDefaultRingFrames;
+const size_t StreamedSample::kLoadFrames = 4096;
+
+namespace {
+
+// The loader sleeps between passes once every ring is full
+const std::chrono::milliseconds kLoaderSleep(1);
+
+} // namespace
+
+StreamedSample::StreamedSample(const std::string& path,
+                               double root_frequency,
+                               size_t num_streams,
+                               size_t head_frames,
+                               size_t ring_frames) :
+    reader_(path),
+    root_frequency_(root_frequency),
+    num_streams_(num_streams),
+    ring_frames_(1),
+    num_underruns_(0),
+    stop_loader_(false) {
+  if (root_frequency <= 0) {
+    throw std::out_of_range("Root frequency must be a positive real number");
+  }
+
+  if (num_streams == 0 || ring_frames == 0) {
+    throw std::out_of_range("Sample must have at least one stream.");
+  }
+
+  // Ring positions wrap with a mask
+  while (ring_frames_ < ring_frames) {
+    ring_frames_ *= 2;
+  }
+
+  head_ = std::vector<float>(std::min(head_frames, reader_.GetNumFrames()));
+  reader_.Read(0, head_.data(), head_.size());
+
+  rings_ = std::vector<float>(num_streams_ * ring_frames_, 0);
+  load_buffer_ = std::vector<float>(kLoadFrames);
+  streams_.reset(new Stream[num_streams_]);
+  for (size_t stream = 0; stream < num_streams_; ++stream) {
+    streams_[stream].file_frame = head_.size();
+  }
+
+  loader_ = std::thread(&StreamedSample::RunLoader, this);
+}
+
+StreamedSample::~StreamedSample() {
+  stop_loader_.store(true, std::memory_order_relaxed);
+  loader_.join();
+}
+
+void StreamedSample::Start(size_t stream) {
+  Stream& state = streams_[stream];
+
+  state.position = 0;
+  state.requested.store(state.requested.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+}
+
+size_t StreamedSample::Read(size_t stream, float* output, size_t num_frames) {
+  Stream& state = streams_[stream];
+  size_t num_read = 0;
+
+  // The head is always in memory
+  if (state.position < head_.size()) {
+    num_read = std::min(num_frames, head_.size() - state.position);
+    std::copy(head_.begin() + state.position,
+              head_.begin() + state.position + num_read, output);
+    state.position += num_read;
+  }
+
+  size_t num_wanted = std::min(num_frames - num_read,
+                               reader_.GetNumFrames() - state.position);
+  if (num_wanted > 0) {
+    uint32_t requested = state.requested.load(std::memory_order_relaxed);
+    size_t num_prefetched = 0;
+
+    if (state.ready.load(std::memory_order_acquire) == requested) {
+      size_t read_count = state.read_count.load(std::memory_order_relaxed);
+      num_prefetched = std::min(
+          num_wanted,
+          state.write_count.load(std::memory_order_acquire) - read_count);
+
+      const float* ring = &rings_[stream * ring_frames_];
+      for (size_t frame = 0; frame < num_prefetched; ++frame) {
+        output[num_read + frame] =
+            ring[(read_count + frame) & (ring_frames_ - 1)];
+      }
+
+      state.read_count.store(read_count + num_prefetched,
+                             std::memory_order_release);
+      state.position += num_prefetched;
+      num_read += num_prefetched;
+    }
+
+    if (num_prefetched < num_wanted) {
+      num_underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  std::fill(output + num_read, output + num_frames, 0.0f);
+  return num_read;
+}
+
+double StreamedSample::GetRootFrequency() const {
+  return root_frequency_;
+}
+
+double StreamedSample::GetSampleRate() const {
+  return reader_.GetSampleRate();
+}
+
+size_t StreamedSample::GetNumFrames() const {
+  return reader_.GetNumFrames();
+}
+
+size_t StreamedSample::GetNumStreams() const {
+  return num_streams_;
+}
+
+size_t StreamedSample::GetNumUnderruns() const {
+  return num_underruns_.load(std::memory_order_relaxed);
+}
+
+void StreamedSample::RunLoader() {
+  while (!stop_loader_.load(std::memory_order_relaxed)) {
+    bool did_work = false;
+    for (size_t stream = 0; stream < num_streams_; ++stream) {
+      did_work |= FillStream(stream);
+    }
+
+    if (!did_work) {
+      std::this_thread::sleep_for(kLoaderSleep);
+    }
+  }
+}
+
+bool StreamedSample::FillStream(size_t stream) {
+  Stream& state = streams_[stream];
+  uint32_t requested = state.requested.load(std::memory_order_acquire);
+
+  if (state.ready.load(std::memory_order_relaxed) != requested) {
+    // The reader stays off the ring until the rewind is published
+    state.read_count.store(0, std::memory_order_relaxed);
+    state.write_count.store(0, std::memory_order_relaxed);
+    state.file_frame = head_.size();
+    state.ready.store(requested, std::memory_order_release);
+  }
+
+  size_t write_count = state.write_count.load(std::memory_order_relaxed);
+  size_t free_frames =
+      ring_frames_ -
+      (write_count - state.read_count.load(std::memory_order_acquire));
+  if (free_frames == 0) {
+    return false;
+  }
+
+  if (has_read_failed_) {
+    return false;
+  }
+
+  // Nothing may leave the loader thread; streams that run dry underrun
+  size_t num_frames = 0;
+  try {
+    num_frames = reader_.Read(state.file_frame, load_buffer_.data(),
+                              std::min(free_frames, kLoadFrames));
+  } catch (std::exception&) {
+    has_read_failed_ = true;
+  }
+
+  if (num_frames == 0) {
+    return false;
+  }
+
+  float* ring = &rings_[stream * ring_frames_];
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    ring[(write_count + frame) & (ring_frames_ - 1)] = load_buffer_[frame];
+  }
+
+  state.write_count.store(write_count + num_frames, std::memory_order_release);
+  state.file_frame += num_frames;
+  return true;
+}
+
+} // namespace scalepiegraph
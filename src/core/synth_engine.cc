@@ -0,0 +1,318 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/synth_engine.h>
+#include <core/realtime_checker.h>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const double SynthEngine::kDefaultSampleRate = 44100;
+const int SynthEngine::kLeadNote = -1;
+
+namespace {
+
+int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+SynthEngine::SynthEngine(double sample_rate,
+                         size_t queue_capacity,
+                         size_t num_voices) :
+    queue_(queue_capacity),
+    voices_(num_voices, sample_rate),
+    sequencer_(sample_rate),
+    sample_rate_(sample_rate),
+    clock_sequence_(0),
+    block_start_frame_(0),
+    block_start_nanos_(0),
+    block_size_(0),
+    num_late_events_(0),
+    applied_wavetable_(nullptr),
+    applied_sample_(nullptr) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+}
+
+bool SynthEngine::Post(ParameterEvent::Type type, double value, int note) {
+  ParameterEvent event;
+  event.type = type;
+  event.frame = EstimateFrame();
+  event.value = value;
+  event.note = note;
+
+  return Post(event);
+}
+
+bool SynthEngine::Post(const ParameterEvent& event) {
+  if (event.type == ParameterEvent::Type::kWavetable &&
+      event.wavetable == nullptr) {
+    throw std::out_of_range("Wavetable must not be null.");
+  }
+
+  if (event.type == ParameterEvent::Type::kSample &&
+      (event.sample == nullptr ||
+       event.sample->GetNumStreams() < voices_.GetNumVoices())) {
+    throw std::out_of_range("Sample must have a stream for every voice.");
+  }
+
+  if (event.type == ParameterEvent::Type::kFilterResonance &&
+      event.value <= 0) {
+    throw std::out_of_range("Resonance must be a positive real number");
+  }
+
+  ParameterEvent ordered_event = event;
+
+  // Events must leave the queue in frame order
+  ordered_event.frame = std::max(event.frame, last_posted_frame_);
+  last_posted_frame_ = ordered_event.frame;
+
+  return queue_.Push(ordered_event);
+}
+
+void SynthEngine::SetPattern(const Pattern& pattern) {
+  sequencer_.SetPattern(pattern);
+}
+
+bool SynthEngine::SetTimbre(const AdditiveTimbre& timbre) {
+  timbres_.Write(timbre);
+  return Post(ParameterEvent::Type::kTimbre);
+}
+
+bool SynthEngine::MorphScale(const ScaleMorph& morph) {
+  morphs_.Write(morph);
+  return Post(ParameterEvent::Type::kMorphScale);
+}
+
+uint64_t SynthEngine::EstimateFrame() const {
+  uint32_t sequence;
+  uint64_t block_start_frame;
+  int64_t block_start_nanos;
+  size_t block_size;
+
+  // Retry until a consistent snapshot of the audio clock is read
+  do {
+    sequence = clock_sequence_.load(std::memory_order_acquire);
+    block_start_frame = block_start_frame_.load(std::memory_order_relaxed);
+    block_start_nanos = block_start_nanos_.load(std::memory_order_relaxed);
+    block_size = block_size_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1) ||
+           sequence != clock_sequence_.load(std::memory_order_relaxed));
+
+  if (block_size == 0) {
+    return block_start_frame; // Nothing rendered yet
+  }
+
+  double elapsed_seconds = (NowNanos() - block_start_nanos) / 1e9;
+  uint64_t elapsed_frames = static_cast<uint64_t>(
+      std::max(0.0, elapsed_seconds * sample_rate_));
+
+  // Delay by one block so the event keeps its offset in the next block
+  return block_start_frame + std::min<uint64_t>(elapsed_frames, block_size) +
+         block_size;
+}
+
+void SynthEngine::Render(float* output, size_t num_frames) {
+  realtime::AudioThreadScope audio_thread;
+
+  uint64_t block_start = frame_clock_;
+  uint64_t block_end = block_start + num_frames;
+  int64_t block_start_nanos = NowNanos();
+
+  profiler_.BeginBlock(block_start_nanos, num_frames, sample_rate_);
+
+  clock_sequence_.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  block_start_frame_.store(block_start, std::memory_order_relaxed);
+  block_start_nanos_.store(block_start_nanos, std::memory_order_relaxed);
+  block_size_.store(num_frames, std::memory_order_relaxed);
+  clock_sequence_.fetch_add(1, std::memory_order_release);
+
+  size_t rendered = 0;
+  uint64_t event_frame;
+  while ((event_frame = GetNextEventFrame()) < block_end) {
+    size_t event_offset = 0;
+    if (event_frame > block_start) {
+      event_offset = static_cast<size_t>(event_frame - block_start);
+    }
+
+    if (event_offset > rendered) {
+      voices_.Render(output + rendered, event_offset - rendered);
+      rendered = event_offset;
+    }
+
+    ApplyNextEvent(block_start);
+  }
+
+  voices_.Render(output + rendered, num_frames - rendered);
+  frame_clock_ = block_end;
+
+  profiler_.EndBlock(NowNanos());
+}
+
+void SynthEngine::SetSampleRate(double sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  sample_rate_ = sample_rate;
+  voices_.SetSampleRate(sample_rate);
+  sequencer_.SetSampleRate(sample_rate);
+}
+
+void SynthEngine::SetNumRenderThreads(size_t num_threads) {
+  voices_.SetNumThreads(num_threads);
+}
+
+void SynthEngine::SetMaxPartials(size_t max_partials) {
+  voices_.SetMaxPartials(max_partials);
+}
+
+double SynthEngine::GetSampleRate() const {
+  return sample_rate_;
+}
+
+uint64_t SynthEngine::GetFrameClock() const {
+  return block_start_frame_.load(std::memory_order_relaxed) +
+         block_size_.load(std::memory_order_relaxed);
+}
+
+const ParameterQueue& SynthEngine::GetParameterQueue() const {
+  return queue_;
+}
+
+size_t SynthEngine::GetNumLateEvents() const {
+  return num_late_events_.load(std::memory_order_relaxed);
+}
+
+const VoicePool& SynthEngine::GetVoicePool() const {
+  return voices_;
+}
+
+const Wavetable* SynthEngine::GetAppliedWavetable() const {
+  return applied_wavetable_.load(std::memory_order_acquire);
+}
+
+const StreamedSample* SynthEngine::GetAppliedSample() const {
+  return applied_sample_.load(std::memory_order_acquire);
+}
+
+RenderStats SynthEngine::GetRenderStats() const {
+  RenderStats stats = profiler_.GetStats();
+
+  stats.queue_depth = queue_.GetDepth();
+  stats.max_queue_depth = queue_.GetMaxDepth();
+  stats.num_dropped_events = queue_.GetNumDropped();
+  stats.num_late_events = GetNumLateEvents();
+
+  return stats;
+}
+
+void SynthEngine::ResetRenderStats() {
+  profiler_.Reset();
+  queue_.ResetStatistics();
+  num_late_events_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t SynthEngine::GetNextEventFrame() const {
+  const ParameterEvent* event = queue_.Peek();
+  uint64_t queue_frame = event != nullptr ? event->frame : Sequencer::kNever;
+
+  return std::min(queue_frame, sequencer_.GetNextEventFrame());
+}
+
+void SynthEngine::ApplyNextEvent(uint64_t block_start) {
+  const ParameterEvent* queued_event = queue_.Peek();
+
+  if (queued_event != nullptr &&
+      queued_event->frame <= sequencer_.GetNextEventFrame()) {
+    ParameterEvent event = *queued_event;
+    queue_.Pop();
+
+    // Late events take effect at the start of the block
+    if (event.frame < block_start) {
+      num_late_events_.fetch_add(1, std::memory_order_relaxed);
+      event.frame = block_start;
+    }
+
+    ApplyEvent(event);
+    return;
+  }
+
+  ParameterEvent sequenced_event;
+  if (sequencer_.PopEvent(&sequenced_event)) {
+    ApplyEvent(sequenced_event);
+  }
+}
+
+void SynthEngine::ApplyEvent(const ParameterEvent& event) {
+  switch (event.type) {
+    case ParameterEvent::Type::kStart:
+      voices_.NoteOn(kLeadNote, event.value);
+      break;
+    case ParameterEvent::Type::kStop:
+      voices_.NoteOff(kLeadNote);
+      break;
+    case ParameterEvent::Type::kFrequency:
+      voices_.SetNoteFrequency(kLeadNote, event.value);
+      break;
+    case ParameterEvent::Type::kWaveform:
+      voices_.SetWaveform(
+          static_cast<Waveform>(static_cast<int>(event.value)));
+      break;
+    case ParameterEvent::Type::kFilterCutoff:
+      voices_.SetFilterCutoff(event.value);
+      break;
+    case ParameterEvent::Type::kNoteOn:
+      voices_.NoteOn(event.note, event.value);
+      break;
+    case ParameterEvent::Type::kNoteOff:
+      voices_.NoteOff(event.note);
+      break;
+    case ParameterEvent::Type::kStopAll:
+      voices_.ReleaseAll();
+      break;
+    case ParameterEvent::Type::kWavetable:
+      voices_.SetWavetable(event.wavetable);
+      applied_wavetable_.store(event.wavetable, std::memory_order_release);
+      break;
+    case ParameterEvent::Type::kPlayPattern:
+      sequencer_.Start(event.frame);
+      break;
+    case ParameterEvent::Type::kStopPattern:
+      sequencer_.Stop(event.frame);
+      break;
+    case ParameterEvent::Type::kFilterMode:
+      voices_.SetFilterMode(
+          static_cast<FilterMode>(static_cast<int>(event.value)));
+      break;
+    case ParameterEvent::Type::kFilterResonance:
+      voices_.SetFilterResonance(event.value);
+      break;
+    case ParameterEvent::Type::kNoteFilterCutoff:
+      voices_.SetNoteFilterCutoff(event.note, event.value);
+      break;
+    case ParameterEvent::Type::kFilterEnvelope:
+      voices_.SetFilterEnvelope(event.value);
+      break;
+    case ParameterEvent::Type::kTimbre:
+      timbres_.Update();
+      voices_.SetTimbre(&timbres_.Read());
+      break;
+    case ParameterEvent::Type::kMorphScale:
+      morphs_.Update();
+      voices_.MorphScale(morphs_.Read());
+      break;
+    case ParameterEvent::Type::kSample:
+      voices_.SetSample(event.sample);
+      applied_sample_.store(event.sample, std::memory_order_release);
+      break;
+  }
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,23 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/synth_node.h>
+
+namespace scalepiegraph {
+
+SynthNode::SynthNode(const std::shared_ptr<SynthEngine>& engine,
+                     const Format& format) :
+    ci::audio::InputNode(format),
+    engine_(engine) {
+  // The engine renders a single channel, like GenOscNode
+  setChannelMode(ChannelMode::SPECIFIED);
+  setNumChannels(1);
+}
+
+void SynthNode::initialize() {
+  engine_->SetSampleRate(getSampleRate());
+}
+
+void SynthNode::process(ci::audio::Buffer* buffer) {
+  engine_->Render(buffer->getChannel(0), buffer->getNumFrames());
+}
+
+} // namespace scalepiegraph
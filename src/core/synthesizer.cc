@@ -3,22 +3,44 @@
 
 namespace scalepiegraph {
 
+namespace {
+
+/**
+ * Release the resources posted before the one the audio thread last applied,
+ * which it no longer reads. Resources still waiting in the queue are kept.
+ */
+template <typename Resource>
+void ReleaseReplaced(std::vector<std::shared_ptr<Resource>>& posted,
+                     const Resource* applied) {
+  for (size_t idx = 0; idx < posted.size(); ++idx) {
+    if (posted[idx].get() == applied) {
+      posted.erase(posted.begin(), posted.begin() + idx);
+      return;
+    }
+  }
+}
+
+} // namespace
+
 Synthesizer::Synthesizer() : context_(ci::audio::Context::master()) {
   if (context_ == nullptr) {
     throw std::runtime_error("No audio device found");
   }
 
-  oscillator_ = context_->makeNode(
-      new ci::audio::GenOscNode(ci::audio::WaveformType::SINE));
-  filter_ = context_->makeNode(new ci::audio::FilterLowPassNode);
+  engine_ = std::make_shared<SynthEngine>(context_->getSampleRate());
+  engine_->SetMaxPartials(AdditiveTimbre::kMaxPartials);
+  synth_node_ = context_->makeNode(new SynthNode(engine_));
   gain_ = context_->makeNode(new ci::audio::GainNode);
+  recorder_ = std::make_shared<Recorder>(context_->getSampleRate());
+  recorder_node_ = context_->makeNode(new RecorderNode(recorder_));
 
-  oscillator_->connect(filter_);
-  filter_->connect(gain_);
-  gain_->connect(context_->getOutput());
+  synth_node_->connect(gain_);
+  gain_->connect(recorder_node_);
+  recorder_node_->connect(context_->getOutput());
 
-  filter_->enable();
+  synth_node_->enable();
   gain_->enable();
+  recorder_node_->enable();
 
   context_->enable();
 }
@@ -28,13 +50,68 @@ void Synthesizer::Start(double frequency) const {
     throw std::range_error("Frequency out of synthesizer range.");
   }
 
-  oscillator_->setFreq(frequency);
-
-  oscillator_->enable();
+  engine_->Post(ParameterEvent::Type::kStart, frequency);
 }
 
 void Synthesizer::Stop() const {
-  oscillator_->disable();
+  engine_->Post(ParameterEvent::Type::kStop);
+}
+
+void Synthesizer::NoteOn(int note, double frequency) const {
+  if (frequency < kFrequencyMin || frequency > kFrequencyMax) {
+    throw std::range_error("Frequency out of synthesizer range.");
+  }
+
+  engine_->Post(ParameterEvent::Type::kNoteOn, frequency, note);
+}
+
+void Synthesizer::NoteOff(int note) const {
+  engine_->Post(ParameterEvent::Type::kNoteOff, 0, note);
+}
+
+void Synthesizer::StopAll() const {
+  engine_->Post(ParameterEvent::Type::kStopAll);
+}
+
+void Synthesizer::PlayPattern(const Pattern& pattern) const {
+  engine_->SetPattern(pattern);
+  engine_->Post(ParameterEvent::Type::kPlayPattern);
+}
+
+void Synthesizer::StopPattern() const {
+  engine_->Post(ParameterEvent::Type::kStopPattern);
+}
+
+void Synthesizer::PlayMidi(const MidiFile& midi_file,
+                           const Scale& scale,
+                           const KeyboardMapping& mapping) {
+  StopMidi();
+
+  midi_player_.reset(new MidiPlayer(
+      midi_file, scale, mapping, engine_->GetSampleRate()));
+  midi_player_->Start(engine_->EstimateFrame());
+  UpdateMidi();
+}
+
+void Synthesizer::UpdateMidi() {
+  if (!midi_player_) {
+    return;
+  }
+
+  uint64_t lookahead_frames =
+      static_cast<uint64_t>(kMidiLookahead * engine_->GetSampleRate());
+  midi_player_->Feed(*engine_, engine_->EstimateFrame() + lookahead_frames);
+
+  if (midi_player_->IsFinished()) {
+    midi_player_.reset();
+  }
+}
+
+void Synthesizer::StopMidi() {
+  if (midi_player_) {
+    midi_player_.reset();
+    engine_->Post(ParameterEvent::Type::kStopAll);
+  }
 }
 
 void Synthesizer::SetFrequency(double frequency) const {
@@ -42,12 +119,53 @@ void Synthesizer::SetFrequency(double frequency) const {
     throw std::range_error("Frequency out of synthesizer range.");
   }
 
-  oscillator_->setFreq(frequency);
+  engine_->Post(ParameterEvent::Type::kFrequency, frequency);
 }
 
 void Synthesizer::SetWaveform(
     cinder::audio::WaveformType waveform_type) const {
-  oscillator_->setWaveform(waveform_type);
+  Waveform waveform;
+
+  switch (waveform_type) {
+    case ci::audio::WaveformType::TRIANGLE:
+      waveform = Waveform::kTriangle;
+      break;
+    case ci::audio::WaveformType::SQUARE:
+      waveform = Waveform::kSquare;
+      break;
+    case ci::audio::WaveformType::SAWTOOTH:
+      waveform = Waveform::kSawtooth;
+      break;
+    default:
+      waveform = Waveform::kSine;
+      break;
+  }
+
+  engine_->Post(ParameterEvent::Type::kWaveform, static_cast<int>(waveform));
+}
+
+void Synthesizer::SetCustomWaveform(const std::vector<float>& cycle) {
+  ReleaseReplaced(custom_wavetables_, engine_->GetAppliedWavetable());
+  custom_wavetables_.push_back(std::make_shared<Wavetable>(
+      Wavetable::FromCycle(cycle, engine_->GetSampleRate())));
+
+  ParameterEvent event;
+  event.type = ParameterEvent::Type::kWavetable;
+  event.frame = engine_->EstimateFrame();
+  event.wavetable = custom_wavetables_.back().get();
+  engine_->Post(event);
+}
+
+void Synthesizer::SetSample(const std::string& path, double root_frequency) {
+  ReleaseReplaced(samples_, engine_->GetAppliedSample());
+  samples_.push_back(std::make_shared<StreamedSample>(
+      path, root_frequency, engine_->GetVoicePool().GetNumVoices()));
+
+  ParameterEvent event;
+  event.type = ParameterEvent::Type::kSample;
+  event.frame = engine_->EstimateFrame();
+  event.sample = samples_.back().get();
+  engine_->Post(event);
 }
 
 void Synthesizer::SetFilter(float cutoff) {
@@ -55,7 +173,78 @@ void Synthesizer::SetFilter(float cutoff) {
     throw std::runtime_error("Cutoff out of synthesizer range.");
   }
 
-  filter_->setCutoffFreq(cutoff);
+  engine_->Post(ParameterEvent::Type::kFilterCutoff, cutoff);
+}
+
+void Synthesizer::SetFilterMode(FilterMode mode) {
+  engine_->Post(ParameterEvent::Type::kFilterMode, static_cast<int>(mode));
+}
+
+void Synthesizer::SetFilterResonance(float resonance) {
+  if (resonance <= 0) {
+    throw std::runtime_error("Resonance must be positive.");
+  }
+
+  engine_->Post(ParameterEvent::Type::kFilterResonance, resonance);
+}
+
+void Synthesizer::SetNoteFilter(int note, float cutoff) {
+  if (cutoff < kFrequencyMin || cutoff > kFrequencyMax) {
+    throw std::runtime_error("Cutoff out of synthesizer range.");
+  }
+
+  engine_->Post(ParameterEvent::Type::kNoteFilterCutoff, cutoff, note);
+}
+
+void Synthesizer::SetFilterEnvelope(float octaves) {
+  engine_->Post(ParameterEvent::Type::kFilterEnvelope, octaves);
+}
+
+void Synthesizer::SetAdditiveTimbre(const Scale& scale) {
+  engine_->SetTimbre(AdditiveTimbre::FromScale(scale));
+}
+
+void Synthesizer::MorphScale(const Scale& from,
+                             const Scale& to,
+                             double base_freq,
+                             double duration) {
+  engine_->MorphScale(ScaleMorph(from, to, base_freq, duration));
+}
+
+void Synthesizer::StartRecording(const std::string& path) {
+  recorder_->Start(path);
+}
+
+void Synthesizer::StopRecording() {
+  recorder_->Stop();
+}
+
+bool Synthesizer::IsRecording() const {
+  return recorder_->IsRecording();
+}
+
+size_t Synthesizer::GetNumRecordingOverruns() const {
+  return recorder_->GetNumOverruns();
+}
+
+size_t Synthesizer::GetQueueDepth() const {
+  return engine_->GetParameterQueue().GetDepth();
+}
+
+size_t Synthesizer::GetMaxQueueDepth() const {
+  return engine_->GetParameterQueue().GetMaxDepth();
+}
+
+size_t Synthesizer::GetNumDroppedChanges() const {
+  return engine_->GetParameterQueue().GetNumDropped();
+}
+
+RenderStats Synthesizer::GetRenderStats() const {
+  return engine_->GetRenderStats();
+}
+
+void Synthesizer::ResetRenderStats() {
+  engine_->ResetRenderStats();
 }
 
-} // namespace scalepiegraph
\ No newline at end of file
+} // namespace scalepiegraph
@@ -0,0 +1,175 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/tuning_export.h>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <core/batch_renderer.h>
+
+namespace scalepiegraph {
+
+const uint8_t TuningExporter::kAllDevices;
+const size_t TuningExporter::kBulkDumpSize;
+const size_t TuningExporter::kNameLength;
+const double TuningExporter::kTunBaseFrequency = 8.1757989156437073336;
+
+namespace {
+
+const uint8_t kSysExStart = 0xF0;
+const uint8_t kSysExEnd = 0xF7;
+const uint8_t kNonRealTime = 0x7E;
+const uint8_t kMidiTuning = 0x08;
+const uint8_t kBulkDumpReply = 0x01;
+const int kMaxFraction = 1 << 14; // Fractions of a semitone are 14 bits
+const double kCentsInOctave = 1200.0;
+
+/**
+ * Write the three-byte MTS frequency of a key: a semitone and a 14-bit
+ * fraction above it, relative to 12-TET with A4 at 440 Hz.
+ */
+void AppendFrequency(double frequency, std::vector<uint8_t>& message) {
+  double semitones = 69 + 12 * std::log2(frequency / 440.0);
+  int semitone = static_cast<int>(std::floor(semitones));
+  int fraction = static_cast<int>(
+      std::lround((semitones - semitone) * kMaxFraction));
+
+  if (fraction == kMaxFraction) {
+    ++semitone;
+    fraction = 0;
+  }
+
+  if (semitone < 0) {
+    semitone = 0;
+    fraction = 0;
+  } else if (semitone > 127 || (semitone == 127 && fraction >= 0x3FFF)) {
+    semitone = 127; // 7F 7F 7F is reserved to mean no change
+    fraction = 0x3FFE;
+  }
+
+  message.push_back(static_cast<uint8_t>(semitone));
+  message.push_back(static_cast<uint8_t>(fraction >> 7));
+  message.push_back(static_cast<uint8_t>(fraction & 0x7F));
+}
+
+} // namespace
+
+std::vector<uint8_t> TuningExporter::MakeBulkDump(
+    const Scale& scale,
+    const KeyboardMapping& mapping,
+    uint8_t program,
+    uint8_t device_id) {
+  if (program > 0x7F || device_id > 0x7F) {
+    throw std::out_of_range("Program and device must be 7-bit numbers.");
+  }
+
+  std::vector<uint8_t> message = {kSysExStart, kNonRealTime, device_id,
+                                  kMidiTuning, kBulkDumpReply, program};
+
+  // The name is 16 printable ASCII characters padded with spaces
+  std::string name = scale.GetName();
+  for (size_t character = 0; character < kNameLength; ++character) {
+    char value = character < name.size() ? name[character] : ' ';
+    message.push_back(value >= 0x20 && value < 0x7F ? value : '_');
+  }
+
+  for (int key = 0; key < KeyboardMapping::kNumKeys; ++key) {
+    AppendFrequency(
+        CalculateKeyFrequency(scale, mapping, static_cast<uint8_t>(key)),
+        message);
+  }
+
+  // The checksum is the XOR of every byte after F0, limited to 7 bits
+  uint8_t checksum = 0;
+  for (size_t byte = 1; byte < message.size(); ++byte) {
+    checksum ^= message[byte];
+  }
+  message.push_back(checksum & 0x7F);
+  message.push_back(kSysExEnd);
+
+  return message;
+}
+
+void TuningExporter::WriteTun(const Scale& scale,
+                              const KeyboardMapping& mapping,
+                              std::ostream& output_stream) {
+  std::string name = scale.GetName();
+  for (char& character : name) {
+    if (character == '"') {
+      character = '\'';
+    }
+  }
+
+  std::vector<double> cents;
+  for (int key = 0; key < KeyboardMapping::kNumKeys; ++key) {
+    double frequency =
+        CalculateKeyFrequency(scale, mapping, static_cast<uint8_t>(key));
+    cents.push_back(kCentsInOctave * std::log2(frequency / kTunBaseFrequency));
+  }
+
+  output_stream << "; " << name << std::endl
+                << "[Scale Begin]" << std::endl
+                << "Format= \"AnaMark-TUN\"" << std::endl
+                << "FormatVersion= 200" << std::endl
+                << std::endl
+                << "[Info]" << std::endl
+                << "Name= \"" << name << "\"" << std::endl
+                << std::endl;
+
+  // Version 1 readers only understand whole cents
+  output_stream << "[Tuning]" << std::endl;
+  for (int key = 0; key < KeyboardMapping::kNumKeys; ++key) {
+    output_stream << "note " << key << "=" << std::lround(cents[key])
+                  << std::endl;
+  }
+
+  output_stream << std::endl
+                << "[Exact Tuning]" << std::endl
+                << "BaseFreq= " << std::setprecision(20) << kTunBaseFrequency
+                << std::endl
+                << std::fixed << std::setprecision(6);
+  for (int key = 0; key < KeyboardMapping::kNumKeys; ++key) {
+    output_stream << "note " << key << "= " << cents[key] << std::endl;
+  }
+
+  output_stream << std::endl << "[Scale End]" << std::endl;
+}
+
+size_t TuningExporter::ExportDataset(const ScaleDataset& dataset,
+                                     const std::string& output_dir,
+                                     const KeyboardMapping& mapping) {
+  const std::vector<std::string>& names = dataset.GetNames();
+
+  for (size_t index = 0; index < names.size(); ++index) {
+    const Scale& scale = dataset[names[index]];
+    std::string path = output_dir + "/";
+
+    std::vector<uint8_t> dump = MakeBulkDump(
+        scale, mapping, static_cast<uint8_t>(index % 128));
+    std::ofstream dump_file(
+        path + BatchRenderer::MakeFileName(index, names[index], ".syx"),
+        std::ios::binary);
+    dump_file.write(reinterpret_cast<const char*>(dump.data()), dump.size());
+
+    std::ofstream tun_file(
+        path + BatchRenderer::MakeFileName(index, names[index], ".tun"));
+    WriteTun(scale, mapping, tun_file);
+
+    if (!dump_file || !tun_file) {
+      throw std::runtime_error("Cannot write tunings to " + output_dir);
+    }
+  }
+
+  return names.size();
+}
+
+double TuningExporter::CalculateKeyFrequency(const Scale& scale,
+                                             const KeyboardMapping& mapping,
+                                             uint8_t key) {
+  if (mapping.IsMapped(key)) {
+    return mapping.CalculateKeyFrequency(scale, key);
+  }
+
+  return 440.0 * std::pow(2.0, (key - 69) / 12.0);
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,223 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/tuning_verifier.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace scalepiegraph {
+
+const size_t TuningVerifier::kDefaultFftSize = 65536;
+const double TuningVerifier::kSettleSeconds = 0.1;
+const double TuningVerifier::kSearchCents = 100;
+
+namespace {
+
+const float kOpenCutoff = 20000; // Filters pass every harmonic
+
+const char* GetWaveformName(Waveform waveform) {
+  switch (waveform) {
+    case Waveform::kSine:
+      return "sine";
+    case Waveform::kTriangle:
+      return "triangle";
+    case Waveform::kSquare:
+      return "square";
+    case Waveform::kSawtooth:
+      return "sawtooth";
+    default:
+      return "other";
+  }
+}
+
+} // namespace
+
+double TuningReport::GetMaxAbsErrorCents() const {
+  double max_error = 0;
+  for (const NoteTuning& note : notes) {
+    max_error = std::max(max_error, std::fabs(note.error_cents));
+  }
+
+  return max_error;
+}
+
+double TuningReport::GetMeanAbsErrorCents() const {
+  double total_error = 0;
+  for (const NoteTuning& note : notes) {
+    total_error += std::fabs(note.error_cents);
+  }
+
+  return notes.empty() ? 0 : total_error / notes.size();
+}
+
+Json::Value TuningReport::ToJson() const {
+  Json::Value root;
+
+  root["num_notes"] = Json::UInt64(notes.size());
+  root["num_workers"] = Json::UInt64(num_workers);
+  root["seconds"] = seconds;
+  root["max_abs_error_cents"] = GetMaxAbsErrorCents();
+  root["mean_abs_error_cents"] = GetMeanAbsErrorCents();
+
+  Json::Value note_array(Json::arrayValue);
+  for (const NoteTuning& note : notes) {
+    Json::Value note_value;
+    note_value["scale_name"] = note.scale_name;
+    note_value["note_index"] = Json::UInt64(note.note_index);
+    note_value["octave"] = Json::UInt64(note.octave);
+    note_value["waveform"] = GetWaveformName(note.waveform);
+    note_value["expected_frequency"] = note.expected_frequency;
+    note_value["measured_frequency"] = note.measured_frequency;
+    note_value["error_cents"] = note.error_cents;
+    note_array.append(note_value);
+  }
+  root["notes"] = note_array;
+
+  return root;
+}
+
+std::ostream& operator<<(std::ostream& output_stream,
+                         const TuningReport& report) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+
+  std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+  writer->write(report.ToJson(), &output_stream);
+
+  return output_stream << std::endl;
+}
+
+TuningVerifier::TuningVerifier(size_t num_workers,
+                               double sample_rate,
+                               size_t fft_size) :
+    num_workers_(num_workers),
+    sample_rate_(sample_rate),
+    fft_(fft_size),
+    waveforms_({Waveform::kSine, Waveform::kTriangle, Waveform::kSquare,
+                Waveform::kSawtooth}) {
+  if (num_workers_ == 0) {
+    num_workers_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+}
+
+void TuningVerifier::SetWaveforms(const std::vector<Waveform>& waveforms) {
+  for (Waveform waveform : waveforms) {
+    if (waveform != Waveform::kSine && waveform != Waveform::kTriangle &&
+        waveform != Waveform::kSquare && waveform != Waveform::kSawtooth) {
+      throw std::out_of_range("Only oscillators can be verified.");
+    }
+  }
+
+  waveforms_ = waveforms;
+}
+
+void TuningVerifier::SetRange(size_t num_octaves, float base_freq) {
+  if (num_octaves == 0) {
+    throw std::out_of_range("Verify at least one octave.");
+  }
+
+  if (base_freq <= 0) {
+    throw std::out_of_range("Base frequency must be a positive real number");
+  }
+
+  num_octaves_ = num_octaves;
+  base_freq_ = base_freq;
+}
+
+std::vector<NoteTuning> TuningVerifier::VerifyScale(const Scale& scale) const {
+  OfflineRenderer renderer(sample_rate_);
+  size_t settle_frames = static_cast<size_t>(kSettleSeconds * sample_rate_);
+  double note_duration =
+      static_cast<double>(settle_frames + fft_.GetSize()) / sample_rate_;
+  std::vector<NoteTuning> tunings;
+
+  for (Waveform waveform : waveforms_) {
+    for (size_t octave = 0; octave < num_octaves_; ++octave) {
+      for (size_t note = 0; note < scale.GetNumNotes(); ++note) {
+        size_t note_index = octave * scale.GetNumNotes() + note;
+        std::vector<float> samples = renderer.Render(
+            scale, {{note_index, note_duration, waveform, kOpenCutoff}},
+            base_freq_);
+
+        NoteTuning tuning;
+        tuning.scale_name = scale.GetName();
+        tuning.note_index = note;
+        tuning.octave = octave;
+        tuning.waveform = waveform;
+        tuning.expected_frequency =
+            scale.CalculateNoteFrequency(note_index, base_freq_);
+        tuning.measured_frequency = MeasureFrequency(
+            &samples[settle_frames], tuning.expected_frequency);
+        tuning.error_cents = Scale::kCentsInOctave * std::log2(
+            tuning.measured_frequency / tuning.expected_frequency);
+        tunings.push_back(tuning);
+      }
+    }
+  }
+
+  return tunings;
+}
+
+TuningReport TuningVerifier::VerifyDataset(const ScaleDataset& dataset) const {
+  const std::vector<std::string>& names = dataset.GetNames();
+  std::vector<std::vector<NoteTuning>> scale_tunings(names.size());
+
+  auto start = std::chrono::steady_clock::now();
+
+  size_t num_threads = dataset.ForEachScale(num_workers_, [&]() {
+    return [&](size_t index, const Scale& scale) {
+      scale_tunings[index] = VerifyScale(scale);
+    };
+  });
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  TuningReport report;
+  for (const std::vector<NoteTuning>& tunings : scale_tunings) {
+    report.notes.insert(report.notes.end(), tunings.begin(), tunings.end());
+  }
+  report.num_workers = num_threads;
+  report.seconds = elapsed.count();
+  return report;
+}
+
+double TuningVerifier::MeasureFrequency(const float* samples,
+                                        double expected_frequency) const {
+  std::vector<double> magnitudes = fft_.GetHannMagnitudes(samples);
+  double bin_width = sample_rate_ / fft_.GetSize();
+
+  // The strongest bin within the search range, away from the edges
+  double search_ratio = std::exp2(kSearchCents / Scale::kCentsInOctave);
+  size_t first_bin = std::max<size_t>(1, static_cast<size_t>(
+      expected_frequency / search_ratio / bin_width));
+  size_t last_bin = std::min(magnitudes.size() - 2, static_cast<size_t>(
+      std::ceil(expected_frequency * search_ratio / bin_width)));
+
+  size_t peak = first_bin;
+  for (size_t bin = first_bin; bin <= last_bin; ++bin) {
+    if (magnitudes[bin] > magnitudes[peak]) {
+      peak = bin;
+    }
+  }
+
+  // Three-point estimate that is exact for a sinusoid under a Hann window
+  double before = magnitudes[peak - 1];
+  double at = magnitudes[peak];
+  double after = magnitudes[peak + 1];
+  double offset = 2 * (after - before) / (before + 2 * at + after);
+
+  return (peak + offset) * bin_width;
+}
+
+size_t TuningVerifier::GetNumWorkers() const {
+  return num_workers_;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,1023 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/voice_pool.h>
+#include <core/realtime_checker.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+using simd::Float4;
+
+const size_t VoicePool::kDefaultNumVoices = 32;
+const size_t VoicePool::kControlFrames = 32;
+const float VoicePool::kVoiceGain = 0.5;
+const size_t VoicePool::kVoicesPerChunk = 16; // One cache line per voice array
+const size_t VoicePool::kMinVoicesPerThread = 64;
+const size_t VoicePool::kPartitionFrames = 512;
+
+namespace {
+
+const double kTwoPi = 6.283185307179586;
+const float kMaxPartialIncrement = 0.45f; // Cycles per sample, below Nyquist
+
+/**
+ * Get the most source frames that one control block of a sample can read,
+ * including the frames still owed from the last block.
+ */
+size_t GetMaxSourceFrames() {
+  return static_cast<size_t>(SincResampler::kMaxRatio) *
+         (VoicePool::kControlFrames + 1) + 1;
+}
+
+// Idle workers spin, then yield, then sleep between polls for a new job
+const size_t kWorkerSpinPolls = 1000;
+const size_t kWorkerYieldPolls = 100000;
+const std::chrono::microseconds kWorkerSleep(200);
+
+// Layout of the job word: generation, number of partitions, next partition
+const unsigned kGenerationShift = 32;
+const unsigned kNumPartitionsShift = 16;
+const uint64_t kPartitionMask = 0xFFFF;
+
+uint64_t MakeJob(uint32_t generation, size_t num_partitions) {
+  return (static_cast<uint64_t>(generation) << kGenerationShift) |
+         (static_cast<uint64_t>(num_partitions) << kNumPartitionsShift);
+}
+
+uint32_t GetJobGeneration(uint64_t job) {
+  return static_cast<uint32_t>(job >> kGenerationShift);
+}
+
+size_t GetJobNumPartitions(uint64_t job) {
+  return static_cast<size_t>((job >> kNumPartitionsShift) & kPartitionMask);
+}
+
+size_t GetJobNextPartition(uint64_t job) {
+  return static_cast<size_t>(job & kPartitionMask);
+}
+
+/**
+ * Get the frames left in the control block after rendering some frames.
+ */
+size_t GetControlFramesLeft(size_t frames_left, size_t num_frames) {
+  if (num_frames <= frames_left) {
+    return frames_left - num_frames;
+  }
+
+  size_t into_block = (num_frames - frames_left) % VoicePool::kControlFrames;
+  return into_block == 0 ? 0 : VoicePool::kControlFrames - into_block;
+}
+
+} // namespace
+
+VoicePool::VoicePool(size_t num_voices, double sample_rate) :
+    sample_rate_(sample_rate),
+    job_(0),
+    num_partitions_done_(0),
+    stop_workers_(false),
+    num_active_voices_(0),
+    num_stolen_voices_(0) {
+  if (num_voices == 0) {
+    throw std::out_of_range("Voice pool must have at least one voice.");
+  }
+
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  // Round up to whole SIMD groups; the extra voices are played like any other
+  num_voices_ = (num_voices + simd::kLanes - 1) / simd::kLanes * simd::kLanes;
+
+  phase_ = std::vector<float>(num_voices_, 0);
+  phase_increment_ = std::vector<float>(num_voices_, 0);
+  wavetable_level_ = std::vector<size_t>(num_voices_, 0);
+  envelope_level_ = std::vector<float>(num_voices_, 0);
+  envelope_step_ = std::vector<float>(num_voices_, 0);
+  release_rate_ = std::vector<float>(num_voices_, 0);
+  note_cutoff_ = std::vector<double>(num_voices_, cutoff_);
+  envelope_stage_ =
+      std::vector<EnvelopeStage>(num_voices_, EnvelopeStage::kIdle);
+  note_ = std::vector<int>(num_voices_, 0);
+  serial_ = std::vector<uint64_t>(num_voices_, 0);
+  group_active_ = std::vector<uint8_t>(num_voices_ / simd::kLanes, 0);
+  morph_from_ = std::vector<float>(num_voices_, 0);
+  morph_to_ = std::vector<float>(num_voices_, 0);
+  increment_step_ = std::vector<float>(num_voices_, 0);
+  morph_blocks_ = std::vector<size_t>(num_voices_, 0);
+  morph_blocks_left_ = std::vector<size_t>(num_voices_, 0);
+  sample_history_ =
+      std::vector<float>(num_voices_ * 2 * SincResampler::kTaps, 0);
+  sample_history_index_ = std::vector<size_t>(num_voices_, 0);
+  sample_fraction_ = std::vector<double>(num_voices_, 0);
+
+  filters_ = BiquadBank(num_voices_, sample_rate, cutoff_);
+  SetSampleRate(sample_rate);
+  SetNumThreads(1);
+}
+
+VoicePool::~VoicePool() {
+  StopWorkers();
+}
+
+void VoicePool::NoteOn(int note, double frequency) {
+  size_t voice = AllocateVoice(note);
+
+  if (envelope_stage_[voice] == EnvelopeStage::kIdle) {
+    // Fresh voices start from a clean state so rendering is deterministic
+    phase_[voice] = 0;
+
+    size_t first_partial = voice * max_partials_;
+    std::fill(partial_real_.begin() + first_partial,
+              partial_real_.begin() + first_partial + max_partials_, 1.0f);
+    std::fill(partial_imag_.begin() + first_partial,
+              partial_imag_.begin() + first_partial + max_partials_, 0.0f);
+  }
+
+  // Recordings always play from their start
+  if (sample_ != nullptr) {
+    StartSample(voice);
+  }
+
+  // Each note starts at the pool's cutoff until it is given its own
+  note_cutoff_[voice] = cutoff_;
+  filters_.SetFilter(voice, filter_mode_, cutoff_, resonance_);
+  if (envelope_stage_[voice] == EnvelopeStage::kIdle) {
+    filters_.Reset(voice);
+  }
+
+  note_[voice] = note;
+  serial_[voice] = next_serial_++;
+  envelope_stage_[voice] = EnvelopeStage::kAttack;
+  TuneVoice(voice, frequency);
+  control_frames_left_ = 0;
+}
+
+void VoicePool::NoteOff(int note) {
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (note_[voice] == note &&
+        envelope_stage_[voice] != EnvelopeStage::kIdle &&
+        envelope_stage_[voice] != EnvelopeStage::kRelease) {
+      envelope_stage_[voice] = EnvelopeStage::kRelease;
+      release_rate_[voice] = static_cast<float>(
+          envelope_level_[voice] / std::max(1.0, release_ * sample_rate_));
+      control_frames_left_ = 0;
+    }
+  }
+}
+
+void VoicePool::SetNoteFrequency(int note, double frequency) {
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (note_[voice] == note &&
+        envelope_stage_[voice] != EnvelopeStage::kIdle) {
+      TuneVoice(voice, frequency);
+    }
+  }
+}
+
+void VoicePool::ReleaseAll() {
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (envelope_stage_[voice] != EnvelopeStage::kIdle) {
+      NoteOff(note_[voice]);
+    }
+  }
+}
+
+void VoicePool::MorphScale(const ScaleMorph& morph) {
+  size_t num_blocks = std::max<size_t>(1, static_cast<size_t>(std::ceil(
+      morph.GetDuration() * sample_rate_ / kControlFrames)));
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (envelope_stage_[voice] == EnvelopeStage::kIdle) {
+      continue;
+    }
+
+    // Voices that are still morphing are found by the note they are headed to
+    int note_idx = morph.FindNote(morph_to_[voice] * sample_rate_);
+    if (note_idx < 0) {
+      continue; // Not a note of the outgoing scale
+    }
+
+    morph_from_[voice] = phase_increment_[voice];
+    morph_to_[voice] = static_cast<float>(
+        morph.GetToFrequency(note_idx) / sample_rate_);
+    morph_blocks_[voice] = num_blocks;
+    morph_blocks_left_[voice] = num_blocks;
+    increment_step_[voice] = 0;
+  }
+
+  control_frames_left_ = 0; // Start the morph on this frame
+}
+
+void VoicePool::SetWaveform(Waveform waveform) {
+  if (waveform == Waveform::kAdditive) {
+    if (timbre_ == nullptr) {
+      return; // No timbre to play yet
+    }
+
+    // Partials do not read the wavetables, but keep a valid one selected
+    wavetable_ = &wavetables_[static_cast<size_t>(Waveform::kSine)];
+  } else if (waveform == Waveform::kSample) {
+    if (sample_ == nullptr) {
+      return; // No sample to play yet
+    }
+
+    wavetable_ = &wavetables_[static_cast<size_t>(Waveform::kSine)];
+  } else if (waveform == Waveform::kCustom) {
+    if (custom_wavetable_ == nullptr) {
+      return; // No custom wavetable to play yet
+    }
+
+    wavetable_ = custom_wavetable_;
+  } else {
+    wavetable_ = &wavetables_[static_cast<size_t>(waveform)];
+  }
+
+  waveform_ = waveform;
+
+  // Levels depend on the number of levels of the new wavetable
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    wavetable_level_[voice] = wavetable_->GetLevel(phase_increment_[voice]);
+  }
+}
+
+void VoicePool::SetWavetable(const Wavetable* wavetable) {
+  if (wavetable == nullptr) {
+    throw std::out_of_range("Wavetable must not be null.");
+  }
+
+  custom_wavetable_ = wavetable;
+  SetWaveform(Waveform::kCustom);
+}
+
+void VoicePool::SetMaxPartials(size_t max_partials) {
+  max_partials_ = std::min(
+      (max_partials + simd::kLanes - 1) / simd::kLanes * simd::kLanes,
+      AdditiveTimbre::kMaxPartials);
+
+  size_t num_partials = num_voices_ * max_partials_;
+  partial_ratio_ = std::vector<float>(max_partials_, 0);
+  partial_real_ = std::vector<float>(num_partials, 1);
+  partial_imag_ = std::vector<float>(num_partials, 0);
+  partial_cos_ = std::vector<float>(num_partials, 1);
+  partial_sin_ = std::vector<float>(num_partials, 0);
+  partial_amplitude_ = std::vector<float>(num_partials, 0);
+  num_partials_ = std::vector<size_t>(num_voices_, 0);
+
+  if (timbre_ != nullptr) {
+    SetTimbre(timbre_);
+  }
+}
+
+void VoicePool::SetTimbre(const AdditiveTimbre* timbre) {
+  if (timbre == nullptr) {
+    throw std::out_of_range("Timbre must not be null.");
+  }
+
+  if (max_partials_ == 0) {
+    return; // No partials to play the timbre on
+  }
+
+  timbre_ = timbre;
+  size_t num_timbre_partials =
+      std::min(timbre->GetNumPartials(), max_partials_);
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (envelope_stage_[voice] == EnvelopeStage::kIdle) {
+      continue; // Idle voices are tuned when they start
+    }
+
+    size_t num_audible = 0;
+    for (size_t partial = 0; partial < max_partials_; ++partial) {
+      size_t index = voice * max_partials_ + partial;
+      float ratio = 0;
+      float amplitude = 0;
+      if (partial < num_timbre_partials) {
+        ratio = timbre->GetRatio(partial);
+        amplitude = timbre->GetAmplitude(partial);
+      }
+
+      if (ratio == partial_ratio_[partial]) {
+        // Unmoved partials keep their rotation; only the level changes.
+        // Parked partials are the ones that do not rotate.
+        if (partial_sin_[index] != 0) {
+          partial_amplitude_[index] = amplitude;
+          num_audible = partial + 1;
+        }
+        continue;
+      }
+
+      if (partial_ratio_[partial] == 0) {
+        partial_real_[index] = 1; // A new partial starts from zero phase
+        partial_imag_[index] = 0;
+      }
+
+      if (TunePartial(voice, partial, ratio, amplitude)) {
+        num_audible = partial + 1;
+      }
+    }
+
+    num_partials_[voice] = num_audible;
+  }
+
+  for (size_t partial = 0; partial < max_partials_; ++partial) {
+    partial_ratio_[partial] =
+        partial < num_timbre_partials ? timbre->GetRatio(partial) : 0;
+  }
+
+  SetWaveform(Waveform::kAdditive);
+}
+
+void VoicePool::SetSample(StreamedSample* sample) {
+  if (sample == nullptr) {
+    throw std::out_of_range("Sample must not be null.");
+  }
+
+  if (sample->GetNumStreams() < num_voices_) {
+    throw std::out_of_range("Sample must have a stream for every voice.");
+  }
+
+  sample_ = sample;
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (envelope_stage_[voice] != EnvelopeStage::kIdle) {
+      StartSample(voice);
+    }
+  }
+
+  SetWaveform(Waveform::kSample);
+}
+
+void VoicePool::SetFilterCutoff(double cutoff) {
+  cutoff_ = cutoff;
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    note_cutoff_[voice] = cutoff;
+    filters_.SetCutoff(voice, cutoff);
+  }
+}
+
+void VoicePool::SetFilterMode(FilterMode mode) {
+  filter_mode_ = mode;
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    filters_.SetFilter(voice, mode, filters_.GetCutoff(voice), resonance_);
+  }
+}
+
+void VoicePool::SetFilterResonance(double resonance) {
+  if (resonance <= 0) {
+    throw std::out_of_range("Resonance must be a positive real number");
+  }
+
+  resonance_ = resonance;
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    filters_.SetFilter(voice, filter_mode_, filters_.GetCutoff(voice),
+                       resonance);
+  }
+}
+
+void VoicePool::SetNoteFilterCutoff(int note, double cutoff) {
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (note_[voice] == note &&
+        envelope_stage_[voice] != EnvelopeStage::kIdle) {
+      note_cutoff_[voice] = cutoff;
+      filters_.SetCutoff(voice, cutoff);
+    }
+  }
+}
+
+void VoicePool::SetFilterEnvelope(double octaves) {
+  filter_envelope_ = octaves;
+}
+
+void VoicePool::SetEnvelope(
+    double attack, double decay, double sustain, double release) {
+  if (attack < 0 || decay < 0 || release < 0 || sustain < 0 || sustain > 1) {
+    throw std::out_of_range("Invalid envelope.");
+  }
+
+  attack_ = attack;
+  decay_ = decay;
+  sustain_ = sustain;
+  release_ = release;
+  control_frames_left_ = 0;
+}
+
+void VoicePool::SetSampleRate(double sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  if (wavetables_.empty() || sample_rate != sample_rate_) {
+    wavetables_.clear();
+    for (Waveform waveform : {Waveform::kSine,
+                              Waveform::kTriangle,
+                              Waveform::kSquare,
+                              Waveform::kSawtooth}) {
+      wavetables_.push_back(Wavetable::FromWaveform(waveform, sample_rate));
+    }
+  }
+
+  // Keep sounding voices and their morphs at the same pitch
+  float rate_ratio = static_cast<float>(sample_rate_ / sample_rate);
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    phase_increment_[voice] *= rate_ratio;
+    morph_from_[voice] *= rate_ratio;
+    morph_to_[voice] *= rate_ratio;
+    increment_step_[voice] *= rate_ratio;
+  }
+
+  sample_rate_ = sample_rate;
+  SetWaveform(waveform_); // Reselects the wavetable and every voice's level
+  for (size_t voice = 0; voice < num_partials_.size(); ++voice) {
+    TunePartials(voice);
+  }
+
+  // Cutoffs were clamped below the old Nyquist frequency, so reapply them
+  filters_.SetSampleRate(sample_rate);
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    filters_.SetCutoff(voice, note_cutoff_[voice]);
+  }
+  control_frames_left_ = 0;
+}
+
+void VoicePool::SetNumThreads(size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // Partitions are counted in a 16-bit field of the job word
+  num_threads = std::min<size_t>(num_threads, kPartitionMask);
+
+  StopWorkers();
+
+  voice_samples_ =
+      std::vector<float>(num_threads * kControlFrames * simd::kLanes, 0);
+  mix_ = std::vector<float>(num_threads * kControlFrames * simd::kLanes, 0);
+  partial_mix_ =
+      std::vector<float>(num_threads * kControlFrames * simd::kLanes, 0);
+  sample_source_ = std::vector<float>(num_threads * GetMaxSourceFrames(), 0);
+  partition_output_ = std::vector<float>(num_threads * kPartitionFrames, 0);
+
+  stop_workers_.store(false, std::memory_order_relaxed);
+  for (size_t worker = 1; worker < num_threads; ++worker) {
+    workers_.push_back(std::thread(&VoicePool::RunWorker, this));
+  }
+}
+
+size_t VoicePool::GetNumThreads() const {
+  return workers_.size() + 1;
+}
+
+void VoicePool::Render(float* output, size_t num_frames) {
+  size_t num_chunks = (num_voices_ + kVoicesPerChunk - 1) / kVoicesPerChunk;
+
+  // Only hand voices out when each thread gets enough to pay for the handoff
+  size_t num_partitions = std::min(
+      {GetNumThreads(), num_chunks,
+       std::max<size_t>(1, GetNumActiveVoices() / kMinVoicesPerThread)});
+
+  if (num_partitions == 1) {
+    RenderPartition(0, 1, output, num_frames);
+    control_frames_left_ = GetControlFramesLeft(control_frames_left_,
+                                                num_frames);
+  }
+
+  for (size_t rendered = 0;
+       num_partitions > 1 && rendered < num_frames;
+       rendered += job_frames_) {
+    job_frames_ = std::min(kPartitionFrames, num_frames - rendered);
+    num_partitions_done_.store(0, std::memory_order_relaxed);
+
+    uint32_t generation =
+        GetJobGeneration(job_.load(std::memory_order_relaxed)) + 1;
+    job_.store(MakeJob(generation, num_partitions), std::memory_order_release);
+
+    // Help render, then wait for partitions claimed by the workers
+    RenderClaimedPartitions(generation);
+    while (num_partitions_done_.load(std::memory_order_acquire) <
+           num_partitions) {
+    }
+
+    for (size_t frame = 0; frame < job_frames_; ++frame) {
+      float sample = 0;
+      for (size_t partition = 0; partition < num_partitions; ++partition) {
+        sample += partition_output_[partition * kPartitionFrames + frame];
+      }
+
+      output[rendered + frame] = sample;
+    }
+
+    control_frames_left_ = GetControlFramesLeft(control_frames_left_,
+                                                job_frames_);
+  }
+
+  size_t num_active = 0;
+  for (uint8_t group_active : group_active_) {
+    num_active += group_active;
+  }
+  num_active_voices_.store(num_active, std::memory_order_relaxed);
+}
+
+void VoicePool::RenderPartition(size_t partition, size_t num_partitions,
+                                float* output, size_t num_frames) {
+  size_t frames_left = control_frames_left_;
+  size_t rendered = 0;
+
+  // Control blocks carry over between calls so the output does not depend on
+  // how the caller splits its blocks, only on when the voices change
+  while (rendered < num_frames) {
+    if (frames_left == 0) {
+      AdvanceEnvelopes(partition, num_partitions, kControlFrames);
+      frames_left = kControlFrames;
+    }
+
+    size_t block_frames = std::min(frames_left, num_frames - rendered);
+    RenderControlBlock(partition, num_partitions,
+                       output + rendered, block_frames);
+    rendered += block_frames;
+    frames_left -= block_frames;
+  }
+}
+
+void VoicePool::RenderClaimedPartitions(uint32_t generation) {
+  uint64_t job = job_.load(std::memory_order_acquire);
+
+  while (GetJobGeneration(job) == generation &&
+         GetJobNextPartition(job) < GetJobNumPartitions(job)) {
+    if (job_.compare_exchange_weak(job, job + 1,
+                                   std::memory_order_acq_rel,
+                                   std::memory_order_acquire)) {
+      size_t partition = GetJobNextPartition(job);
+      RenderPartition(partition, GetJobNumPartitions(job),
+                      &partition_output_[partition * kPartitionFrames],
+                      job_frames_);
+      num_partitions_done_.fetch_add(1, std::memory_order_release);
+
+      job = job_.load(std::memory_order_acquire);
+    }
+  }
+}
+
+void VoicePool::RunWorker() {
+  uint32_t seen_generation =
+      GetJobGeneration(job_.load(std::memory_order_acquire));
+  size_t num_idle_polls = 0;
+
+  while (!stop_workers_.load(std::memory_order_acquire)) {
+    uint32_t generation =
+        GetJobGeneration(job_.load(std::memory_order_acquire));
+
+    if (generation != seen_generation) {
+      seen_generation = generation;
+      num_idle_polls = 0;
+
+      realtime::AudioThreadScope audio_thread;
+      RenderClaimedPartitions(generation);
+      continue;
+    }
+
+    // A sleeping worker only delays its share; the caller renders any
+    // partition left unclaimed
+    ++num_idle_polls;
+    if (num_idle_polls > kWorkerYieldPolls) {
+      std::this_thread::sleep_for(kWorkerSleep);
+    } else if (num_idle_polls > kWorkerSpinPolls) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void VoicePool::StopWorkers() {
+  stop_workers_.store(true, std::memory_order_release);
+
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+
+  workers_.clear();
+}
+
+void VoicePool::TuneVoice(size_t voice, double frequency) {
+  phase_increment_[voice] = static_cast<float>(frequency / sample_rate_);
+
+  wavetable_level_[voice] = wavetable_->GetLevel(phase_increment_[voice]);
+  TunePartials(voice);
+
+  // A retuned note stops following any morph
+  morph_from_[voice] = phase_increment_[voice];
+  morph_to_[voice] = phase_increment_[voice];
+  increment_step_[voice] = 0;
+  morph_blocks_left_[voice] = 0;
+}
+
+void VoicePool::AdvanceMorph(size_t voice, size_t num_frames) {
+  if (morph_blocks_left_[voice] == 0) {
+    if (increment_step_[voice] == 0) {
+      return; // Not morphing
+    }
+
+    // The morph has ended; land exactly on the incoming note
+    phase_increment_[voice] = morph_to_[voice];
+    increment_step_[voice] = 0;
+  } else {
+    double distance = morph_to_[voice] - morph_from_[voice];
+    double progress = 1.0 - static_cast<double>(morph_blocks_left_[voice]) /
+                            morph_blocks_[voice];
+
+    phase_increment_[voice] =
+        static_cast<float>(morph_from_[voice] + distance * progress);
+    increment_step_[voice] = static_cast<float>(
+        distance / (morph_blocks_[voice] * num_frames));
+    --morph_blocks_left_[voice];
+  }
+
+  // Band-limit for the highest frequency reached in the block
+  float end_increment =
+      phase_increment_[voice] + increment_step_[voice] * num_frames;
+  wavetable_level_[voice] = wavetable_->GetLevel(
+      std::max(phase_increment_[voice], end_increment));
+  TunePartials(voice);
+}
+
+void VoicePool::TunePartials(size_t voice) {
+  if (timbre_ == nullptr) {
+    return;
+  }
+
+  size_t num_timbre_partials =
+      std::min(timbre_->GetNumPartials(), max_partials_);
+  size_t num_audible = 0;
+
+  for (size_t partial = 0; partial < max_partials_; ++partial) {
+    float ratio = 0;
+    float amplitude = 0;
+    if (partial < num_timbre_partials) {
+      ratio = timbre_->GetRatio(partial);
+      amplitude = timbre_->GetAmplitude(partial);
+    }
+
+    if (TunePartial(voice, partial, ratio, amplitude)) {
+      num_audible = partial + 1;
+    }
+  }
+
+  num_partials_[voice] = num_audible;
+}
+
+bool VoicePool::TunePartial(
+    size_t voice, size_t partial, float ratio, float amplitude) {
+  size_t index = voice * max_partials_ + partial;
+  float increment = phase_increment_[voice] * ratio;
+
+  if (ratio == 0 || increment >= kMaxPartialIncrement) {
+    partial_cos_[index] = 1; // Parked partials stand still and stay silent
+    partial_sin_[index] = 0;
+    partial_amplitude_[index] = 0;
+    return false;
+  }
+
+  partial_cos_[index] = static_cast<float>(std::cos(kTwoPi * increment));
+  partial_sin_[index] = static_cast<float>(std::sin(kTwoPi * increment));
+  partial_amplitude_[index] = amplitude;
+  return true;
+}
+
+size_t VoicePool::GetNumVoices() const {
+  return num_voices_;
+}
+
+size_t VoicePool::GetNumActiveVoices() const {
+  return num_active_voices_.load(std::memory_order_relaxed);
+}
+
+size_t VoicePool::GetNumStolenVoices() const {
+  return num_stolen_voices_.load(std::memory_order_relaxed);
+}
+
+double VoicePool::GetNoteFrequency(int note) const {
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    if (note_[voice] == note &&
+        envelope_stage_[voice] != EnvelopeStage::kIdle) {
+      return phase_increment_[voice] * sample_rate_;
+    }
+  }
+
+  return 0;
+}
+
+size_t VoicePool::AllocateVoice(int note) {
+  size_t free_voice = num_voices_;
+  size_t quietest_released = num_voices_;
+  size_t oldest = 0;
+
+  for (size_t voice = 0; voice < num_voices_; ++voice) {
+    EnvelopeStage stage = envelope_stage_[voice];
+
+    if (stage != EnvelopeStage::kIdle && note_[voice] == note) {
+      return voice; // Retrigger the voice already playing this note
+    }
+
+    if (stage == EnvelopeStage::kIdle) {
+      if (free_voice == num_voices_) {
+        free_voice = voice;
+      }
+    } else if (stage == EnvelopeStage::kRelease) {
+      if (quietest_released == num_voices_ ||
+          envelope_level_[voice] < envelope_level_[quietest_released]) {
+        quietest_released = voice;
+      }
+    }
+
+    if (serial_[voice] < serial_[oldest]) {
+      oldest = voice;
+    }
+  }
+
+  if (free_voice < num_voices_) {
+    return free_voice;
+  }
+
+  num_stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+
+  if (quietest_released < num_voices_) {
+    return quietest_released;
+  }
+
+  return oldest;
+}
+
+void VoicePool::AdvanceEnvelopes(size_t partition, size_t num_partitions,
+                                 size_t num_frames) {
+  double attack_rate = 1.0 / std::max(1.0, attack_ * sample_rate_);
+  double decay_rate =
+      (1.0 - sustain_) / std::max(1.0, decay_ * sample_rate_);
+
+  for (size_t chunk = partition * kVoicesPerChunk; chunk < num_voices_;
+       chunk += num_partitions * kVoicesPerChunk) {
+    size_t chunk_end = std::min(chunk + kVoicesPerChunk, num_voices_);
+    std::fill(group_active_.begin() + chunk / simd::kLanes,
+              group_active_.begin() + chunk_end / simd::kLanes, 0);
+
+    for (size_t voice = chunk; voice < chunk_end; ++voice) {
+      AdvanceMorph(voice, num_frames);
+
+      float level = envelope_level_[voice];
+      double end_level = 0;
+
+      switch (envelope_stage_[voice]) {
+        case EnvelopeStage::kIdle:
+          end_level = 0;
+          break;
+        case EnvelopeStage::kAttack:
+          end_level = level + attack_rate * num_frames;
+          if (end_level >= 1) {
+            end_level = 1;
+            envelope_stage_[voice] = EnvelopeStage::kDecay;
+          }
+          break;
+        case EnvelopeStage::kDecay:
+          end_level = level - decay_rate * num_frames;
+          if (end_level <= sustain_) {
+            end_level = sustain_;
+            envelope_stage_[voice] = EnvelopeStage::kSustain;
+          }
+          break;
+        case EnvelopeStage::kSustain:
+          end_level = sustain_;
+          break;
+        case EnvelopeStage::kRelease:
+          end_level = level - release_rate_[voice] * num_frames;
+          if (end_level <= 0) {
+            end_level = 0;
+            envelope_stage_[voice] = EnvelopeStage::kIdle;
+          }
+          break;
+      }
+
+      envelope_step_[voice] =
+          static_cast<float>((end_level - level) / num_frames);
+
+      if (level > 0 || end_level > 0) {
+        ++group_active_[voice / simd::kLanes];
+
+        if (filter_envelope_ != 0) {
+          filters_.SetCutoff(voice, note_cutoff_[voice] *
+                                    std::exp2(filter_envelope_ * end_level));
+        }
+      }
+    }
+
+    filters_.Glide(chunk, chunk_end, num_frames);
+  }
+}
+
+void VoicePool::RenderWavetables(
+    size_t first, float* samples, size_t num_frames) {
+  const Float4 kOne = simd::Splat(1);
+  const Float4 kTableSize = simd::Splat(Wavetable::kTableSize);
+
+  Float4 phase = simd::Load(&phase_[first]);
+  Float4 increment = simd::Load(&phase_increment_[first]);
+  Float4 increment_step = simd::Load(&increment_step_[first]);
+
+  const float* tables[simd::kLanes];
+  for (size_t lane = 0; lane < simd::kLanes; ++lane) {
+    tables[lane] = wavetable_->GetTable(wavetable_level_[first + lane]);
+  }
+
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    // Gather neighbouring table samples, then interpolate in SIMD
+    Float4 position = phase * kTableSize;
+    Float4 whole = simd::Truncate(position);
+    float indices[simd::kLanes];
+    float lower[simd::kLanes];
+    float upper[simd::kLanes];
+
+    simd::Store(indices, whole);
+    for (size_t lane = 0; lane < simd::kLanes; ++lane) {
+      size_t index = static_cast<size_t>(indices[lane]);
+      lower[lane] = tables[lane][index];
+      upper[lane] = tables[lane][index + 1];
+    }
+
+    Float4 lower_sample = simd::Load(lower);
+    simd::Store(samples + frame * simd::kLanes,
+                lower_sample + (simd::Load(upper) - lower_sample) *
+                               (position - whole));
+
+    phase = phase + increment;
+    phase = phase - simd::Step(kOne, phase);
+    increment = increment + increment_step; // Nonzero only while morphing
+  }
+
+  simd::Store(&phase_[first], phase);
+  simd::Store(&phase_increment_[first], increment);
+}
+
+void VoicePool::RenderPartials(size_t voice, float* partial_mix,
+                               float* samples, size_t num_frames) {
+  if (envelope_level_[voice] == 0 && envelope_step_[voice] == 0) {
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+      samples[frame * simd::kLanes] = 0; // Idle lane of a sounding group
+    }
+    return;
+  }
+
+  std::fill(partial_mix, partial_mix + num_frames * simd::kLanes, 0.0f);
+
+  const Float4 kHalf = simd::Splat(0.5f);
+  const Float4 kThreeHalves = simd::Splat(1.5f);
+
+  for (size_t index = voice * max_partials_;
+       index < voice * max_partials_ + num_partials_[voice];
+       index += simd::kLanes) {
+    Float4 real = simd::Load(&partial_real_[index]);
+    Float4 imag = simd::Load(&partial_imag_[index]);
+    Float4 cos = simd::Load(&partial_cos_[index]);
+    Float4 sin = simd::Load(&partial_sin_[index]);
+    Float4 amplitude = simd::Load(&partial_amplitude_[index]);
+
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+      // Rotate each phasor by its partial's angle per sample
+      Float4 next_real = real * cos - imag * sin;
+      imag = real * sin + imag * cos;
+      real = next_real;
+
+      float* frame_mix = &partial_mix[frame * simd::kLanes];
+      simd::Store(frame_mix, simd::Load(frame_mix) + imag * amplitude);
+    }
+
+    // Pull the phasors back onto the unit circle before rounding drifts them
+    Float4 gain = kThreeHalves - kHalf * (real * real + imag * imag);
+    simd::Store(&partial_real_[index], real * gain);
+    simd::Store(&partial_imag_[index], imag * gain);
+  }
+
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    samples[frame * simd::kLanes] = simd::HorizontalSum(
+        simd::Load(&partial_mix[frame * simd::kLanes]));
+  }
+}
+
+void VoicePool::RenderSample(size_t voice, float* source, float* samples,
+                             size_t num_frames) {
+  if (envelope_level_[voice] == 0 && envelope_step_[voice] == 0) {
+    for (size_t frame = 0; frame < num_frames; ++frame) {
+      samples[frame * simd::kLanes] = 0; // Idle lane of a sounding group
+    }
+    return;
+  }
+
+  // Source frames read per output frame, following any morph
+  double frames_per_cycle =
+      sample_->GetSampleRate() / sample_->GetRootFrequency();
+  double start_ratio = phase_increment_[voice] * frames_per_cycle;
+  double ratio_step = increment_step_[voice] * frames_per_cycle;
+  size_t band = resampler_.GetBand(
+      std::max(start_ratio, start_ratio + ratio_step * num_frames));
+
+  // Count the source frames that the block moves past, then read them at once
+  double fraction = sample_fraction_[voice];
+  double ratio = start_ratio;
+  size_t num_source_frames = 0;
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    double whole = std::floor(fraction);
+    num_source_frames += static_cast<size_t>(whole);
+    fraction += std::min(ratio, SincResampler::kMaxRatio) - whole;
+    ratio += ratio_step;
+  }
+
+  sample_->Read(voice, source, num_source_frames);
+
+  float* history = &sample_history_[voice * 2 * SincResampler::kTaps];
+  size_t index = sample_history_index_[voice];
+  fraction = sample_fraction_[voice];
+  ratio = start_ratio;
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    double whole = std::floor(fraction);
+    for (size_t source_frame = 0; source_frame < whole; ++source_frame) {
+      history[index] = *source;
+      history[index + SincResampler::kTaps] = *source;
+      index = (index + 1) % SincResampler::kTaps;
+      ++source;
+    }
+
+    samples[frame * simd::kLanes] = resampler_.Interpolate(
+        history + index, static_cast<float>(fraction - whole), band);
+    fraction += std::min(ratio, SincResampler::kMaxRatio) - whole;
+    ratio += ratio_step;
+  }
+
+  sample_history_index_[voice] = index;
+  sample_fraction_[voice] = fraction;
+  phase_increment_[voice] += increment_step_[voice] * num_frames;
+}
+
+void VoicePool::StartSample(size_t voice) {
+  sample_->Start(voice);
+
+  std::fill(sample_history_.begin() + voice * 2 * SincResampler::kTaps,
+            sample_history_.begin() + (voice + 1) * 2 * SincResampler::kTaps,
+            0.0f);
+  sample_history_index_[voice] = 0;
+  sample_fraction_[voice] = 0;
+}
+
+void VoicePool::RenderControlBlock(size_t partition, size_t num_partitions,
+                                   float* output, size_t num_frames) {
+  float* samples = &voice_samples_[partition * kControlFrames * simd::kLanes];
+  float* mix = &mix_[partition * kControlFrames * simd::kLanes];
+  float* partial_mix =
+      &partial_mix_[partition * kControlFrames * simd::kLanes];
+  float* source = &sample_source_[partition * GetMaxSourceFrames()];
+  std::fill(mix, mix + num_frames * simd::kLanes, 0.0f);
+
+  for (size_t chunk = partition * kVoicesPerChunk; chunk < num_voices_;
+       chunk += num_partitions * kVoicesPerChunk) {
+    size_t chunk_end = std::min(chunk + kVoicesPerChunk, num_voices_);
+
+    for (size_t first = chunk; first < chunk_end; first += simd::kLanes) {
+      if (group_active_[first / simd::kLanes] == 0) {
+        continue; // Silent groups add nothing to the mix
+      }
+
+      if (waveform_ == Waveform::kAdditive) {
+        for (size_t lane = 0; lane < simd::kLanes; ++lane) {
+          RenderPartials(first + lane, partial_mix, samples + lane,
+                         num_frames);
+        }
+      } else if (waveform_ == Waveform::kSample) {
+        for (size_t lane = 0; lane < simd::kLanes; ++lane) {
+          RenderSample(first + lane, source, samples + lane, num_frames);
+        }
+      } else {
+        RenderWavetables(first, samples, num_frames);
+      }
+
+      filters_.Process(first, samples, num_frames);
+
+      Float4 level = simd::Load(&envelope_level_[first]);
+      Float4 step = simd::Load(&envelope_step_[first]);
+
+      for (size_t frame = 0; frame < num_frames; ++frame) {
+        float* frame_mix = &mix[frame * simd::kLanes];
+        simd::Store(frame_mix, simd::Load(frame_mix) +
+                               simd::Load(samples + frame * simd::kLanes) *
+                               level);
+        level = level + step;
+      }
+
+      simd::Store(&envelope_level_[first], simd::Max(level, simd::Splat(0)));
+    }
+  }
+
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    output[frame] = kVoiceGain *
+        simd::HorizontalSum(simd::Load(&mix[frame * simd::kLanes]));
+  }
+}
+
+} // namespace scalepiegraph
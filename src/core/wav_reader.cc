@@ -0,0 +1,161 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/wav_reader.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+namespace {
+
+const uint16_t kPcmFormat = 1;
+const uint16_t kFloatFormat = 3;
+const uint16_t kExtensibleFormat = 0xFFFE;
+
+/**
+ * Decode an unsigned little-endian integer, independent of the byte order of
+ * the host.
+ */
+uint32_t ReadLittleEndian(const unsigned char* bytes, size_t num_bytes) {
+  uint32_t value = 0;
+  for (size_t byte = 0; byte < num_bytes; ++byte) {
+    value |= static_cast<uint32_t>(bytes[byte]) << (8 * byte);
+  }
+
+  return value;
+}
+
+/**
+ * Read exactly the specified number of bytes from a file.
+ */
+void ReadBytes(std::ifstream& file, unsigned char* bytes, size_t num_bytes) {
+  file.read(reinterpret_cast<char*>(bytes), num_bytes);
+  if (static_cast<size_t>(file.gcount()) != num_bytes) {
+    throw std::runtime_error("Truncated WAV file.");
+  }
+}
+
+} // namespace
+
+WavReader::WavReader(const std::string& path) :
+    file_(path, std::ios::binary) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("Cannot open " + path + " for reading.");
+  }
+
+  unsigned char riff[12];
+  ReadBytes(file_, riff, sizeof(riff));
+  if (std::memcmp(riff, "RIFF", 4) != 0 ||
+      std::memcmp(riff + 8, "WAVE", 4) != 0) {
+    throw std::runtime_error("Not a WAV file.");
+  }
+
+  // Walk the chunks until the samples, skipping any we do not need
+  bool has_format = false;
+  while (true) {
+    unsigned char chunk[8];
+    ReadBytes(file_, chunk, sizeof(chunk));
+    uint32_t chunk_size = ReadLittleEndian(chunk + 4, 4);
+
+    if (std::memcmp(chunk, "fmt ", 4) == 0) {
+      if (chunk_size < 16) {
+        throw std::runtime_error("Truncated WAV format.");
+      }
+
+      std::vector<unsigned char> format(chunk_size);
+      ReadBytes(file_, format.data(), chunk_size);
+      format_ = static_cast<uint16_t>(ReadLittleEndian(&format[0], 2));
+      num_channels_ = static_cast<uint16_t>(ReadLittleEndian(&format[2], 2));
+      sample_rate_ = ReadLittleEndian(&format[4], 4);
+      bytes_per_sample_ =
+          static_cast<uint16_t>(ReadLittleEndian(&format[14], 2) / 8);
+
+      // Extensible files keep the real format in their subformat GUID
+      if (format_ == kExtensibleFormat && chunk_size >= 26) {
+        format_ = static_cast<uint16_t>(ReadLittleEndian(&format[24], 2));
+      }
+
+      has_format = true;
+    } else if (std::memcmp(chunk, "data", 4) == 0) {
+      data_offset_ = file_.tellg();
+
+      // A truncated file holds fewer samples than its header claims
+      file_.seekg(0, std::ios::end);
+      std::streamoff bytes_left = file_.tellg() - data_offset_;
+      size_t data_size = std::min(static_cast<size_t>(chunk_size),
+                                  static_cast<size_t>(bytes_left));
+
+      if (has_format && num_channels_ > 0 && bytes_per_sample_ > 0) {
+        num_frames_ = data_size / (num_channels_ * bytes_per_sample_);
+      }
+      break;
+    } else {
+      file_.seekg(chunk_size + (chunk_size & 1), std::ios::cur);
+    }
+  }
+
+  bool is_pcm = format_ == kPcmFormat && bytes_per_sample_ >= 1 &&
+                bytes_per_sample_ <= 4;
+  bool is_float = format_ == kFloatFormat && bytes_per_sample_ == 4;
+  if (!has_format || num_channels_ == 0 || sample_rate_ == 0 ||
+      !(is_pcm || is_float)) {
+    throw std::runtime_error("Unsupported WAV format.");
+  }
+}
+
+size_t WavReader::Read(size_t first_frame, float* output, size_t num_frames) {
+  if (first_frame >= num_frames_) {
+    return 0;
+  }
+
+  num_frames = std::min(num_frames, num_frames_ - first_frame);
+  size_t frame_size = num_channels_ * bytes_per_sample_;
+  encoded_.resize(num_frames * frame_size);
+
+  file_.clear();
+  file_.seekg(data_offset_ + static_cast<std::streamoff>(first_frame *
+                                                          frame_size));
+  ReadBytes(file_, encoded_.data(), encoded_.size());
+
+  const unsigned char* sample = encoded_.data();
+  float channel_gain = 1.0f / num_channels_;
+  for (size_t frame = 0; frame < num_frames; ++frame) {
+    float mix = 0;
+
+    for (size_t channel = 0; channel < num_channels_; ++channel) {
+      uint32_t bits = ReadLittleEndian(sample, bytes_per_sample_);
+      sample += bytes_per_sample_;
+
+      if (format_ == kFloatFormat) {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        mix += value;
+      } else if (bytes_per_sample_ == 1) {
+        mix += (static_cast<float>(bits) - 128) / 128; // 8-bit is unsigned
+      } else {
+        // Sign-extend from the top bit of the sample
+        size_t shift = 32 - 8 * bytes_per_sample_;
+        int32_t value = static_cast<int32_t>(bits << shift) >> shift;
+        mix += value / static_cast<float>(1u << (31 - shift));
+      }
+    }
+
+    output[frame] = mix * channel_gain;
+  }
+
+  return num_frames;
+}
+
+double WavReader::GetSampleRate() const {
+  return sample_rate_;
+}
+
+size_t WavReader::GetNumChannels() const {
+  return num_channels_;
+}
+
+size_t WavReader::GetNumFrames() const {
+  return num_frames_;
+}
+
+} // namespace scalepiegraph
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/wav_writer.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t WavWriter::kHeaderSize = 44;
+
+namespace {
+
+const uint16_t kBitsPerSample = 16;
+const uint16_t kPcmFormat = 1;
+
+/**
+ * Append an integer to a byte buffer in little-endian order, independent of
+ * the byte order of the host.
+ */
+void AppendLittleEndian(std::vector<char>& bytes, uint32_t value,
+                        size_t num_bytes) {
+  for (size_t byte = 0; byte < num_bytes; ++byte) {
+    bytes.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+  }
+}
+
+} // namespace
+
+WavWriter::WavWriter(const std::string& path, double sample_rate,
+                     size_t num_channels) :
+    file_(path, std::ios::binary | std::ios::trunc),
+    sample_rate_(static_cast<uint32_t>(std::lround(sample_rate))),
+    num_channels_(static_cast<uint16_t>(num_channels)) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("Cannot open " + path + " for writing.");
+  }
+
+  if (sample_rate <= 0 || num_channels == 0) {
+    throw std::out_of_range("Invalid WAV format.");
+  }
+
+  WriteHeader();
+}
+
+WavWriter::~WavWriter() {
+  if (file_.is_open()) {
+    Close();
+  }
+}
+
+void WavWriter::Write(const float* samples, size_t num_samples) {
+  encoded_.clear();
+
+  for (size_t index = 0; index < num_samples; ++index) {
+    float clipped = std::max(-1.0f, std::min(1.0f, samples[index]));
+    int16_t quantized = static_cast<int16_t>(std::lround(clipped * 32767));
+    AppendLittleEndian(encoded_, static_cast<uint16_t>(quantized), 2);
+  }
+
+  file_.write(encoded_.data(), encoded_.size());
+  num_samples_ += num_samples;
+}
+
+void WavWriter::Close() {
+  file_.seekp(0);
+  WriteHeader();
+  file_.close();
+}
+
+size_t WavWriter::GetNumFrames() const {
+  return num_samples_ / num_channels_;
+}
+
+void WavWriter::WriteFile(const std::string& path,
+                          const std::vector<float>& samples,
+                          double sample_rate,
+                          size_t num_channels) {
+  WavWriter writer(path, sample_rate, num_channels);
+  writer.Write(samples.data(), samples.size());
+  writer.Close();
+}
+
+void WavWriter::WriteHeader() {
+  uint32_t data_size =
+      static_cast<uint32_t>(num_samples_ * kBitsPerSample / 8);
+  uint16_t block_align = num_channels_ * kBitsPerSample / 8;
+  std::vector<char> header;
+
+  header.insert(header.end(), {'R', 'I', 'F', 'F'});
+  AppendLittleEndian(header, 36 + data_size, 4);
+  header.insert(header.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+  AppendLittleEndian(header, 16, 4);
+  AppendLittleEndian(header, kPcmFormat, 2);
+  AppendLittleEndian(header, num_channels_, 2);
+  AppendLittleEndian(header, sample_rate_, 4);
+  AppendLittleEndian(header, sample_rate_ * block_align, 4);
+  AppendLittleEndian(header, block_align, 2);
+  AppendLittleEndian(header, kBitsPerSample, 2);
+  header.insert(header.end(), {'d', 'a', 't', 'a'});
+  AppendLittleEndian(header, data_size, 4);
+
+  file_.write(header.data(), header.size());
+}
+
+} // namespace scalepiegraph
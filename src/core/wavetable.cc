@@ -0,0 +1,203 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <core/wavetable.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace scalepiegraph {
+
+const size_t Wavetable::kTableSize = 2048;
+const double Wavetable::kBaseFrequency = 40;
+
+namespace {
+
+const double kPi = 3.141592653589793;
+
+} // namespace
+
+Wavetable::Wavetable(const std::vector<float>& sine_amplitudes,
+                     const std::vector<float>& cosine_amplitudes,
+                     double sample_rate) :
+    sample_rate_(sample_rate) {
+  if (sample_rate <= 0) {
+    throw std::out_of_range("Sample rate must be a positive real number");
+  }
+
+  if (sine_amplitudes.size() != cosine_amplitudes.size()) {
+    throw std::out_of_range("Harmonic amplitudes must have the same length.");
+  }
+
+  double nyquist = sample_rate / 2;
+  size_t num_levels = 1;
+  while (kBaseFrequency * (1 << (num_levels - 1)) < nyquist) {
+    ++num_levels;
+  }
+
+  // Harmonics allowed per level, capped by the resolution of the table. Every
+  // level keeps the fundamental, which lies below Nyquist for any note played
+  std::vector<size_t> num_harmonics(num_levels);
+  for (size_t level = 0; level < num_levels; ++level) {
+    double max_fundamental = kBaseFrequency * (1 << level);
+    size_t num_allowed = std::min(
+        static_cast<size_t>(nyquist / max_fundamental), kTableSize / 2);
+    num_harmonics[level] = std::min(std::max<size_t>(num_allowed, 1),
+                                    sine_amplitudes.size());
+  }
+
+  std::vector<float> sine_table(kTableSize);
+  for (size_t index = 0; index < kTableSize; ++index) {
+    sine_table[index] = static_cast<float>(std::sin(2 * kPi * index /
+                                                    kTableSize));
+  }
+
+  // Build from the top level down; each level adds harmonics to the one above
+  std::vector<double> accumulated(kTableSize, 0);
+  size_t built_harmonics = 0;
+  tables_ = std::vector<std::vector<float>>(num_levels);
+
+  for (size_t level = num_levels; level-- > 0;) {
+    for (size_t harmonic = built_harmonics;
+         harmonic < num_harmonics[level];
+         ++harmonic) {
+      size_t multiple = harmonic + 1;
+
+      for (size_t index = 0; index < kTableSize; ++index) {
+        size_t sine_index = (multiple * index) % kTableSize;
+        size_t cosine_index = (sine_index + kTableSize / 4) % kTableSize;
+
+        accumulated[index] +=
+            sine_amplitudes[harmonic] * sine_table[sine_index] +
+            cosine_amplitudes[harmonic] * sine_table[cosine_index];
+      }
+    }
+
+    built_harmonics = std::max(built_harmonics, num_harmonics[level]);
+    tables_[level] = std::vector<float>(accumulated.begin(), accumulated.end());
+  }
+
+  // Normalize every level by the peak of the full-bandwidth table
+  float peak = 0;
+  for (float sample : tables_[0]) {
+    peak = std::max(peak, std::fabs(sample));
+  }
+
+  for (std::vector<float>& table : tables_) {
+    if (peak > 0) {
+      for (float& sample : table) {
+        sample /= peak;
+      }
+    }
+
+    table.push_back(table.front()); // Guard sample for interpolation
+  }
+}
+
+Wavetable Wavetable::FromWaveform(Waveform waveform, double sample_rate) {
+  size_t max_harmonics = kTableSize / 2;
+  std::vector<float> sine_amplitudes(max_harmonics, 0);
+  std::vector<float> cosine_amplitudes(max_harmonics, 0);
+
+  for (size_t harmonic = 0; harmonic < max_harmonics; ++harmonic) {
+    double multiple = harmonic + 1;
+    bool is_odd = (harmonic % 2) == 0;
+
+    switch (waveform) {
+      case Waveform::kSine:
+        sine_amplitudes[harmonic] = harmonic == 0 ? 1 : 0;
+        break;
+      case Waveform::kTriangle:
+        // Peaks at phase 0 to match 1 - 4|phase - 0.5|
+        cosine_amplitudes[harmonic] =
+            is_odd ? 8 / (kPi * kPi * multiple * multiple) : 0;
+        break;
+      case Waveform::kSquare:
+        sine_amplitudes[harmonic] = is_odd ? 4 / (kPi * multiple) : 0;
+        break;
+      case Waveform::kSawtooth:
+        // Rises from -1 to 1 to match 2 * phase - 1
+        sine_amplitudes[harmonic] = -2 / (kPi * multiple);
+        break;
+      case Waveform::kCustom:
+        throw std::out_of_range("Custom wavetables must be built from a cycle");
+      case Waveform::kAdditive:
+      case Waveform::kSample:
+        throw std::out_of_range("Only oscillators have wavetables");
+    }
+  }
+
+  return Wavetable(sine_amplitudes, cosine_amplitudes, sample_rate);
+}
+
+Wavetable Wavetable::FromCycle(const std::vector<float>& cycle,
+                               double sample_rate) {
+  if (cycle.size() < 2) {
+    throw std::out_of_range("A waveform cycle needs at least two samples.");
+  }
+
+  size_t num_harmonics = std::min(cycle.size() / 2, kTableSize / 2);
+  std::vector<float> sine_amplitudes(num_harmonics);
+  std::vector<float> cosine_amplitudes(num_harmonics);
+
+  // Discrete Fourier transform of the cycle, skipping the DC component
+  for (size_t harmonic = 0; harmonic < num_harmonics; ++harmonic) {
+    double step = 2 * kPi * (harmonic + 1) / cycle.size();
+    double rotation_cos = std::cos(step);
+    double rotation_sin = std::sin(step);
+    double phasor_cos = 1;
+    double phasor_sin = 0;
+    double sine_sum = 0;
+    double cosine_sum = 0;
+
+    for (float sample : cycle) {
+      sine_sum += sample * phasor_sin;
+      cosine_sum += sample * phasor_cos;
+
+      double next_cos = phasor_cos * rotation_cos - phasor_sin * rotation_sin;
+      phasor_sin = phasor_sin * rotation_cos + phasor_cos * rotation_sin;
+      phasor_cos = next_cos;
+    }
+
+    // The Nyquist bin of an even-length cycle is not doubled
+    double scale = 2.0 / cycle.size();
+    if (2 * (harmonic + 1) == cycle.size()) {
+      scale = 1.0 / cycle.size();
+    }
+
+    sine_amplitudes[harmonic] = static_cast<float>(scale * sine_sum);
+    cosine_amplitudes[harmonic] = static_cast<float>(scale * cosine_sum);
+  }
+
+  return Wavetable(sine_amplitudes, cosine_amplitudes, sample_rate);
+}
+
+size_t Wavetable::GetLevel(double phase_increment) const {
+  double frequency = phase_increment * sample_rate_;
+
+  if (frequency <= kBaseFrequency) {
+    return 0;
+  }
+
+  size_t level =
+      static_cast<size_t>(std::ceil(std::log2(frequency / kBaseFrequency)));
+
+  return std::min(level, tables_.size() - 1);
+}
+
+const float* Wavetable::GetTable(size_t level) const {
+  return tables_.at(level).data();
+}
+
+float Wavetable::Evaluate(size_t level, double phase) const {
+  const float* table = GetTable(level);
+  double position = (phase - std::floor(phase)) * kTableSize;
+  size_t index = std::min(static_cast<size_t>(position), kTableSize - 1);
+  float fraction = static_cast<float>(position - index);
+
+  return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+size_t Wavetable::GetNumLevels() const {
+  return tables_.size();
+}
+
+} // namespace scalepiegraph
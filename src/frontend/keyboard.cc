@@ -1,5 +1,8 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <frontend/keyboard.h>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
 
 namespace scalepiegraph {
 
@@ -8,6 +11,10 @@ namespace frontend {
 const ci::Color Keyboard::kStrokeColor = ci::Color("white");
 const ci::Color Keyboard::kKeyColor = ci::Color("black");
 const ci::Color Keyboard::kOctaveShade = ci::Color("grey");
+const ci::Color Keyboard::kPressedColor = ci::Color("steelblue");
+const size_t Keyboard::kFillVertices = 6; // Two triangles
+const float Keyboard::kMinKeyWidth = 4;
+const float Keyboard::kMaxZoom = 64;
 
 Keyboard::Keyboard(const glm::vec2& bottom_left_corner,
                    float width,
@@ -17,85 +24,290 @@ Keyboard::Keyboard(const glm::vec2& bottom_left_corner,
     width_(width),
     height_(height),
     current_divisions_(num_divisions) {
-  CreateKeys(false);
+  CreateKeys();
 }
 
 void Keyboard::Draw() {
-  // Draw bounding box
-  ci::gl::drawStrokedRect(ci::Rectf(
-      glm::vec2(bottom_left_corner_.x, bottom_left_corner_.y - height_),
-      glm::vec2(bottom_left_corner_.x + width_, bottom_left_corner_.y)));
+  size_t num_fill_vertices = GetNumBands() * kFillVertices;
 
-  CreateKeys(true);
+  if (is_mesh_stale_) {
+    vertex_vbo_ =
+        ci::gl::Vbo::create(GL_ARRAY_BUFFER, vertices_, GL_DYNAMIC_DRAW);
+    fill_mesh_ = CreateMesh(0, num_fill_vertices, GL_TRIANGLES);
+    outline_mesh_ = CreateMesh(num_fill_vertices,
+                               vertices_.size() - num_fill_vertices,
+                               GL_LINES);
+    is_mesh_stale_ = false;
+  } else if (first_dirty_vertex_ < end_dirty_vertex_) {
+    // Only recolored keys are uploaded
+    vertex_vbo_->bufferSubData(
+        first_dirty_vertex_ * sizeof(KeyVertex),
+        (end_dirty_vertex_ - first_dirty_vertex_) * sizeof(KeyVertex),
+        &vertices_[first_dirty_vertex_]);
+  }
+
+  first_dirty_vertex_ = vertices_.size();
+  end_dirty_vertex_ = 0;
+
+  ci::gl::ScopedGlslProg shader(
+      ci::gl::getStockShader(ci::gl::ShaderDef().color()));
+  ci::gl::draw(fill_mesh_);
+  ci::gl::draw(outline_mesh_);
+}
+
+bool Keyboard::IsDirty() const {
+  return is_mesh_stale_ || first_dirty_vertex_ < end_dirty_vertex_;
 }
 
 int Keyboard::GetKeyIndex(const glm::vec2& mouse_pos) const {
-  int key_idx = 0;
+  size_t num_keys = GetNumKeys();
 
-  for (const ci::Path2d& key : keys_) {
-    if (key.contains(mouse_pos)) {
-      return key_idx;
+  if (num_keys == 0 ||
+      mouse_pos.y < bottom_left_corner_.y - height_ ||
+      mouse_pos.y > bottom_left_corner_.y ||
+      mouse_pos.x < bottom_left_corner_.x ||
+      mouse_pos.x > bottom_left_corner_.x + width_ ||
+      mouse_pos.x < key_edges_.front() || mouse_pos.x > key_edges_.back()) {
+    return -1; // Position is not inside a key
+  }
+
+  size_t key_idx;
+  if (key_proportions_.empty()) {
+    // Equal keys: the index follows from the distance along the keyboard
+    float distance = (mouse_pos.x - bottom_left_corner_.x - zoom_offset_) /
+                     zoom_;
+    key_idx = static_cast<size_t>(distance * num_keys / width_);
+  } else {
+    key_idx = std::upper_bound(key_edges_.begin(), key_edges_.end(),
+                               mouse_pos.x) - key_edges_.begin() - 1;
+  }
+
+  // The right edge of the keyboard belongs to the last key
+  return static_cast<int>(std::min(key_idx, num_keys - 1));
+}
+
+void Keyboard::SetPressedKey(int key_idx) {
+  if (key_idx == pressed_key_) {
+    return;
+  }
+
+  int last_pressed_key = pressed_key_;
+  pressed_key_ = key_idx;
+
+  for (int key : {last_pressed_key, key_idx}) {
+    if (key >= 0 && static_cast<size_t>(key) < GetNumKeys()) {
+      WriteKeyColor(key);
     }
+  }
+}
 
-    ++key_idx;
+void Keyboard::SetLevelOfDetail(bool is_enabled) {
+  if (is_enabled != is_level_of_detail_) {
+    is_level_of_detail_ = is_enabled;
+    CreateKeys();
+  }
+}
+
+void Keyboard::Zoom(float factor, float anchor_x) {
+  if (factor <= 0) {
+    throw std::out_of_range("Zoom factor must be a positive real number");
   }
 
-  return -1; // Position is not inside a key
+  float zoom = std::min(std::max(zoom_ * factor, 1.0f), kMaxZoom);
+
+  // Keep the point under the anchor in place, and the keys filling the width
+  float anchor = anchor_x - bottom_left_corner_.x;
+  zoom_offset_ = anchor - (anchor - zoom_offset_) * zoom / zoom_;
+  zoom_offset_ = std::min(std::max(zoom_offset_, (1 - zoom) * width_), 0.0f);
+  zoom_ = zoom;
+
+  CreateKeys();
 }
 
-void Keyboard::UpdateDivisions(size_t num_divisions) {
-  current_divisions_ = num_divisions;
-}
-
-void Keyboard::CreateKeys(bool should_draw) {
-  keys_ = std::vector<ci::Path2d>();
-
-  for (size_t div_idx = 0;
-       div_idx < current_divisions_ * num_octaves_;
-       ++div_idx) {
-    float width_unit = width_ / (current_divisions_ * num_octaves_);
-
-    glm::vec2 upper_left_corner(
-        div_idx * width_unit, bottom_left_corner_.y - height_);
-    glm::vec2 upper_right_corner(
-        (div_idx + 1) * width_unit, bottom_left_corner_.y - height_);
-    glm::vec2 lower_right_corner(
-        (div_idx + 1) * width_unit, bottom_left_corner_.y);
-    glm::vec2 lower_left_corner(
-        div_idx * width_unit, bottom_left_corner_.y);
-
-    ci::Path2d key;
-    key.moveTo(upper_left_corner);
-    key.lineTo(upper_right_corner);
-    key.lineTo(lower_right_corner);
-    key.lineTo(lower_left_corner);
-    key.close();
-
-    if (should_draw) {
-      if (div_idx % (current_divisions_ - 1) == 0) {
-        ci::gl::color(kOctaveShade);
-        ci::gl::drawSolid(key);
-      } else {
-        ci::gl::color(kKeyColor);
-        ci::gl::drawSolid(key);
+void Keyboard::SetKeyProportions(const std::vector<float>& proportions) {
+  if (!proportions.empty()) {
+    if (proportions.size() != current_divisions_ ||
+        proportions.back() != 1) {
+      throw std::out_of_range("Proportions must end each octave's keys.");
+    }
+
+    float last_proportion = 0;
+    for (float proportion : proportions) {
+      if (proportion <= last_proportion) {
+        throw std::out_of_range("Every key must have a positive width.");
       }
 
-      ci::gl::color(kStrokeColor);
-      ci::gl::draw(key);
+      last_proportion = proportion;
     }
+  }
 
-    keys_.push_back(key);
+  key_proportions_ = proportions;
+  CreateKeys();
+}
+
+void Keyboard::UpdateDivisions(size_t num_divisions) {
+  if (num_divisions != current_divisions_) {
+    current_divisions_ = num_divisions;
+    key_proportions_.clear(); // The proportions were for the old divisions
+    CreateKeys();
   }
 }
 
+void Keyboard::CreateKeys() {
+  size_t num_keys = GetNumKeys();
+  float octave_width = width_ / num_octaves_;
+  float left = bottom_left_corner_.x;
+  float right = bottom_left_corner_.x + width_;
+  float top = bottom_left_corner_.y - height_;
+  float bottom = bottom_left_corner_.y;
+
+  // Edges are stored where they are shown, after zooming
+  key_edges_ = {left + zoom_offset_};
+  for (size_t key_idx = 1; key_idx <= num_keys; ++key_idx) {
+    float distance;
+    if (key_proportions_.empty()) {
+      distance = key_idx * width_ / num_keys;
+    } else {
+      size_t octave = (key_idx - 1) / current_divisions_;
+      float proportion = key_proportions_[(key_idx - 1) % current_divisions_];
+      distance = (octave + proportion) * octave_width;
+    }
+
+    key_edges_.push_back(left + distance * zoom_ + zoom_offset_);
+  }
+
+  // Only visible keys are drawn, in bands no narrower than kMinKeyWidth when
+  // keys are too dense to tell apart
+  size_t first_key = std::upper_bound(key_edges_.begin(), key_edges_.end(),
+                                      left) - key_edges_.begin();
+  size_t end_key = std::lower_bound(key_edges_.begin(), key_edges_.end(),
+                                    right) - key_edges_.begin();
+  first_key = first_key > 0 ? first_key - 1 : 0;
+  end_key = std::min(end_key, num_keys);
+
+  band_first_keys_ = std::vector<size_t>();
+  for (size_t key_idx = first_key; key_idx < end_key;) {
+    band_first_keys_.push_back(key_idx);
+
+    float band_left = key_edges_[key_idx];
+    ++key_idx;
+    while (is_level_of_detail_ && key_idx < end_key &&
+           key_edges_[key_idx] - band_left < kMinKeyWidth) {
+      ++key_idx;
+    }
+  }
+  band_first_keys_.push_back(end_key);
+
+  vertices_ = std::vector<KeyVertex>();
+
+  for (size_t band = 0; band < GetNumBands(); ++band) {
+    float band_left = std::max(key_edges_[band_first_keys_[band]], left);
+    float band_right = std::min(key_edges_[band_first_keys_[band + 1]], right);
+
+    ci::Color color = GetBandColor(band);
+    vertices_.push_back({glm::vec2(band_left, top), color});
+    vertices_.push_back({glm::vec2(band_right, top), color});
+    vertices_.push_back({glm::vec2(band_right, bottom), color});
+    vertices_.push_back({glm::vec2(band_left, top), color});
+    vertices_.push_back({glm::vec2(band_right, bottom), color});
+    vertices_.push_back({glm::vec2(band_left, bottom), color});
+  }
+
+  // Outlines: the edge of every band, then the top and bottom of the keyboard
+  for (size_t key_idx : band_first_keys_) {
+    float x = std::min(std::max(key_edges_[key_idx], left), right);
+    vertices_.push_back({glm::vec2(x, top), kStrokeColor});
+    vertices_.push_back({glm::vec2(x, bottom), kStrokeColor});
+  }
+
+  vertices_.push_back({glm::vec2(left, top), kStrokeColor});
+  vertices_.push_back({glm::vec2(right, top), kStrokeColor});
+  vertices_.push_back({glm::vec2(left, bottom), kStrokeColor});
+  vertices_.push_back({glm::vec2(right, bottom), kStrokeColor});
+
+  is_mesh_stale_ = true;
+}
+
+ci::Color Keyboard::GetBandColor(size_t band) const {
+  size_t first_key = band_first_keys_[band];
+  size_t end_key = band_first_keys_[band + 1];
+
+  if (pressed_key_ >= 0 && static_cast<size_t>(pressed_key_) >= first_key &&
+      static_cast<size_t>(pressed_key_) < end_key) {
+    return kPressedColor;
+  }
+
+  // Shade the band if it holds the first key of an octave
+  if (current_divisions_ > 1) {
+    size_t period = current_divisions_ - 1;
+    if ((first_key + period - 1) / period * period < end_key) {
+      return kOctaveShade;
+    }
+  }
+
+  return kKeyColor;
+}
+
+void Keyboard::WriteKeyColor(size_t key_idx) {
+  if (key_idx < band_first_keys_.front() ||
+      key_idx >= band_first_keys_.back()) {
+    return; // The key is not shown
+  }
+
+  size_t band = std::upper_bound(band_first_keys_.begin(),
+                                 band_first_keys_.end(), key_idx) -
+                band_first_keys_.begin() - 1;
+  ci::Color color = GetBandColor(band);
+  size_t first_vertex = band * kFillVertices;
+
+  for (size_t vertex = first_vertex; vertex < first_vertex + kFillVertices;
+       ++vertex) {
+    vertices_[vertex].color = color;
+  }
+
+  first_dirty_vertex_ = std::min(first_dirty_vertex_, first_vertex);
+  end_dirty_vertex_ =
+      std::max(end_dirty_vertex_, first_vertex + kFillVertices);
+}
+
+ci::gl::VboMeshRef Keyboard::CreateMesh(
+    size_t first_vertex, size_t num_vertices, GLenum primitive) const {
+  size_t offset = first_vertex * sizeof(KeyVertex);
+
+  ci::geom::BufferLayout layout;
+  layout.append(ci::geom::Attrib::POSITION, 2, sizeof(KeyVertex),
+                offset + offsetof(KeyVertex, position));
+  layout.append(ci::geom::Attrib::COLOR, 3, sizeof(KeyVertex),
+                offset + offsetof(KeyVertex, color));
+
+  return ci::gl::VboMesh::create(
+      static_cast<uint32_t>(num_vertices), primitive,
+      {{layout, vertex_vbo_}});
+}
+
 void Keyboard::SetNumOctaves(size_t num_octaves) {
-  num_octaves_ = num_octaves;
+  if (num_octaves != num_octaves_) {
+    num_octaves_ = num_octaves;
+    CreateKeys();
+  }
 }
 
 size_t Keyboard::GetNumOctaves() const {
   return num_octaves_;
 }
 
+size_t Keyboard::GetNumKeys() const {
+  return current_divisions_ * num_octaves_;
+}
+
+size_t Keyboard::GetNumBands() const {
+  return band_first_keys_.size() - 1;
+}
+
+float Keyboard::GetZoom() const {
+  return zoom_;
+}
+
 } // namespace frontend
 
 } // namespace scalepiegraph
\ No newline at end of file
@@ -1,5 +1,9 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <frontend/pie_graph.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
 
 namespace scalepiegraph {
 
@@ -7,8 +11,20 @@ namespace frontend {
 
 const float PieGraph::kCircleStartOffset = 1.5 * glm::pi<float>();
 const float PieGraph::kHandleRadius = 5;
+const float PieGraph::kOverlapOffset = 4 * PieGraph::kHandleRadius;
+const float PieGraph::kStrokeWidth = 1;
+const size_t PieGraph::kArcSegments = 128;
+const size_t PieGraph::kHandleSegments = 16;
+const size_t PieGraph::kLineVertices = 6; // Two triangles
+const size_t PieGraph::kHandleVertices =
+    PieGraph::kLineVertices + 3 * PieGraph::kHandleSegments;
 const ci::Color PieGraph::kStrokeColorPrimary = ci::Color("white");
 const ci::Color PieGraph::kStrokeColorSecondary = ci::Color("grey");
+const float PieGraph::kMaxZoom = 32;
+const float PieGraph::kMinHandleSpacing = 2 * PieGraph::kHandleRadius;
+const size_t PieGraph::kNumBands = 1024;
+const float PieGraph::kBandDepth = 3 * PieGraph::kHandleRadius;
+const float PieGraph::kBandSaturation = 8; // Divisions in a full band
 
 PieGraph::PieGraph(
     const glm::vec2& pos, float radius, std::vector<float> proportions) :
@@ -18,51 +34,150 @@ PieGraph::PieGraph(
     division_radians_.push_back(proportion * 2 * glm::pi<float>());
   }
 
-  CreateHandles(false);
+  CreateGeometry();
 }
 
-void PieGraph::Draw() {
-  ci::Path2d outer_arc;
-  ci::Path2d arc_tail_shadow;
-  ci::Path2d end_caps;
-
-  float arc_end = division_radians_.back() + kCircleStartOffset;
-  outer_arc.arc(center_, -radius_, -kCircleStartOffset, -arc_end, false);
-  outer_arc.lineTo(center_);
+PieGraph::PieGraph(const PieGraph& other) :
+    center_(other.center_),
+    radius_(other.radius_),
+    division_radians_(other.division_radians_),
+    is_level_of_detail_(other.is_level_of_detail_),
+    zoom_(other.zoom_),
+    zoom_offset_(other.zoom_offset_),
+    detailed_handles_(other.detailed_handles_),
+    handle_points_(other.handle_points_),
+    positions_(other.positions_),
+    handle_vertex_(other.handle_vertex_) {}
+
+PieGraph& PieGraph::operator=(const PieGraph& other) {
+  center_ = other.center_;
+  radius_ = other.radius_;
+  division_radians_ = other.division_radians_;
+  is_level_of_detail_ = other.is_level_of_detail_;
+  zoom_ = other.zoom_;
+  zoom_offset_ = other.zoom_offset_;
+  detailed_handles_ = other.detailed_handles_;
+  handle_points_ = other.handle_points_;
+  positions_ = other.positions_;
+  handle_vertex_ = other.handle_vertex_;
+
+  // The mesh of the other graph is not shared; upload a fresh one
+  first_dirty_vertex_ = 0;
+  is_outline_dirty_ = false;
+  position_vbo_.reset();
+  mesh_.reset();
+
+  return *this;
+}
 
-  arc_tail_shadow.arc(center_, -radius_, -arc_end, -kCircleStartOffset, false);
+void PieGraph::Draw() {
+  if (!mesh_ || positions_.size() > vertex_capacity_) {
+    // Leave room for handles to come into detail without reallocating
+    vertex_capacity_ = 2 * positions_.size();
+    std::vector<glm::vec2> positions(positions_);
+    positions.resize(vertex_capacity_);
+
+    // The shadow of the arc's tail comes first in the outline
+    std::vector<ci::Color> colors(vertex_capacity_, kStrokeColorPrimary);
+    std::fill(colors.begin() + kLineVertices,
+              colors.begin() + kLineVertices + kArcSegments * kLineVertices,
+              kStrokeColorSecondary);
+
+    ci::geom::BufferLayout position_layout;
+    position_layout.append(ci::geom::Attrib::POSITION, 2, 0, 0);
+    ci::geom::BufferLayout color_layout;
+    color_layout.append(ci::geom::Attrib::COLOR, 3, 0, 0);
+
+    position_vbo_ =
+        ci::gl::Vbo::create(GL_ARRAY_BUFFER, positions, GL_DYNAMIC_DRAW);
+    mesh_ = ci::gl::VboMesh::create(
+        static_cast<uint32_t>(vertex_capacity_), GL_TRIANGLES,
+        {{position_layout, position_vbo_},
+         {color_layout, ci::gl::Vbo::create(GL_ARRAY_BUFFER, colors)}});
+  } else {
+    // Only the outline, the bands and the handles after a move are uploaded
+    if (is_outline_dirty_ && first_dirty_vertex_ > kLineVertices) {
+      UploadPositions(kLineVertices,
+                      std::min(handle_vertex_, first_dirty_vertex_));
+    }
 
-  glm::vec2 start(center_.x, center_.y - radius_);
-  end_caps.moveTo(center_);
-  end_caps.lineTo(start);
+    UploadPositions(first_dirty_vertex_, positions_.size());
+  }
 
-  ci::gl::color(kStrokeColorSecondary);
-  ci::gl::draw(arc_tail_shadow);
+  first_dirty_vertex_ = positions_.size();
+  is_outline_dirty_ = false;
+
+  // A zoomed graph stays inside the square it covers unzoomed
+  std::unique_ptr<ci::gl::ScopedScissor> scissor;
+  if (zoom_ > 1) {
+    float extent = radius_ + kOverlapOffset + kHandleRadius;
+    int viewport_height = ci::gl::getViewport().second.y;
+    scissor.reset(new ci::gl::ScopedScissor(
+        glm::ivec2(center_.x - extent, viewport_height - center_.y - extent),
+        glm::ivec2(2 * extent, 2 * extent)));
+  }
 
-  ci::gl::color(kStrokeColorPrimary);
-  ci::gl::draw(outer_arc);
-  ci::gl::draw(end_caps);
+  ci::gl::ScopedGlslProg shader(
+      ci::gl::getStockShader(ci::gl::ShaderDef().color()));
+  ci::gl::draw(mesh_, 0, static_cast<GLsizei>(positions_.size()));
+}
 
-  CreateHandles(true);
+bool PieGraph::IsDirty() const {
+  return !mesh_ || is_outline_dirty_ ||
+         first_dirty_vertex_ < positions_.size();
 }
 
 int PieGraph::GetHandleIndex(const glm::vec2& pos) const {
-  int handle_idx = 0;
+  float extent = radius_ + kOverlapOffset + kHandleRadius;
+  if (zoom_ > 1 && (std::abs(pos.x - center_.x) > extent ||
+                    std::abs(pos.y - center_.y) > extent)) {
+    return -1; // Position is outside the graph, where handles are hidden
+  }
 
-  for (const ci::Path2d& handle : current_handles_) {
-    if (handle.contains(pos)) {
-      return handle_idx;
-    }
+  float view_radius = GetViewRadius();
+  glm::vec2 offset = pos - GetViewCenter();
+  float distance = glm::length(offset);
+
+  // Handles sit on the arc, or outside it when moved off a neighbour
+  if (division_radians_.empty() ||
+      distance < view_radius - kHandleRadius ||
+      distance > view_radius + kOverlapOffset + kHandleRadius) {
+    return -1; // Position is not inside a handle
+  }
+
+  float angle = std::atan2(-offset.x, -offset.y);
+  if (angle < 0) {
+    angle += 2 * glm::pi<float>();
+  }
 
-    ++handle_idx;
+  // Only handles this close in angle can encompass the position
+  float window = glm::pi<float>();
+  if (view_radius > kHandleRadius) {
+    window = std::asin(kHandleRadius / view_radius);
   }
 
-  return -1; // Position is not inside a handle
+  // Search in order of index, wrapping around the apex at either end
+  int handle_idx = -1;
+  if (angle + window > 2 * glm::pi<float>()) {
+    handle_idx = FindHandle(
+        pos, 0, angle + window - 2 * glm::pi<float>());
+  }
+
+  if (handle_idx < 0) {
+    handle_idx = FindHandle(pos, angle - window, angle + window);
+  }
+
+  if (handle_idx < 0 && angle - window < 0) {
+    handle_idx = FindHandle(
+        pos, angle - window + 2 * glm::pi<float>(), 2 * glm::pi<float>());
+  }
+
+  return handle_idx;
 }
 
 bool PieGraph::UpdateHandle(size_t handle_index, glm::vec2 mouse_pos) {
   float curr_angle = division_radians_[handle_index];
-  glm::vec2 mouse_vec(mouse_pos - center_);
+  glm::vec2 mouse_vec(mouse_pos - GetViewCenter());
   glm::vec2 rad_vec(0, -radius_);
   glm::vec2 rad_vec_left_normal(-radius_, 0);
 
@@ -92,9 +207,53 @@ bool PieGraph::UpdateHandle(size_t handle_index, glm::vec2 mouse_pos) {
     division_radians_[current_handle_idx] += diff; // Update handles
   }
 
+  UpdateGeometry(handle_index);
+
   return true; // Portion successfully resized
 }
 
+void PieGraph::SetLevelOfDetail(bool is_enabled) {
+  if (is_enabled != is_level_of_detail_) {
+    is_level_of_detail_ = is_enabled;
+    CreateGeometry();
+  }
+}
+
+void PieGraph::Zoom(float factor, const glm::vec2& anchor) {
+  if (factor <= 0) {
+    throw std::out_of_range("Zoom factor must be a positive real number");
+  }
+
+  float zoom = std::min(std::max(zoom_ * factor, 1.0f), kMaxZoom);
+
+  // Keep the point under the anchor in place
+  glm::vec2 anchor_offset = anchor - center_;
+  zoom_offset_ =
+      anchor_offset - (anchor_offset - zoom_offset_) * (zoom / zoom_);
+  if (zoom == 1) {
+    zoom_offset_ = glm::vec2(0, 0);
+  }
+
+  zoom_ = zoom;
+
+  if (!division_radians_.empty()) {
+    CreateGeometry();
+  }
+}
+
+float PieGraph::GetZoom() const {
+  return zoom_;
+}
+
+bool PieGraph::IsHandleDetailed(size_t handle_index) const {
+  if (handle_index >= division_radians_.size()) {
+    throw std::out_of_range("Handle index exceeds number of handles.");
+  }
+
+  return std::binary_search(detailed_handles_.begin(),
+                            detailed_handles_.end(), handle_index);
+}
+
 glm::vec2 PieGraph::GetCenter() const {
   return center_;
 }
@@ -114,42 +273,340 @@ std::vector<float> PieGraph::GetProportions() const {
   return proportions;
 }
 
-void PieGraph::CreateHandles(bool should_draw) {
-  current_handles_ = std::vector<ci::Path2d>();
+void PieGraph::CreateGeometry() {
+  handle_vertex_ = kLineVertices + 2 * kArcSegments * kLineVertices +
+                   kLineVertices;
+  if (is_level_of_detail_) {
+    handle_vertex_ += kNumBands * kLineVertices;
+  }
+
+  first_dirty_vertex_ = 0;
+  detailed_handles_ = std::vector<size_t>();
+  handle_points_ = std::vector<glm::vec2>();
+  positions_ = std::vector<glm::vec2>(handle_vertex_);
+
+  WriteLine(GetViewCenter(), GetPointAt(0, GetViewRadius()), 0);
+
+  if (!division_radians_.empty()) {
+    UpdateGeometry(0);
+  }
+}
+
+void PieGraph::UpdateGeometry(size_t first_handle) {
+  glm::vec2 view_center = GetViewCenter();
+  float view_radius = GetViewRadius();
 
-  glm::vec2 rad_vec = glm::vec2(0, -radius_);
+  // A moved handle changes the spacing, and so the detail, of the one before
+  if (is_level_of_detail_ && first_handle > 0) {
+    --first_handle;
+  }
 
-  size_t current_idx = 0;
-  for (float sweep : division_radians_) {
-    float new_x = glm::cos(sweep) * rad_vec.x + glm::sin(sweep) * rad_vec.y;
-    float new_y = -glm::sin(sweep) * rad_vec.x + glm::cos(sweep) * rad_vec.y;
-    glm::vec2 handle_point = glm::vec2(new_x + center_.x, new_y + center_.y);
+  // Handles before the first one keep their places in the buffer
+  size_t first_slot = std::lower_bound(detailed_handles_.begin(),
+                                       detailed_handles_.end(),
+                                       first_handle) -
+                      detailed_handles_.begin();
+  detailed_handles_.resize(first_slot);
+  handle_points_.resize(first_slot);
+  SelectDetailedHandles(first_handle);
+  positions_.resize(handle_vertex_ +
+                    detailed_handles_.size() * kHandleVertices);
+
+  for (size_t slot = first_slot; slot < detailed_handles_.size(); ++slot) {
+    size_t handle = detailed_handles_[slot];
+    float sweep = division_radians_[handle];
+    glm::vec2 handle_point = GetPointAt(sweep, view_radius);
+
+    // If handles overlap, move this one outward at the same angle
+    if (slot > 0 && detailed_handles_[slot - 1] == handle - 1 &&
+        glm::distance(handle_points_[slot - 1], handle_point) <=
+            kHandleRadius) {
+      handle_point = GetPointAt(sweep, view_radius + kOverlapOffset);
+    }
 
-    // If handles overlap
-    if (current_idx > 0 &&
-         current_handles_[current_idx - 1].contains(handle_point)) {
-      float x_buffer = 4 * glm::cos(sweep + kCircleStartOffset) * kHandleRadius;
-      float y_buffer = 4 * glm::sin(sweep + kCircleStartOffset) * kHandleRadius;
-      handle_point =
-          glm::vec2(handle_point.x - x_buffer, handle_point.y + y_buffer);
+    handle_points_[slot] = handle_point;
+
+    size_t vertex = handle_vertex_ + slot * kHandleVertices;
+    WriteLine(view_center, handle_point, vertex);
+    vertex += kLineVertices;
+
+    // The handle is a fan of triangles around its center
+    for (size_t segment = 0; segment < kHandleSegments; ++segment) {
+      float start = 2 * glm::pi<float>() * segment / kHandleSegments;
+      float end = 2 * glm::pi<float>() * (segment + 1) / kHandleSegments;
+      positions_[vertex++] = handle_point;
+      positions_[vertex++] = handle_point + kHandleRadius *
+          glm::vec2(glm::cos(start), glm::sin(start));
+      positions_[vertex++] = handle_point + kHandleRadius *
+          glm::vec2(glm::cos(end), glm::sin(end));
     }
+  }
 
-    // Create the handle circles
-    ci::Path2d handle;
-    handle.arc(handle_point, kHandleRadius, 0, 2 * glm::pi<float>());
-    handle.close();
-    current_handles_.push_back(handle);
+  // The outline ends at the last handle, so it always follows a move
+  float arc_end = division_radians_.back();
+  size_t vertex = kLineVertices;
+  WriteArc(arc_end, 2 * glm::pi<float>(), vertex);
+  vertex += kArcSegments * kLineVertices;
+  WriteArc(0, arc_end, vertex);
+  vertex += kArcSegments * kLineVertices;
+  WriteLine(GetPointAt(arc_end, view_radius), view_center, vertex);
+  vertex += kLineVertices;
+
+  if (is_level_of_detail_) {
+    WriteBands(vertex);
+  }
+
+  is_outline_dirty_ = true;
+  first_dirty_vertex_ = std::min(
+      first_dirty_vertex_, handle_vertex_ + first_slot * kHandleVertices);
+}
+
+void PieGraph::SelectDetailedHandles(size_t first_handle) {
+  float two_pi = 2 * glm::pi<float>();
+  float min_spacing = 0;
+  if (is_level_of_detail_) {
+    min_spacing = kMinHandleSpacing / GetViewRadius();
+  }
+
+  float start_angle;
+  float end_angle;
+  if (!GetVisibleAngles(&start_angle, &end_angle)) {
+    return;
+  }
 
-    if (should_draw) {
-      ci::gl::color(kStrokeColorPrimary);
-      ci::gl::drawLine(center_, handle_point);
-      ci::gl::drawSolid(handle);
+  // Visible handles in order of index; the range may wrap past the apex
+  std::vector<std::pair<float, float>> ranges;
+  if (end_angle > two_pi) {
+    ranges.push_back({0, end_angle - two_pi});
+    ranges.push_back({start_angle, two_pi});
+  } else {
+    ranges.push_back({start_angle, end_angle});
+  }
+
+  auto begin = division_radians_.begin();
+  for (const std::pair<float, float>& range : ranges) {
+    size_t handle = std::max<size_t>(
+        first_handle,
+        std::lower_bound(begin, division_radians_.end(), range.first) - begin);
+    size_t end = std::upper_bound(begin, division_radians_.end(),
+                                  range.second) - begin;
+
+    while (handle < end) {
+      if (CalculateSpacing(handle) >= min_spacing) {
+        detailed_handles_.push_back(handle);
+        handle_points_.push_back(glm::vec2());
+      }
+
+      // Handles closer than the spacing to this one cannot be detailed, so
+      // dense runs are skipped in a single search
+      size_t next = handle + 1;
+      if (is_level_of_detail_ && next < end) {
+        next = std::lower_bound(begin + next, division_radians_.end(),
+                                division_radians_[handle] + min_spacing) -
+               begin;
+      }
+
+      handle = next;
+    }
+  }
+}
+
+bool PieGraph::GetVisibleAngles(float* start_angle, float* end_angle) const {
+  float two_pi = 2 * glm::pi<float>();
+  *start_angle = 0;
+  *end_angle = two_pi;
+
+  // The clip square, widened so that handles across its edge are kept
+  float extent = radius_ + kOverlapOffset + 2 * kHandleRadius;
+  glm::vec2 offset = center_ - GetViewCenter();
+  if (zoom_ == 1 ||
+      (std::abs(offset.x) <= extent && std::abs(offset.y) <= extent)) {
+    return true; // The square holds the center, so every angle is visible
+  }
+
+  // Handles are hidden unless the arc crosses the square
+  float view_radius = GetViewRadius();
+  glm::vec2 nearest(
+      std::min(std::max(0.0f, offset.x - extent), offset.x + extent),
+      std::min(std::max(0.0f, offset.y - extent), offset.y + extent));
+  float farthest = glm::length(glm::vec2(std::abs(offset.x) + extent,
+                                         std::abs(offset.y) + extent));
+  if (glm::length(nearest) > view_radius + kOverlapOffset + kHandleRadius ||
+      farthest < view_radius - kHandleRadius) {
+    return false;
+  }
+
+  float corner_angles[4];
+  for (size_t corner = 0; corner < 4; ++corner) {
+    glm::vec2 point = offset + glm::vec2(corner % 2 ? extent : -extent,
+                                         corner / 2 ? extent : -extent);
+    corner_angles[corner] = std::atan2(-point.x, -point.y);
+    if (corner_angles[corner] < 0) {
+      corner_angles[corner] += two_pi;
+    }
+  }
+
+  // The square spans less than half a turn; find the corner it starts from
+  for (float first : corner_angles) {
+    float span = 0;
+    for (float other : corner_angles) {
+      float turn = other - first;
+      span = std::max(span, turn < 0 ? turn + two_pi : turn);
+    }
+
+    if (span < glm::pi<float>()) {
+      *start_angle = first;
+      *end_angle = first + span;
+      return true;
+    }
+  }
+
+  return true;
+}
+
+void PieGraph::WriteBands(size_t vertex) {
+  glm::vec2 view_center = GetViewCenter();
+  float view_radius = GetViewRadius();
+  float band_angle = 2 * glm::pi<float>() / kNumBands;
+  auto begin = division_radians_.begin();
+
+  // Count the handles in each band by search, less the detailed ones
+  std::vector<size_t> band_ends(kNumBands);
+  for (size_t band = 0; band + 1 < kNumBands; ++band) {
+    band_ends[band] = std::lower_bound(begin, division_radians_.end(),
+                                       (band + 1) * band_angle) - begin;
+  }
+  band_ends.back() = division_radians_.size();
+
+  std::vector<size_t> num_detailed(kNumBands, 0);
+  for (size_t handle : detailed_handles_) {
+    ++num_detailed[std::upper_bound(band_ends.begin(), band_ends.end(),
+                                    handle) - band_ends.begin()];
+  }
+
+  // Each band reaches inward from the arc as far as it is dense
+  size_t band_start = 0;
+  for (size_t band = 0; band < kNumBands; ++band) {
+    size_t count = band_ends[band] - band_start - num_detailed[band];
+    band_start = band_ends[band];
+
+    if (count == 0) {
+      std::fill(positions_.begin() + vertex,
+                positions_.begin() + vertex + kLineVertices, view_center);
+    } else {
+      float depth = kBandDepth * std::min(1.0f, count / kBandSaturation);
+      WriteSector(band * band_angle, (band + 1) * band_angle,
+                  view_radius - depth, view_radius, vertex);
     }
 
-    ++current_idx;
+    vertex += kLineVertices;
   }
 }
 
+float PieGraph::CalculateSpacing(size_t handle) const {
+  float spacing = division_radians_[handle];
+  if (handle > 0) {
+    spacing -= division_radians_[handle - 1];
+  }
+
+  if (handle + 1 < division_radians_.size()) {
+    spacing = std::min(
+        spacing, division_radians_[handle + 1] - division_radians_[handle]);
+  }
+
+  return spacing;
+}
+
+int PieGraph::FindHandle(
+    const glm::vec2& pos, float start_angle, float end_angle) const {
+  auto is_before = [this](size_t handle, float angle) {
+    return division_radians_[handle] < angle;
+  };
+  auto is_after = [this](float angle, size_t handle) {
+    return angle < division_radians_[handle];
+  };
+
+  auto first = std::lower_bound(detailed_handles_.begin(),
+                                detailed_handles_.end(), start_angle,
+                                is_before);
+  auto last = std::upper_bound(first, detailed_handles_.end(), end_angle,
+                               is_after);
+
+  for (auto slot = first; slot != last; ++slot) {
+    if (glm::distance(handle_points_[slot - detailed_handles_.begin()],
+                      pos) <= kHandleRadius) {
+      return static_cast<int>(*slot);
+    }
+  }
+
+  return -1;
+}
+
+glm::vec2 PieGraph::GetPointAt(float angle, float radius) const {
+  return GetViewCenter() +
+      radius * glm::vec2(-glm::sin(angle), -glm::cos(angle));
+}
+
+glm::vec2 PieGraph::GetViewCenter() const {
+  return center_ + zoom_offset_;
+}
+
+float PieGraph::GetViewRadius() const {
+  return radius_ * zoom_;
+}
+
+void PieGraph::UploadPositions(size_t first_vertex, size_t end_vertex) {
+  if (first_vertex < end_vertex) {
+    position_vbo_->bufferSubData(
+        first_vertex * sizeof(glm::vec2),
+        (end_vertex - first_vertex) * sizeof(glm::vec2),
+        &positions_[first_vertex]);
+  }
+}
+
+void PieGraph::WriteLine(
+    const glm::vec2& start, const glm::vec2& end, size_t vertex) {
+  glm::vec2 direction = end - start;
+  float length = glm::length(direction);
+  glm::vec2 offset;
+  if (length > 0) {
+    offset = glm::vec2(-direction.y, direction.x) * (kStrokeWidth / 2 / length);
+  }
+
+  positions_[vertex] = start + offset;
+  positions_[vertex + 1] = end + offset;
+  positions_[vertex + 2] = end - offset;
+  positions_[vertex + 3] = start + offset;
+  positions_[vertex + 4] = end - offset;
+  positions_[vertex + 5] = start - offset;
+}
+
+void PieGraph::WriteArc(float start_angle, float end_angle, size_t vertex) {
+  float view_radius = GetViewRadius();
+
+  for (size_t segment = 0; segment < kArcSegments; ++segment) {
+    float start = start_angle +
+        (end_angle - start_angle) * segment / kArcSegments;
+    float end = start_angle +
+        (end_angle - start_angle) * (segment + 1) / kArcSegments;
+
+    WriteSector(start, end, view_radius - kStrokeWidth / 2,
+                view_radius + kStrokeWidth / 2, vertex);
+    vertex += kLineVertices;
+  }
+}
+
+void PieGraph::WriteSector(float start_angle, float end_angle,
+                           float inner_radius, float outer_radius,
+                           size_t vertex) {
+  positions_[vertex] = GetPointAt(start_angle, outer_radius);
+  positions_[vertex + 1] = GetPointAt(end_angle, outer_radius);
+  positions_[vertex + 2] = GetPointAt(end_angle, inner_radius);
+  positions_[vertex + 3] = GetPointAt(start_angle, outer_radius);
+  positions_[vertex + 4] = GetPointAt(end_angle, inner_radius);
+  positions_[vertex + 5] = GetPointAt(start_angle, inner_radius);
+}
+
 } // namespace frontend
 
 } // namespace scalepiegraph
\ No newline at end of file
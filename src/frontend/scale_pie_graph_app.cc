@@ -1,5 +1,7 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <frontend/scale_pie_graph_app.h>
+#include <cmath>
+#include <sstream>
 
 namespace scalepiegraph {
 
@@ -8,7 +10,9 @@ namespace frontend {
 ScalePieGraphApp::ScalePieGraphApp() :
     current_width_(kMinWindowSize),
     current_height_(kMinWindowSize),
-    current_scale_(Scale(12)) { // Load a default 12 TET scale
+    current_scale_(Scale(12)), // Load a default 12 TET scale
+    text_renderer_(ci::Font::getDefault(),
+                   (kMinWindowSize - kMargin) / 3.0) {
   ci::app::setWindowSize(current_width_, current_height_);
 
   UpdateText("Drop scale dataset to begin");
@@ -17,27 +21,92 @@ ScalePieGraphApp::ScalePieGraphApp() :
   graph_ = PieGraph(graph_center,
                     graph_center.y - kMargin,
                     current_scale_.GetProportions());
+  graph_.SetLevelOfDetail(true);
 
   keyboard_ = Keyboard(glm::vec2(0, current_height_),
                        current_width_,
                        current_height_ / 3,
                        current_scale_.GetNumIntervals());
+  keyboard_.SetLevelOfDetail(true);
+}
+
+void ScalePieGraphApp::update() {
+  synthesizer_.UpdateMidi();
 }
 
 void ScalePieGraphApp::draw() {
+  if (!frame_fbo_) {
+    frame_fbo_ = ci::gl::Fbo::create(ci::app::getWindowWidth(),
+                                     ci::app::getWindowHeight());
+  }
+
+  if (IsFrameDirty()) {
+    ci::gl::ScopedFramebuffer framebuffer(frame_fbo_);
+    DrawFrame();
+
+    ++num_frames_drawn_;
+    num_clean_frames_ = 0;
+  } else {
+    ++num_frames_skipped_;
+
+    // Nothing is changing; wake less often until the next input
+    if (++num_clean_frames_ == kFramesBeforeIdle) {
+      setFrameRate(kIdleFrameRate);
+      is_idle_ = true;
+    }
+  }
+
+  ci::gl::clear(kBackgroundColor);
+  ci::gl::draw(frame_fbo_->getColorTexture());
+}
+
+bool ScalePieGraphApp::IsFrameDirty() const {
+  if (needs_redraw_ || is_text_dirty_ ||
+      graph_.IsDirty() || keyboard_.IsDirty()) {
+    return true;
+  }
+
+  // Render statistics change continuously, so they are redrawn on a tick
+  return show_render_stats_ && ci::app::getElapsedSeconds() -
+      last_stats_seconds_ >= kStatsRefreshSeconds;
+}
+
+void ScalePieGraphApp::DrawFrame() {
   ci::gl::clear(kBackgroundColor);
   graph_.Draw();
   keyboard_.Draw();
 
-  ci::gl::drawStringCentered(
-      title_,
-      glm::vec2(current_width_ / 2, kMargin / 2), kTextColor);
+  {
+    ci::gl::ScopedColor text_color(kTextColor);
+    text_renderer_.DrawCentered(
+        title_, glm::vec2(current_width_ / 2, kMargin / 2));
+    text_renderer_.DrawWrapped(
+        info_key_, info_,
+        glm::vec2(2 * current_width_ / 3, current_height_ / 4));
+  }
+
+  if (show_render_stats_) {
+    DrawRenderStats();
+    last_stats_seconds_ = ci::app::getElapsedSeconds();
+  }
 
-  ci::gl::draw(text_box_texture_,
-               glm::vec2(2 * current_width_ / 3, current_height_ / 4));
+  needs_redraw_ = false;
+  is_text_dirty_ = false;
+}
+
+void ScalePieGraphApp::RequestRedraw() {
+  needs_redraw_ = true;
+  num_clean_frames_ = 0;
+
+  if (is_idle_) {
+    setFrameRate(kActiveFrameRate);
+    is_idle_ = false;
+  }
 }
 
 void ScalePieGraphApp::mouseDown(ci::app::MouseEvent event) {
+  RequestRedraw();
+
   if (is_ready_) {
     last_graph_ = graph_;
     current_handle_idx_ = graph_.GetHandleIndex(event.getPos());
@@ -46,11 +115,14 @@ void ScalePieGraphApp::mouseDown(ci::app::MouseEvent event) {
     int key_idx = keyboard_.GetKeyIndex(event.getPos());
     if (key_idx >= 0) {
       StartSynthesizer(key_idx);
+      keyboard_.SetPressedKey(key_idx);
     }
   }
 }
 
 void ScalePieGraphApp::mouseUp(ci::app::MouseEvent event) {
+  RequestRedraw();
+
   if (is_ready_) {
     if (current_handle_idx_ >= 0) { // Handle selected
       try {
@@ -58,6 +130,7 @@ void ScalePieGraphApp::mouseUp(ci::app::MouseEvent event) {
                                graph_.GetProportions(),
                                current_scale_.GetNumOctaves());
         UpdateText();
+        UpdateTimbre(current_scale_);
       } catch (std::out_of_range&) {
         graph_ = last_graph_; // Revert to previous state
       }
@@ -66,19 +139,30 @@ void ScalePieGraphApp::mouseUp(ci::app::MouseEvent event) {
     }
 
     synthesizer_.Stop();
+    keyboard_.SetPressedKey(-1);
   }
 }
 
 void ScalePieGraphApp::mouseDrag(ci::app::MouseEvent event) {
+  RequestRedraw();
+
   if (is_ready_) {
     glm::vec2 mouse_pos(event.getPos());
 
     if (current_handle_idx_ >= 0) {
       graph_.UpdateHandle(current_handle_idx_, mouse_pos);
+
+      // Partials follow the handle while it moves
+      try {
+        UpdateTimbre(Scale("Custom",
+                           graph_.GetProportions(),
+                           current_scale_.GetNumOctaves()));
+      } catch (std::out_of_range&) {}
     }
 
     int key_idx = keyboard_.GetKeyIndex(event.getPos());
     if (key_idx >= 0) {
+      keyboard_.SetPressedKey(key_idx);
       try {
         synthesizer_.SetFrequency(current_scale_.CalculateNoteFrequency(
             key_idx, base_scale_.CalculateNoteFrequency(
@@ -88,11 +172,32 @@ void ScalePieGraphApp::mouseDrag(ci::app::MouseEvent event) {
   }
 }
 
+void ScalePieGraphApp::mouseWheel(ci::app::MouseEvent event) {
+  RequestRedraw();
+
+  float factor = std::pow(kZoomStep, event.getWheelIncrement());
+
+  // The keyboard fills the bottom third of the window
+  if (event.getPos().y > current_height_ - current_height_ / 3) {
+    keyboard_.Zoom(factor, static_cast<float>(event.getPos().x));
+  } else {
+    graph_.Zoom(factor, event.getPos());
+  }
+}
+
 void ScalePieGraphApp::keyDown(ci::app::KeyEvent event) {
+  RequestRedraw();
+
+  HandleRenderStats(event);
+
   if (is_ready_) {
     UpdateWaveform(event);
+    UpdateFilterMode(event);
     HandleKeyboardNotes(event);
+    HandlePatterns(event);
     HandleTransposition(event);
+    HandleMorphMode(event);
+    HandleRecording(event);
 
     switch (event.getCode()) {
       case ci::app::KeyEvent::KEY_RIGHT:
@@ -126,6 +231,17 @@ void ScalePieGraphApp::keyDown(ci::app::KeyEvent event) {
   }
 }
 
+void ScalePieGraphApp::keyUp(ci::app::KeyEvent event) {
+  RequestRedraw();
+
+  if (is_ready_) {
+    int note_idx = GetKeyNoteIndex(event);
+    if (note_idx >= 0) {
+      synthesizer_.NoteOff(note_idx);
+    }
+  }
+}
+
 void ScalePieGraphApp::StartSynthesizer(size_t note_idx) {
   try {
     synthesizer_.Start(current_scale_.CalculateNoteFrequency(
@@ -133,61 +249,125 @@ void ScalePieGraphApp::StartSynthesizer(size_t note_idx) {
   } catch (std::runtime_error&) {}
 }
 
+void ScalePieGraphApp::StartNote(size_t note_idx) {
+  try {
+    synthesizer_.NoteOn(note_idx, current_scale_.CalculateNoteFrequency(
+        note_idx, base_scale_.CalculateNoteFrequency(current_transposition_)));
+  } catch (std::runtime_error&) {}
+}
+
 void ScalePieGraphApp::UpdateWaveform(ci::app::KeyEvent event) {
   switch (event.getCode()) {
     case ci::app::KeyEvent::KEY_q:
+      is_additive_ = false;
       synthesizer_.SetWaveform(ci::audio::WaveformType::SINE);
       break;
     case ci::app::KeyEvent::KEY_w:
+      is_additive_ = false;
       synthesizer_.SetWaveform(ci::audio::WaveformType::TRIANGLE);
       break;
     case ci::app::KeyEvent::KEY_e:
+      is_additive_ = false;
       synthesizer_.SetWaveform(ci::audio::WaveformType::SQUARE);
       break;
     case ci::app::KeyEvent::KEY_r:
+      is_additive_ = false;
       synthesizer_.SetWaveform(ci::audio::WaveformType::SAWTOOTH);
       break;
+    case ci::app::KeyEvent::KEY_v:
+      is_additive_ = true;
+      UpdateTimbre(current_scale_);
+      break;
+  }
+}
+
+void ScalePieGraphApp::UpdateFilterMode(ci::app::KeyEvent event) {
+  switch (event.getCode()) {
+    case ci::app::KeyEvent::KEY_t:
+      synthesizer_.SetFilterMode(FilterMode::kLowPass);
+      break;
+    case ci::app::KeyEvent::KEY_y:
+      synthesizer_.SetFilterMode(FilterMode::kHighPass);
+      break;
+    case ci::app::KeyEvent::KEY_u:
+      synthesizer_.SetFilterMode(FilterMode::kBandPass);
+      break;
+  }
+}
+
+void ScalePieGraphApp::UpdateTimbre(const Scale& scale) {
+  if (is_additive_) {
+    synthesizer_.SetAdditiveTimbre(scale);
   }
 }
 
 void ScalePieGraphApp::HandleKeyboardNotes(ci::app::KeyEvent event) {
+  if (event.getCode() == ci::app::KeyEvent::KEY_SPACE) {
+    synthesizer_.StopPattern();
+    synthesizer_.StopMidi();
+    synthesizer_.StopAll();
+    return;
+  }
+
+  int note_idx = GetKeyNoteIndex(event);
+  if (note_idx >= 0) {
+    StartNote(note_idx);
+  }
+}
+
+int ScalePieGraphApp::GetKeyNoteIndex(ci::app::KeyEvent event) const {
   switch (event.getCode()) {
     case ci::app::KeyEvent::KEY_a:
-      StartSynthesizer(0);
-      break;
+      return 0;
     case ci::app::KeyEvent::KEY_s:
-      StartSynthesizer(1);
-      break;
+      return 1;
     case ci::app::KeyEvent::KEY_d:
-      StartSynthesizer(2);
-      break;
+      return 2;
     case ci::app::KeyEvent::KEY_f:
-      StartSynthesizer(3);
-      break;
+      return 3;
     case ci::app::KeyEvent::KEY_g:
-      StartSynthesizer(4);
-      break;
+      return 4;
     case ci::app::KeyEvent::KEY_h:
-      StartSynthesizer(5);
-      break;
+      return 5;
     case ci::app::KeyEvent::KEY_j:
-      StartSynthesizer(6);
-      break;
+      return 6;
     case ci::app::KeyEvent::KEY_k:
-      StartSynthesizer(7);
-      break;
+      return 7;
     case ci::app::KeyEvent::KEY_l:
-      StartSynthesizer(8);
-      break;
+      return 8;
     case ci::app::KeyEvent::KEY_SEMICOLON:
-      StartSynthesizer(9);
-      break;
+      return 9;
     case ci::app::KeyEvent::KEY_QUOTE:
-      StartSynthesizer(10);
+      return 10;
+    default:
+      return -1; // Key does not play a note
+  }
+}
+
+void ScalePieGraphApp::HandlePatterns(ci::app::KeyEvent event) {
+  float base_freq = static_cast<float>(
+      base_scale_.CalculateNoteFrequency(current_transposition_));
+
+  switch (event.getCode()) {
+    case ci::app::KeyEvent::KEY_z:
+      synthesizer_.PlayPattern(Pattern::ScaleRun(
+          current_scale_, kPatternStepDuration, base_freq));
       break;
-    case ci::app::KeyEvent::KEY_SPACE:
-      synthesizer_.Stop();
+
+    case ci::app::KeyEvent::KEY_x: {
+      // Stack every other note of the scale into a chord
+      std::vector<size_t> chord;
+      for (size_t note_idx = 0;
+           note_idx < current_scale_.GetNumNotes();
+           note_idx += 2) {
+        chord.push_back(note_idx);
+      }
+
+      synthesizer_.PlayPattern(Pattern::Arpeggio(
+          current_scale_, chord, ArpeggioMode::kUpDown, kArpeggioOctaves,
+          kPatternStepDuration, base_freq));
       break;
+    }
   }
 }
 
@@ -209,7 +389,96 @@ void ScalePieGraphApp::HandleTransposition(ci::app::KeyEvent event) {
   }
 }
 
+void ScalePieGraphApp::HandleMorphMode(ci::app::KeyEvent event) {
+  if (event.getCode() == ci::app::KeyEvent::KEY_m) {
+    is_morphing_ = !is_morphing_;
+    UpdateText(is_morphing_ ? "Morphing Between Scales" : "");
+  }
+}
+
+void ScalePieGraphApp::HandleRecording(ci::app::KeyEvent event) {
+  if (event.getCode() != ci::app::KeyEvent::KEY_c) {
+    return;
+  }
+
+  if (synthesizer_.IsRecording()) {
+    synthesizer_.StopRecording();
+    UpdateText("");
+    return;
+  }
+
+  try {
+    synthesizer_.StartRecording(kRecordingPath);
+    UpdateText("Recording");
+  } catch (std::runtime_error&) {
+    UpdateText("Cannot Record");
+  }
+}
+
+void ScalePieGraphApp::HandleRenderStats(ci::app::KeyEvent event) {
+  switch (event.getCode()) {
+    case ci::app::KeyEvent::KEY_p:
+      show_render_stats_ = !show_render_stats_;
+      break;
+
+    case ci::app::KeyEvent::KEY_o: {
+      std::ofstream render_stats_file(kRenderStatsPath);
+      render_stats_file << synthesizer_.GetRenderStats();
+      break;
+    }
+
+    case ci::app::KeyEvent::KEY_i:
+      synthesizer_.ResetRenderStats();
+      break;
+  }
+}
+
+void ScalePieGraphApp::DrawRenderStats() {
+  RenderStats stats = synthesizer_.GetRenderStats();
+
+  std::ostringstream lines[6];
+  lines[0] << "blocks: " << stats.num_blocks
+           << "  frames: " << stats.min_block_frames
+           << "-" << stats.max_block_frames;
+  lines[1] << "render us: " << stats.last_render_micros
+           << "  mean " << stats.mean_render_micros
+           << "  max " << stats.max_render_micros;
+  lines[2] << "max load: " << stats.max_load
+           << "  jitter us: " << stats.mean_jitter_micros
+           << "  max " << stats.max_jitter_micros;
+  lines[3] << "dropouts: " << stats.num_dropouts
+           << "  late callbacks: " << stats.num_late_callbacks
+           << "  recording overruns: "
+           << synthesizer_.GetNumRecordingOverruns();
+  lines[4] << "queue: " << stats.queue_depth
+           << "  max " << stats.max_queue_depth
+           << "  dropped " << stats.num_dropped_events
+           << "  late " << stats.num_late_events;
+  lines[5] << "frames drawn: " << num_frames_drawn_
+           << "  skipped: " << num_frames_skipped_;
+
+  // Through the atlas, so the font is never measured outside its lock
+  ci::gl::ScopedColor text_color(kTextColor);
+  for (size_t line = 0; line < 6; ++line) {
+    text_renderer_.DrawLine(lines[line].str(),
+                            glm::vec2(kMargin / 4, kMargin / 4 + 12 * line));
+  }
+}
+
 void ScalePieGraphApp::fileDrop(ci::app::FileDropEvent event) {
+  RequestRedraw();
+
+  std::string extension = event.getFile(0).extension().string();
+  if (is_ready_ && (extension == ".mid" || extension == ".midi")) {
+    PlayMidiFile(event.getFile(0).string());
+    return;
+  }
+
+  if (is_ready_ && extension == ".wav") {
+    PlaySample(event.getFile(0).string());
+    return;
+  }
+
   std::ifstream scale_dataset_file;
   scale_dataset_file.open(event.getFile(0).string());
 
@@ -225,17 +494,69 @@ void ScalePieGraphApp::fileDrop(ci::app::FileDropEvent event) {
   scale_dataset_file.close();
 }
 
+void ScalePieGraphApp::PlayMidiFile(const std::string& path) {
+  try {
+    // Middle C plays the first note of the scale, as the 'a' key does
+    KeyboardMapping mapping(
+        {}, kMidiMiddleKey, kMidiMiddleKey,
+        base_scale_.CalculateNoteFrequency(current_transposition_));
+    synthesizer_.PlayMidi(MidiFile::Load(path), current_scale_, mapping);
+  } catch (std::runtime_error&) {
+    UpdateText("Invalid MIDI File");
+  }
+}
+
+void ScalePieGraphApp::PlaySample(const std::string& path) {
+  try {
+    // The first note of the scale plays the recording at its own pitch
+    synthesizer_.SetSample(
+        path, base_scale_.CalculateNoteFrequency(current_transposition_));
+    is_additive_ = false;
+  } catch (std::runtime_error&) {
+    UpdateText("Invalid WAV File");
+  }
+}
+
 void ScalePieGraphApp::UpdateScale(const std::string& new_scale_name) {
+  Scale last_scale = current_scale_;
   current_scale_ = scale_dataset_[new_scale_name];
+
+  if (is_morphing_) {
+    synthesizer_.MorphScale(
+        last_scale, current_scale_,
+        base_scale_.CalculateNoteFrequency(current_transposition_),
+        kMorphDuration);
+  }
+
   graph_ = PieGraph(
       graph_.GetCenter(),
       graph_.GetRadius(),
       current_scale_.GetProportions());
+  graph_.SetLevelOfDetail(true);
   UpdateText();
+  PrefetchText();
+  UpdateTimbre(current_scale_);
 
   keyboard_.UpdateDivisions(current_scale_.GetNumNotes() + 1);
 }
 
+void ScalePieGraphApp::PrefetchText() {
+  std::vector<std::pair<std::string, std::string>> entries;
+
+  // Nearest neighbours first, as they are the likeliest to be shown next
+  for (size_t distance = 1; distance <= kPrefetchRadius; ++distance) {
+    for (size_t scale_idx : {current_scale_idx_ + distance,
+                             current_scale_idx_ - distance}) {
+      if (scale_idx < scale_names_.size()) { // Wraps past zero when below
+        const std::string& name = scale_names_[scale_idx];
+        entries.push_back({name, scale_dataset_[name].GetDescription()});
+      }
+    }
+  }
+
+  text_renderer_.Prefetch(entries);
+}
+
 void ScalePieGraphApp::UpdateText(const std::string& custom_text) {
   if (custom_text.empty()) {
     title_ = current_scale_.GetName();;
@@ -245,12 +566,9 @@ void ScalePieGraphApp::UpdateText(const std::string& custom_text) {
     info_ = "";
   }
 
-  ci::TextBox text_box = ci::TextBox().alignment(ci::TextBox::LEFT).size(
-      glm::vec2((current_width_ - kMargin) / 3.0, ci::TextBox::GROW));
-
-  text_box.text(info_).color(kTextColor);
-
-  text_box_texture_ = ci::gl::Texture2d::create(text_box.render());
+  // Layouts are cached by scale and laid out when the frame is next drawn
+  info_key_ = title_;
+  is_text_dirty_ = true;
 }
 
 } // namespace frontend
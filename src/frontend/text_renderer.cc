@@ -0,0 +1,136 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <frontend/text_renderer.h>
+
+namespace scalepiegraph {
+
+namespace frontend {
+
+const size_t TextRenderer::kDefaultCacheCapacity = 256;
+
+namespace {
+
+const float kUnboundedHeight = 1e6; // Wrapped text may be as tall as it needs
+
+} // namespace
+
+TextRenderer::TextRenderer(const ci::Font& font,
+                           float wrap_width,
+                           size_t cache_capacity) :
+    atlas_(ci::gl::TextureFont::create(font)),
+    wrap_rect_(0, 0, wrap_width, kUnboundedHeight),
+    wrapped_layouts_(cache_capacity),
+    line_layouts_(cache_capacity),
+    prefetch_thread_(&TextRenderer::RunPrefetch, this) {}
+
+TextRenderer::~TextRenderer() {
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    is_stopping_ = true;
+  }
+
+  pending_condition_.notify_one();
+  prefetch_thread_.join();
+}
+
+void TextRenderer::DrawWrapped(const std::string& key,
+                               const std::string& text,
+                               const glm::vec2& upper_left) {
+  LayoutRef layout = GetLayout(wrapped_layouts_, key, text, true);
+  atlas_->drawGlyphs(layout->glyphs, upper_left);
+}
+
+void TextRenderer::DrawCentered(const std::string& text,
+                                const glm::vec2& center) {
+  LayoutRef layout = GetLayout(line_layouts_, text, text, false);
+  atlas_->drawGlyphs(
+      layout->glyphs,
+      glm::vec2(center.x - layout->width / 2, center.y + atlas_->getAscent()));
+}
+
+void TextRenderer::DrawLine(const std::string& text,
+                            const glm::vec2& upper_left) {
+  LayoutRef layout = GetLayout(line_layouts_, text, text, false);
+  atlas_->drawGlyphs(layout->glyphs,
+                     upper_left + glm::vec2(0, atlas_->getAscent()));
+}
+
+void TextRenderer::Prefetch(
+    const std::vector<std::pair<std::string, std::string>>& entries) {
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    pending_.assign(entries.begin(), entries.end());
+  }
+
+  pending_condition_.notify_one();
+}
+
+size_t TextRenderer::GetNumCached() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return wrapped_layouts_.GetSize();
+}
+
+TextRenderer::LayoutRef TextRenderer::GetLayout(LayoutCache& cache,
+                                                const std::string& key,
+                                                const std::string& text,
+                                                bool is_wrapped) {
+  LayoutRef layout;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache.Get(key, &layout) && layout->text == text) {
+      return layout;
+    }
+  }
+
+  layout = Layout(text, is_wrapped);
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache.Put(key, layout);
+  return layout;
+}
+
+TextRenderer::LayoutRef TextRenderer::Layout(const std::string& text,
+                                             bool is_wrapped) const {
+  std::shared_ptr<TextLayout> layout = std::make_shared<TextLayout>();
+  layout->text = text;
+
+  std::lock_guard<std::mutex> lock(font_mutex_);
+  if (is_wrapped) {
+    layout->glyphs = atlas_->getGlyphPlacementsWrapped(text, wrap_rect_);
+    layout->width = wrap_rect_.getWidth();
+  } else {
+    layout->glyphs = atlas_->getGlyphPlacements(text);
+    layout->width = atlas_->measureString(text).x;
+  }
+
+  return layout;
+}
+
+void TextRenderer::RunPrefetch() {
+  std::unique_lock<std::mutex> lock(cache_mutex_);
+
+  while (true) {
+    pending_condition_.wait(
+        lock, [this]() { return is_stopping_ || !pending_.empty(); });
+
+    if (is_stopping_) {
+      return;
+    }
+
+    std::pair<std::string, std::string> entry = pending_.front();
+    pending_.pop_front();
+
+    if (wrapped_layouts_.Contains(entry.first)) {
+      continue; // Already laid out; a stale text is replaced when drawn
+    }
+
+    lock.unlock();
+    LayoutRef layout = Layout(entry.second, true);
+    lock.lock();
+
+    wrapped_layouts_.Put(entry.first, layout);
+  }
+}
+
+} // namespace frontend
+
+} // namespace scalepiegraph
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <core/additive_timbre.h>
+
+using scalepiegraph::AdditiveTimbre;
+using scalepiegraph::Scale;
+
+TEST_CASE("Construct additive timbre") {
+  AdditiveTimbre timbre;
+
+  REQUIRE(timbre.GetNumPartials() == 1);
+  REQUIRE(timbre.GetRatio(0) == 1);
+  REQUIRE(timbre.GetAmplitude(0) == 1);
+}
+
+TEST_CASE("Add partials to additive timbre") {
+  AdditiveTimbre timbre;
+
+  SECTION("Partials in ascending order") {
+    timbre.AddPartial(2.5, 0.5);
+
+    REQUIRE(timbre.GetNumPartials() == 2);
+    REQUIRE(timbre.GetRatio(1) == Approx(2.5));
+    REQUIRE(timbre.GetAmplitude(1) == Approx(0.5));
+  }
+
+  SECTION("Clear") {
+    timbre.Clear();
+
+    REQUIRE(timbre.GetNumPartials() == 0);
+    REQUIRE_THROWS_AS(timbre.GetRatio(0), std::out_of_range);
+  }
+
+  SECTION("Descending partial") {
+    timbre.AddPartial(2, 1);
+
+    REQUIRE_THROWS_AS(timbre.AddPartial(1.5, 1), std::out_of_range);
+  }
+
+  SECTION("Invalid partial") {
+    REQUIRE_THROWS_AS(timbre.AddPartial(0, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(timbre.AddPartial(2, -1), std::out_of_range);
+  }
+
+  SECTION("Full timbre") {
+    for (size_t partial = 2; partial <= AdditiveTimbre::kMaxPartials;
+         ++partial) {
+      timbre.AddPartial(partial, 1);
+    }
+
+    REQUIRE_THROWS_AS(timbre.AddPartial(1000, 1), std::out_of_range);
+  }
+}
+
+TEST_CASE("Match additive timbre to scale") {
+  SECTION("Harmonics move to the nearest notes") {
+    AdditiveTimbre timbre = AdditiveTimbre::FromScale(Scale(12), 4);
+
+    REQUIRE(timbre.GetNumPartials() == 4);
+    REQUIRE(timbre.GetRatio(0) == Approx(1));
+    REQUIRE(timbre.GetRatio(1) == Approx(2));
+    REQUIRE(timbre.GetRatio(2) == Approx(std::pow(2, 19.0 / 12)));
+    REQUIRE(timbre.GetRatio(3) == Approx(4));
+  }
+
+  SECTION("Harmonics on the same note merge") {
+    // The fifth and sixth harmonics both land on the tritone
+    AdditiveTimbre timbre = AdditiveTimbre::FromScale(Scale(2), 6);
+
+    REQUIRE(timbre.GetNumPartials() == 5);
+    REQUIRE(timbre.GetRatio(4) == Approx(std::pow(2, 2.5)));
+    REQUIRE(timbre.GetAmplitude(4) / timbre.GetAmplitude(0) ==
+            Approx(1.0 / 5 + 1.0 / 6));
+  }
+
+  SECTION("Power is normalized") {
+    AdditiveTimbre timbre = AdditiveTimbre::FromScale(Scale(7));
+
+    double power = 0;
+    for (size_t partial = 0; partial < timbre.GetNumPartials(); ++partial) {
+      power += timbre.GetAmplitude(partial) * timbre.GetAmplitude(partial);
+    }
+
+    REQUIRE(power == Approx(1));
+  }
+
+  SECTION("Rolloff") {
+    AdditiveTimbre timbre = AdditiveTimbre::FromScale(Scale(12), 4, 2);
+
+    REQUIRE(timbre.GetAmplitude(1) / timbre.GetAmplitude(0) == Approx(0.25));
+  }
+
+  SECTION("Invalid number of harmonics") {
+    REQUIRE_THROWS_AS(AdditiveTimbre::FromScale(Scale(12), 0),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(
+        AdditiveTimbre::FromScale(Scale(12), AdditiveTimbre::kMaxPartials + 1),
+        std::out_of_range);
+  }
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <catch2/catch.hpp>
+#include <core/batch_renderer.h>
+
+using scalepiegraph::BatchRenderer;
+using scalepiegraph::BatchReport;
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleDataset;
+using scalepiegraph::SequenceStep;
+using scalepiegraph::Waveform;
+
+TEST_CASE("Make ascending and descending run") {
+  Scale scale("Pentatonic", {200, 200, 300, 200});
+
+  std::vector<SequenceStep> run =
+      BatchRenderer::MakeRun(scale, 0.5, Waveform::kSine, 1000);
+
+  REQUIRE(run.size() == 2 * scale.GetNumNotes() + 1);
+  REQUIRE(run.front().note_index == 0);
+  REQUIRE(run[scale.GetNumNotes()].note_index == scale.GetNumNotes());
+  REQUIRE(run.back().note_index == 0);
+  REQUIRE(run.front().duration == 0.5);
+}
+
+TEST_CASE("Make preview file name") {
+  SECTION("Safe characters kept") {
+    REQUIRE(BatchRenderer::MakeFileName(3, "Blues") == "3_Blues.wav");
+  }
+
+  SECTION("Unsafe characters replaced") {
+    REQUIRE(BatchRenderer::MakeFileName(0, "La Paz/Bolivia") ==
+            "0_La_Paz_Bolivia.wav");
+  }
+}
+
+TEST_CASE("Batch render dataset") {
+  std::istringstream json(
+      "{\"scales\": ["
+      "{\"name\": \"Blues\", \"intervals\": [0, 3, 5, 6, 7, 10]},"
+      "{\"name\": \"Whole Tone\", \"intervals\": [0, 2, 4, 6, 8, 10]},"
+      "{\"name\": \"Tritone\", \"intervals\": [0, 6]}"
+      "]}");
+  ScaleDataset dataset;
+  json >> dataset;
+
+  BatchRenderer renderer(2, 0.05);
+  BatchReport report = renderer.Render(dataset, ".");
+
+  const std::vector<std::string> kExpectedFiles = {
+      "0_Blues.wav", "1_Whole_Tone.wav", "2_Tritone.wav"};
+
+  for (const std::string& file_name : kExpectedFiles) {
+    std::ifstream file(file_name, std::ios::binary);
+    REQUIRE(file.good());
+    file.close();
+    std::remove(file_name.c_str());
+  }
+
+  REQUIRE(report.num_scales == 3);
+  REQUIRE(report.num_workers == 2);
+  REQUIRE(report.num_frames > 0);
+  REQUIRE(report.GetScalesPerSecond() > 0);
+}
+
+TEST_CASE("Batch render invalid output directory") {
+  std::istringstream json(
+      "{\"scales\": [{\"name\": \"Tritone\", \"intervals\": [0, 6]}]}");
+  ScaleDataset dataset;
+  json >> dataset;
+
+  BatchRenderer renderer(1, 0.05);
+
+  REQUIRE_THROWS_AS(renderer.Render(dataset, "no/such/directory"),
+                    std::runtime_error);
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <core/biquad_bank.h>
+
+using scalepiegraph::BiquadBank;
+using scalepiegraph::FilterMode;
+
+namespace simd = scalepiegraph::simd;
+
+/**
+ * Filter a sine wave through the first filter of a bank and measure the peak
+ * of the steady-state output.
+ */
+float MeasureFilterGain(BiquadBank& bank, double frequency) {
+  const double kSampleRate = 44100;
+  const size_t kNumFrames = 8192;
+  std::vector<float> samples(kNumFrames * simd::kLanes, 0);
+
+  for (size_t frame = 0; frame < kNumFrames; ++frame) {
+    samples[frame * simd::kLanes] = static_cast<float>(
+        std::sin(6.283185307179586 * frequency * frame / kSampleRate));
+  }
+
+  bank.Reset(0);
+  bank.Glide(0, simd::kLanes, kNumFrames);
+  bank.Process(0, samples.data(), kNumFrames);
+
+  float peak = 0;
+  for (size_t frame = kNumFrames / 2; frame < kNumFrames; ++frame) {
+    peak = std::max(peak, std::fabs(samples[frame * simd::kLanes]));
+  }
+
+  return peak;
+}
+
+TEST_CASE("Construct biquad bank") {
+  SECTION("Filters padded to SIMD width") {
+    BiquadBank bank(5);
+
+    REQUIRE(bank.GetNumFilters() == 8);
+    REQUIRE(bank.GetMode(7) == FilterMode::kLowPass);
+    REQUIRE(bank.GetCutoff(7) == BiquadBank::kDefaultCutoff);
+  }
+
+  SECTION("No filters") {
+    REQUIRE_THROWS_AS(BiquadBank(0), std::out_of_range);
+  }
+
+  SECTION("Invalid resonance") {
+    BiquadBank bank;
+
+    REQUIRE_THROWS_AS(bank.SetFilter(0, FilterMode::kLowPass, 1000, 0),
+                      std::out_of_range);
+  }
+
+  SECTION("Cutoff kept below Nyquist") {
+    BiquadBank bank(4, 44100);
+    bank.SetCutoff(0, 30000);
+
+    REQUIRE(bank.GetCutoff(0) < 22050);
+  }
+}
+
+TEST_CASE("Biquad bank filter responses") {
+  BiquadBank bank;
+
+  SECTION("Low-pass") {
+    bank.SetFilter(0, FilterMode::kLowPass, 1000);
+
+    REQUIRE(MeasureFilterGain(bank, 100) == Approx(1).margin(0.02));
+    REQUIRE(MeasureFilterGain(bank, 1000) == Approx(0.7071).margin(0.02));
+    REQUIRE(MeasureFilterGain(bank, 10000) < 0.02);
+  }
+
+  SECTION("High-pass") {
+    bank.SetFilter(0, FilterMode::kHighPass, 1000);
+
+    REQUIRE(MeasureFilterGain(bank, 100) < 0.02);
+    REQUIRE(MeasureFilterGain(bank, 1000) == Approx(0.7071).margin(0.02));
+    REQUIRE(MeasureFilterGain(bank, 10000) == Approx(1).margin(0.02));
+  }
+
+  SECTION("Band-pass") {
+    bank.SetFilter(0, FilterMode::kBandPass, 1000, 4);
+
+    REQUIRE(MeasureFilterGain(bank, 100) < 0.05);
+    REQUIRE(MeasureFilterGain(bank, 1000) == Approx(1).margin(0.02));
+    REQUIRE(MeasureFilterGain(bank, 10000) < 0.05);
+  }
+}
+
+TEST_CASE("Biquad bank filters each lane independently") {
+  BiquadBank bank;
+  bank.SetFilter(0, FilterMode::kLowPass, 200);
+  bank.SetFilter(1, FilterMode::kHighPass, 200);
+  for (size_t filter = 0; filter < simd::kLanes; ++filter) {
+    bank.Reset(filter);
+  }
+
+  // A constant input passes the low-pass and is blocked by the high-pass
+  std::vector<float> samples(4096 * simd::kLanes, 1);
+  bank.Glide(0, simd::kLanes, 4096);
+  bank.Process(0, samples.data(), 4096);
+
+  REQUIRE(samples[4095 * simd::kLanes] == Approx(1).margin(1e-3));
+  REQUIRE(samples[4095 * simd::kLanes + 1] == Approx(0).margin(1e-3));
+}
+
+TEST_CASE("Biquad bank glides between responses") {
+  const size_t kBlockFrames = 32;
+
+  /**
+   * Record the impulse response of the first filter over one block.
+   */
+  auto impulse_response = [](BiquadBank& bank) {
+    std::vector<float> samples(kBlockFrames * simd::kLanes, 0);
+    samples[0] = 1;
+    bank.Glide(0, simd::kLanes, kBlockFrames);
+    bank.Process(0, samples.data(), kBlockFrames);
+    return samples;
+  };
+
+  BiquadBank target;
+  target.SetFilter(0, FilterMode::kLowPass, 5000);
+  target.Reset(0);
+  std::vector<float> target_response = impulse_response(target);
+
+  BiquadBank bank;
+  bank.SetFilter(0, FilterMode::kLowPass, 100);
+  bank.Reset(0);
+  bank.SetCutoff(0, 5000);
+
+  SECTION("Coefficients move gradually during the block") {
+    std::vector<float> response = impulse_response(bank);
+
+    REQUIRE(response[0] < target_response[0] / 2);
+  }
+
+  SECTION("Coefficients reach the target after the block") {
+    std::vector<float> silence(kBlockFrames * simd::kLanes, 0);
+    bank.Glide(0, simd::kLanes, kBlockFrames);
+    bank.Process(0, silence.data(), kBlockFrames);
+
+    std::vector<float> response = impulse_response(bank);
+    for (size_t frame = 0; frame < kBlockFrames; ++frame) {
+      REQUIRE(response[frame * simd::kLanes] ==
+              Approx(target_response[frame * simd::kLanes]).margin(1e-5));
+    }
+  }
+}
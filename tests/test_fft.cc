@@ -0,0 +1,53 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include <core/fft.h>
+
+using scalepiegraph::Fft;
+
+TEST_CASE("Fft transforms signals") {
+  const size_t kSize = 64;
+  Fft fft(kSize);
+
+  SECTION("Impulse has a flat spectrum") {
+    std::vector<std::complex<double>> data(kSize);
+    data[0] = 1;
+    fft.Transform(data.data());
+
+    for (const std::complex<double>& bin : data) {
+      REQUIRE(bin.real() == Approx(1));
+      REQUIRE(bin.imag() == Approx(0).margin(1e-12));
+    }
+  }
+
+  SECTION("Bin-centered sine peaks at its bin") {
+    const size_t kBin = 5;
+    std::vector<float> samples(kSize);
+    for (size_t frame = 0; frame < kSize; ++frame) {
+      samples[frame] = static_cast<float>(
+          std::sin(6.283185307179586 * kBin * frame / kSize));
+    }
+
+    std::vector<double> magnitudes = fft.GetHannMagnitudes(samples.data());
+
+    REQUIRE(magnitudes.size() == kSize / 2 + 1);
+    // A Hann window spreads the sine over its bin and both neighbours
+    REQUIRE(magnitudes[kBin] == Approx(kSize / 4.0).epsilon(1e-4));
+    REQUIRE(magnitudes[kBin - 1] == Approx(kSize / 8.0).epsilon(1e-4));
+    REQUIRE(magnitudes[kBin + 1] == Approx(kSize / 8.0).epsilon(1e-4));
+    REQUIRE(magnitudes[kBin + 3] == Approx(0).margin(1e-4));
+  }
+
+  SECTION("Size") {
+    REQUIRE(fft.GetSize() == kSize);
+  }
+}
+
+TEST_CASE("Fft rejects invalid sizes") {
+  REQUIRE_THROWS_AS(Fft(0), std::out_of_range);
+  REQUIRE_THROWS_AS(Fft(1), std::out_of_range);
+  REQUIRE_THROWS_AS(Fft(48), std::out_of_range);
+}
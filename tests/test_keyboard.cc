@@ -9,6 +9,10 @@ TEST_CASE("Test construct keyboard from divisions") {
   REQUIRE_NOTHROW(Keyboard(glm::vec2(0, 100), 100, 100, 10));
 }
 
+TEST_CASE("Test new keyboard must be drawn") {
+  REQUIRE(Keyboard(glm::vec2(0, 100), 100, 100, 10).IsDirty());
+}
+
 TEST_CASE("Test get key index") {
   Keyboard keyboard(glm::vec2(0, 100), 100, 100, 10);
 
@@ -40,4 +44,140 @@ TEST_CASE("Test get key index") {
 
     REQUIRE(keyboard.GetKeyIndex(kMousePos) == kExpectedIndex);
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test keys follow layout changes") {
+  Keyboard keyboard(glm::vec2(0, 100), 100, 100, 10);
+  keyboard.SetPressedKey(4);
+
+  SECTION("Test update divisions") {
+    keyboard.UpdateDivisions(5);
+
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(49, 50)) == 2);
+  }
+
+  SECTION("Test set number of octaves") {
+    keyboard.UpdateDivisions(5);
+    keyboard.SetNumOctaves(2);
+
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(49, 50)) == 4);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(99, 50)) == 9);
+  }
+}
+
+TEST_CASE("Test get key index at every position") {
+  Keyboard keyboard(glm::vec2(0, 100), 100, 100, 7);
+  keyboard.SetNumOctaves(3);
+
+  for (float x = 0.25; x < 100; x += 0.5) {
+    int expected_index = static_cast<int>(x / (100.0 / 21));
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(x, 50)) == expected_index);
+  }
+
+  REQUIRE(keyboard.GetKeyIndex(glm::vec2(100, 50)) == 20);
+  REQUIRE(keyboard.GetKeyIndex(glm::vec2(100.5, 50)) == -1);
+  REQUIRE(keyboard.GetKeyIndex(glm::vec2(-0.5, 50)) == -1);
+  REQUIRE(keyboard.GetKeyIndex(glm::vec2(50, -0.5)) == -1);
+}
+
+TEST_CASE("Test keys of unequal widths") {
+  Keyboard keyboard(glm::vec2(0, 100), 100, 100, 4);
+  keyboard.SetNumOctaves(2);
+  keyboard.SetKeyProportions({0.1, 0.5, 0.6, 1});
+
+  SECTION("Test get key index") {
+    const std::vector<float> kPositions = {4, 20, 27, 40, 52, 60, 77, 90};
+
+    for (size_t key_idx = 0; key_idx < kPositions.size(); ++key_idx) {
+      REQUIRE(keyboard.GetKeyIndex(glm::vec2(kPositions[key_idx], 50)) ==
+              static_cast<int>(key_idx));
+    }
+  }
+
+  SECTION("Test proportions cleared by new divisions") {
+    keyboard.UpdateDivisions(5);
+
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(4, 50)) == 0);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(27, 50)) == 2);
+  }
+
+  SECTION("Test invalid proportions") {
+    REQUIRE_THROWS_AS(keyboard.SetKeyProportions({0.5, 1}),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(keyboard.SetKeyProportions({0.1, 0.5, 0.6, 0.9}),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(keyboard.SetKeyProportions({0.1, 0.5, 0.5, 1}),
+                      std::out_of_range);
+  }
+}
+
+TEST_CASE("Test keys merged by level of detail") {
+  Keyboard keyboard(glm::vec2(0, 100), 100, 100, 1201);
+
+  SECTION("Test every key drawn by default") {
+    REQUIRE(keyboard.GetNumBands() == keyboard.GetNumKeys());
+  }
+
+  SECTION("Test dense keys merged into bands") {
+    keyboard.SetLevelOfDetail(true);
+
+    REQUIRE(keyboard.GetNumBands() <= 100 / Keyboard::kMinKeyWidth + 1);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(50, 50)) == 600);
+  }
+
+  SECTION("Test keys apart when zoomed in") {
+    keyboard.SetLevelOfDetail(true);
+    keyboard.Zoom(Keyboard::kMaxZoom, 50);
+
+    // Zoomed keys are wider than kMinKeyWidth, so each is its own band
+    size_t num_visible_keys = static_cast<size_t>(
+        keyboard.GetNumKeys() / Keyboard::kMaxZoom) + 1;
+    REQUIRE(keyboard.GetNumBands() == num_visible_keys);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(50, 50)) == 600);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(55, 50)) == 601);
+  }
+}
+
+TEST_CASE("Test zoom keyboard") {
+  Keyboard keyboard(glm::vec2(0, 100), 100, 100, 10);
+
+  SECTION("Test zoom around the left edge") {
+    keyboard.Zoom(2, 0);
+
+    REQUIRE(keyboard.GetZoom() == Approx(2));
+    REQUIRE(keyboard.GetNumBands() == 5);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(15, 50)) == 0);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(25, 50)) == 1);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(99, 50)) == 4);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(101, 50)) == -1);
+  }
+
+  SECTION("Test zoom around the right edge") {
+    keyboard.Zoom(2, 100);
+
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(5, 50)) == 5);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(95, 50)) == 9);
+  }
+
+  SECTION("Test zoom of unequal keys") {
+    keyboard.UpdateDivisions(4);
+    keyboard.SetKeyProportions({0.1, 0.5, 0.6, 1});
+    keyboard.Zoom(2, 0);
+
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(18, 50)) == 0);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(22, 50)) == 1);
+  }
+
+  SECTION("Test zoom clamped") {
+    keyboard.Zoom(2, 50);
+    keyboard.Zoom(0.01, 50);
+
+    REQUIRE(keyboard.GetZoom() == Approx(1));
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(5, 50)) == 0);
+    REQUIRE(keyboard.GetKeyIndex(glm::vec2(95, 50)) == 9);
+  }
+
+  SECTION("Test invalid zoom factor") {
+    REQUIRE_THROWS_AS(keyboard.Zoom(-1, 50), std::out_of_range);
+  }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <core/keyboard_mapping.h>
+
+using scalepiegraph::KeyboardMapping;
+using scalepiegraph::Scale;
+
+TEST_CASE("Linear keyboard mapping tunes keys in twelve-tone equal") {
+  KeyboardMapping mapping;
+  Scale scale(12);
+
+  REQUIRE(mapping.IsMapped(0));
+  REQUIRE(mapping.IsMapped(127));
+  REQUIRE(mapping.GetDegree(60, scale.GetNumNotes()) == 0);
+  REQUIRE(mapping.GetDegree(48, scale.GetNumNotes()) == -12);
+  REQUIRE(mapping.CalculateKeyFrequency(scale, 69) == Approx(440));
+  REQUIRE(mapping.CalculateKeyFrequency(scale, 60) == Approx(261.6256));
+  REQUIRE(mapping.CalculateKeyFrequency(scale, 81) == Approx(880));
+  REQUIRE(mapping.CalculateKeyFrequency(scale, 21) == Approx(27.5));
+}
+
+TEST_CASE("Keyboard mapping table places a scale on the white keys") {
+  Scale major("Major", {200, 200, 100, 200, 200, 200});
+  const int kX = KeyboardMapping::kUnmapped;
+  KeyboardMapping mapping({0, kX, 1, kX, 2, 3, kX, 4, kX, 5, kX, 6},
+                          60, 69, 440, 0, 127, 7);
+
+  REQUIRE_FALSE(mapping.IsMapped(61));
+  REQUIRE_FALSE(mapping.IsMapped(49));
+  REQUIRE(mapping.IsMapped(64));
+  REQUIRE(mapping.GetDegree(64, major.GetNumNotes()) == 2);
+  REQUIRE(mapping.GetDegree(72, major.GetNumNotes()) == 7);
+  REQUIRE(mapping.GetDegree(59, major.GetNumNotes()) == -1);
+
+  REQUIRE(mapping.CalculateKeyFrequency(major, 69) == Approx(440));
+  REQUIRE(mapping.CalculateKeyFrequency(major, 60) == Approx(261.6256));
+  REQUIRE(mapping.CalculateKeyFrequency(major, 72) == Approx(523.2511));
+  REQUIRE(mapping.CalculateKeyFrequency(major, 48) == Approx(130.8128));
+  REQUIRE_THROWS_AS(mapping.CalculateKeyFrequency(major, 61),
+                    std::out_of_range);
+}
+
+TEST_CASE("Keyboard mapping limits the mapped keys") {
+  KeyboardMapping mapping({}, 60, 69, 440, 36, 96);
+
+  REQUIRE_FALSE(mapping.IsMapped(35));
+  REQUIRE(mapping.IsMapped(36));
+  REQUIRE(mapping.IsMapped(96));
+  REQUIRE_FALSE(mapping.IsMapped(97));
+}
+
+TEST_CASE("Keyboard mapping rejects inconsistent fields") {
+  REQUIRE_THROWS_AS(KeyboardMapping({}, 60, 69, 0), std::out_of_range);
+  REQUIRE_THROWS_AS(KeyboardMapping({}, 60, 128, 440), std::out_of_range);
+  REQUIRE_THROWS_AS(KeyboardMapping({}, 60, 69, 440, 70, 60),
+                    std::out_of_range);
+  REQUIRE_THROWS_AS(KeyboardMapping({0, KeyboardMapping::kUnmapped},
+                                    60, 61, 440),
+                    std::out_of_range);
+}
+
+TEST_CASE("Load Scala keyboard mapping") {
+  SECTION("Valid file") {
+    std::istringstream kbm(
+        "! white_keys.kbm\n"
+        "! Size of map:\n"
+        "12\n"
+        "0\n127\n60\n69\n440.0\n7\n"
+        "! Mapping:\n"
+        "0\nx\n1\nx\n2\n3\nx\n4\nx\n5\nx\n6\n");
+    KeyboardMapping mapping;
+    kbm >> mapping;
+
+    REQUIRE_FALSE(mapping.IsMapped(61));
+    REQUIRE(mapping.CalculateKeyFrequency(
+        Scale("Major", {200, 200, 100, 200, 200, 200}), 72) ==
+            Approx(523.2511));
+  }
+
+  SECTION("Truncated file") {
+    std::istringstream kbm("12\n0\n127\n");
+    KeyboardMapping mapping;
+    REQUIRE_THROWS_AS(kbm >> mapping, std::runtime_error);
+  }
+
+  SECTION("Malformed number") {
+    std::istringstream kbm("twelve\n0\n127\n60\n69\n440.0\n12\n");
+    KeyboardMapping mapping;
+    REQUIRE_THROWS_AS(kbm >> mapping, std::runtime_error);
+  }
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <core/lru_cache.h>
+
+using scalepiegraph::LruCache;
+
+TEST_CASE("LRU cache looks up values") {
+  LruCache<std::string, int> cache(2);
+  cache.Put("Blues", 6);
+  int value = 0;
+
+  SECTION("Cached key found") {
+    REQUIRE(cache.Get("Blues", &value));
+    REQUIRE(value == 6);
+  }
+
+  SECTION("Missing key not found") {
+    REQUIRE_FALSE(cache.Get("Tritone", &value));
+    REQUIRE(value == 0);
+  }
+
+  SECTION("Value replaced") {
+    cache.Put("Blues", 7);
+
+    REQUIRE(cache.Get("Blues", &value));
+    REQUIRE(value == 7);
+    REQUIRE(cache.GetSize() == 1);
+  }
+}
+
+TEST_CASE("LRU cache evicts least recently used entry") {
+  LruCache<std::string, int> cache(2);
+  cache.Put("Blues", 6);
+  cache.Put("Tritone", 2);
+  int value = 0;
+
+  SECTION("Oldest entry evicted") {
+    cache.Put("Major", 7);
+
+    REQUIRE_FALSE(cache.Contains("Blues"));
+    REQUIRE(cache.Contains("Tritone"));
+    REQUIRE(cache.Contains("Major"));
+    REQUIRE(cache.GetSize() == 2);
+  }
+
+  SECTION("Lookup keeps entry") {
+    REQUIRE(cache.Get("Blues", &value));
+    cache.Put("Major", 7);
+
+    REQUIRE(cache.Contains("Blues"));
+    REQUIRE_FALSE(cache.Contains("Tritone"));
+  }
+
+  SECTION("Contains does not keep entry") {
+    REQUIRE(cache.Contains("Blues"));
+    cache.Put("Major", 7);
+
+    REQUIRE_FALSE(cache.Contains("Blues"));
+  }
+
+  SECTION("Replacing keeps entry") {
+    cache.Put("Blues", 5);
+    cache.Put("Major", 7);
+
+    REQUIRE(cache.Get("Blues", &value));
+    REQUIRE(value == 5);
+    REQUIRE_FALSE(cache.Contains("Tritone"));
+  }
+}
+
+TEST_CASE("LRU cache rejects zero capacity") {
+  REQUIRE_THROWS_AS((LruCache<std::string, int>(0)), std::out_of_range);
+  REQUIRE(LruCache<std::string, int>(3).GetCapacity() == 3);
+}
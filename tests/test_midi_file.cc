@@ -0,0 +1,201 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <core/midi_file.h>
+#include <core/midi_player.h>
+#include <core/offline_renderer.h>
+
+using scalepiegraph::KeyboardMapping;
+using scalepiegraph::MidiFile;
+using scalepiegraph::MidiNote;
+using scalepiegraph::MidiPlayer;
+using scalepiegraph::OfflineRenderer;
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::Scale;
+using scalepiegraph::SynthEngine;
+
+/**
+ * Build a Standard MIDI File from its header fields and track contents.
+ */
+std::vector<uint8_t> MakeMidiBytes(
+    uint16_t format,
+    uint16_t division,
+    const std::vector<std::vector<uint8_t>>& tracks) {
+  std::vector<uint8_t> bytes = {'M', 'T', 'h', 'd', 0, 0, 0, 6};
+  bytes.push_back(format >> 8);
+  bytes.push_back(format & 0xFF);
+  bytes.push_back(tracks.size() >> 8);
+  bytes.push_back(tracks.size() & 0xFF);
+  bytes.push_back(division >> 8);
+  bytes.push_back(division & 0xFF);
+
+  for (const std::vector<uint8_t>& track : tracks) {
+    bytes.insert(bytes.end(), {'M', 'T', 'r', 'k'});
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      bytes.push_back((track.size() >> shift) & 0xFF);
+    }
+    bytes.insert(bytes.end(), track.begin(), track.end());
+  }
+
+  return bytes;
+}
+
+/**
+ * A two-track file at 480 ticks per quarter. Middle C sounds for a quarter
+ * note at 120 bpm, then the tempo halves while A4 sounds for a quarter note.
+ */
+std::vector<uint8_t> MakeTwoTrackMidi() {
+  std::vector<uint8_t> conductor = {
+      0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, // 500000 us per quarter
+      0x83, 0x60, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40, // 1000000 at tick 480
+      0x00, 0xFF, 0x2F, 0x00};
+  std::vector<uint8_t> melody = {
+      0x00, 0x90, 0x3C, 0x64,
+      0x83, 0x60, 0x3C, 0x00, // Running status note on with zero velocity
+      0x00, 0x45, 0x64,
+      0x00, 0xF0, 0x02, 0x7D, 0xF7, // System exclusive is skipped
+      0x83, 0x60, 0x80, 0x45, 0x40,
+      0x00, 0xFF, 0x2F, 0x00};
+
+  return MakeMidiBytes(1, 480, {conductor, melody});
+}
+
+TEST_CASE("MIDI file reads its header") {
+  MidiFile midi_file(MakeTwoTrackMidi());
+
+  REQUIRE(midi_file.GetFormat() == 1);
+  REQUIRE(midi_file.GetNumTracks() == 2);
+  REQUIRE(midi_file.GetTicksPerQuarter() == 480);
+}
+
+TEST_CASE("MIDI file merges tracks into timed notes") {
+  std::vector<MidiNote> notes = MidiFile(MakeTwoTrackMidi()).GetNotes();
+
+  REQUIRE(notes.size() == 4);
+
+  REQUIRE(notes[0].is_note_on);
+  REQUIRE(notes[0].key == 60);
+  REQUIRE(notes[0].velocity == 100);
+  REQUIRE(notes[0].time == 0);
+
+  REQUIRE_FALSE(notes[1].is_note_on);
+  REQUIRE(notes[1].key == 60);
+  REQUIRE(notes[1].time == Approx(0.5));
+
+  REQUIRE(notes[2].is_note_on);
+  REQUIRE(notes[2].key == 69);
+  REQUIRE(notes[2].time == Approx(0.5));
+
+  REQUIRE_FALSE(notes[3].is_note_on);
+  REQUIRE(notes[3].time == Approx(1.5)); // At the halved tempo
+}
+
+TEST_CASE("MIDI file supports SMPTE time") {
+  // 25 frames per second of 40 ticks each, so one tick per millisecond
+  std::vector<uint8_t> track = {0x00, 0x91, 0x40, 0x50,
+                                0x87, 0x68, 0x81, 0x40, 0x00,
+                                0x00, 0xFF, 0x2F, 0x00};
+  std::vector<MidiNote> notes =
+      MidiFile(MakeMidiBytes(0, 0xE728, {track})).GetNotes();
+
+  REQUIRE(notes.size() == 2);
+  REQUIRE(notes[0].channel == 1);
+  REQUIRE(notes[1].time == Approx(1.0));
+  REQUIRE(MidiFile(MakeMidiBytes(0, 0xE728, {track})).GetTicksPerQuarter() ==
+          0);
+}
+
+TEST_CASE("MIDI file rejects invalid data") {
+  SECTION("Not a MIDI file") {
+    REQUIRE_THROWS_AS(MidiFile({'R', 'I', 'F', 'F', 0, 0, 0, 6,
+                                0, 0, 0, 0, 0, 0}),
+                      std::runtime_error);
+  }
+
+  SECTION("Missing track") {
+    std::vector<uint8_t> bytes = MakeTwoTrackMidi();
+    bytes.resize(14);
+    REQUIRE_THROWS_AS(MidiFile(bytes), std::runtime_error);
+  }
+
+  SECTION("Truncated event") {
+    std::vector<uint8_t> track = {0x00, 0x90, 0x3C};
+    MidiFile midi_file(MakeMidiBytes(0, 96, {track}));
+    REQUIRE_THROWS_AS(midi_file.GetNotes(), std::runtime_error);
+  }
+
+  SECTION("Data without a status") {
+    std::vector<uint8_t> track = {0x00, 0x3C, 0x64};
+    MidiFile midi_file(MakeMidiBytes(0, 96, {track}));
+    REQUIRE_THROWS_AS(midi_file.GetNotes(), std::runtime_error);
+  }
+
+  SECTION("Missing file") {
+    REQUIRE_THROWS_AS(MidiFile::Load("missing.mid"), std::runtime_error);
+  }
+}
+
+TEST_CASE("MIDI player retunes notes through a scale") {
+  const double kSampleRate = 1000;
+  Scale scale(12);
+  MidiFile midi_file(MakeTwoTrackMidi());
+
+  SECTION("Notes become note events on their frames") {
+    MidiPlayer player(midi_file, scale, KeyboardMapping(), kSampleRate);
+    const std::vector<ParameterEvent>& events = player.GetEvents();
+
+    REQUIRE(events.size() == 4);
+    REQUIRE(events[0].type == ParameterEvent::Type::kNoteOn);
+    REQUIRE(events[0].note == MidiPlayer::GetNoteId(0, 60));
+    REQUIRE(events[0].value == Approx(261.6256));
+    REQUIRE(events[1].type == ParameterEvent::Type::kNoteOff);
+    REQUIRE(events[1].frame == 500);
+    REQUIRE(events[2].value == Approx(440));
+    REQUIRE(player.GetNumFrames() == 1500);
+  }
+
+  SECTION("Unmapped keys are skipped") {
+    KeyboardMapping mapping({}, 60, 69, 440, 61, 127);
+    MidiPlayer player(midi_file, scale, mapping, kSampleRate);
+
+    REQUIRE(player.GetEvents().size() == 2);
+    REQUIRE(player.GetEvents()[0].value == Approx(440));
+  }
+
+  SECTION("Events are fed up to a frame") {
+    SynthEngine engine(kSampleRate);
+    MidiPlayer player(midi_file, scale, KeyboardMapping(), kSampleRate);
+    player.Start(100);
+
+    REQUIRE(player.Feed(engine, 600) == 1);
+    REQUIRE(player.Feed(engine, 601) == 2);
+    REQUIRE_FALSE(player.IsFinished());
+    REQUIRE(player.Feed(engine, 10000) == 1);
+    REQUIRE(player.IsFinished());
+    REQUIRE(engine.GetParameterQueue().GetDepth() == 4);
+  }
+
+  SECTION("Feeding stops while the queue is full") {
+    SynthEngine engine(kSampleRate, 2);
+    MidiPlayer player(midi_file, scale, KeyboardMapping(), kSampleRate);
+    player.Start(0);
+
+    REQUIRE(player.Feed(engine, 10000) == 2);
+    REQUIRE_FALSE(player.IsFinished());
+  }
+}
+
+TEST_CASE("Offline renderer plays MIDI files") {
+  OfflineRenderer renderer;
+  std::vector<float> samples =
+      renderer.RenderMidi(MidiFile(MakeTwoTrackMidi()), Scale(12));
+
+  REQUIRE(samples.size() ==
+          static_cast<size_t>((1.5 + OfflineRenderer::kTailSeconds) *
+                              renderer.GetSampleRate()));
+
+  float peak = 0;
+  for (float sample : samples) {
+    peak = std::max(peak, std::abs(sample));
+  }
+  REQUIRE(peak > 0.01);
+}
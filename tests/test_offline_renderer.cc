@@ -0,0 +1,99 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <catch2/catch.hpp>
+#include <core/offline_renderer.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::OfflineRenderer;
+using scalepiegraph::Scale;
+using scalepiegraph::SequenceStep;
+using scalepiegraph::WavWriter;
+using scalepiegraph::Waveform;
+
+const std::vector<SequenceStep> kSequence = {
+    {0, 0.1, Waveform::kSine, 20000},
+    {4, 0.1, Waveform::kSquare, 2000},
+    {7, 0.05, Waveform::kSawtooth, 800}};
+
+TEST_CASE("Offline render to memory") {
+  OfflineRenderer renderer;
+  Scale scale(12);
+
+  std::vector<float> samples = renderer.Render(scale, kSequence);
+
+  SECTION("Length covers every step and the tail") {
+    const size_t kExpectedFrames = 4410 + 4410 + 2205 + 11025;
+
+    REQUIRE(samples.size() == kExpectedFrames);
+    REQUIRE(renderer.GetNumFrames(kSequence) == kExpectedFrames);
+  }
+
+  SECTION("Rendering is deterministic") {
+    REQUIRE(renderer.Render(scale, kSequence) == samples);
+  }
+
+  SECTION("Notes sound and the tail decays to silence") {
+    float peak = 0;
+    for (size_t frame = 0; frame < 4410; ++frame) {
+      peak = std::max(peak, std::fabs(samples[frame]));
+    }
+
+    REQUIRE(peak > 0.1);
+    REQUIRE(samples.back() == 0);
+  }
+
+  SECTION("First note is at the scale frequency") {
+    // Count rising zero crossings of the sine note after its attack
+    size_t crossings = 0;
+    for (size_t frame = 1000; frame < 4410; ++frame) {
+      if (samples[frame - 1] < 0 && samples[frame] >= 0) {
+        ++crossings;
+      }
+    }
+
+    double expected = 440.0 * (4410 - 1000) / 44100;
+    REQUIRE(crossings == Approx(expected).margin(1));
+  }
+}
+
+TEST_CASE("Offline render invalid") {
+  SECTION("Invalid sample rate") {
+    REQUIRE_THROWS_AS(OfflineRenderer(0), std::out_of_range);
+  }
+
+  SECTION("Negative duration") {
+    OfflineRenderer renderer;
+
+    REQUIRE_THROWS_AS(
+        renderer.Render(Scale(12), {{0, -1, Waveform::kSine, 200}}),
+        std::out_of_range);
+  }
+}
+
+TEST_CASE("Offline render to WAV file") {
+  const std::string kPath = "test_offline_render.wav";
+  OfflineRenderer renderer;
+  Scale scale(12);
+
+  size_t num_frames = renderer.RenderToFile(scale, kSequence, kPath);
+
+  std::ifstream file(kPath, std::ios::binary);
+  std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  file.close();
+  std::remove(kPath.c_str());
+
+  REQUIRE(num_frames == renderer.GetNumFrames(kSequence));
+  REQUIRE(bytes.size() == WavWriter::kHeaderSize + 2 * num_frames);
+  REQUIRE(std::string(bytes.begin(), bytes.begin() + 4) == "RIFF");
+  REQUIRE(std::string(bytes.begin() + 8, bytes.begin() + 12) == "WAVE");
+
+  // Data chunk size is patched in on close
+  uint32_t data_size = static_cast<uint8_t>(bytes[40]) |
+                       static_cast<uint8_t>(bytes[41]) << 8 |
+                       static_cast<uint8_t>(bytes[42]) << 16 |
+                       static_cast<uint8_t>(bytes[43]) << 24;
+  REQUIRE(data_size == 2 * num_frames);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <thread>
+#include <catch2/catch.hpp>
+#include <core/parameter_queue.h>
+
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::ParameterQueue;
+
+ParameterEvent MakeFrequencyEvent(uint64_t frame) {
+  ParameterEvent event;
+  event.type = ParameterEvent::Type::kFrequency;
+  event.frame = frame;
+  event.value = 440.0 + frame;
+  return event;
+}
+
+TEST_CASE("Construct parameter queue") {
+  SECTION("Capacity rounded to power of two") {
+    ParameterQueue queue(5);
+
+    REQUIRE(queue.GetCapacity() == 8);
+    REQUIRE(queue.GetDepth() == 0);
+    REQUIRE(queue.Peek() == nullptr);
+  }
+
+  SECTION("Zero capacity") {
+    REQUIRE_THROWS_AS(ParameterQueue(0), std::out_of_range);
+  }
+}
+
+TEST_CASE("Push and pop parameter events") {
+  ParameterQueue queue(4);
+
+  SECTION("Events leave in order") {
+    for (uint64_t frame = 0; frame < 3; ++frame) {
+      REQUIRE(queue.Push(MakeFrequencyEvent(frame)));
+    }
+
+    for (uint64_t frame = 0; frame < 3; ++frame) {
+      const ParameterEvent* event = queue.Peek();
+      REQUIRE(event != nullptr);
+      REQUIRE(event->frame == frame);
+      REQUIRE(event->value == Approx(440.0 + frame));
+      queue.Pop();
+    }
+
+    REQUIRE(queue.Peek() == nullptr);
+  }
+
+  SECTION("Full queue drops events") {
+    for (uint64_t frame = 0; frame < 4; ++frame) {
+      REQUIRE(queue.Push(MakeFrequencyEvent(frame)));
+    }
+
+    REQUIRE_FALSE(queue.Push(MakeFrequencyEvent(4)));
+    REQUIRE(queue.GetNumDropped() == 1);
+    REQUIRE(queue.GetDepth() == 4);
+  }
+
+  SECTION("Depth instrumentation") {
+    queue.Push(MakeFrequencyEvent(0));
+    queue.Push(MakeFrequencyEvent(1));
+    queue.Push(MakeFrequencyEvent(2));
+    queue.Pop();
+    queue.Pop();
+
+    REQUIRE(queue.GetDepth() == 1);
+    REQUIRE(queue.GetMaxDepth() == 3);
+
+    queue.ResetStatistics();
+    REQUIRE(queue.GetMaxDepth() == 0);
+  }
+}
+
+TEST_CASE("Parameter queue across threads") {
+  const uint64_t kNumEvents = 100000;
+  ParameterQueue queue(64);
+
+  std::thread producer([&queue, kNumEvents]() {
+    for (uint64_t frame = 0; frame < kNumEvents; ++frame) {
+      while (!queue.Push(MakeFrequencyEvent(frame))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected_frame = 0;
+  bool in_order = true;
+  while (expected_frame < kNumEvents) {
+    const ParameterEvent* event = queue.Peek();
+    if (event == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    in_order = in_order && event->frame == expected_frame;
+    queue.Pop();
+    ++expected_frame;
+  }
+
+  producer.join();
+
+  REQUIRE(in_order);
+  REQUIRE(queue.GetMaxDepth() <= queue.GetCapacity());
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <core/performance_analyzer.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::PerformanceAnalyzer;
+using scalepiegraph::PerformanceReport;
+using scalepiegraph::Scale;
+using scalepiegraph::WavWriter;
+
+/**
+ * Perform a sequence of notes of a Scale, each detuned by some cents, as
+ * half a second of sawtooth-like tone each.
+ */
+std::vector<float> MakePerformance(const Scale& scale,
+                                   const std::vector<size_t>& notes,
+                                   const std::vector<double>& detunes) {
+  const double kSampleRate = 44100;
+  std::vector<float> performance;
+  double phase = 0;
+
+  for (size_t note_idx = 0; note_idx < notes.size(); ++note_idx) {
+    double frequency = scale.CalculateNoteFrequency(notes[note_idx], 220) *
+                       std::exp2(detunes[note_idx] / 1200);
+
+    for (size_t frame = 0; frame < kSampleRate / 2; ++frame) {
+      phase += frequency / kSampleRate;
+      float sample = 0;
+      for (size_t harmonic = 1; harmonic <= 4; ++harmonic) {
+        sample += static_cast<float>(
+            0.3 / harmonic * std::sin(6.283185307179586 * harmonic * phase));
+      }
+      performance.push_back(sample);
+    }
+  }
+
+  return performance;
+}
+
+TEST_CASE("Score a performance against a scale") {
+  Scale scale(12);
+  std::vector<float> performance =
+      MakePerformance(scale, {0, 4, 7, 16}, {0, 10, -20, 10});
+
+  SECTION("Deviations per note") {
+    PerformanceAnalyzer analyzer(scale, 220, 44100);
+
+    // Blocks of any size
+    for (size_t first = 0; first < performance.size(); first += 1000) {
+      analyzer.Process(&performance[first],
+                       std::min<size_t>(1000, performance.size() - first));
+    }
+    PerformanceReport report = analyzer.GetReport();
+
+    REQUIRE(report.seconds == Approx(2));
+    REQUIRE(report.notes.size() == 12);
+    REQUIRE(report.num_pitched_windows > 0.9 * report.num_windows);
+    REQUIRE(report.notes[0].mean_cents == Approx(0).margin(1));
+    REQUIRE(report.notes[4].mean_cents == Approx(10).margin(1));
+    REQUIRE(report.notes[7].mean_cents == Approx(-20).margin(2));
+    REQUIRE(report.notes[7].max_cents >= 19);
+
+    // Note 16 is note 4 an octave up
+    REQUIRE(report.notes[4].num_windows > report.notes[0].num_windows);
+    REQUIRE(report.notes[2].num_windows == 0);
+  }
+
+  SECTION("From a file") {
+    const std::string kPath = "test_performance_analyzer.wav";
+    WavWriter::WriteFile(kPath, performance, 44100);
+
+    PerformanceReport report =
+        PerformanceAnalyzer::AnalyzeFile(kPath, scale, 220);
+    std::remove(kPath.c_str());
+
+    REQUIRE(report.scale_name == scale.GetName());
+    REQUIRE(report.notes[7].mean_cents == Approx(-20).margin(2));
+    REQUIRE(report.mean_abs_cents == Approx(10).margin(2));
+
+    std::ostringstream json;
+    json << report;
+    REQUIRE(json.str().find("\"mean_cents\"") != std::string::npos);
+  }
+}
+
+TEST_CASE("Invalid performance analyzer") {
+  REQUIRE_THROWS_AS(PerformanceAnalyzer(Scale(12), 0, 44100),
+                    std::out_of_range);
+  REQUIRE_THROWS_AS(PerformanceAnalyzer(Scale(12), 220, 44100, 0),
+                    std::out_of_range);
+}
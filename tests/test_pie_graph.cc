@@ -16,6 +16,8 @@ TEST_CASE("Construct pie graph from proportions") {
   for (size_t prop_index = 0; prop_index < out.size(); ++prop_index) {
     REQUIRE(out[prop_index] == Approx(kExpectedProportions.at(prop_index)));
   }
+
+  REQUIRE(graph.IsDirty());
 }
 
 TEST_CASE("Test get handle index") {
@@ -128,4 +130,166 @@ TEST_CASE("Test update handle") {
       REQUIRE(out[prop_index] == Approx(kExpected.at(prop_index)));
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test handles follow update") {
+  PieGraph graph(glm::vec2(0, 0), 100, {0.25, 0.5, 0.75, 0.8});
+  PieGraph original = graph;
+
+  REQUIRE(graph.UpdateHandle(2, glm::vec2(100, -100)));
+
+  SECTION("Moved handle found at new position") {
+    REQUIRE(graph.GetHandleIndex(glm::vec2(70.71f, -70.71f)) == 2);
+    REQUIRE(graph.GetHandleIndex(glm::vec2(100, 0)) == -1);
+  }
+
+  SECTION("Unmoved handle found at old position") {
+    REQUIRE(graph.GetHandleIndex(glm::vec2(-100, 0)) == 0);
+  }
+
+  SECTION("Copy keeps its own handles") {
+    REQUIRE(original.GetHandleIndex(glm::vec2(100, 0)) == 2);
+  }
+}
+
+TEST_CASE("Test get handle index of many handles") {
+  const size_t kNumHandles = 100;
+  std::vector<float> proportions;
+  for (size_t handle = 1; handle <= kNumHandles; ++handle) {
+    proportions.push_back(static_cast<float>(handle) / kNumHandles);
+  }
+
+  PieGraph graph(glm::vec2(0, 0), 100, proportions);
+
+  SECTION("Every handle found at its position") {
+    for (size_t handle = 0; handle < kNumHandles; ++handle) {
+      float angle = 2 * glm::pi<float>() * proportions[handle];
+      glm::vec2 direction(-glm::sin(angle), -glm::cos(angle));
+
+      REQUIRE(graph.GetHandleIndex(100.0f * direction) ==
+              static_cast<int>(handle));
+      REQUIRE(graph.GetHandleIndex(104.0f * direction) ==
+              static_cast<int>(handle));
+    }
+  }
+
+  SECTION("Last handle found on either side of the apex") {
+    REQUIRE(graph.GetHandleIndex(glm::vec2(1, -100)) == kNumHandles - 1);
+    REQUIRE(graph.GetHandleIndex(glm::vec2(-1, -100)) == kNumHandles - 1);
+  }
+}
+
+TEST_CASE("Test get handle index of overlapping handles") {
+  const float kAngle = 0.251f * 2 * glm::pi<float>();
+  PieGraph graph(glm::vec2(0, 0), 100, {0.25, 0.251, 0.5, 1});
+
+  // The second handle is moved outward, off the first
+  REQUIRE(graph.GetHandleIndex(
+      glm::vec2(-120 * glm::sin(kAngle), -120 * glm::cos(kAngle))) == 1);
+  REQUIRE(graph.GetHandleIndex(glm::vec2(-100, 0)) == 0);
+}
+
+TEST_CASE("Test handles collapsed by level of detail") {
+  std::vector<float> proportions;
+  for (size_t note = 1; note <= 1200; ++note) {
+    proportions.push_back(note / 1200.0f);
+  }
+
+  PieGraph graph(glm::vec2(0, 0), 100, proportions);
+
+  SECTION("Every handle detailed by default") {
+    REQUIRE(graph.IsHandleDetailed(0));
+    REQUIRE(graph.IsHandleDetailed(599));
+  }
+
+  graph.SetLevelOfDetail(true);
+
+  SECTION("Dense handles collapsed and not found") {
+    REQUIRE_FALSE(graph.IsHandleDetailed(0));
+    REQUIRE_FALSE(graph.IsHandleDetailed(599));
+    REQUIRE(graph.GetHandleIndex(glm::vec2(0, 100)) == -1);
+    REQUIRE(graph.IsDirty());
+  }
+
+  SECTION("Handles detailed when zoomed in") {
+    graph.Zoom(PieGraph::kMaxZoom, glm::vec2(0, 100));
+
+    REQUIRE(graph.GetZoom() == Approx(PieGraph::kMaxZoom));
+    REQUIRE(graph.IsHandleDetailed(599));
+    REQUIRE(graph.GetHandleIndex(glm::vec2(0, 100)) == 599);
+    REQUIRE(graph.GetHandleIndex(glm::vec2(0, -100)) == -1);
+  }
+
+  SECTION("Handles outside the zoomed view not drawn") {
+    graph.Zoom(PieGraph::kMaxZoom, glm::vec2(0, 100));
+
+    REQUIRE_FALSE(graph.IsHandleDetailed(0));
+    REQUIRE_FALSE(graph.IsHandleDetailed(299));
+    REQUIRE_FALSE(graph.IsHandleDetailed(899));
+  }
+
+  SECTION("Sparse handles among dense ones stay detailed") {
+    std::vector<float> mixed;
+    for (size_t note = 1; note <= 100; ++note) {
+      mixed.push_back(note / 1200.0f);
+    }
+    mixed.push_back(0.5);
+    mixed.push_back(0.75);
+    mixed.push_back(1);
+
+    PieGraph sparse(glm::vec2(0, 0), 100, mixed);
+    sparse.SetLevelOfDetail(true);
+
+    REQUIRE_FALSE(sparse.IsHandleDetailed(50));
+    REQUIRE(sparse.IsHandleDetailed(100));
+    REQUIRE(sparse.IsHandleDetailed(102));
+    REQUIRE(sparse.GetHandleIndex(glm::vec2(0, 100)) == 100);
+
+    // Dragging a detailed handle keeps it detailed and found
+    REQUIRE(sparse.UpdateHandle(100, glm::vec2(-100, 0)));
+    REQUIRE(sparse.IsHandleDetailed(100));
+    REQUIRE(sparse.GetHandleIndex(glm::vec2(-100, 0)) == 100);
+    REQUIRE(sparse.GetHandleIndex(glm::vec2(100, 0)) == 102);
+  }
+
+  SECTION("Sparse handles stay detailed") {
+    PieGraph sparse(glm::vec2(0, 0), 100, {0.25, 0.5, 0.75, 1});
+    sparse.SetLevelOfDetail(true);
+
+    REQUIRE(sparse.IsHandleDetailed(0));
+    REQUIRE(sparse.IsHandleDetailed(3));
+    REQUIRE(sparse.GetHandleIndex(glm::vec2(-100, 0)) == 0);
+  }
+}
+
+TEST_CASE("Test zoom pie graph") {
+  PieGraph graph(glm::vec2(0, 0), 100, {0.25, 0.5, 0.75, 1});
+
+  SECTION("Anchor stays in place") {
+    graph.Zoom(2, glm::vec2(-100, 0));
+
+    REQUIRE(graph.GetZoom() == Approx(2));
+    REQUIRE(graph.GetHandleIndex(glm::vec2(-100, 0)) == 0);
+    REQUIRE(graph.GetHandleIndex(glm::vec2(100, 0)) == -1);
+    REQUIRE(graph.GetCenter() == glm::vec2(0, 0));
+    REQUIRE(graph.GetRadius() == Approx(100));
+  }
+
+  SECTION("Zoom out restores the whole graph") {
+    graph.Zoom(2, glm::vec2(-100, 0));
+    graph.Zoom(0.01, glm::vec2(50, 50));
+
+    REQUIRE(graph.GetZoom() == Approx(1));
+    REQUIRE(graph.GetHandleIndex(glm::vec2(100, 0)) == 2);
+  }
+
+  SECTION("Zoom clamped") {
+    graph.Zoom(1000, glm::vec2(0, 0));
+
+    REQUIRE(graph.GetZoom() == Approx(PieGraph::kMaxZoom));
+  }
+
+  SECTION("Invalid zoom factor") {
+    REQUIRE_THROWS_AS(graph.Zoom(0, glm::vec2(0, 0)), std::out_of_range);
+  }
+}
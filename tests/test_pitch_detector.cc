@@ -0,0 +1,59 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <core/pitch_detector.h>
+
+using scalepiegraph::PitchDetector;
+using scalepiegraph::PitchEstimate;
+
+/**
+ * Fill the input of a detector with a tone of a few harmonics.
+ */
+std::vector<float> MakeDetectorInput(const PitchDetector& detector,
+                                     double frequency,
+                                     size_t num_harmonics) {
+  std::vector<float> input(detector.GetInputFrames());
+  for (size_t frame = 0; frame < input.size(); ++frame) {
+    for (size_t harmonic = 1; harmonic <= num_harmonics; ++harmonic) {
+      input[frame] += static_cast<float>(
+          0.5 / harmonic *
+          std::sin(6.283185307179586 * harmonic * frequency * frame / 44100));
+    }
+  }
+
+  return input;
+}
+
+TEST_CASE("Detect pitch") {
+  PitchDetector detector(44100);
+
+  SECTION("Sine") {
+    std::vector<float> input = MakeDetectorInput(detector, 440, 1);
+    PitchEstimate estimate = detector.Detect(input.data());
+
+    REQUIRE(estimate.frequency == Approx(440).epsilon(0.002));
+    REQUIRE(estimate.aperiodicity < PitchDetector::kThreshold);
+  }
+
+  SECTION("Harmonic tone") {
+    for (double frequency : {65.0, 110.0, 277.18, 1046.5}) {
+      std::vector<float> input = MakeDetectorInput(detector, frequency, 8);
+
+      REQUIRE(detector.Detect(input.data()).frequency ==
+              Approx(frequency).epsilon(0.002));
+    }
+  }
+
+  SECTION("Silence") {
+    std::vector<float> input(detector.GetInputFrames(), 0);
+
+    REQUIRE(detector.Detect(input.data()).frequency == 0);
+  }
+}
+
+TEST_CASE("Invalid pitch detector") {
+  REQUIRE_THROWS_AS(PitchDetector(0), std::out_of_range);
+  REQUIRE_THROWS_AS(PitchDetector(44100, 500, 100), std::out_of_range);
+  REQUIRE_THROWS_AS(PitchDetector(44100, 60, 20000), std::out_of_range);
+  REQUIRE_THROWS_AS(PitchDetector(44100, 60, 2000, 0), std::out_of_range);
+}
@@ -0,0 +1,241 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <core/additive_timbre.h>
+#include <core/biquad_bank.h>
+#include <core/realtime_checker.h>
+#include <core/recorder.h>
+#include <core/scale_morph.h>
+#include <core/streamed_sample.h>
+#include <core/synth_engine.h>
+#include <core/wav_writer.h>
+#include <core/wavetable.h>
+#include <cstdio>
+#include <mutex>
+
+namespace realtime = scalepiegraph::realtime;
+
+using scalepiegraph::AdditiveTimbre;
+using scalepiegraph::FilterMode;
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::Recorder;
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleMorph;
+using scalepiegraph::StreamedSample;
+using scalepiegraph::SynthEngine;
+using scalepiegraph::Waveform;
+using scalepiegraph::Wavetable;
+
+/**
+ * Create an event stamped with a frame for the engine under test.
+ */
+ParameterEvent MakeTimedEvent(ParameterEvent::Type type,
+                              uint64_t frame,
+                              double value = 0,
+                              int note = 0) {
+  ParameterEvent event;
+  event.type = type;
+  event.frame = frame;
+  event.value = value;
+  event.note = note;
+  return event;
+}
+
+TEST_CASE("Real-time violations are only recorded on the audio thread") {
+  realtime::ClearViolations();
+
+  realtime::ReportViolation(realtime::ViolationType::kAllocation);
+  REQUIRE(realtime::GetNumViolations() == 0);
+
+  {
+    realtime::AudioThreadScope audio_thread;
+    REQUIRE(realtime::IsAudioThread());
+
+    {
+      realtime::AudioThreadScope nested_audio_thread;
+      realtime::ReportViolation(realtime::ViolationType::kMutexLock);
+    }
+    REQUIRE(realtime::IsAudioThread());
+  }
+  REQUIRE_FALSE(realtime::IsAudioThread());
+
+  std::vector<realtime::Violation> violations = realtime::GetViolations();
+  REQUIRE(violations.size() == 1);
+  REQUIRE(violations[0].type == realtime::ViolationType::kMutexLock);
+  REQUIRE(realtime::DescribeViolations().find("mutex lock") !=
+          std::string::npos);
+
+  realtime::ClearViolations();
+  REQUIRE(realtime::GetNumViolations() == 0);
+  REQUIRE(realtime::GetViolations().empty());
+}
+
+TEST_CASE("Real-time checker intercepts unsafe operations") {
+  if (!realtime::IsEnabled()) {
+    return; // Interception needs a SCALEPIEGRAPH_RT_CHECK build
+  }
+  realtime::ClearViolations();
+
+  SECTION("Allocations") {
+    {
+      realtime::AudioThreadScope audio_thread;
+      std::vector<float> buffer(64);
+    }
+
+    REQUIRE(realtime::GetNumViolations() == 2);
+    REQUIRE(realtime::GetViolations()[0].type ==
+            realtime::ViolationType::kAllocation);
+    REQUIRE(realtime::GetViolations()[1].type ==
+            realtime::ViolationType::kDeallocation);
+  }
+
+#if defined(__GLIBC__)
+  SECTION("Mutex locks") {
+    std::mutex mutex;
+    {
+      realtime::AudioThreadScope audio_thread;
+      std::lock_guard<std::mutex> lock(mutex);
+    }
+
+    REQUIRE(realtime::GetNumViolations() == 1);
+    REQUIRE(realtime::GetViolations()[0].type ==
+            realtime::ViolationType::kMutexLock);
+  }
+
+  SECTION("Exception throws") {
+    {
+      realtime::AudioThreadScope audio_thread;
+      try {
+        throw std::range_error("Thrown on the audio thread");
+      } catch (std::range_error&) {}
+    }
+
+    bool has_throw = false;
+    for (const realtime::Violation& violation : realtime::GetViolations()) {
+      has_throw |= violation.type == realtime::ViolationType::kThrow;
+    }
+    REQUIRE(has_throw);
+  }
+#endif
+
+  realtime::ClearViolations();
+}
+
+TEST_CASE("Synth engine renders without real-time violations") {
+  const std::string kPath = "test_realtime_sample.wav";
+  const size_t kBlockSize = 128;
+  scalepiegraph::WavWriter::WriteFile(
+      kPath, std::vector<float>(4096, 0.5f), SynthEngine::kDefaultSampleRate);
+
+  SynthEngine engine(SynthEngine::kDefaultSampleRate, 1024, 8);
+  engine.SetMaxPartials(8);
+  Wavetable custom_wavetable = Wavetable::FromCycle(
+      {0, 1, 0, -1}, SynthEngine::kDefaultSampleRate);
+  StreamedSample sample(kPath, 440, engine.GetVoicePool().GetNumVoices());
+  AdditiveTimbre timbre;
+  timbre.AddPartial(1, 1);
+  timbre.AddPartial(3, 0.5);
+
+  // Exercise every event type, retriggering and voice stealing
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kWaveform, 0,
+                             static_cast<int>(Waveform::kSawtooth)));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kFilterCutoff, 10, 5000));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kFilterMode, 10,
+                             static_cast<int>(FilterMode::kBandPass)));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kFilterResonance, 10, 4));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kFilterEnvelope, 10, 2));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kStart, 20, 220));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kFrequency, 200, 330));
+  for (int note = 0; note < 12; ++note) {
+    engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 300 + 10 * note,
+                               440 + 20 * note, note));
+  }
+  engine.Post(
+      MakeTimedEvent(ParameterEvent::Type::kNoteFilterCutoff, 450, 2000, 5));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 500, 880, 3));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOff, 600, 0, 4));
+
+  ParameterEvent wavetable_event =
+      MakeTimedEvent(ParameterEvent::Type::kWavetable, 700);
+  wavetable_event.wavetable = &custom_wavetable;
+  engine.Post(wavetable_event);
+
+  engine.SetPattern(scalepiegraph::Pattern::Arpeggio(
+      Scale(12), {0, 4, 7}, scalepiegraph::ArpeggioMode::kUpDown, 2, 0.002));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kPlayPattern, 750));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kStop, 800));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kStopAll, 900));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kStopPattern, 1900));
+
+  // Later events are stamped after the ones above and take effect in order
+  engine.SetTimbre(timbre);
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 2000, 440, 1));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 2000, 660, 2));
+  engine.MorphScale(ScaleMorph(Scale(12), Scale(5), 440, 0.005));
+
+  ParameterEvent sample_event =
+      MakeTimedEvent(ParameterEvent::Type::kSample, 2400);
+  sample_event.sample = &sample;
+  engine.Post(sample_event);
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 2500, 550, 3));
+  engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOff, 3000, 0, 3));
+
+  std::vector<float> block(kBlockSize);
+  realtime::ClearViolations();
+  for (size_t i = 0; i < 32; ++i) {
+    engine.Render(block.data(), block.size());
+  }
+
+  INFO(realtime::DescribeViolations());
+  REQUIRE(realtime::GetNumViolations() == 0);
+  REQUIRE(engine.GetAppliedSample() == &sample);
+
+  std::remove(kPath.c_str());
+}
+
+TEST_CASE("Threaded voice rendering runs without real-time violations") {
+  SynthEngine engine(SynthEngine::kDefaultSampleRate, 1024, 256);
+  engine.SetNumRenderThreads(2);
+  REQUIRE(engine.GetVoicePool().GetNumThreads() == 2);
+
+  // Enough notes that the workers share the voices with the audio thread
+  for (int note = 0; note < 160; ++note) {
+    engine.Post(MakeTimedEvent(ParameterEvent::Type::kNoteOn, 0,
+                               220 + 5 * note, note));
+  }
+
+  std::vector<float> block(128);
+  realtime::ClearViolations();
+  for (size_t i = 0; i < 16; ++i) {
+    engine.Render(block.data(), block.size());
+  }
+
+  INFO(realtime::DescribeViolations());
+  REQUIRE(realtime::GetNumViolations() == 0);
+}
+
+TEST_CASE("Synth engine rejects null wavetables before the audio thread") {
+  SynthEngine engine;
+
+  REQUIRE_THROWS_AS(
+      engine.Post(MakeTimedEvent(ParameterEvent::Type::kWavetable, 0)),
+      std::out_of_range);
+}
+
+TEST_CASE("Recorder pushes without real-time violations") {
+  const std::string kPath = "test_realtime_recorder.wav";
+  Recorder recorder(SynthEngine::kDefaultSampleRate, 1, 256);
+  std::vector<float> block(128);
+  recorder.Start(kPath);
+
+  // The small ring overruns unless the writer keeps up; both paths are checked
+  realtime::ClearViolations();
+  for (size_t i = 0; i < 16; ++i) {
+    recorder.Push(block.data(), block.size());
+  }
+
+  INFO(realtime::DescribeViolations());
+  REQUIRE(realtime::GetNumViolations() == 0);
+
+  recorder.Stop();
+  std::remove(kPath.c_str());
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <thread>
+#include <core/recorder.h>
+#include <core/wav_reader.h>
+
+using scalepiegraph::Recorder;
+using scalepiegraph::WavReader;
+
+TEST_CASE("Record blocks to a WAV file") {
+  const std::string kPath = "test_recorder.wav";
+  const size_t kBlockSize = 64;
+  Recorder recorder(44100, 1, 1024);
+  std::vector<float> block(kBlockSize);
+
+  SECTION("Blocks are written in order") {
+    recorder.Start(kPath);
+    REQUIRE(recorder.IsRecording());
+
+    for (size_t block_idx = 0; block_idx < 100; ++block_idx) {
+      for (size_t frame = 0; frame < kBlockSize; ++frame) {
+        block[frame] = ((block_idx * kBlockSize + frame) % 100) / 100.0f;
+      }
+      recorder.Push(block.data(), block.size());
+
+      // Give the writer time to keep up with the ring
+      if (block_idx % 8 == 7) {
+        while (recorder.GetNumFrames() < (block_idx + 1) * kBlockSize) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    recorder.Stop();
+    REQUIRE_FALSE(recorder.IsRecording());
+    REQUIRE(recorder.GetNumFrames() == 100 * kBlockSize);
+    REQUIRE(recorder.GetNumOverruns() == 0);
+
+    WavReader reader(kPath);
+    std::vector<float> recording(reader.GetNumFrames());
+    reader.Read(0, recording.data(), recording.size());
+
+    REQUIRE(reader.GetSampleRate() == 44100);
+    REQUIRE(recording.size() == 100 * kBlockSize);
+    for (size_t frame = 0; frame < recording.size(); ++frame) {
+      REQUIRE(recording[frame] == Approx((frame % 100) / 100.0).margin(1e-4));
+    }
+  }
+
+  SECTION("Blocks are ignored while stopped") {
+    recorder.Push(block.data(), block.size());
+    recorder.Start(kPath);
+    recorder.Stop();
+
+    REQUIRE(recorder.GetNumFrames() == 0);
+    REQUIRE(WavReader(kPath).GetNumFrames() == 0);
+  }
+
+  SECTION("Blocks that do not fit are dropped") {
+    std::vector<float> long_block(2048);
+    recorder.Start(kPath);
+    recorder.Push(long_block.data(), long_block.size());
+    recorder.Push(block.data(), block.size());
+    recorder.Stop();
+
+    REQUIRE(recorder.GetNumOverruns() == 1);
+    REQUIRE(recorder.GetNumDroppedFrames() == long_block.size());
+    REQUIRE(recorder.GetNumFrames() == kBlockSize);
+  }
+
+  SECTION("A new recording starts clean") {
+    std::vector<float> long_block(2048);
+    recorder.Start(kPath);
+    recorder.Push(long_block.data(), long_block.size());
+    recorder.Start(kPath);
+
+    REQUIRE(recorder.IsRecording());
+    REQUIRE(recorder.GetNumOverruns() == 0);
+    recorder.Stop();
+  }
+
+  std::remove(kPath.c_str());
+}
+
+TEST_CASE("Invalid recorder") {
+  REQUIRE_THROWS_AS(Recorder(0), std::out_of_range);
+  REQUIRE_THROWS_AS(Recorder(44100, 0), std::out_of_range);
+
+  Recorder recorder(44100);
+  REQUIRE_THROWS_AS(recorder.Start("missing_directory/recording.wav"),
+                    std::runtime_error);
+  REQUIRE_FALSE(recorder.IsRecording());
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <core/render_profiler.h>
+#include <core/synth_engine.h>
+#include <sstream>
+
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::RenderProfiler;
+using scalepiegraph::RenderStats;
+using scalepiegraph::SynthEngine;
+
+// 64 frames at 64 kHz last exactly one millisecond
+const double kProfilerSampleRate = 64000;
+const size_t kProfilerBlockSize = 64;
+const int64_t kBlockNanos = 1000000;
+
+TEST_CASE("Render profiler starts empty") {
+  RenderStats stats = RenderProfiler().GetStats();
+
+  REQUIRE(stats.num_blocks == 0);
+  REQUIRE(stats.num_dropouts == 0);
+  REQUIRE(stats.min_block_frames == 0);
+  REQUIRE(stats.render_histogram.size() == RenderProfiler::kNumHistogramBins);
+}
+
+TEST_CASE("Render profiler times blocks") {
+  RenderProfiler profiler;
+
+  profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+  profiler.EndBlock(kBlockNanos + 100000);
+  profiler.BeginBlock(2 * kBlockNanos, 2 * kProfilerBlockSize,
+                      kProfilerSampleRate);
+  profiler.EndBlock(2 * kBlockNanos + 300000);
+
+  RenderStats stats = profiler.GetStats();
+
+  REQUIRE(stats.num_blocks == 2);
+  REQUIRE(stats.last_render_micros == Approx(300));
+  REQUIRE(stats.mean_render_micros == Approx(200));
+  REQUIRE(stats.max_render_micros == Approx(300));
+  REQUIRE(stats.max_load == Approx(0.15));
+  REQUIRE(stats.min_block_frames == kProfilerBlockSize);
+  REQUIRE(stats.max_block_frames == 2 * kProfilerBlockSize);
+  REQUIRE(stats.num_dropouts == 0);
+}
+
+TEST_CASE("Render profiler bins render times by powers of two") {
+  RenderProfiler profiler;
+
+  SECTION("Sub-microsecond renders land in the first bin") {
+    profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+    profiler.EndBlock(kBlockNanos + 500);
+
+    REQUIRE(profiler.GetStats().render_histogram[0] == 1);
+  }
+
+  SECTION("A 100 us render lands in the [64, 128) us bin") {
+    profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+    profiler.EndBlock(kBlockNanos + 100000);
+
+    REQUIRE(profiler.GetStats().render_histogram[7] == 1);
+  }
+
+  SECTION("Very slow renders land in the last bin") {
+    profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+    profiler.EndBlock(kBlockNanos + 1000 * kBlockNanos);
+
+    REQUIRE(profiler.GetStats().render_histogram.back() == 1);
+  }
+}
+
+TEST_CASE("Render profiler counts dropouts and late callbacks") {
+  RenderProfiler profiler;
+
+  SECTION("A render longer than its block is a dropout") {
+    profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+    profiler.EndBlock(kBlockNanos + 2 * kBlockNanos);
+
+    RenderStats stats = profiler.GetStats();
+    REQUIRE(stats.num_dropouts == 1);
+    REQUIRE(stats.max_load == Approx(2));
+  }
+
+  SECTION("A callback over a block late is counted with its jitter") {
+    profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+    profiler.EndBlock(kBlockNanos + 1000);
+    profiler.BeginBlock(4 * kBlockNanos, kProfilerBlockSize,
+                        kProfilerSampleRate);
+    profiler.EndBlock(4 * kBlockNanos + 1000);
+
+    RenderStats stats = profiler.GetStats();
+    REQUIRE(stats.num_late_callbacks == 1);
+    REQUIRE(stats.max_jitter_micros == Approx(2000));
+    REQUIRE(stats.mean_jitter_micros == Approx(2000));
+  }
+
+  SECTION("Evenly spaced callbacks have no jitter") {
+    for (int64_t block = 1; block <= 4; ++block) {
+      profiler.BeginBlock(block * kBlockNanos, kProfilerBlockSize,
+                          kProfilerSampleRate);
+      profiler.EndBlock(block * kBlockNanos + 1000);
+    }
+
+    RenderStats stats = profiler.GetStats();
+    REQUIRE(stats.num_late_callbacks == 0);
+    REQUIRE(stats.max_jitter_micros == 0);
+  }
+}
+
+TEST_CASE("Render profiler resets at the next block") {
+  RenderProfiler profiler;
+  profiler.BeginBlock(kBlockNanos, kProfilerBlockSize, kProfilerSampleRate);
+  profiler.EndBlock(kBlockNanos + 2 * kBlockNanos);
+
+  profiler.Reset();
+  profiler.BeginBlock(4 * kBlockNanos, kProfilerBlockSize,
+                      kProfilerSampleRate);
+  profiler.EndBlock(4 * kBlockNanos + 1000);
+
+  RenderStats stats = profiler.GetStats();
+  REQUIRE(stats.num_blocks == 1);
+  REQUIRE(stats.num_dropouts == 0);
+  REQUIRE(stats.num_late_callbacks == 0);
+}
+
+TEST_CASE("Synth engine reports render statistics") {
+  SynthEngine engine;
+  std::vector<float> block(256);
+
+  engine.Post(ParameterEvent::Type::kStart, 440);
+  for (size_t i = 0; i < 8; ++i) {
+    engine.Render(block.data(), block.size());
+  }
+
+  RenderStats stats = engine.GetRenderStats();
+  REQUIRE(stats.num_blocks == 8);
+  REQUIRE(stats.min_block_frames == block.size());
+  REQUIRE(stats.max_queue_depth == 1);
+  REQUIRE(stats.queue_depth == 0);
+
+  SECTION("Stats serialize to JSON") {
+    std::stringstream json_stream;
+    json_stream << stats;
+
+    Json::Value root;
+    json_stream >> root;
+    REQUIRE(root["num_blocks"].asUInt64() == 8);
+    REQUIRE(root["render_histogram"].size() ==
+            RenderProfiler::kNumHistogramBins);
+  }
+}
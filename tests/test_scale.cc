@@ -440,4 +440,55 @@ TEST_CASE("Convert proportions to cents valid") {
       ++idx;
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Find nearest note") {
+  Scale scale("Test", {200, 300, 500}); // Notes at 0, 200, 500 and 1000 cents
+
+  SECTION("Note cents") {
+    REQUIRE(scale.GetNoteCents(0) == 0);
+    REQUIRE(scale.GetNoteCents(2) == Approx(500));
+    REQUIRE(scale.GetNoteCents(3) == Approx(1000));
+    REQUIRE_THROWS_AS(scale.GetNoteCents(4), std::out_of_range);
+  }
+
+  SECTION("Between notes") {
+    scalepiegraph::NearestNote nearest = scale.FindNearestNote(420);
+
+    REQUIRE(nearest.note_index == 2);
+    REQUIRE(nearest.period == 0);
+    REQUIRE(nearest.deviation == Approx(-80));
+  }
+
+  SECTION("Exactly on a note") {
+    scalepiegraph::NearestNote nearest = scale.FindNearestNote(200);
+
+    REQUIRE(nearest.note_index == 1);
+    REQUIRE(nearest.deviation == Approx(0));
+  }
+
+  SECTION("Nearest to the next period") {
+    scalepiegraph::NearestNote nearest = scale.FindNearestNote(1150);
+
+    REQUIRE(nearest.note_index == 0);
+    REQUIRE(nearest.period == 1);
+    REQUIRE(nearest.deviation == Approx(-50));
+  }
+
+  SECTION("Below the first note") {
+    scalepiegraph::NearestNote nearest = scale.FindNearestNote(-1010);
+
+    REQUIRE(nearest.note_index == 1);
+    REQUIRE(nearest.period == -1);
+    REQUIRE(nearest.deviation == Approx(-10));
+  }
+
+  SECTION("Multiple octave scale") {
+    Scale wide("Wide", {0.5}, 2); // Notes at 0 and 1200 cents
+
+    scalepiegraph::NearestNote nearest = wide.FindNearestNote(3550);
+    REQUIRE(nearest.note_index == 1);
+    REQUIRE(nearest.period == 1);
+    REQUIRE(nearest.deviation == Approx(-50));
+  }
+}
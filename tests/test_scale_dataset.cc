@@ -1,5 +1,8 @@
 // Copyright (c) 2021 Andrew Orals. All rights reserved.
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <catch2/catch.hpp>
 #include <core/scale_dataset.h>
 
@@ -42,4 +45,54 @@ TEST_CASE("Import Dataset Valid") {
   REQUIRE(dataset.GetNames() == kExpectedNames);
   REQUIRE(dataset[kExpectedNames[0]] == kBluesScale);
   REQUIRE(dataset[kExpectedNames[1]] == kBoliviaScale);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Visit every scale of a dataset in parallel") {
+  std::istringstream json(
+      "{\"scales\": ["
+      "{\"name\": \"Blues\", \"intervals\": [0, 3, 5, 6, 7, 10]},"
+      "{\"name\": \"Whole Tone\", \"intervals\": [0, 2, 4, 6, 8, 10]},"
+      "{\"name\": \"Tritone\", \"intervals\": [0, 6]}"
+      "]}");
+  ScaleDataset dataset;
+  json >> dataset;
+
+  std::mutex visits_mutex;
+  std::vector<size_t> visits(dataset.GetNames().size(), 0);
+  size_t num_visitors = 0;
+
+  SECTION("Each scale visited once") {
+    size_t num_threads = dataset.ForEachScale(2, [&]() {
+      std::lock_guard<std::mutex> lock(visits_mutex);
+      ++num_visitors;
+
+      return [&](size_t index, const Scale& scale) {
+        std::lock_guard<std::mutex> lock(visits_mutex);
+        if (scale == dataset[dataset.GetNames()[index]]) {
+          ++visits[index];
+        }
+      };
+    });
+
+    REQUIRE(num_threads == 2);
+    REQUIRE(num_visitors == 2);
+    REQUIRE(visits == std::vector<size_t>({1, 1, 1}));
+  }
+
+  SECTION("First error rethrown after every scale visited") {
+    REQUIRE_THROWS_AS(dataset.ForEachScale(1, [&]() {
+      return [&](size_t index, const Scale&) {
+        ++visits[index];
+        throw std::runtime_error("Visit failed");
+      };
+    }), std::runtime_error);
+
+    REQUIRE(visits == std::vector<size_t>({1, 1, 1}));
+  }
+
+  SECTION("At least one worker") {
+    REQUIRE(dataset.ForEachScale(0, [&]() {
+      return [](size_t, const Scale&) {};
+    }) == 1);
+  }
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <core/scale_inference.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleInference;
+using scalepiegraph::WavWriter;
+
+TEST_CASE("Infer scale from noisy frequencies") {
+  const double kTonic = 200;
+
+  SECTION("Five equal notes among noise") {
+    std::mt19937 generator(42);
+    std::normal_distribution<double> noise(0, 8);
+    std::uniform_int_distribution<int> note(0, 4);
+    std::uniform_int_distribution<int> octave(-1, 2);
+
+    // The reference is a little off the true tonic
+    ScaleInference inference(kTonic * 0.99);
+    for (size_t observation = 0; observation < 200000; ++observation) {
+      double cents = 240 * note(generator) + 1200 * octave(generator) +
+                     noise(generator);
+      inference.AddFrequency(kTonic * std::exp2(cents / 1200));
+    }
+
+    Scale scale = inference.Infer("Slendro");
+    std::vector<double> frequencies = inference.InferFrequencies();
+
+    REQUIRE(inference.GetNumObservations() == 200000);
+    REQUIRE(scale.GetNumNotes() == 5);
+    REQUIRE(frequencies[0] == Approx(kTonic).epsilon(0.002));
+    for (size_t interval = 0; interval < scale.GetNumIntervals(); ++interval) {
+      REQUIRE(scale.GetInterval(interval) == Approx(240).margin(2));
+    }
+  }
+
+  SECTION("Tonic just below the reference") {
+    ScaleInference inference(kTonic);
+    for (double cents : {-10.0, 300.0, 700.0}) {
+      for (size_t repeat = 0; repeat < 10; ++repeat) {
+        inference.AddFrequency(kTonic * std::exp2(cents / 1200));
+      }
+    }
+
+    std::vector<double> frequencies = inference.InferFrequencies();
+
+    REQUIRE(frequencies.size() == 3);
+    REQUIRE(frequencies[0] == Approx(kTonic * std::exp2(-10 / 1200.0)));
+    REQUIRE(frequencies[2] == Approx(kTonic * std::exp2(700 / 1200.0)));
+  }
+
+  SECTION("Weak peaks are ignored") {
+    ScaleInference inference(kTonic);
+    inference.AddFrequency(kTonic, 100);
+    inference.AddFrequency(kTonic * 1.5, 100);
+    inference.AddFrequency(kTonic * 1.25, 5);
+
+    REQUIRE(inference.InferFrequencies().size() == 2);
+    REQUIRE(inference.InferFrequencies(10, 0.01).size() == 3);
+  }
+}
+
+TEST_CASE("Infer scale from CSV") {
+  std::istringstream csv(
+      "frequency,confidence\n220,0.9\n330,0.8\n440,0.7\n331,0.6\n");
+  ScaleInference inference(220);
+
+  REQUIRE(inference.AddCsv(csv) == 8);
+
+  // Each confidence folds in as a lone low pitch, below the threshold
+  std::vector<double> frequencies = inference.InferFrequencies(10, 0.75);
+  REQUIRE(frequencies.size() == 2);
+  REQUIRE(frequencies[0] == Approx(220).epsilon(0.001));
+  REQUIRE(frequencies[1] == Approx(330.5).epsilon(0.001));
+}
+
+TEST_CASE("Infer scale from a recording") {
+  const std::string kPath = "test_scale_inference.wav";
+  std::vector<float> recording;
+  for (double frequency : {220.0, 330.0, 440.0, 330.0}) {
+    for (size_t frame = 0; frame < 22050; ++frame) {
+      recording.push_back(static_cast<float>(
+          0.5 * std::sin(6.283185307179586 * frequency * frame / 44100)));
+    }
+  }
+  WavWriter::WriteFile(kPath, recording, 44100);
+
+  ScaleInference inference(220);
+  size_t num_added = inference.AddRecording(kPath);
+  std::remove(kPath.c_str());
+
+  REQUIRE(num_added > 60);
+  std::vector<double> frequencies = inference.InferFrequencies(10, 0.3);
+  REQUIRE(frequencies.size() == 2);
+  REQUIRE(frequencies[1] == Approx(330).epsilon(0.002));
+}
+
+TEST_CASE("Invalid scale inference") {
+  REQUIRE_THROWS_AS(ScaleInference(0), std::out_of_range);
+
+  ScaleInference inference(220);
+  REQUIRE_THROWS_AS(inference.AddFrequency(-1), std::out_of_range);
+  REQUIRE_THROWS_AS(inference.InferFrequencies(), std::runtime_error);
+
+  inference.AddFrequency(220);
+  REQUIRE_THROWS_AS(inference.Infer("Single"), std::runtime_error);
+  REQUIRE_THROWS_AS(inference.InferFrequencies(0), std::out_of_range);
+}
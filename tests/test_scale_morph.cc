@@ -0,0 +1,69 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <core/scale_morph.h>
+
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleMorph;
+
+TEST_CASE("Construct scale morph") {
+  SECTION("Empty morph") {
+    ScaleMorph morph;
+
+    REQUIRE(morph.GetNumNotes() == 0);
+    REQUIRE(morph.FindNote(440) == -1);
+  }
+
+  SECTION("Notes are tabulated from both scales") {
+    Scale from(12);
+    Scale to(7);
+    ScaleMorph morph(from, to, 440, 0.5);
+
+    REQUIRE(morph.GetDuration() == 0.5);
+    for (size_t note_idx = 0; note_idx < 20; ++note_idx) {
+      REQUIRE(morph.GetFromFrequency(note_idx) ==
+              Approx(from.CalculateNoteFrequency(note_idx, 440)));
+      REQUIRE(morph.GetToFrequency(note_idx) ==
+              Approx(to.CalculateNoteFrequency(note_idx, 440)));
+    }
+  }
+
+  SECTION("Notes stop at the top of hearing") {
+    ScaleMorph morph(Scale(12), Scale(12), 440, 0.5);
+
+    // 440 Hz times 2^(65 / 12) is the last note below 20 kHz
+    REQUIRE(morph.GetNumNotes() == 67);
+    REQUIRE(morph.GetFromFrequency(66) <= ScaleMorph::kMaxFrequency);
+    REQUIRE_THROWS_AS(morph.GetFromFrequency(67), std::out_of_range);
+  }
+
+  SECTION("Invalid arguments") {
+    REQUIRE_THROWS_AS(ScaleMorph(Scale(12), Scale(7), 0, 0.5),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(ScaleMorph(Scale(12), Scale(7), 440, -1),
+                      std::out_of_range);
+  }
+}
+
+TEST_CASE("Find notes of scale morph") {
+  ScaleMorph morph(Scale(12), Scale(7), 440, 0.5);
+
+  SECTION("Exact notes") {
+    REQUIRE(morph.FindNote(440) == 0);
+    REQUIRE(morph.FindNote(880) == 12);
+    REQUIRE(morph.FindNote(morph.GetFromFrequency(7)) == 7);
+  }
+
+  SECTION("Within tolerance") {
+    REQUIRE(morph.FindNote(440.1) == 0);
+    REQUIRE(morph.FindNote(morph.GetFromFrequency(30) * 0.9999) == 30);
+  }
+
+  SECTION("Between notes") {
+    REQUIRE(morph.FindNote(452) == -1);
+  }
+
+  SECTION("Outside the table") {
+    REQUIRE(morph.FindNote(220) == -1);
+    REQUIRE(morph.FindNote(30000) == -1);
+  }
+}
@@ -0,0 +1,247 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <core/offline_renderer.h>
+#include <core/pattern.h>
+#include <core/sequencer.h>
+#include <core/triple_buffer.h>
+
+using scalepiegraph::ArpeggioMode;
+using scalepiegraph::OfflineRenderer;
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::Pattern;
+using scalepiegraph::Scale;
+using scalepiegraph::Sequencer;
+using scalepiegraph::TripleBuffer;
+
+const double kSequencerSampleRate = 44100;
+
+/**
+ * Pop every event the sequencer produces before a frame.
+ */
+std::vector<ParameterEvent> PopEventsBefore(Sequencer& sequencer,
+                                            uint64_t end_frame) {
+  std::vector<ParameterEvent> events;
+
+  while (sequencer.GetNextEventFrame() < end_frame) {
+    ParameterEvent event;
+    if (sequencer.PopEvent(&event)) {
+      events.push_back(event);
+    }
+  }
+
+  return events;
+}
+
+TEST_CASE("Triple buffer hands over the latest value") {
+  TripleBuffer<int> buffer;
+  REQUIRE_FALSE(buffer.Update());
+
+  buffer.Write(1);
+  buffer.Write(2);
+  REQUIRE(buffer.Update());
+  REQUIRE(buffer.Read() == 2);
+  REQUIRE_FALSE(buffer.Update());
+  REQUIRE(buffer.Read() == 2);
+
+  buffer.Write(3);
+  REQUIRE(buffer.Update());
+  REQUIRE(buffer.Read() == 3);
+}
+
+TEST_CASE("Pattern validates steps") {
+  Pattern pattern;
+
+  REQUIRE_THROWS_AS(pattern.AddNote(0, 1), std::out_of_range);
+  REQUIRE_THROWS_AS(pattern.AddNote(440, 0), std::out_of_range);
+  REQUIRE_THROWS_AS(pattern.AddNote(440, 1, 1.5), std::out_of_range);
+  REQUIRE_THROWS_AS(pattern.AddRest(-1), std::out_of_range);
+  REQUIRE_THROWS_AS(pattern.GetStep(0), std::out_of_range);
+
+  for (size_t step = 0; step < Pattern::kMaxSteps; ++step) {
+    pattern.AddNote(440, 0.5);
+  }
+  REQUIRE_THROWS_AS(pattern.AddRest(1), std::out_of_range);
+  REQUIRE(pattern.GetDuration() == Approx(Pattern::kMaxSteps * 0.5));
+}
+
+TEST_CASE("Pattern builds runs and arpeggios over a scale") {
+  Scale scale(12);
+
+  SECTION("Scale run goes up every note and back down") {
+    Pattern run = Pattern::ScaleRun(scale, 0.1);
+
+    REQUIRE(run.GetNumSteps() == 2 * scale.GetNumNotes() + 1);
+    REQUIRE(run.GetStep(0).frequency == Approx(440));
+    REQUIRE(run.GetStep(scale.GetNumNotes()).frequency == Approx(880));
+    REQUIRE(run.GetStep(run.GetNumSteps() - 1).frequency == Approx(440));
+    REQUIRE_FALSE(run.IsLooping());
+  }
+
+  SECTION("Arpeggio modes order the chord notes") {
+    std::vector<size_t> chord = {0, 4, 7};
+
+    Pattern up = Pattern::Arpeggio(scale, chord, ArpeggioMode::kUp, 2, 0.1);
+    REQUIRE(up.GetNumSteps() == 6);
+    REQUIRE(up.GetStep(0).frequency == Approx(440));
+    REQUIRE(up.GetStep(3).frequency == Approx(880));
+    REQUIRE(up.IsLooping());
+
+    Pattern down =
+        Pattern::Arpeggio(scale, chord, ArpeggioMode::kDown, 2, 0.1);
+    REQUIRE(down.GetStep(0).frequency == Approx(up.GetStep(5).frequency));
+    REQUIRE(down.GetStep(5).frequency == Approx(440));
+
+    Pattern up_down =
+        Pattern::Arpeggio(scale, chord, ArpeggioMode::kUpDown, 2, 0.1);
+    REQUIRE(up_down.GetNumSteps() == 10);
+    REQUIRE(up_down.GetStep(6).frequency == Approx(up.GetStep(4).frequency));
+    REQUIRE(up_down.GetStep(9).frequency == Approx(up.GetStep(1).frequency));
+  }
+
+  SECTION("Arpeggio needs notes") {
+    REQUIRE_THROWS_AS(
+        Pattern::Arpeggio(scale, {}, ArpeggioMode::kUp, 1, 0.1),
+        std::out_of_range);
+  }
+}
+
+TEST_CASE("Patterns over large scales fit in a pattern") {
+  Scale scale(200);
+
+  SECTION("Scale run skips notes but keeps its ends") {
+    Pattern run = Pattern::ScaleRun(scale, 0.1);
+
+    REQUIRE(run.GetNumSteps() <= Pattern::kMaxSteps);
+    REQUIRE(run.GetStep(0).frequency == Approx(440));
+    REQUIRE(run.GetStep(run.GetNumSteps() / 2).frequency == Approx(880));
+    REQUIRE(run.GetStep(run.GetNumSteps() - 1).frequency == Approx(440));
+
+    for (size_t step = 1; step <= run.GetNumSteps() / 2; ++step) {
+      REQUIRE(run.GetStep(step).frequency >
+              run.GetStep(step - 1).frequency);
+    }
+  }
+
+  SECTION("Arpeggio skips notes but keeps the lowest and highest") {
+    std::vector<size_t> chord;
+    for (size_t note_idx = 0; note_idx < scale.GetNumNotes(); note_idx += 2) {
+      chord.push_back(note_idx);
+    }
+
+    Pattern up_down =
+        Pattern::Arpeggio(scale, chord, ArpeggioMode::kUpDown, 2, 0.1);
+    REQUIRE(up_down.GetNumSteps() <= Pattern::kMaxSteps);
+    REQUIRE(up_down.GetStep(0).frequency == Approx(440));
+    REQUIRE(up_down.GetStep(up_down.GetNumSteps() / 2).frequency ==
+            Approx(scale.CalculateNoteFrequency(198, 880)));
+
+    Pattern up = Pattern::Arpeggio(scale, chord, ArpeggioMode::kUp, 3, 0.1);
+    REQUIRE(up.GetNumSteps() == Pattern::kMaxSteps);
+  }
+}
+
+TEST_CASE("Sequencer schedules notes on exact frames") {
+  const uint64_t kStartFrame = 100;
+  const double kStepDuration = 0.01013; // 446.733 frames, to expose drift
+
+  Pattern pattern;
+  for (size_t step = 0; step < 100; ++step) {
+    pattern.AddNote(440 + step, kStepDuration, 0.5);
+  }
+
+  Sequencer sequencer(kSequencerSampleRate);
+  sequencer.SetPattern(pattern);
+  sequencer.Start(kStartFrame);
+
+  std::vector<ParameterEvent> events =
+      PopEventsBefore(sequencer, Sequencer::kNever);
+  REQUIRE(events.size() == 200);
+
+  for (size_t step = 0; step < 100; ++step) {
+    double step_frames = kStepDuration * kSequencerSampleRate;
+    const ParameterEvent& note_on = events[2 * step];
+    const ParameterEvent& note_off = events[2 * step + 1];
+
+    REQUIRE(note_on.type == ParameterEvent::Type::kNoteOn);
+    REQUIRE(note_on.note == Sequencer::kSequencerNote);
+    REQUIRE(note_on.value == Approx(440 + step));
+    REQUIRE(note_on.frame == static_cast<uint64_t>(
+        std::llround(kStartFrame + step * step_frames)));
+
+    REQUIRE(note_off.type == ParameterEvent::Type::kNoteOff);
+    REQUIRE(note_off.frame == static_cast<uint64_t>(
+        std::llround(kStartFrame + (step + 0.5) * step_frames)));
+  }
+
+  REQUIRE_FALSE(sequencer.IsPlaying());
+}
+
+TEST_CASE("Sequencer rests, loops and switches patterns between steps") {
+  Pattern pattern;
+  pattern.AddNote(440, 0.01, 1);
+  pattern.AddRest(0.01);
+  pattern.SetLooping(true);
+
+  Sequencer sequencer(kSequencerSampleRate);
+  sequencer.SetPattern(pattern);
+  sequencer.Start(0);
+
+  SECTION("Legato notes release on the frame the next step starts") {
+    std::vector<ParameterEvent> events = PopEventsBefore(sequencer, 1000);
+
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].frame == 0);
+    REQUIRE(events[1].type == ParameterEvent::Type::kNoteOff);
+    REQUIRE(events[1].frame == 441);
+    REQUIRE(events[2].type == ParameterEvent::Type::kNoteOn);
+    REQUIRE(events[2].frame == 882);
+    REQUIRE(sequencer.IsPlaying());
+  }
+
+  SECTION("A new pattern takes over at the next step") {
+    PopEventsBefore(sequencer, 200);
+
+    Pattern next_pattern;
+    next_pattern.AddNote(660, 0.01);
+    sequencer.SetPattern(next_pattern);
+
+    std::vector<ParameterEvent> events = PopEventsBefore(sequencer, 1000);
+    REQUIRE(events[0].type == ParameterEvent::Type::kNoteOff);
+    REQUIRE(events[1].type == ParameterEvent::Type::kNoteOn);
+    REQUIRE(events[1].frame == 441);
+    REQUIRE(events[1].value == Approx(660));
+  }
+
+  SECTION("Stopping releases the sounding note") {
+    PopEventsBefore(sequencer, 200);
+    sequencer.Stop(300);
+
+    std::vector<ParameterEvent> events =
+        PopEventsBefore(sequencer, Sequencer::kNever);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == ParameterEvent::Type::kNoteOff);
+    REQUIRE(events[0].frame == 300);
+    REQUIRE_FALSE(sequencer.IsPlaying());
+  }
+}
+
+TEST_CASE("Sequenced rendering does not depend on the block size") {
+  Pattern pattern = Pattern::Arpeggio(Scale(12), {0, 4, 7},
+                                      ArpeggioMode::kUpDown, 2, 0.0123);
+
+  std::vector<float> reference =
+      OfflineRenderer(kSequencerSampleRate, 512).RenderPattern(pattern, 0.5);
+  REQUIRE(reference.size() == 22050);
+
+  // The first note starts on the first frame from a silent envelope
+  REQUIRE(reference[0] == 0);
+  REQUIRE(reference[1] != 0);
+
+  for (size_t block_size : {1, 37, 64, 1000}) {
+    std::vector<float> output = OfflineRenderer(kSequencerSampleRate,
+                                                block_size)
+        .RenderPattern(pattern, 0.5);
+    REQUIRE(output == reference);
+  }
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <core/sinc_resampler.h>
+
+using scalepiegraph::SincResampler;
+
+/**
+ * Fill a window of the resampler with a sine wave whose phase at the center
+ * of the window is zero.
+ */
+std::vector<float> MakeSineWindow(double cycles_per_sample) {
+  std::vector<float> window(SincResampler::kTaps);
+  for (size_t tap = 0; tap < window.size(); ++tap) {
+    double offset = tap - (SincResampler::kTaps / 2.0 - 1);
+    window[tap] = static_cast<float>(
+        std::sin(6.283185307179586 * cycles_per_sample * offset));
+  }
+
+  return window;
+}
+
+TEST_CASE("Resampler bands") {
+  SincResampler resampler;
+
+  REQUIRE(resampler.GetBand(0.5) == 0);
+  REQUIRE(resampler.GetBand(1) == 0);
+  REQUIRE(resampler.GetBand(1.2) == 1);
+  REQUIRE(resampler.GetBand(2) == 2);
+  REQUIRE(resampler.GetBand(1000) == SincResampler::kNumBands - 1);
+}
+
+TEST_CASE("Resampler interpolates") {
+  SincResampler resampler;
+
+  SECTION("Unity gain at DC") {
+    std::vector<float> window(SincResampler::kTaps, 1);
+
+    for (float fraction : {0.0f, 0.3f, 0.999f}) {
+      REQUIRE(resampler.Interpolate(window.data(), fraction, 0) ==
+              Approx(1).margin(1e-5));
+    }
+  }
+
+  SECTION("Low sine between samples") {
+    const double kCyclesPerSample = 0.05;
+    std::vector<float> window = MakeSineWindow(kCyclesPerSample);
+
+    for (float fraction : {0.0f, 0.25f, 0.5f, 0.8f}) {
+      REQUIRE(resampler.Interpolate(window.data(), fraction, 0) ==
+              Approx(std::sin(6.283185307179586 * kCyclesPerSample *
+                              fraction)).margin(1e-3));
+    }
+  }
+
+  SECTION("Higher bands block what would alias") {
+    std::vector<float> window = MakeSineWindow(0.2);
+    float peak = 0;
+    for (float fraction = 0; fraction < 1; fraction += 0.125f) {
+      peak = std::max(peak, std::fabs(resampler.Interpolate(
+          window.data(), fraction, resampler.GetBand(4))));
+    }
+
+    REQUIRE(peak < 0.05);
+  }
+}
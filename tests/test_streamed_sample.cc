@@ -0,0 +1,123 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <core/streamed_sample.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::StreamedSample;
+using scalepiegraph::WavWriter;
+
+/**
+ * Read a whole stream of a sample in small blocks, waiting for the loader
+ * whenever the ring runs dry.
+ */
+std::vector<float> ReadWholeStream(StreamedSample& sample, size_t stream) {
+  std::vector<float> frames;
+  std::vector<float> block(256);
+
+  while (frames.size() < sample.GetNumFrames()) {
+    size_t num_read = sample.Read(stream, block.data(), block.size());
+    frames.insert(frames.end(), block.begin(), block.begin() + num_read);
+
+    if (num_read < block.size()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  return frames;
+}
+
+TEST_CASE("Stream sample from disk") {
+  const std::string kPath = "test_streamed_sample.wav";
+  std::vector<float> recording(10000);
+  for (size_t frame = 0; frame < recording.size(); ++frame) {
+    recording[frame] = (frame % 1000) / 1000.0f - 0.5f;
+  }
+  WavWriter::WriteFile(kPath, recording, 44100);
+
+  StreamedSample sample(kPath, 440, 2, 1000, 1000);
+
+  SECTION("Format") {
+    REQUIRE(sample.GetNumFrames() == recording.size());
+    REQUIRE(sample.GetSampleRate() == 44100);
+    REQUIRE(sample.GetRootFrequency() == 440);
+    REQUIRE(sample.GetNumStreams() == 2);
+  }
+
+  SECTION("Whole recording through head and ring") {
+    std::vector<float> frames = ReadWholeStream(sample, 0);
+
+    for (size_t frame = 0; frame < recording.size(); ++frame) {
+      REQUIRE(frames[frame] == Approx(recording[frame]).margin(1e-4));
+    }
+  }
+
+  SECTION("Silence past the end") {
+    ReadWholeStream(sample, 0);
+    std::vector<float> block(16, 1);
+
+    REQUIRE(sample.Read(0, block.data(), block.size()) == 0);
+    REQUIRE(block[0] == 0);
+  }
+
+  SECTION("Start rewinds a stream") {
+    ReadWholeStream(sample, 0);
+    sample.Start(0);
+    std::vector<float> frames = ReadWholeStream(sample, 0);
+
+    REQUIRE(frames[2000] == Approx(recording[2000]).margin(1e-4));
+    REQUIRE(frames[9999] == Approx(recording[9999]).margin(1e-4));
+  }
+
+  SECTION("Streams are independent") {
+    std::vector<float> block(500);
+    sample.Read(0, block.data(), block.size());
+    std::vector<float> frames = ReadWholeStream(sample, 1);
+
+    REQUIRE(frames[0] == Approx(recording[0]).margin(1e-4));
+    REQUIRE(frames[5000] == Approx(recording[5000]).margin(1e-4));
+  }
+
+  SECTION("Reading past the ring underruns") {
+    std::vector<float> block(5000);
+
+    REQUIRE(sample.Read(0, block.data(), block.size()) < block.size());
+    REQUIRE(sample.GetNumUnderruns() == 1);
+  }
+
+  std::remove(kPath.c_str());
+}
+
+TEST_CASE("Stream truncated sample") {
+  const std::string kPath = "test_streamed_sample_truncated.wav";
+  WavWriter::WriteFile(kPath, std::vector<float>(10000, 0.25f), 44100);
+
+  // Cut the samples in half, leaving the header claiming all of them
+  std::ifstream input(kPath, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(input)),
+                    std::istreambuf_iterator<char>());
+  input.close();
+  std::ofstream output(kPath, std::ios::binary);
+  output.write(bytes.data(), bytes.size() / 2);
+  output.close();
+
+  {
+    StreamedSample sample(kPath, 440, 1, 1000, 1000);
+    std::vector<float> frames = ReadWholeStream(sample, 0);
+
+    REQUIRE(sample.GetNumFrames() < 10000);
+    REQUIRE(frames.size() == sample.GetNumFrames());
+    REQUIRE(frames.back() == Approx(0.25).margin(1e-4));
+  }
+
+  std::remove(kPath.c_str());
+}
+
+TEST_CASE("Invalid streamed sample") {
+  REQUIRE_THROWS_AS(StreamedSample("missing.wav", 440, 1),
+                    std::runtime_error);
+}
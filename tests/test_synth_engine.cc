@@ -0,0 +1,206 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdio>
+#include <core/streamed_sample.h>
+#include <core/synth_engine.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::ParameterEvent;
+using scalepiegraph::SynthEngine;
+using scalepiegraph::Waveform;
+
+ParameterEvent MakeEvent(ParameterEvent::Type type,
+                         uint64_t frame,
+                         double value = 0,
+                         int note = 0);
+
+TEST_CASE("Synth engine renders silence until started") {
+  SynthEngine engine;
+  std::vector<float> block(256, 1);
+
+  engine.Render(block.data(), block.size());
+
+  for (float sample : block) {
+    REQUIRE(sample == 0);
+  }
+  REQUIRE(engine.GetFrameClock() == block.size());
+}
+
+TEST_CASE("Synth engine applies events sample-accurately") {
+  const size_t kBlockSize = 64;
+  const uint64_t kStartFrame = 100;
+  const uint64_t kStopFrame = 150;
+
+  SynthEngine engine;
+  engine.Post(MakeEvent(ParameterEvent::Type::kWaveform, 0,
+                        static_cast<int>(Waveform::kSquare)));
+  engine.Post(MakeEvent(ParameterEvent::Type::kFilterCutoff, 0, 20000));
+  engine.Post(MakeEvent(ParameterEvent::Type::kStart, kStartFrame, 440));
+  engine.Post(MakeEvent(ParameterEvent::Type::kStop, kStopFrame));
+
+  std::vector<float> output(4 * kBlockSize);
+  for (size_t offset = 0; offset < output.size(); offset += kBlockSize) {
+    engine.Render(output.data() + offset, kBlockSize);
+  }
+
+  SECTION("Silent before start frame") {
+    for (size_t frame = 0; frame < kStartFrame; ++frame) {
+      REQUIRE(output[frame] == 0);
+    }
+  }
+
+  SECTION("Sounding from the start frame") {
+    // The envelope attack starts from zero on the start frame itself
+    REQUIRE(output[kStartFrame] == 0);
+    REQUIRE(output[kStartFrame + 1] != 0);
+  }
+
+  SECTION("All events consumed on time") {
+    REQUIRE(engine.GetParameterQueue().GetDepth() == 0);
+    REQUIRE(engine.GetNumLateEvents() == 0);
+  }
+}
+
+TEST_CASE("Synth engine counts late events") {
+  SynthEngine engine;
+  std::vector<float> block(64);
+
+  engine.Render(block.data(), block.size());
+  engine.Post(MakeEvent(ParameterEvent::Type::kStart, 0, 440));
+  engine.Render(block.data(), block.size());
+
+  REQUIRE(engine.GetNumLateEvents() == 1);
+}
+
+TEST_CASE("Synth engine plays notes polyphonically") {
+  SynthEngine engine;
+  std::vector<float> block(256);
+
+  engine.Post(MakeEvent(ParameterEvent::Type::kNoteOn, 0, 440, 1));
+  engine.Post(MakeEvent(ParameterEvent::Type::kNoteOn, 0, 550, 2));
+  engine.Post(MakeEvent(ParameterEvent::Type::kStart, 0, 660));
+  engine.Render(block.data(), block.size());
+
+  REQUIRE(engine.GetVoicePool().GetNumActiveVoices() == 3);
+
+  engine.Post(MakeEvent(ParameterEvent::Type::kStopAll, 256));
+  for (size_t block_idx = 0; block_idx < 20; ++block_idx) {
+    engine.Render(block.data(), block.size());
+  }
+
+  REQUIRE(engine.GetVoicePool().GetNumActiveVoices() == 0);
+}
+
+TEST_CASE("Synth engine invalid sample rate") {
+  REQUIRE_THROWS_AS(SynthEngine(0), std::out_of_range);
+}
+
+TEST_CASE("Synth engine rejects invalid events before queueing them") {
+  SynthEngine engine;
+
+  REQUIRE_THROWS_AS(
+      engine.Post(MakeEvent(ParameterEvent::Type::kFilterResonance, 0, 0)),
+      std::out_of_range);
+  REQUIRE_THROWS_AS(engine.Post(MakeEvent(ParameterEvent::Type::kSample, 0, 0)),
+                    std::out_of_range);
+  REQUIRE(engine.GetParameterQueue().GetDepth() == 0);
+}
+
+TEST_CASE("Synth engine hands timbres to the voices") {
+  SynthEngine engine;
+  std::vector<float> block(256);
+  scalepiegraph::AdditiveTimbre timbre;
+  timbre.AddPartial(2, 1);
+
+  engine.SetMaxPartials(8);
+  engine.Post(MakeEvent(ParameterEvent::Type::kNoteOn, 0, 440, 1));
+  REQUIRE(engine.SetTimbre(timbre));
+  timbre.AddPartial(3, 1); // The engine plays its own copy
+  REQUIRE(engine.SetTimbre(timbre));
+  engine.Render(block.data(), block.size());
+
+  float peak = 0;
+  for (float sample : block) {
+    peak = std::max(peak, std::fabs(sample));
+  }
+
+  REQUIRE(peak > 0);
+  REQUIRE(engine.GetParameterQueue().GetDepth() == 0);
+}
+
+TEST_CASE("Synth engine hands scale morphs to the voices") {
+  SynthEngine engine;
+  std::vector<float> block(4410);
+  scalepiegraph::Scale from(12);
+  scalepiegraph::Scale to(5);
+
+  engine.Post(MakeEvent(ParameterEvent::Type::kNoteOn, 0, 880, 1));
+  REQUIRE(engine.MorphScale(scalepiegraph::ScaleMorph(from, to, 440, 0.05)));
+  engine.Render(block.data(), block.size());
+
+  REQUIRE(engine.GetVoicePool().GetNoteFrequency(1) ==
+          Approx(to.CalculateNoteFrequency(12, 440)));
+}
+
+TEST_CASE("Synth engine acknowledges applied wavetables") {
+  SynthEngine engine;
+  scalepiegraph::Wavetable wavetable = scalepiegraph::Wavetable::FromWaveform(
+      Waveform::kSquare, engine.GetSampleRate());
+  std::vector<float> block(256);
+
+  ParameterEvent event = MakeEvent(ParameterEvent::Type::kWavetable, 0);
+  event.wavetable = &wavetable;
+  engine.Post(event);
+
+  REQUIRE(engine.GetAppliedWavetable() == nullptr);
+  engine.Render(block.data(), block.size());
+  REQUIRE(engine.GetAppliedWavetable() == &wavetable);
+}
+
+TEST_CASE("Synth engine acknowledges applied samples") {
+  const std::string kPath = "test_synth_engine_sample.wav";
+  scalepiegraph::WavWriter::WriteFile(
+      kPath, std::vector<float>(1000, 0.5f), 44100);
+
+  {
+    SynthEngine engine;
+    size_t num_voices = engine.GetVoicePool().GetNumVoices();
+    scalepiegraph::StreamedSample first(kPath, 440, num_voices);
+    scalepiegraph::StreamedSample second(kPath, 440, num_voices);
+    std::vector<float> block(256);
+
+    ParameterEvent event = MakeEvent(ParameterEvent::Type::kSample, 0);
+    event.sample = &first;
+    engine.Post(event);
+    event.sample = &second;
+    event.frame = 1000;
+    engine.Post(event);
+
+    REQUIRE(engine.GetAppliedSample() == nullptr);
+    engine.Render(block.data(), block.size());
+    REQUIRE(engine.GetAppliedSample() == &first);
+
+    // The second sample is still queued, so the first is still read
+    engine.Render(block.data(), block.size());
+    REQUIRE(engine.GetAppliedSample() == &first);
+    for (size_t block_idx = 0; block_idx < 4; ++block_idx) {
+      engine.Render(block.data(), block.size());
+    }
+    REQUIRE(engine.GetAppliedSample() == &second);
+  }
+
+  std::remove(kPath.c_str());
+}
+
+ParameterEvent MakeEvent(ParameterEvent::Type type,
+                         uint64_t frame,
+                         double value,
+                         int note) {
+  ParameterEvent event;
+  event.type = type;
+  event.frame = frame;
+  event.value = value;
+  event.note = note;
+  return event;
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <core/tuning_export.h>
+
+using scalepiegraph::KeyboardMapping;
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleDataset;
+using scalepiegraph::TuningExporter;
+
+TEST_CASE("Bulk dump follows the MIDI Tuning Standard layout") {
+  std::vector<uint8_t> dump =
+      TuningExporter::MakeBulkDump(Scale(12), KeyboardMapping(), 5);
+
+  REQUIRE(dump.size() == TuningExporter::kBulkDumpSize);
+  REQUIRE(dump.front() == 0xF0);
+  REQUIRE(dump[1] == 0x7E);
+  REQUIRE(dump[2] == TuningExporter::kAllDevices);
+  REQUIRE(dump[3] == 0x08);
+  REQUIRE(dump[4] == 0x01);
+  REQUIRE(dump[5] == 5);
+  REQUIRE(dump.back() == 0xF7);
+
+  uint8_t checksum = 0;
+  for (size_t byte = 1; byte < dump.size() - 2; ++byte) {
+    checksum ^= dump[byte];
+  }
+  REQUIRE(dump[dump.size() - 2] == (checksum & 0x7F));
+
+  for (size_t byte = 1; byte < dump.size() - 1; ++byte) {
+    REQUIRE(dump[byte] < 0x80);
+  }
+}
+
+TEST_CASE("Bulk dump encodes key frequencies") {
+  const size_t kFirstKeyByte = 6 + TuningExporter::kNameLength;
+
+  SECTION("Twelve-tone equal temperament lands on whole semitones") {
+    std::vector<uint8_t> dump =
+        TuningExporter::MakeBulkDump(Scale(12), KeyboardMapping(), 0);
+
+    for (size_t key = 0; key < 128; ++key) {
+      REQUIRE(dump[kFirstKeyByte + 3 * key] == key);
+      REQUIRE(dump[kFirstKeyByte + 3 * key + 1] == 0);
+      REQUIRE(dump[kFirstKeyByte + 3 * key + 2] == 0);
+    }
+  }
+
+  SECTION("Quarter tones land halfway between semitones") {
+    KeyboardMapping mapping({}, 69, 69, 440);
+    std::vector<uint8_t> dump =
+        TuningExporter::MakeBulkDump(Scale(24), mapping, 0);
+
+    // Key 70 is a quarter tone above A4: 69 semitones and 8192/16384
+    REQUIRE(dump[kFirstKeyByte + 3 * 70] == 69);
+    REQUIRE(dump[kFirstKeyByte + 3 * 70 + 1] == 0x40);
+    REQUIRE(dump[kFirstKeyByte + 3 * 70 + 2] == 0);
+  }
+
+  SECTION("Name is padded to sixteen characters") {
+    std::vector<uint8_t> dump = TuningExporter::MakeBulkDump(
+        Scale("Pelog", {120, 150, 270, 130, 110, 300}), KeyboardMapping(), 0);
+
+    std::string name(dump.begin() + 6, dump.begin() + kFirstKeyByte);
+    REQUIRE(name == "Pelog           ");
+  }
+}
+
+TEST_CASE("Tun file lists every key in cents") {
+  std::ostringstream tun;
+  TuningExporter::WriteTun(Scale(12), KeyboardMapping(), tun);
+  std::string contents = tun.str();
+
+  REQUIRE(contents.find("[Tuning]") != std::string::npos);
+  REQUIRE(contents.find("note 0=0\n") != std::string::npos);
+  REQUIRE(contents.find("note 69=6900\n") != std::string::npos);
+  REQUIRE(contents.find("[Exact Tuning]") != std::string::npos);
+  REQUIRE(contents.find("note 69= 6900.000000\n") != std::string::npos);
+  REQUIRE(contents.find("[Scale End]") != std::string::npos);
+}
+
+TEST_CASE("Export tunings of a dataset") {
+  std::istringstream json(
+      "{\"scales\": ["
+      "{\"name\": \"Blues\", \"intervals\": [0, 3, 5, 6, 7, 10]},"
+      "{\"name\": \"Whole Tone\", \"intervals\": [0, 2, 4, 6, 8, 10]}"
+      "]}");
+  ScaleDataset dataset;
+  json >> dataset;
+
+  REQUIRE(TuningExporter::ExportDataset(dataset, ".") == 2);
+
+  for (std::string name : {"0_Blues", "1_Whole_Tone"}) {
+    std::ifstream dump_file(name + ".syx", std::ios::binary);
+    dump_file.seekg(0, std::ios::end);
+    REQUIRE(static_cast<size_t>(dump_file.tellg()) ==
+            TuningExporter::kBulkDumpSize);
+    dump_file.close();
+
+    std::ifstream tun_file(name + ".tun");
+    REQUIRE(tun_file.good());
+    tun_file.close();
+
+    std::remove((name + ".syx").c_str());
+    std::remove((name + ".tun").c_str());
+  }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <core/tuning_verifier.h>
+
+using scalepiegraph::NoteTuning;
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleDataset;
+using scalepiegraph::TuningReport;
+using scalepiegraph::TuningVerifier;
+using scalepiegraph::Waveform;
+
+TEST_CASE("Measure frequency between bins") {
+  const size_t kFftSize = 16384;
+  const double kSampleRate = 44100;
+  TuningVerifier verifier(1, kSampleRate, kFftSize);
+
+  for (double frequency : {220.0, 311.127, 439.3, 1234.5}) {
+    std::vector<float> samples(kFftSize);
+    for (size_t frame = 0; frame < kFftSize; ++frame) {
+      samples[frame] = static_cast<float>(
+          0.5 * std::sin(6.283185307179586 * frequency * frame / kSampleRate));
+    }
+
+    double measured = verifier.MeasureFrequency(samples.data(), frequency);
+    double error_cents = 1200 * std::log2(measured / frequency);
+
+    REQUIRE(std::fabs(error_cents) < 0.05);
+  }
+}
+
+TEST_CASE("Verify tuning of a scale") {
+  TuningVerifier verifier(1, 44100, 16384);
+  verifier.SetWaveforms({Waveform::kSine, Waveform::kSawtooth});
+  verifier.SetRange(2, 220);
+
+  std::vector<NoteTuning> tunings = verifier.VerifyScale(Scale(12));
+
+  REQUIRE(tunings.size() == 2 * 2 * 12);
+  REQUIRE(tunings[0].waveform == Waveform::kSine);
+  REQUIRE(tunings[0].expected_frequency == Approx(220));
+  REQUIRE(tunings[13].octave == 1);
+  REQUIRE(tunings[13].note_index == 1);
+  REQUIRE(tunings.back().waveform == Waveform::kSawtooth);
+  for (const NoteTuning& tuning : tunings) {
+    REQUIRE(std::fabs(tuning.error_cents) < 0.5);
+  }
+}
+
+TEST_CASE("Verify tuning of a dataset in parallel") {
+  std::istringstream json(
+      "{\"scales\": ["
+      "{\"name\": \"Blues\", \"intervals\": [0, 3, 5, 6, 7, 10]},"
+      "{\"name\": \"Tritone\", \"intervals\": [0, 6]},"
+      "{\"name\": \"Major\", \"intervals\": [0, 2, 4, 5, 7, 9, 11]}"
+      "]}");
+  ScaleDataset dataset;
+  json >> dataset;
+
+  TuningVerifier verifier(2, 44100, 8192);
+  verifier.SetWaveforms({Waveform::kTriangle});
+  verifier.SetRange(1, 330);
+  TuningReport report = verifier.VerifyDataset(dataset);
+
+  REQUIRE(report.num_workers == 2);
+  REQUIRE(report.notes.size() == 6 + 2 + 7);
+  REQUIRE(report.notes[0].scale_name == "Blues");
+  REQUIRE(report.notes[6].scale_name == "Tritone");
+  REQUIRE(report.notes.back().scale_name == "Major");
+  REQUIRE(report.GetMaxAbsErrorCents() < 1);
+  REQUIRE(report.GetMeanAbsErrorCents() <= report.GetMaxAbsErrorCents());
+
+  std::ostringstream output;
+  output << report;
+  REQUIRE(output.str().find("\"max_abs_error_cents\"") != std::string::npos);
+}
+
+TEST_CASE("Tuning verifier rejects invalid settings") {
+  TuningVerifier verifier(1);
+
+  REQUIRE_THROWS_AS(TuningVerifier(1, 0), std::out_of_range);
+  REQUIRE_THROWS_AS(TuningVerifier(1, 44100, 1000), std::out_of_range);
+  REQUIRE_THROWS_AS(verifier.SetWaveforms({Waveform::kAdditive}),
+                    std::out_of_range);
+  REQUIRE_THROWS_AS(verifier.SetRange(0, 220), std::out_of_range);
+  REQUIRE_THROWS_AS(verifier.SetRange(1, 0), std::out_of_range);
+}
@@ -0,0 +1,498 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <cmath>
+#include <cstdio>
+#include <catch2/catch.hpp>
+#include <core/voice_pool.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::AdditiveTimbre;
+using scalepiegraph::FilterMode;
+using scalepiegraph::Scale;
+using scalepiegraph::ScaleMorph;
+using scalepiegraph::StreamedSample;
+using scalepiegraph::VoicePool;
+using scalepiegraph::Waveform;
+using scalepiegraph::WavWriter;
+
+TEST_CASE("Construct voice pool") {
+  SECTION("Voices padded to SIMD width") {
+    VoicePool pool(5);
+
+    REQUIRE(pool.GetNumVoices() == 8);
+    REQUIRE(pool.GetNumActiveVoices() == 0);
+  }
+
+  SECTION("No voices") {
+    REQUIRE_THROWS_AS(VoicePool(0), std::out_of_range);
+  }
+
+  SECTION("Invalid envelope") {
+    VoicePool pool;
+
+    REQUIRE_THROWS_AS(pool.SetEnvelope(0.1, 0.1, 1.5, 0.1), std::out_of_range);
+  }
+}
+
+TEST_CASE("Voice pool renders notes") {
+  VoicePool pool(4);
+  pool.SetFilterCutoff(20000);
+  std::vector<float> output(1024);
+
+  SECTION("Silent when idle") {
+    pool.Render(output.data(), output.size());
+
+    for (float sample : output) {
+      REQUIRE(sample == 0);
+    }
+  }
+
+  SECTION("Sine note is bounded and nonzero") {
+    pool.NoteOn(0, 440);
+    pool.Render(output.data(), output.size());
+
+    float peak = 0;
+    for (float sample : output) {
+      peak = std::max(peak, std::fabs(sample));
+    }
+
+    REQUIRE(peak > 0.1);
+    REQUIRE(peak <= VoicePool::kVoiceGain * 1.1);
+    REQUIRE(pool.GetNumActiveVoices() == 1);
+  }
+
+  SECTION("Released note falls silent") {
+    pool.SetEnvelope(0.001, 0.01, 0.5, 0.001);
+    pool.NoteOn(0, 440);
+    pool.Render(output.data(), output.size());
+    pool.NoteOff(0);
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNumActiveVoices() == 0);
+  }
+
+  SECTION("Same note retriggers its voice") {
+    pool.NoteOn(3, 440);
+    pool.NoteOn(3, 440);
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNumActiveVoices() == 1);
+    REQUIRE(pool.GetNumStolenVoices() == 0);
+  }
+}
+
+TEST_CASE("Voice pool steals voices") {
+  VoicePool pool(4);
+  std::vector<float> output(256);
+
+  for (int note = 0; note < 4; ++note) {
+    pool.NoteOn(note, 220 + 10 * note);
+  }
+  pool.Render(output.data(), output.size());
+
+  SECTION("Oldest voice is stolen") {
+    pool.NoteOn(4, 440);
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNumStolenVoices() == 1);
+    REQUIRE(pool.GetNumActiveVoices() == 4);
+  }
+
+  SECTION("Released voice is stolen before held voices") {
+    pool.NoteOff(2);
+    pool.NoteOn(4, 440);
+    pool.NoteOff(0);
+    pool.Render(output.data(), output.size());
+
+    // Note 0 is still releasing because note 4 took the voice of note 2
+    REQUIRE(pool.GetNumStolenVoices() == 1);
+    REQUIRE(pool.GetNumActiveVoices() == 4);
+  }
+}
+
+TEST_CASE("Voice pool waveforms") {
+  const std::vector<Waveform> kWaveforms = {Waveform::kSine,
+                                            Waveform::kTriangle,
+                                            Waveform::kSquare,
+                                            Waveform::kSawtooth};
+
+  for (Waveform waveform : kWaveforms) {
+    VoicePool pool(1);
+    std::vector<float> output(2048);
+
+    pool.SetFilterCutoff(20000);
+    pool.SetWaveform(waveform);
+    pool.NoteOn(0, 100);
+    pool.Render(output.data(), output.size());
+
+    float peak = 0;
+    for (float sample : output) {
+      peak = std::max(peak, std::fabs(sample));
+    }
+
+    REQUIRE(peak > 0.3);
+    REQUIRE(peak < 0.75);
+  }
+}
+
+/**
+ * Render a cluster of notes that are started, partly released and restarted
+ * across uneven blocks, as the engine does around events.
+ */
+std::vector<float> RenderCluster(size_t num_threads, size_t num_notes) {
+  VoicePool pool(512);
+  pool.SetNumThreads(num_threads);
+  pool.SetFilterCutoff(8000);
+  pool.SetWaveform(Waveform::kSawtooth);
+
+  std::vector<float> output(4000);
+  for (size_t note = 0; note < num_notes; ++note) {
+    pool.NoteOn(note, 55.0 * (1 + note % 24 / 12.0) * (1 + note / 24));
+  }
+
+  pool.Render(output.data(), 1000);
+  for (size_t note = 0; note < num_notes; note += 3) {
+    pool.NoteOff(note);
+  }
+  pool.Render(output.data() + 1000, 1300);
+  pool.NoteOn(1000, 440);
+  pool.Render(output.data() + 2300, 1700);
+
+  return output;
+}
+
+TEST_CASE("Voice pool renders on several threads") {
+  SECTION("Thread count") {
+    VoicePool pool;
+    REQUIRE(pool.GetNumThreads() == 1);
+
+    pool.SetNumThreads(3);
+    REQUIRE(pool.GetNumThreads() == 3);
+
+    pool.SetNumThreads(0);
+    REQUIRE(pool.GetNumThreads() >= 1);
+  }
+
+  SECTION("Dense cluster matches one thread") {
+    std::vector<float> single = RenderCluster(1, 400);
+    std::vector<float> threaded = RenderCluster(4, 400);
+
+    for (size_t frame = 0; frame < single.size(); ++frame) {
+      REQUIRE(threaded[frame] == Approx(single[frame]).margin(1e-4));
+    }
+  }
+
+  SECTION("Few voices stay on the calling thread") {
+    std::vector<float> single = RenderCluster(1, 8);
+    std::vector<float> threaded = RenderCluster(4, 8);
+
+    REQUIRE(threaded == single);
+  }
+
+  SECTION("Active voices are counted across partitions") {
+    VoicePool pool(512);
+    std::vector<float> output(512);
+    pool.SetNumThreads(4);
+
+    for (int note = 0; note < 300; ++note) {
+      pool.NoteOn(note, 110 + note);
+    }
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNumActiveVoices() == 300);
+  }
+}
+
+/**
+ * Measure the peak of a square note after its attack.
+ */
+float MeasureNotePeak(VoicePool& pool) {
+  std::vector<float> output(4096);
+  pool.Render(output.data(), output.size());
+
+  float peak = 0;
+  for (size_t frame = output.size() / 2; frame < output.size(); ++frame) {
+    peak = std::max(peak, std::fabs(output[frame]));
+  }
+
+  return peak;
+}
+
+TEST_CASE("Voice pool filters each voice") {
+  VoicePool pool(4);
+  pool.SetWaveform(Waveform::kSquare);
+  pool.SetEnvelope(0.001, 0.001, 1, 0.001);
+  pool.SetFilterCutoff(20000);
+
+  SECTION("Per-note cutoff") {
+    pool.NoteOn(0, 2000);
+    float open_peak = MeasureNotePeak(pool);
+
+    pool.SetNoteFilterCutoff(0, 200);
+    REQUIRE(MeasureNotePeak(pool) < open_peak / 10);
+  }
+
+  SECTION("Per-note cutoff ends with the note") {
+    pool.NoteOn(0, 2000);
+    pool.SetNoteFilterCutoff(0, 200);
+    MeasureNotePeak(pool);
+    pool.NoteOn(0, 2000);
+
+    REQUIRE(MeasureNotePeak(pool) > 0.3);
+  }
+
+  SECTION("High-pass blocks a low note") {
+    pool.SetFilterMode(FilterMode::kHighPass);
+    pool.SetFilterCutoff(5000);
+    pool.SetWaveform(Waveform::kSine);
+    pool.NoteOn(0, 100);
+
+    REQUIRE(MeasureNotePeak(pool) < 0.01);
+  }
+
+  SECTION("Envelope sweeps the cutoff") {
+    pool.SetFilterCutoff(100);
+    pool.NoteOn(0, 2000);
+    float closed_peak = MeasureNotePeak(pool);
+
+    pool.SetFilterEnvelope(7);
+    REQUIRE(MeasureNotePeak(pool) > 5 * closed_peak);
+  }
+
+  SECTION("Invalid resonance") {
+    REQUIRE_THROWS_AS(pool.SetFilterResonance(0), std::out_of_range);
+  }
+}
+
+/**
+ * Create a timbre of the first harmonics with equal amplitudes.
+ */
+AdditiveTimbre MakeHarmonicTimbre(size_t num_harmonics) {
+  AdditiveTimbre timbre;
+  for (size_t harmonic = 2; harmonic <= num_harmonics; ++harmonic) {
+    timbre.AddPartial(harmonic, 1);
+  }
+
+  return timbre;
+}
+
+/**
+ * Render a block and measure its peak.
+ */
+float RenderPeak(VoicePool& pool, size_t num_frames) {
+  std::vector<float> output(num_frames);
+  pool.Render(output.data(), output.size());
+
+  float peak = 0;
+  for (float sample : output) {
+    peak = std::max(peak, std::fabs(sample));
+  }
+
+  return peak;
+}
+
+TEST_CASE("Voice pool plays additive timbres") {
+  VoicePool pool(4);
+  pool.SetFilterCutoff(20000);
+  AdditiveTimbre sine;
+  AdditiveTimbre harmonics = MakeHarmonicTimbre(64);
+
+  SECTION("Ignored until partials are allocated") {
+    pool.NoteOn(0, 100);
+    float sine_peak = RenderPeak(pool, 4096);
+
+    VoicePool additive_pool(4);
+    additive_pool.SetFilterCutoff(20000);
+    additive_pool.SetTimbre(&harmonics);
+    additive_pool.SetWaveform(Waveform::kAdditive);
+    additive_pool.NoteOn(0, 100);
+
+    REQUIRE(RenderPeak(additive_pool, 4096) == sine_peak);
+  }
+
+  SECTION("Single partial matches the sine oscillator") {
+    pool.NoteOn(0, 100);
+    float sine_peak = RenderPeak(pool, 4096);
+
+    VoicePool additive_pool(4);
+    additive_pool.SetFilterCutoff(20000);
+    additive_pool.SetMaxPartials(AdditiveTimbre::kMaxPartials);
+    additive_pool.SetTimbre(&sine);
+    additive_pool.NoteOn(0, 100);
+
+    REQUIRE(RenderPeak(additive_pool, 4096) == Approx(sine_peak).margin(0.01));
+  }
+
+  SECTION("Partials above Nyquist are dropped") {
+    pool.SetMaxPartials(AdditiveTimbre::kMaxPartials);
+    pool.SetTimbre(&harmonics);
+    pool.NoteOn(0, 100);
+    float low_peak = RenderPeak(pool, 4096);
+
+    // Only the fundamental of a high note is below Nyquist
+    pool.NoteOn(1, 15000);
+    pool.NoteOff(0);
+    RenderPeak(pool, 44100);
+    float high_peak = RenderPeak(pool, 4096);
+
+    REQUIRE(high_peak > 0.1);
+    REQUIRE(high_peak < low_peak / 4);
+  }
+
+  SECTION("Sounding voices keep their phase") {
+    pool.SetMaxPartials(AdditiveTimbre::kMaxPartials);
+    pool.SetTimbre(&sine);
+    pool.NoteOn(0, 100);
+    RenderPeak(pool, 4096);
+
+    VoicePool retimbred_pool(4);
+    retimbred_pool.SetFilterCutoff(20000);
+    retimbred_pool.SetMaxPartials(AdditiveTimbre::kMaxPartials);
+    retimbred_pool.SetTimbre(&sine);
+    retimbred_pool.NoteOn(0, 100);
+    RenderPeak(retimbred_pool, 4096);
+
+    // Adding silent partials must not disturb the fundamental
+    AdditiveTimbre silent_harmonics;
+    silent_harmonics.AddPartial(2, 0);
+    silent_harmonics.AddPartial(3, 0);
+    retimbred_pool.SetTimbre(&silent_harmonics);
+
+    std::vector<float> output(256);
+    std::vector<float> retimbred_output(256);
+    pool.Render(output.data(), output.size());
+    retimbred_pool.Render(retimbred_output.data(), retimbred_output.size());
+    for (size_t frame = 0; frame < output.size(); ++frame) {
+      REQUIRE(retimbred_output[frame] == Approx(output[frame]).margin(1e-5));
+    }
+  }
+
+  SECTION("Dense timbre stays bounded") {
+    pool.SetMaxPartials(AdditiveTimbre::kMaxPartials);
+    AdditiveTimbre timbre =
+        AdditiveTimbre::FromScale(Scale(12), 256);
+    pool.SetTimbre(&timbre);
+    pool.NoteOn(0, 55);
+
+    float peak = RenderPeak(pool, 44100);
+    REQUIRE(peak > 0.1);
+    REQUIRE(peak < 2);
+  }
+}
+
+TEST_CASE("Voice pool morphs between scales") {
+  VoicePool pool(4);
+  std::vector<float> output(2205); // 50 ms
+  Scale from(12);
+  Scale to(7);
+  ScaleMorph morph(from, to, 220, 0.1);
+
+  pool.NoteOn(1, from.CalculateNoteFrequency(5, 220));
+  pool.NoteOn(2, 300); // Not a note of either scale
+  pool.Render(output.data(), output.size());
+
+  SECTION("Notes glide to the incoming scale") {
+    double start = from.CalculateNoteFrequency(5, 220);
+    double end = to.CalculateNoteFrequency(5, 220);
+
+    pool.MorphScale(morph);
+    pool.Render(output.data(), output.size());
+    double halfway = pool.GetNoteFrequency(1);
+    REQUIRE(halfway > std::min(start, end));
+    REQUIRE(halfway < std::max(start, end));
+
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+    REQUIRE(pool.GetNoteFrequency(1) == Approx(end));
+    REQUIRE(pool.GetNoteFrequency(2) == Approx(300));
+  }
+
+  SECTION("Retuned note leaves the morph") {
+    pool.MorphScale(morph);
+    pool.SetNoteFrequency(1, 500);
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNoteFrequency(1) == Approx(500));
+  }
+
+  SECTION("Morph from a morph") {
+    pool.MorphScale(morph);
+    pool.Render(output.data(), output.size());
+
+    // The note is found by where it is headed, not where it is
+    ScaleMorph back(to, from, 220, 0.1);
+    pool.MorphScale(back);
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+    pool.Render(output.data(), output.size());
+
+    REQUIRE(pool.GetNoteFrequency(1) ==
+            Approx(from.CalculateNoteFrequency(5, 220)));
+  }
+
+  SECTION("Silent note") {
+    REQUIRE(pool.GetNoteFrequency(3) == 0);
+  }
+}
+
+/**
+ * Count the upward zero crossings of a signal.
+ */
+size_t CountCrossings(const std::vector<float>& signal) {
+  size_t crossings = 0;
+  for (size_t frame = 1; frame < signal.size(); ++frame) {
+    if (signal[frame - 1] < 0 && signal[frame] >= 0) {
+      ++crossings;
+    }
+  }
+
+  return crossings;
+}
+
+TEST_CASE("Voice pool plays streamed samples") {
+  const std::string kPath = "test_voice_pool_sample.wav";
+  const double kSampleRate = 44100;
+  std::vector<float> recording(44100);
+  for (size_t frame = 0; frame < recording.size(); ++frame) {
+    recording[frame] = static_cast<float>(
+        0.5 * std::sin(6.283185307179586 * 441 * frame / kSampleRate));
+  }
+  WavWriter::WriteFile(kPath, recording, kSampleRate);
+
+  VoicePool pool(4);
+  pool.SetFilterCutoff(20000);
+
+  SECTION("Too few streams for the voices") {
+    StreamedSample sample(kPath, 441, 2);
+
+    REQUIRE_THROWS_AS(pool.SetSample(&sample), std::out_of_range);
+    REQUIRE_THROWS_AS(pool.SetSample(nullptr), std::out_of_range);
+  }
+
+  SECTION("Notes transpose the sample") {
+    StreamedSample sample(kPath, 441, pool.GetNumVoices());
+    pool.SetSample(&sample);
+    pool.NoteOn(0, 882);
+
+    // Skip the attack; a fifth of a second at twice the speed stays within
+    // the preloaded head
+    std::vector<float> output(1024);
+    pool.Render(output.data(), output.size());
+    output.resize(8820);
+    pool.Render(output.data(), output.size());
+    float peak = 0;
+    for (float sample_value : output) {
+      peak = std::max(peak, std::fabs(sample_value));
+    }
+
+    REQUIRE(peak > 0);
+    REQUIRE(peak <= 1);
+    REQUIRE(CountCrossings(output) == Approx(882 / 5.0).margin(1));
+    REQUIRE(sample.GetNumUnderruns() == 0);
+  }
+
+  std::remove(kPath.c_str());
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <core/wav_reader.h>
+#include <core/wav_writer.h>
+
+using scalepiegraph::WavReader;
+using scalepiegraph::WavWriter;
+
+TEST_CASE("Read WAV file") {
+  const std::string kPath = "test_wav_reader.wav";
+  std::vector<float> stereo;
+  for (size_t frame = 0; frame < 1000; ++frame) {
+    stereo.push_back(frame / 1000.0f);
+    stereo.push_back(-0.5f);
+  }
+  WavWriter::WriteFile(kPath, stereo, 22050, 2);
+
+  WavReader reader(kPath);
+
+  SECTION("Format") {
+    REQUIRE(reader.GetSampleRate() == 22050);
+    REQUIRE(reader.GetNumChannels() == 2);
+    REQUIRE(reader.GetNumFrames() == 1000);
+  }
+
+  SECTION("Channels are averaged") {
+    std::vector<float> mono(10);
+    REQUIRE(reader.Read(500, mono.data(), mono.size()) == mono.size());
+
+    for (size_t frame = 0; frame < mono.size(); ++frame) {
+      REQUIRE(mono[frame] ==
+              Approx(((500 + frame) / 1000.0 - 0.5) / 2).margin(1e-4));
+    }
+  }
+
+  SECTION("Reads stop at the end of the file") {
+    std::vector<float> mono(10);
+
+    REQUIRE(reader.Read(995, mono.data(), mono.size()) == 5);
+    REQUIRE(reader.Read(1000, mono.data(), mono.size()) == 0);
+  }
+
+  std::remove(kPath.c_str());
+}
+
+TEST_CASE("Read invalid WAV file") {
+  SECTION("Missing file") {
+    REQUIRE_THROWS_AS(WavReader("missing.wav"), std::runtime_error);
+  }
+
+  SECTION("Not a WAV file") {
+    const std::string kPath = "test_wav_reader.txt";
+    std::ofstream file(kPath);
+    file << "RIFF but not really a wave file";
+    file.close();
+
+    REQUIRE_THROWS_AS(WavReader(kPath), std::runtime_error);
+    std::remove(kPath.c_str());
+  }
+}
+
+TEST_CASE("Read truncated WAV file") {
+  const std::string kPath = "test_wav_reader_truncated.wav";
+  WavWriter::WriteFile(kPath, std::vector<float>(1000, 0.25f), 44100);
+
+  // Cut the samples in half, leaving the header claiming all of them
+  std::ifstream input(kPath, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(input)),
+                    std::istreambuf_iterator<char>());
+  input.close();
+  std::ofstream output(kPath, std::ios::binary);
+  output.write(bytes.data(), bytes.size() / 2);
+  output.close();
+
+  WavReader reader(kPath);
+  std::vector<float> mono(1000);
+
+  REQUIRE(reader.GetNumFrames() > 0);
+  REQUIRE(reader.GetNumFrames() < 1000);
+  REQUIRE(reader.Read(0, mono.data(), mono.size()) == reader.GetNumFrames());
+  REQUIRE(mono[reader.GetNumFrames() - 1] == Approx(0.25).margin(1e-4));
+
+  std::remove(kPath.c_str());
+}
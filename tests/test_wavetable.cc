@@ -0,0 +1,121 @@
+// Copyright (c) 2021 Andrew Orals. All rights reserved.
+#include <cmath>
+#include <catch2/catch.hpp>
+#include <core/wavetable.h>
+
+using scalepiegraph::Wavetable;
+using scalepiegraph::Waveform;
+
+const double kSampleRate = 44100;
+const double kPi = 3.141592653589793;
+
+TEST_CASE("Wavetable levels") {
+  Wavetable wavetable = Wavetable::FromWaveform(Waveform::kSawtooth,
+                                                kSampleRate);
+
+  SECTION("One level per octave up to Nyquist") {
+    REQUIRE(wavetable.GetNumLevels() == 11);
+  }
+
+  SECTION("Low notes use the full table") {
+    REQUIRE(wavetable.GetLevel(20 / kSampleRate) == 0);
+    REQUIRE(wavetable.GetLevel(40 / kSampleRate) == 0);
+  }
+
+  SECTION("Each octave moves up a level") {
+    REQUIRE(wavetable.GetLevel(41 / kSampleRate) == 1);
+    REQUIRE(wavetable.GetLevel(440 / kSampleRate) == 4);
+    REQUIRE(wavetable.GetLevel(880 / kSampleRate) == 5);
+  }
+
+  SECTION("Very high notes use the top level") {
+    REQUIRE(wavetable.GetLevel(0.49) == wavetable.GetNumLevels() - 1);
+  }
+
+  SECTION("Notes just below Nyquist are not silent") {
+    size_t level = wavetable.GetLevel(21000 / kSampleRate);
+
+    REQUIRE(level == wavetable.GetNumLevels() - 1);
+    REQUIRE(std::fabs(wavetable.Evaluate(level, 0.25)) > 0.1);
+  }
+}
+
+TEST_CASE("Wavetable shapes") {
+  SECTION("Sine matches sin") {
+    Wavetable wavetable = Wavetable::FromWaveform(Waveform::kSine,
+                                                  kSampleRate);
+
+    for (double phase = 0; phase < 1; phase += 0.01) {
+      REQUIRE(wavetable.Evaluate(0, phase) ==
+              Approx(std::sin(2 * kPi * phase)).margin(1e-4));
+    }
+  }
+
+  SECTION("Top level of sawtooth is band-limited to its fundamental") {
+    Wavetable wavetable = Wavetable::FromWaveform(Waveform::kSawtooth,
+                                                  kSampleRate);
+    size_t top_level = wavetable.GetNumLevels() - 1;
+    float peak = wavetable.Evaluate(top_level, 0.75);
+
+    REQUIRE(peak > 0);
+    for (double phase = 0; phase < 1; phase += 0.01) {
+      REQUIRE(wavetable.Evaluate(top_level, phase) ==
+              Approx(-peak * std::sin(2 * kPi * phase)).margin(1e-4));
+    }
+  }
+
+  SECTION("Full sawtooth rises across the cycle") {
+    Wavetable wavetable = Wavetable::FromWaveform(Waveform::kSawtooth,
+                                                  kSampleRate);
+
+    REQUIRE(wavetable.Evaluate(0, 0.1) < wavetable.Evaluate(0, 0.4));
+    REQUIRE(wavetable.Evaluate(0, 0.6) < wavetable.Evaluate(0, 0.9));
+  }
+
+  SECTION("Square stays close to normalized at every level") {
+    Wavetable wavetable = Wavetable::FromWaveform(Waveform::kSquare,
+                                                  kSampleRate);
+
+    for (size_t level = 0; level < wavetable.GetNumLevels(); ++level) {
+      for (double phase = 0; phase < 1; phase += 0.001) {
+        REQUIRE(std::fabs(wavetable.Evaluate(level, phase)) <= 1.1);
+      }
+    }
+  }
+
+  SECTION("Custom waveform is invalid for built-in construction") {
+    REQUIRE_THROWS_AS(
+        Wavetable::FromWaveform(Waveform::kCustom, kSampleRate),
+        std::out_of_range);
+  }
+}
+
+TEST_CASE("Wavetable from user cycle") {
+  SECTION("Cycle of a sum of harmonics is reproduced") {
+    const size_t kCycleLength = 256;
+    std::vector<float> cycle(kCycleLength);
+
+    for (size_t index = 0; index < kCycleLength; ++index) {
+      double phase = static_cast<double>(index) / kCycleLength;
+      cycle[index] = static_cast<float>(0.5 * std::sin(2 * kPi * phase) +
+                                        0.25 * std::cos(6 * kPi * phase));
+    }
+
+    Wavetable wavetable = Wavetable::FromCycle(cycle, kSampleRate);
+    float peak = 0;
+    for (float sample : cycle) {
+      peak = std::max(peak, std::fabs(sample));
+    }
+
+    for (size_t index = 0; index < kCycleLength; ++index) {
+      double phase = static_cast<double>(index) / kCycleLength;
+      REQUIRE(wavetable.Evaluate(0, phase) * peak ==
+              Approx(cycle[index]).margin(1e-3));
+    }
+  }
+
+  SECTION("Cycle too short") {
+    REQUIRE_THROWS_AS(Wavetable::FromCycle({1}, kSampleRate),
+                      std::out_of_range);
+  }
+}